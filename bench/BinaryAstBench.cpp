@@ -0,0 +1,263 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+/*
+ * Benchmark of binary AST. Synthetic sources of growing size are parsed,
+ * then the tree is written as XML, JSON and binary AST to files, and the
+ * binary one is mapped back. Load is the time to map and check the image,
+ * and walk is a full traversal of the mapped tree, which is also checked
+ * against the original tree node by node.
+ *
+ * Usage: BinaryAstBench [-r rounds] [-d directory]
+ * Time is the best of all rounds.
+ */
+
+#include <tomic/lexer/impl/DefaultLexicalParser.h>
+#include <tomic/lexer/impl/StreamingPreprocessor.h>
+#include <tomic/lexer/impl/TableLexicalAnalyzer.h>
+#include <tomic/lexer/impl/token/DefaultTokenMapper.h>
+#include <tomic/logger/debug/impl/DumbLogger.h>
+#include <tomic/logger/error/impl/StandardErrorLogger.h>
+#include <tomic/logger/error/impl/StandardErrorMapper.h>
+#include <tomic/parser/ast/BinarySyntaxTree.h>
+#include <tomic/parser/ast/CompactSyntaxTree.h>
+#include <tomic/parser/ast/mapper/CompleteSyntaxMapper.h>
+#include <tomic/parser/ast/printer/BinaryAstPrinter.h>
+#include <tomic/parser/ast/printer/JsonAstPrinter.h>
+#include <tomic/parser/ast/printer/XmlAstPrinter.h>
+#include <tomic/parser/ast/SyntaxNode.h>
+#include <tomic/parser/impl/ResilientSyntacticParser.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace tomic;
+
+static std::string _SyntheticSource(int functions)
+{
+    std::string source = "const int N = 10;\nint g[4] = {1, 2, 3, 4};\n";
+    for (int i = 0; i < functions; i++)
+    {
+        char buffer[1024];
+        snprintf(buffer, sizeof(buffer),
+                 "int f%d(int a, int b[]) {\n"
+                 "    int x = a * %d + b[0] - (a / 3) %% 5, y = 0;\n"
+                 "    for (y = 0; y < N; y = y + 1) {\n"
+                 "        if (x > y && y != 3 || !x) { x = x + g[y %% 4] * N; } else x = x - 1;\n"
+                 "    }\n"
+                 "    printf(\"<%%d> & %%d\\n\", x, y);\n"
+                 "    return x;\n"
+                 "}\n",
+                 i, i % 17 + 1);
+        source += buffer;
+    }
+    source += "int main() {\n    printf(\"%d\\n\", f0(1, g));\n    return 0;\n}\n";
+
+    return source;
+}
+
+
+static SyntaxTreePtr _Parse(const std::string& source, ITokenMapperPtr tokenMapper, ISyntaxMapperPtr syntaxMapper)
+{
+    auto logger = DumbLogger::New();
+    auto errorLogger = std::make_shared<StandardErrorLogger>(std::make_shared<StandardErrorMapper>());
+    auto lexicalParser = std::make_shared<DefaultLexicalParser>(
+        std::make_shared<TableLexicalAnalyzer>(tokenMapper), errorLogger, logger);
+    ResilientSyntacticParser parser(lexicalParser, syntaxMapper, tokenMapper, errorLogger, logger);
+
+    auto stream = twio::BufferInputStream::New(source.c_str(), source.length());
+    parser.SetReader(StreamingPreprocessor::New(twio::MemoryReader::New(stream)));
+
+    return parser.Parse();
+}
+
+
+static bool _SameNode(const CompactSyntaxNode& lhs, const BinarySyntaxNode& rhs)
+{
+    if ((lhs.Type() != rhs.Type()) || (lhs.IsTerminal() != rhs.IsTerminal()) ||
+        (lhs.IsEpsilon() != rhs.IsEpsilon()) || (lhs.Attributes() != rhs.Attributes()))
+    {
+        return false;
+    }
+    if (lhs.IsTerminal())
+    {
+        TokenPtr a = lhs.Token();
+        BinaryToken b = rhs.Token();
+        return (a->type == b.Type()) && (a->length == b.Length()) && (a.Position() == b.Position()) &&
+            (strcmp(a.Lexeme(), b.Lexeme()) == 0) && (a.LineNo() == b.LineNo()) && (a.CharNo() == b.CharNo());
+    }
+    return true;
+}
+
+
+static bool _SameTree(const CompactSyntaxTree& lhs, const BinarySyntaxTree& rhs)
+{
+    if (lhs.Size() != rhs.Size())
+    {
+        return false;
+    }
+
+    // Compact tree is in preorder, and so is the walk.
+    CompactNodeId id = 0;
+    std::vector<BinarySyntaxNode> stack{ rhs.Root() };
+    while (!stack.empty())
+    {
+        BinarySyntaxNode node = stack.back();
+        stack.pop_back();
+        if (!_SameNode(lhs.Node(id++), node))
+        {
+            return false;
+        }
+        if (node.NextSibling())
+        {
+            stack.push_back(node.NextSibling());
+        }
+        if (node.FirstChild())
+        {
+            stack.push_back(node.FirstChild());
+        }
+    }
+
+    return id == lhs.Size();
+}
+
+
+static size_t _Walk(const BinarySyntaxTree& tree)
+{
+    size_t lexemes = 0;
+    std::vector<BinarySyntaxNode> stack{ tree.Root() };
+    while (!stack.empty())
+    {
+        BinarySyntaxNode node = stack.back();
+        stack.pop_back();
+        if (node.IsTerminal())
+        {
+            lexemes += node.Token().Length();
+        }
+        if (node.NextSibling())
+        {
+            stack.push_back(node.NextSibling());
+        }
+        if (node.FirstChild())
+        {
+            stack.push_back(node.FirstChild());
+        }
+    }
+    return lexemes;
+}
+
+
+template<typename Func>
+static double _Time(int rounds, Func&& func)
+{
+    double best = 0.0;
+    for (int round = 0; round < rounds; round++)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        func();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if ((round == 0) || (seconds < best))
+        {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+
+static long _FileSize(const std::string& path)
+{
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp)
+    {
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+
+static void _Benchmark(int functions, int rounds, const std::string& directory)
+{
+    auto tokenMapper = std::make_shared<DefaultTokenMapper>();
+    auto syntaxMapper = std::make_shared<CompleteSyntaxMapper>();
+    auto tree = _Parse(_SyntheticSource(functions), tokenMapper, syntaxMapper);
+    if (!tree)
+    {
+        printf("synthetic-%d: parse failed\n", functions);
+        return;
+    }
+    auto compact = CompactSyntaxTree::New(tree);
+
+    const std::string xml = directory + "/bench-ast.xml";
+    const std::string json = directory + "/bench-ast.json";
+    const std::string bin = directory + "/bench-ast.bin";
+
+    XmlAstPrinter xmlPrinter(syntaxMapper, tokenMapper);
+    JsonAstPrinter jsonPrinter(syntaxMapper, tokenMapper);
+    BinaryAstPrinter binaryPrinter;
+
+    double xmlTime = _Time(rounds, [&] {
+        xmlPrinter.Print(compact, twio::Writer::New(twio::FileOutputStream::New(xml.c_str())));
+    });
+    double jsonTime = _Time(rounds, [&] {
+        jsonPrinter.Print(compact, twio::Writer::New(twio::FileOutputStream::New(json.c_str())));
+    });
+    double binTime = _Time(rounds, [&] {
+        binaryPrinter.Print(compact, twio::Writer::New(twio::FileOutputStream::New(fopen(bin.c_str(), "wb"))));
+    });
+
+    BinarySyntaxTreePtr loaded;
+    double loadTime = _Time(rounds, [&] { loaded = BinarySyntaxTree::Load(bin.c_str()); });
+    size_t lexemes = 0;
+    double walkTime = _Time(rounds, [&] { lexemes += _Walk(*loaded); });
+    bool match = loaded && _SameTree(*compact, *loaded);
+
+    printf("synthetic-%d (%zu nodes):\n", functions, compact->Size());
+    printf("    %-8s %12s %12s\n", "format", "write (ms)", "size (KB)");
+    printf("    %-8s %12.3f %12ld\n", "xml", xmlTime * 1e3, _FileSize(xml) / 1024);
+    printf("    %-8s %12.3f %12ld\n", "json", jsonTime * 1e3, _FileSize(json) / 1024);
+    printf("    %-8s %12.3f %12ld\n", "binary", binTime * 1e3, _FileSize(bin) / 1024);
+    printf("    load %.3f ms, walk %.3f ms, match %s\n\n",
+           loadTime * 1e3, walkTime * 1e3, match ? "yes" : "NO");
+
+    remove(xml.c_str());
+    remove(json.c_str());
+    remove(bin.c_str());
+}
+
+
+int main(int argc, char* argv[])
+{
+    int rounds = 3;
+    std::string directory = ".";
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+        {
+            rounds = std::max(1, atoi(argv[++i]));
+        }
+        else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc))
+        {
+            directory = argv[++i];
+        }
+    }
+
+    for (int functions : { 100, 1000, 10000 })
+    {
+        _Benchmark(functions, rounds, directory);
+    }
+
+    return 0;
+}
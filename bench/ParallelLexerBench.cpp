@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+/*
+ * Scaling benchmark of ParallelLexicalAnalyzer. The source is preprocessed
+ * once, then lexed with 1 to 16 threads. Tokens of each run are checked
+ * against serial lexing by TableLexicalAnalyzer.
+ *
+ * Usage: ParallelLexerBench [source file] [rounds]
+ * If no source file is given, a synthetic one is used.
+ */
+
+#include <tomic/lexer/impl/ParallelLexicalAnalyzer.h>
+#include <tomic/lexer/impl/StreamingPreprocessor.h>
+#include <tomic/lexer/impl/TableLexicalAnalyzer.h>
+#include <tomic/lexer/impl/token/DefaultTokenMapper.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using namespace tomic;
+
+static std::string _SyntheticSource()
+{
+    static const char* const STATEMENTS[] = {
+        "int counter_%d = value_%d + offset_%d * scale;\n",
+        "if (index_%d < limit_%d && flag || !done) { total = total + item_%d; }\n",
+        "for (i_%d = 0; i_%d <= length; i_%d = i_%d + 1) continue; // loop\n",
+        "const int size_%d = 10; void helper_%d(int a, int b[]) { return; }\n",
+        "result_%d = getint(); printf(\"%%d and %%d\\n\", result_%d, 0); break;\n",
+    };
+
+    std::string source;
+    char line[256];
+    for (int i = 0; i < 1000000; i++)
+    {
+        snprintf(line, sizeof(line), STATEMENTS[i % 5], i, i, i, i);
+        source += line;
+        if (i % 97 == 0)
+        {
+            // A bad string across lines, which is where chunks may be split.
+            source += "printf(\"broken\n string\n here\");\n";
+        }
+    }
+
+    return source;
+}
+
+
+static std::string _Preprocess(const twio::IInputStreamPtr& stream)
+{
+    auto reader = StreamingPreprocessor::New(twio::MemoryReader::New(stream));
+
+    std::string source;
+    char buffer[4096 + 1];
+    size_t count;
+    while ((count = reader->Read(buffer, sizeof(buffer) - 1)) > 0)
+    {
+        source.append(buffer, count);
+    }
+
+    return source;
+}
+
+
+static bool _Same(const TokenPtr& lhs, const TokenPtr& rhs)
+{
+    return (lhs->type == rhs->type)
+        && (lhs.Position() == rhs.Position())
+        && (lhs->length == rhs->length)
+        && (memcmp(lhs.Lexeme(), rhs.Lexeme(), lhs->length) == 0);
+}
+
+
+int main(int argc, char* argv[])
+{
+    twio::IInputStreamPtr stream;
+    std::string synthetic;
+    if (argc > 1)
+    {
+        stream = twio::MappedInputStream::New(argv[1]);
+    }
+    else
+    {
+        synthetic = _SyntheticSource();
+        stream = twio::BufferInputStream::New(synthetic.c_str(), synthetic.length());
+    }
+    int rounds = (argc > 2) ? atoi(argv[2]) : 3;
+    if (rounds <= 0)
+    {
+        rounds = 1;
+    }
+
+    const std::string source = _Preprocess(stream);
+    auto reader = twio::MemoryReader::New(twio::BufferInputStream::New(source.c_str(), source.length()));
+    auto mapper = std::make_shared<DefaultTokenMapper>();
+
+    // Serial lexing as reference.
+    auto expected = TokenArena::New();
+    TableLexicalAnalyzer serial(mapper);
+    serial.SetArena(expected)->SetContent(source.c_str(), source.length(), 0);
+    while (serial.Next()->type != TokenType::TK_TERMINATOR)
+    {
+    }
+    const size_t count = expected->Size() - 1;
+
+    printf("%zu bytes, %zu tokens, %d rounds, %u hardware threads\n",
+           source.length(), count, rounds, std::thread::hardware_concurrency());
+    printf("%8s %12s %10s %10s\n", "threads", "time (ms)", "speedup", "identical");
+
+    double baseline = 0.0;
+    for (int threads = 1; threads <= 16; threads *= 2)
+    {
+        auto analyzer = ParallelLexicalAnalyzer::New(mapper, threads);
+
+        double best = 0.0;
+        TokenArenaPtr arena;
+        for (int r = 0; r < rounds; r++)
+        {
+            arena = TokenArena::New();
+            auto start = std::chrono::steady_clock::now();
+            analyzer->SetArena(arena)->SetReader(reader);
+            auto end = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            if ((r == 0) || (seconds < best))
+            {
+                best = seconds;
+            }
+        }
+        if (threads == 1)
+        {
+            baseline = best;
+        }
+
+        bool identical = true;
+        for (size_t i = 0; i <= count; i++)
+        {
+            if (!_Same(analyzer->Next(), TokenPtr(expected.get(), static_cast<uint32_t>(i))))
+            {
+                identical = false;
+                break;
+            }
+        }
+
+        printf("%8d %12.3f %9.2fx %10s\n", threads, best * 1e3, baseline / best, identical ? "yes" : "NO");
+    }
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+/*
+ * Scaling benchmark of parallel parse in ResilientSyntacticParser.
+ * Synthetic sources are parsed with 1 to 16 threads, and each tree and
+ * its errors are checked against the serial parse.
+ *
+ *   clean     no errors
+ *   errors    missing tokens and unknown ones in some functions
+ *   broken    also a function with its '}' missing
+ *
+ * Usage: ParallelParserBench [-f functions] [-r rounds]
+ * Time is the best of all rounds.
+ */
+
+#include <tomic/lexer/impl/DefaultLexicalParser.h>
+#include <tomic/lexer/impl/StreamingPreprocessor.h>
+#include <tomic/lexer/impl/TableLexicalAnalyzer.h>
+#include <tomic/lexer/impl/token/DefaultTokenMapper.h>
+#include <tomic/logger/debug/impl/DumbLogger.h>
+#include <tomic/logger/error/impl/StandardErrorLogger.h>
+#include <tomic/logger/error/impl/StandardErrorMapper.h>
+#include <tomic/parser/ast/mapper/ReducedSyntaxMapper.h>
+#include <tomic/parser/impl/ResilientSyntacticParser.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tomic;
+
+static std::string _Function(int i, bool errors)
+{
+    char buffer[1024];
+    snprintf(buffer, sizeof(buffer),
+             "int f%d(int a, int b[]) {\n"
+             "    int x = a * %d + b[0] - (a / 3) %% 5, y = 0; // keep\n"
+             "    for (y = 0; y < N; y = y + 1) {\n"
+             "        if (x > y && y != 3 || !x) { x = x + g[y %% 4] * N; } else x = x - 1;\n"
+             "    }\n"
+             "    printf(\"%%d %%d\\n\", x, y);\n"
+             "    return x;\n"
+             "}\n",
+             i, i % 17 + 1);
+    std::string function = buffer;
+
+    if (errors)
+    {
+        switch (i % 3)
+        {
+        case 0:
+            function.erase(function.find("; // keep"), 1);
+            break;
+        case 1:
+            function.erase(function.find(") %"), 1);
+            break;
+        default:
+            function.replace(function.find("return"), 0, "@ ");
+            break;
+        }
+    }
+
+    return function;
+}
+
+
+static std::string _SyntheticSource(int functions, int errorEvery, bool broken)
+{
+    std::string source = "const int N = 10;\nint g[4] = {1, 2, 3, 4};\n";
+    for (int i = 0; i < functions; i++)
+    {
+        source += _Function(i, (errorEvery > 0) && (i % errorEvery == 0));
+        if (broken && (i == functions / 2))
+        {
+            source.erase(source.rfind('}'), 1);
+        }
+    }
+
+    source += "int main() {\n    int s = 0;\n    s = getint();\n";
+    for (int i = 0; i < functions; i++)
+    {
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "    s = s + f%d(%d, g);\n", i, i % 10);
+        source += buffer;
+    }
+    source += "    printf(\"%d\\n\", s);\n    return 0;\n}\n";
+
+    return source;
+}
+
+
+/*
+ * ================================ Parse ================================
+ */
+
+struct Result
+{
+    SyntaxTreePtr tree;
+    std::string errors;
+    double seconds;
+};
+
+
+static Result _Parse(const std::string& source, int threads)
+{
+    auto tokenMapper = std::make_shared<DefaultTokenMapper>();
+    auto logger = DumbLogger::New();
+    auto errorLogger = std::make_shared<StandardErrorLogger>(std::make_shared<StandardErrorMapper>());
+    auto lexicalParser = std::make_shared<DefaultLexicalParser>(
+        std::make_shared<TableLexicalAnalyzer>(tokenMapper), errorLogger, logger);
+    ResilientSyntacticParser parser(
+        lexicalParser, std::make_shared<ReducedSyntaxMapper>(), tokenMapper, errorLogger, logger);
+    parser.SetThreads(threads);
+
+    auto stream = twio::BufferInputStream::New(source.c_str(), source.length());
+    parser.SetReader(StreamingPreprocessor::New(twio::MemoryReader::New(stream)));
+
+    Result result;
+    auto begin = std::chrono::steady_clock::now();
+    result.tree = parser.Parse();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    auto output = twio::BufferOutputStream::New();
+    errorLogger->Dumps(twio::Writer::New(output));
+    result.errors = output->Yield()->buffer.get();
+
+    return result;
+}
+
+
+static bool _SameToken(TokenPtr lhs, TokenPtr rhs)
+{
+    if (!lhs || !rhs)
+    {
+        return !lhs && !rhs;
+    }
+    return (lhs->type == rhs->type) && (lhs.Position() == rhs.Position()) &&
+        (strcmp(lhs.Lexeme(), rhs.Lexeme()) == 0) &&
+        (lhs.LineNo() == rhs.LineNo()) && (lhs.CharNo() == rhs.CharNo());
+}
+
+
+static bool _SameTree(SyntaxNodePtr lhs, SyntaxNodePtr rhs)
+{
+    std::vector<std::pair<SyntaxNodePtr, SyntaxNodePtr>> stack{ { lhs, rhs } };
+    while (!stack.empty())
+    {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+        if (!a || !b)
+        {
+            if (a || b)
+            {
+                return false;
+            }
+            continue;
+        }
+        if ((a->Type() != b->Type()) || (a->IsTerminal() != b->IsTerminal()) ||
+            (a->IsTerminal() && !_SameToken(a->Token(), b->Token())))
+        {
+            return false;
+        }
+        if (a->Attributes() != b->Attributes())
+        {
+            return false;
+        }
+        stack.emplace_back(a->NextSibling(), b->NextSibling());
+        stack.emplace_back(a->FirstChild(), b->FirstChild());
+    }
+    return true;
+}
+
+
+static bool _Same(const Result& lhs, const Result& rhs)
+{
+    if (!lhs.tree || !rhs.tree)
+    {
+        return !lhs.tree && !rhs.tree && (lhs.errors == rhs.errors);
+    }
+    return _SameTree(lhs.tree->Root(), rhs.tree->Root()) && (lhs.errors == rhs.errors);
+}
+
+
+static void _Benchmark(const char* name, const std::string& source, int rounds)
+{
+    printf("%s (%zu bytes):\n", name, source.length());
+    printf("    %-8s %12s %10s %8s\n", "threads", "time (ms)", "speedup", "match");
+
+    Result serial = _Parse(source, 1);
+    double base = 0.0;
+    const int maxThreads = std::max(16, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        double best = 0.0;
+        bool match = true;
+        for (int round = 0; round < rounds; round++)
+        {
+            Result result = _Parse(source, threads);
+            match = match && _Same(result, serial);
+            if ((round == 0) || (result.seconds < best))
+            {
+                best = result.seconds;
+            }
+        }
+        if (threads == 1)
+        {
+            base = best;
+        }
+
+        printf("    %-8d %12.3f %10.2f %8s\n", threads, best * 1e3, base / best, match ? "yes" : "NO");
+    }
+    printf("\n");
+}
+
+
+int main(int argc, char* argv[])
+{
+    int functions = 20000;
+    int rounds = 3;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc))
+        {
+            functions = std::max(2, atoi(argv[++i]));
+        }
+        else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+        {
+            rounds = std::max(1, atoi(argv[++i]));
+        }
+    }
+
+    _Benchmark("clean", _SyntheticSource(functions, 0, false), rounds);
+    _Benchmark("errors", _SyntheticSource(functions, 50, false), rounds);
+    _Benchmark("broken", _SyntheticSource(functions, 50, true), rounds);
+
+    return 0;
+}
@@ -0,0 +1,294 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+/*
+ * Fuzz-style benchmark of ResilientSyntacticParser error recovery. Each
+ * source is corrupted by random mutations that keep its size, and the parse
+ * time of the corrupted one is compared with that of the valid one. Since
+ * recovery is bounded, the ratio should stay close to 1 at any error rate.
+ *
+ *   substitute  replace characters with random SysY characters
+ *   shift       delete characters and insert random ones elsewhere
+ *   splice      glue truncated fragments of the source together
+ *
+ * Usage: RecoveryBench [-r rounds] [-s seed] [source files...]
+ * If no source file is given, two synthetic sources are used. Time is the
+ * best of all rounds.
+ */
+
+#include <tomic/lexer/impl/DefaultLexicalParser.h>
+#include <tomic/lexer/impl/StreamingPreprocessor.h>
+#include <tomic/lexer/impl/TableLexicalAnalyzer.h>
+#include <tomic/lexer/impl/token/DefaultTokenMapper.h>
+#include <tomic/logger/debug/impl/DumbLogger.h>
+#include <tomic/logger/error/impl/StandardErrorLogger.h>
+#include <tomic/logger/error/impl/StandardErrorMapper.h>
+#include <tomic/parser/ast/mapper/ReducedSyntaxMapper.h>
+#include <tomic/parser/impl/ResilientSyntacticParser.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace tomic;
+
+struct Source
+{
+    std::string name;
+    std::string content;    // preprocessed
+};
+
+
+static std::string _Preprocess(const twio::IInputStreamPtr& stream)
+{
+    auto reader = StreamingPreprocessor::New(twio::MemoryReader::New(stream));
+
+    std::string content;
+    char buffer[4096 + 1];
+    size_t count;
+    while ((count = reader->Read(buffer, sizeof(buffer) - 1)) > 0)
+    {
+        content.append(buffer, count);
+    }
+
+    return content;
+}
+
+
+static std::string _SyntheticSource(int functions)
+{
+    std::string source = "const int N = 10;\nint g[4] = {1, 2, 3, 4};\n";
+
+    char buffer[1024];
+    for (int i = 0; i < functions; i++)
+    {
+        snprintf(buffer, sizeof(buffer),
+                 "int f%d(int a, int b[]) {\n"
+                 "    int x = a * %d + b[0] - (a / 3) %% 5, y = 0;\n"
+                 "    for (y = 0; y < N; y = y + 1) {\n"
+                 "        if (x > y && y != 3 || !x) { x = x + g[y %% 4] * N; } else x = x - 1;\n"
+                 "    }\n"
+                 "    printf(\"%%d %%d\\n\", x, y);\n"
+                 "    return x;\n"
+                 "}\n",
+                 i, i % 17);
+        source += buffer;
+    }
+
+    source += "int main() {\n    int s = 0;\n    s = getint();\n";
+    for (int i = 0; i < functions; i++)
+    {
+        snprintf(buffer, sizeof(buffer), "    s = s + f%d(%d, g);\n", i, i % 10);
+        source += buffer;
+    }
+    source += "    printf(\"%d\\n\", s);\n    return 0;\n}\n";
+
+    return source;
+}
+
+
+/*
+ * ================================ Mutations ================================
+ */
+
+static const char _ALPHABET[] = "{}()[];,=+-*/%<>!&|\"aint 019\n";
+
+
+static char _RandomChar(std::mt19937& random)
+{
+    return _ALPHABET[random() % (sizeof(_ALPHABET) - 1)];
+}
+
+
+static std::string _Substitute(const std::string& source, int permille, std::mt19937& random)
+{
+    std::string result = source;
+    size_t count = result.length() * permille / 1000;
+    for (size_t i = 0; i < count; i++)
+    {
+        result[random() % result.length()] = _RandomChar(random);
+    }
+    return result;
+}
+
+
+static std::string _Shift(const std::string& source, int permille, std::mt19937& random)
+{
+    std::string result = source;
+    size_t count = result.length() * permille / 1000;
+    for (size_t i = 0; i < count; i++)
+    {
+        result.erase(random() % result.length(), 1);
+        result.insert(result.begin() + random() % (result.length() + 1), _RandomChar(random));
+    }
+    return result;
+}
+
+
+// Each fragment is a random piece of the source, cut at both ends.
+static std::string _Splice(const std::string& source, int permille, std::mt19937& random)
+{
+    size_t pieces = std::max<size_t>(1, source.length() * permille / 1000);
+    size_t length = std::max<size_t>(1, source.length() / pieces);
+
+    std::string result;
+    while (result.length() < source.length())
+    {
+        size_t begin = random() % source.length();
+        size_t count = std::min({ length, source.length() - begin, source.length() - result.length() });
+        result.append(source, begin, count);
+    }
+    return result;
+}
+
+
+/*
+ * ================================ Benchmark ================================
+ */
+
+struct Result
+{
+    double seconds = 0.0;
+    int errors = 0;
+    bool parsed = false;
+};
+
+
+static Result _Parse(const std::string& content, int rounds)
+{
+    auto tokenMapper = std::make_shared<DefaultTokenMapper>();
+    auto syntaxMapper = std::make_shared<ReducedSyntaxMapper>();
+    auto logger = DumbLogger::New();
+
+    Result result;
+    for (int round = 0; round < rounds; round++)
+    {
+        auto errorLogger = std::make_shared<StandardErrorLogger>(std::make_shared<StandardErrorMapper>());
+        auto lexicalParser = std::make_shared<DefaultLexicalParser>(
+            std::make_shared<TableLexicalAnalyzer>(tokenMapper), errorLogger, logger);
+        ResilientSyntacticParser parser(lexicalParser, syntaxMapper, tokenMapper, errorLogger, logger);
+
+        auto begin = std::chrono::steady_clock::now();
+        parser.SetReader(twio::MemoryReader::New(twio::BufferInputStream::New(content.c_str(), content.length())));
+        bool parsed = parser.Parse() != nullptr;
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        if ((round == 0) || (seconds < result.seconds))
+        {
+            result.seconds = seconds;
+        }
+        result.errors = errorLogger->Count();
+        result.parsed = parsed;
+    }
+
+    return result;
+}
+
+
+static void _Print(const char* input, const std::string& content, const Result& result, double baseline)
+{
+    printf("    %-20s %10zu %10.3f %10.2f %8.2f %8d %8s\n",
+           input, content.length(), result.seconds * 1e3,
+           content.length() / result.seconds / (1024.0 * 1024.0),
+           result.seconds / baseline, result.errors, result.parsed ? "yes" : "no");
+}
+
+
+static void _Benchmark(const Source& source, int rounds, unsigned seed)
+{
+    using Mutation = std::string (*)(const std::string&, int, std::mt19937&);
+    const struct
+    {
+        const char* name;
+        Mutation mutate;
+    } mutations[] = {
+        { "substitute", _Substitute },
+        { "shift", _Shift },
+        { "splice", _Splice },
+    };
+
+    printf("%s:\n", source.name.c_str());
+    printf("    %-20s %10s %10s %10s %8s %8s %8s\n", "input", "bytes", "time (ms)", "MB/s", "ratio", "errors", "parsed");
+
+    Result valid = _Parse(source.content, rounds);
+    _Print("valid", source.content, valid, valid.seconds);
+
+    double worst = 0.0;
+    for (const auto& mutation : mutations)
+    {
+        for (int permille : { 1, 10, 100 })
+        {
+            std::mt19937 random(seed);
+            std::string content = mutation.mutate(source.content, permille, random);
+            Result result = _Parse(content, rounds);
+
+            char input[64];
+            snprintf(input, sizeof(input), "%s/%d%%o", mutation.name, permille);
+            _Print(input, content, result, valid.seconds);
+            worst = std::max(worst, result.seconds / valid.seconds);
+        }
+    }
+
+    printf("    worst ratio %.2f\n\n", worst);
+}
+
+
+int main(int argc, char* argv[])
+{
+    int rounds = 3;
+    unsigned seed = 1;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+        {
+            rounds = std::max(1, atoi(argv[++i]));
+        }
+        else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+        {
+            seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            files.emplace_back(argv[i]);
+        }
+    }
+
+    std::vector<Source> sources;
+    for (const auto& path : files)
+    {
+        auto stream = twio::MappedInputStream::New(path.c_str());
+        if (!stream->IsReady())
+        {
+            fprintf(stderr, "Cannot open %s\n", path.c_str());
+            continue;
+        }
+        sources.push_back({ std::filesystem::path(path).filename().string(), _Preprocess(stream) });
+    }
+    if (files.empty())
+    {
+        for (int functions : { 100, 2000 })
+        {
+            std::string content = _SyntheticSource(functions);
+            auto stream = twio::BufferInputStream::New(content.c_str(), content.length());
+            sources.push_back({ "synthetic-" + std::to_string(functions), _Preprocess(stream) });
+        }
+    }
+
+    for (const auto& source : sources)
+    {
+        _Benchmark(source, rounds, seed);
+    }
+
+    return 0;
+}
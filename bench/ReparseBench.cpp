@@ -0,0 +1,294 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+/*
+ * Benchmark of ResilientSyntacticParser::Reparse. Synthetic sources of
+ * growing size are parsed, then edited in the middle, and the time to
+ * reparse the edited source is compared with a full parse of it. Each
+ * reparsed tree is also checked against the full parse, node by node.
+ *
+ *   decl      change the first declaration
+ *   body      change a constant in a function body
+ *   insert    insert a new function definition
+ *   remove    remove a function definition
+ *   main      add a statement to the main function
+ *   comment   open a block comment, which is parsed in full
+ *
+ * Usage: ReparseBench [-r rounds]
+ * Time is the best of all rounds.
+ */
+
+#include <tomic/lexer/impl/DefaultLexicalParser.h>
+#include <tomic/lexer/impl/StreamingPreprocessor.h>
+#include <tomic/lexer/impl/TableLexicalAnalyzer.h>
+#include <tomic/lexer/impl/token/DefaultTokenMapper.h>
+#include <tomic/logger/debug/impl/DumbLogger.h>
+#include <tomic/logger/error/impl/StandardErrorLogger.h>
+#include <tomic/logger/error/impl/StandardErrorMapper.h>
+#include <tomic/parser/ast/mapper/ReducedSyntaxMapper.h>
+#include <tomic/parser/impl/ResilientSyntacticParser.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace tomic;
+
+static std::string _Function(int i)
+{
+    char buffer[1024];
+    snprintf(buffer, sizeof(buffer),
+             "int f%d(int a, int b[]) {\n"
+             "    int x = a * %d + b[0] - (a / 3) %% 5, y = 0; // keep\n"
+             "    for (y = 0; y < N; y = y + 1) {\n"
+             "        if (x > y && y != 3 || !x) { x = x + g[y %% 4] * N; } else x = x - 1;\n"
+             "    }\n"
+             "    printf(\"%%d %%d\\n\", x, y);\n"
+             "    return x;\n"
+             "}\n",
+             i, i % 17 + 1);
+    return buffer;
+}
+
+
+static std::string _SyntheticSource(int functions)
+{
+    std::string source = "const int N = 10;\nint g[4] = {1, 2, 3, 4};\n";
+    for (int i = 0; i < functions; i++)
+    {
+        source += _Function(i);
+    }
+
+    source += "int main() {\n    int s = 0;\n    s = getint();\n";
+    for (int i = 0; i < functions; i++)
+    {
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "    s = s + f%d(%d, g);\n", i, i % 10);
+        source += buffer;
+    }
+    source += "    printf(\"%d\\n\", s);\n    return 0;\n}\n";
+
+    return source;
+}
+
+
+/*
+ * ================================ Edits ================================
+ */
+
+struct Edit
+{
+    const char* name;
+    SourceEdit edit;
+    std::string content;    // after the edit
+};
+
+
+static Edit _MakeEdit(const char* name, const std::string& source, size_t offset, size_t length, const std::string& text)
+{
+    std::string content = source;
+    content.replace(offset, length, text);
+    return { name, { offset, length, text.length() }, content };
+}
+
+
+static std::vector<Edit> _Edits(const std::string& source, int functions)
+{
+    const std::string target = "int f" + std::to_string(functions / 2) + "(";
+    const size_t func = source.find(target);
+    const size_t next = source.find("int f", func + 1);
+
+    std::vector<Edit> edits;
+
+    edits.push_back(_MakeEdit("decl", source, source.find("10"), 2, "100"));
+
+    size_t constant = source.find("a * ", func) + 4;
+    size_t digits = source.find_first_not_of("0123456789", constant) - constant;
+    edits.push_back(_MakeEdit("body", source, constant, digits, "12345"));
+
+    edits.push_back(_MakeEdit("insert", source, func, 0, "int inserted() {\n    return 0;\n}\n"));
+    edits.push_back(_MakeEdit("remove", source, func, next - func, ""));
+    edits.push_back(_MakeEdit("main", source, source.find("return 0;"), 0, "s = s * 2;\n    "));
+    edits.push_back(_MakeEdit("comment", source, func, 0, "/* "));
+
+    return edits;
+}
+
+
+/*
+ * ================================ Parse ================================
+ */
+
+class Parser
+{
+public:
+    Parser()
+    {
+        auto tokenMapper = std::make_shared<DefaultTokenMapper>();
+        auto logger = DumbLogger::New();
+        _errorLogger = std::make_shared<StandardErrorLogger>(std::make_shared<StandardErrorMapper>());
+        auto lexicalParser = std::make_shared<DefaultLexicalParser>(
+            std::make_shared<TableLexicalAnalyzer>(tokenMapper), _errorLogger, logger);
+        _parser = std::make_unique<ResilientSyntacticParser>(
+            lexicalParser, std::make_shared<ReducedSyntaxMapper>(), tokenMapper, _errorLogger, logger);
+    }
+
+
+    static twio::MemoryReaderPtr Source(const std::string& content)
+    {
+        return twio::MemoryReader::New(twio::BufferInputStream::New(content.c_str(), content.length()));
+    }
+
+
+    SyntaxTreePtr Parse(const std::string& content)
+    {
+        _parser->SetReader(StreamingPreprocessor::New(Source(content)));
+        return _parser->Parse();
+    }
+
+
+    SyntaxTreePtr Reparse(SyntaxTreePtr tree, twio::MemoryReaderPtr source, const SourceEdit& edit)
+    {
+        return _parser->Reparse(tree, source, edit);
+    }
+
+
+    int Errors() const { return _errorLogger->Count(); }
+
+private:
+    IErrorLoggerPtr _errorLogger;
+    std::unique_ptr<ResilientSyntacticParser> _parser;
+};
+
+
+static bool _SameToken(TokenPtr lhs, TokenPtr rhs)
+{
+    if (!lhs || !rhs)
+    {
+        return !lhs && !rhs;
+    }
+    return (lhs->type == rhs->type) && (lhs.Position() == rhs.Position()) &&
+        (strcmp(lhs.Lexeme(), rhs.Lexeme()) == 0) &&
+        (lhs.LineNo() == rhs.LineNo()) && (lhs.CharNo() == rhs.CharNo());
+}
+
+
+static bool _SameTree(SyntaxNodePtr lhs, SyntaxNodePtr rhs)
+{
+    std::vector<std::pair<SyntaxNodePtr, SyntaxNodePtr>> stack{ { lhs, rhs } };
+    while (!stack.empty())
+    {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+        if (!a || !b)
+        {
+            if (a || b)
+            {
+                return false;
+            }
+            continue;
+        }
+        if ((a->Type() != b->Type()) || (a->IsTerminal() != b->IsTerminal()) ||
+            (a->IsTerminal() && !_SameToken(a->Token(), b->Token())))
+        {
+            return false;
+        }
+        if (a->Attributes() != b->Attributes())
+        {
+            return false;
+        }
+        stack.emplace_back(a->NextSibling(), b->NextSibling());
+        stack.emplace_back(a->FirstChild(), b->FirstChild());
+    }
+    return true;
+}
+
+
+template<typename Func>
+static double _Time(int rounds, Func&& func)
+{
+    double best = 0.0;
+    for (int round = 0; round < rounds; round++)
+    {
+        double seconds = func();
+        if ((round == 0) || (seconds < best))
+        {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+
+static void _Benchmark(int functions, int rounds)
+{
+    std::string source = _SyntheticSource(functions);
+
+    printf("synthetic-%d (%zu bytes):\n", functions, source.length());
+    printf("    %-10s %12s %12s %10s %8s\n", "edit", "full (ms)", "reparse (ms)", "speedup", "match");
+
+    for (const auto& edit : _Edits(source, functions))
+    {
+        double full = _Time(rounds, [&] {
+            Parser parser;
+            auto begin = std::chrono::steady_clock::now();
+            parser.Parse(edit.content);
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        });
+
+        bool match = true;
+        double reparse = _Time(rounds, [&] {
+            Parser parser;
+            auto tree = parser.Parse(source);
+            auto reader = Parser::Source(edit.content);
+
+            auto begin = std::chrono::steady_clock::now();
+            tree = parser.Reparse(tree, reader, edit.edit);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            auto expected = Parser().Parse(edit.content);
+            if (tree && expected)
+            {
+                match = match && _SameTree(tree->Root(), expected->Root());
+            }
+            else
+            {
+                match = match && !tree && !expected;
+            }
+
+            return seconds;
+        });
+
+        printf("    %-10s %12.3f %12.3f %10.1f %8s\n",
+               edit.name, full * 1e3, reparse * 1e3, full / reparse, match ? "yes" : "NO");
+    }
+    printf("\n");
+}
+
+
+int main(int argc, char* argv[])
+{
+    int rounds = 5;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+        {
+            rounds = std::max(1, atoi(argv[++i]));
+        }
+    }
+
+    for (int functions : { 100, 1000, 10000 })
+    {
+        _Benchmark(functions, rounds);
+    }
+
+    return 0;
+}
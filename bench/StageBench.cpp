@@ -0,0 +1,463 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+/*
+ * Benchmark of each compilation stage in isolation. For every input, the
+ * source is preprocessed once, then each stage is run on the output of the
+ * previous one, and only the stage itself is timed.
+ *
+ *   lex        ILexicalAnalyzer, Table and Default
+ *   syntactic  ISyntacticParser, Default and Resilient
+ *   semantic   DefaultSemanticAnalyzer
+ *   compact    CompactSyntaxTree conversion
+ *   visit      AstVisitor traversal, on SyntaxTree and CompactSyntaxTree
+ *   ast        XmlAstPrinter, on SyntaxTree and CompactSyntaxTree
+ *   ir         StandardAsmGenerator
+ *   print      IAsmPrinter, Standard and Verbose
+ *
+ * Usage: tomic_bench [-r rounds] [source files...]
+ * If no source file is given, the pre/tests corpus and two synthetic
+ * sources are used. Time is the best of all rounds.
+ */
+
+#include <tomic/lexer/impl/DefaultLexicalAnalyzer.h>
+#include <tomic/lexer/impl/DefaultLexicalParser.h>
+#include <tomic/lexer/impl/StreamingPreprocessor.h>
+#include <tomic/lexer/impl/TableLexicalAnalyzer.h>
+#include <tomic/lexer/impl/token/DefaultTokenMapper.h>
+#include <tomic/llvm/asm/impl/StandardAsmGenerator.h>
+#include <tomic/llvm/asm/impl/StandardAsmPrinter.h>
+#include <tomic/llvm/asm/impl/VerboseAsmPrinter.h>
+#include <tomic/llvm/ir/Module.h>
+#include <tomic/logger/debug/impl/DumbLogger.h>
+#include <tomic/logger/error/impl/StandardErrorLogger.h>
+#include <tomic/logger/error/impl/StandardErrorMapper.h>
+#include <tomic/parser/ast/CompactAstVisitor.h>
+#include <tomic/parser/ast/CompactSyntaxTree.h>
+#include <tomic/parser/ast/mapper/ReducedSyntaxMapper.h>
+#include <tomic/parser/ast/printer/XmlAstPrinter.h>
+#include <tomic/parser/ast/SyntaxTree.h>
+#include <tomic/parser/impl/DefaultSemanticAnalyzer.h>
+#include <tomic/parser/impl/DefaultSyntacticParser.h>
+#include <tomic/parser/impl/ResilientSyntacticParser.h>
+#include <tomic/utils/StringUtil.h>
+#include <tomic/utils/TimeReport.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace tomic;
+
+/*
+ * ================================ Sources ================================
+ */
+
+struct Source
+{
+    std::string name;
+    std::string content;    // preprocessed
+};
+
+
+static std::string _Preprocess(const twio::IInputStreamPtr& stream)
+{
+    auto reader = StreamingPreprocessor::New(twio::MemoryReader::New(stream));
+
+    std::string content;
+    char buffer[4096 + 1];
+    size_t count;
+    while ((count = reader->Read(buffer, sizeof(buffer) - 1)) > 0)
+    {
+        content.append(buffer, count);
+    }
+
+    return content;
+}
+
+
+// A valid program with the given number of functions. Arrays are not used,
+// since they are not supported by StandardAsmGenerator yet.
+static std::string _SyntheticSource(int functions)
+{
+    std::string source = "const int N = 10;\nint g = 3;\n";
+
+    char buffer[1024];
+    for (int i = 0; i < functions; i++)
+    {
+        snprintf(buffer, sizeof(buffer),
+                 "int f%d(int a, int b) {\n"
+                 "    int x = a * %d + b - (a / 3) %% 5, y = 0;\n"
+                 "    for (y = 0; y < N; y = y + 1) {\n"
+                 "        if (x > y && y != 3 || !x) { x = x + g * N; } else x = x - 1;\n"
+                 "    }\n"
+                 "    printf(\"%%d %%d\\n\", x, y);\n"
+                 "    return x;\n"
+                 "}\n",
+                 i, i % 17);
+        source += buffer;
+    }
+
+    source += "int main() {\n    int s = 0;\n    s = getint();\n";
+    for (int i = 0; i < functions; i++)
+    {
+        snprintf(buffer, sizeof(buffer), "    s = s + f%d(%d, s);\n", i, i % 10);
+        source += buffer;
+    }
+    source += "    printf(\"%d\\n\", s);\n    return 0;\n}\n";
+
+    return source;
+}
+
+
+static std::vector<Source> _LoadSources(const std::vector<std::string>& files)
+{
+    std::vector<Source> sources;
+
+    std::vector<std::string> paths = files;
+    if (paths.empty())
+    {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(TOMIC_BENCH_CORPUS))
+        {
+            const auto filename = entry.path().filename().string();
+            if (StringUtil::BeginsWith(filename.c_str(), "testfile") && StringUtil::EndsWith(filename.c_str(), ".c"))
+            {
+                paths.push_back(entry.path().string());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+    }
+
+    for (const auto& path : paths)
+    {
+        auto stream = twio::MappedInputStream::New(path.c_str());
+        if (!stream->IsReady())
+        {
+            fprintf(stderr, "Cannot open %s\n", path.c_str());
+            continue;
+        }
+        sources.push_back({ std::filesystem::path(path).filename().string(), _Preprocess(stream) });
+    }
+
+    if (files.empty())
+    {
+        for (int functions : { 100, 2000 })
+        {
+            std::string content = _SyntheticSource(functions);
+            auto stream = twio::BufferInputStream::New(content.c_str(), content.length());
+            sources.push_back({ "synthetic-" + std::to_string(functions), _Preprocess(stream) });
+        }
+    }
+
+    return sources;
+}
+
+
+/*
+ * ================================ Stages ================================
+ */
+
+class NodeCounter : public AstVisitor
+{
+public:
+    bool VisitEnter(SyntaxNodePtr node) override
+    {
+        count++;
+        return true;
+    }
+
+
+    bool Visit(SyntaxNodePtr node) override
+    {
+        count++;
+        return true;
+    }
+
+
+    size_t count = 0;
+};
+
+
+static size_t _CountNodes(const SyntaxTreePtr& tree)
+{
+    NodeCounter counter;
+    tree->Accept(&counter);
+    return counter.count;
+}
+
+
+class CompactNodeCounter : public CompactAstVisitor
+{
+public:
+    bool VisitEnter(CompactSyntaxNode node) override
+    {
+        count++;
+        return true;
+    }
+
+
+    bool Visit(CompactSyntaxNode node) override
+    {
+        count++;
+        return true;
+    }
+
+
+    size_t count = 0;
+};
+
+
+static size_t _CountNodes(const CompactSyntaxTreePtr& tree)
+{
+    CompactNodeCounter counter;
+    tree->Accept(&counter);
+    return counter.count;
+}
+
+
+struct StageResult
+{
+    const char* name;
+    double seconds;
+    size_t allocCount;
+    size_t allocBytes;
+    bool tokens;    // report tokens/sec
+    bool nodes;     // report nodes/sec
+};
+
+
+class StageTimer
+{
+public:
+    explicit StageTimer(std::vector<StageResult>* results) : _results(results)
+    {
+    }
+
+
+    void Run(const char* name, bool tokens, bool nodes, const std::function<void()>& stage)
+    {
+        const size_t count = TimeReport::AllocCount();
+        const size_t bytes = TimeReport::AllocBytes();
+        auto start = std::chrono::steady_clock::now();
+
+        stage();
+
+        auto end = std::chrono::steady_clock::now();
+        StageResult result = {
+            name,
+            std::chrono::duration<double>(end - start).count(),
+            TimeReport::AllocCount() - count,
+            TimeReport::AllocBytes() - bytes,
+            tokens,
+            nodes
+        };
+
+        for (auto& existing : *_results)
+        {
+            if (strcmp(existing.name, name) == 0)
+            {
+                if (result.seconds < existing.seconds)
+                {
+                    existing.seconds = result.seconds;
+                }
+                return;
+            }
+        }
+        _results->push_back(result);
+    }
+
+private:
+    std::vector<StageResult>* _results;
+};
+
+
+static twio::IAdvancedReaderPtr _NewReader(const Source& source)
+{
+    return twio::MemoryReader::New(twio::BufferInputStream::New(source.content.c_str(), source.content.length()));
+}
+
+
+// AST output is too large for BufferOutputStream, which grows linearly.
+static twio::IWriterPtr _NullWriter()
+{
+#ifdef _WIN32
+    FILE* fp = fopen("NUL", "w");
+#else
+    FILE* fp = fopen("/dev/null", "w");
+#endif
+    return twio::Writer::New(twio::FileOutputStream::New(fp));
+}
+
+
+static size_t _Lex(const ILexicalAnalyzerPtr& analyzer, const Source& source, bool* hasArray)
+{
+    analyzer->SetArena(TokenArena::New());
+    analyzer->SetReader(_NewReader(source));
+
+    size_t count = 0;
+    *hasArray = false;
+    for (TokenPtr token = analyzer->Next(); token->type != TokenType::TK_TERMINATOR; token = analyzer->Next())
+    {
+        if (token->type == TokenType::TK_LEFT_BRACKET)
+        {
+            *hasArray = true;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+
+static void _Benchmark(const Source& source, int rounds)
+{
+    auto tokenMapper = std::make_shared<DefaultTokenMapper>();
+    auto syntaxMapper = std::make_shared<ReducedSyntaxMapper>();
+    auto logger = DumbLogger::New();
+
+    std::vector<StageResult> results;
+    StageTimer timer(&results);
+
+    size_t tokens = 0;
+    size_t nodes = 0;
+    bool hasArray = false;
+    const char* skipped = nullptr;
+
+    for (int round = 0; round < rounds; round++)
+    {
+        timer.Run("lex/table", true, false, [&] {
+            tokens = _Lex(std::make_shared<TableLexicalAnalyzer>(tokenMapper), source, &hasArray);
+        });
+        timer.Run("lex/default", true, false, [&] {
+            _Lex(std::make_shared<DefaultLexicalAnalyzer>(tokenMapper), source, &hasArray);
+        });
+
+        auto errorLogger = std::make_shared<StandardErrorLogger>(std::make_shared<StandardErrorMapper>());
+        auto newLexicalParser = [&] {
+            return std::make_shared<DefaultLexicalParser>(
+                std::make_shared<TableLexicalAnalyzer>(tokenMapper), errorLogger, logger);
+        };
+
+        timer.Run("syntactic/default", true, true, [&] {
+            DefaultSyntacticParser parser(newLexicalParser(), syntaxMapper, tokenMapper, logger);
+            parser.SetReader(_NewReader(source));
+            parser.Parse();
+        });
+
+        SyntaxTreePtr tree;
+        timer.Run("syntactic/resilient", true, true, [&] {
+            ResilientSyntacticParser parser(newLexicalParser(), syntaxMapper, tokenMapper, errorLogger, logger);
+            parser.SetReader(_NewReader(source));
+            tree = parser.Parse();
+        });
+        if (!tree)
+        {
+            skipped = "syntactic parse failed";
+            break;
+        }
+        nodes = _CountNodes(tree);
+
+        SymbolTablePtr table;
+        timer.Run("semantic", false, true, [&] {
+            table = DefaultSemanticAnalyzer(errorLogger, logger).Analyze(tree);
+        });
+        if (!table || (errorLogger->Count() > 0))
+        {
+            skipped = "source has errors";
+            break;
+        }
+
+        CompactSyntaxTreePtr compact;
+        timer.Run("compact", false, true, [&] {
+            compact = CompactSyntaxTree::New(tree);
+        });
+        timer.Run("visit", false, true, [&] {
+            _CountNodes(tree);
+        });
+        timer.Run("visit-compact", false, true, [&] {
+            _CountNodes(compact);
+        });
+        timer.Run("ast/xml", false, true, [&] {
+            XmlAstPrinter(syntaxMapper, tokenMapper).Print(tree, _NullWriter());
+        });
+        timer.Run("ast/xml-compact", false, true, [&] {
+            XmlAstPrinter(syntaxMapper, tokenMapper).Print(compact, _NullWriter());
+        });
+        if (hasArray)
+        {
+            skipped = "arrays are not supported by IR generation yet";
+            break;
+        }
+
+        llvm::ModuleSmartPtr module;
+        timer.Run("ir", false, true, [&] {
+            module = llvm::StandardAsmGenerator().Generate(tree, table, source.name.c_str());
+        });
+
+        timer.Run("print/standard", false, true, [&] {
+            llvm::StandardAsmPrinter().Print(module.get(), twio::Writer::New(twio::BufferOutputStream::New()));
+        });
+        timer.Run("print/verbose", false, true, [&] {
+            llvm::VerboseAsmPrinter().Print(module.get(), twio::Writer::New(twio::BufferOutputStream::New()));
+        });
+    }
+
+    printf("%s: %zu bytes, %zu tokens, %zu nodes\n",
+           source.name.c_str(), source.content.length(), tokens, nodes);
+    if (skipped)
+    {
+        printf("    (%s, later stages skipped)\n", skipped);
+    }
+    printf("    %-20s %10s %12s %12s %10s %10s\n", "stage", "time (ms)", "Mtokens/s", "Mnodes/s", "allocs", "KB");
+    for (const auto& result : results)
+    {
+        char tokenRate[32] = "-";
+        char nodeRate[32] = "-";
+        if (result.tokens && (result.seconds > 0))
+        {
+            snprintf(tokenRate, sizeof(tokenRate), "%.2f", tokens / result.seconds / 1e6);
+        }
+        if (result.nodes && (result.seconds > 0))
+        {
+            snprintf(nodeRate, sizeof(nodeRate), "%.2f", nodes / result.seconds / 1e6);
+        }
+        printf("    %-20s %10.3f %12s %12s %10zu %10zu\n",
+               result.name, result.seconds * 1e3, tokenRate, nodeRate,
+               result.allocCount, result.allocBytes / 1024);
+    }
+    printf("\n");
+}
+
+
+int main(int argc, char* argv[])
+{
+    int rounds = 3;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+        {
+            rounds = std::max(1, atoi(argv[++i]));
+        }
+        else
+        {
+            files.emplace_back(argv[i]);
+        }
+    }
+
+    for (const auto& source : _LoadSources(files))
+    {
+        _Benchmark(source, rounds);
+    }
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+/*
+ * Benchmark of symbol lookup. Globals of growing count are added to the
+ * root block, and a chain of nested blocks is opened below it, each with
+ * a few locals. Names are then looked up from the innermost block: globals,
+ * locals of the outer blocks, and names that are not defined at all.
+ *
+ * Usage: SymbolTableBench [-n lookups] [-r rounds]
+ * Time is the best of all rounds.
+ */
+
+#include <tomic/parser/table/SymbolTable.h>
+#include <tomic/parser/table/SymbolTableBlock.h>
+#include <tomic/parser/table/SymbolTableEntry.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace tomic;
+
+static SymbolTableEntryPtr _Variable(const std::string& name)
+{
+    return VariableEntryBuilder(name).Type(SymbolValueType::VT_INT)->Build();
+}
+
+
+static void _Benchmark(int globals, int depth, int lookups, int rounds)
+{
+    auto table = SymbolTable::New();
+    auto block = table->NewRoot();
+    for (int i = 0; i < globals; i++)
+    {
+        block->AddEntry(_Variable("g" + std::to_string(i)));
+    }
+    for (int level = 0; level < depth; level++)
+    {
+        block = block->NewChild();
+        for (int i = 0; i < 4; i++)
+        {
+            block->AddEntry(_Variable("l" + std::to_string(level) + "_" + std::to_string(i)));
+        }
+    }
+
+    // One in eight names is not defined.
+    std::vector<std::string> names;
+    for (int i = 0; i < 1024; i++)
+    {
+        switch (i % 8)
+        {
+        case 0:
+            names.push_back("u" + std::to_string(i));
+            break;
+        case 1:
+            names.push_back("l" + std::to_string(i % depth) + "_" + std::to_string(i % 4));
+            break;
+        default:
+            names.push_back("g" + std::to_string(i * 7919 % globals));
+            break;
+        }
+    }
+
+    double best = 0.0;
+    int found = 0;
+    for (int round = 0; round < rounds; round++)
+    {
+        found = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < lookups; i++)
+        {
+            if (block->FindEntry(names[i % names.size()]))
+            {
+                found++;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if ((round == 0) || (seconds < best))
+        {
+            best = seconds;
+        }
+    }
+
+    printf("    %-8d %-6d %12.1f %10d\n", globals, depth, best * 1e9 / lookups, found);
+}
+
+
+int main(int argc, char* argv[])
+{
+    int lookups = 1000000;
+    int rounds = 3;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+        {
+            lookups = std::max(1, atoi(argv[++i]));
+        }
+        else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+        {
+            rounds = std::max(1, atoi(argv[++i]));
+        }
+    }
+
+    printf("    %-8s %-6s %12s %10s\n", "globals", "depth", "ns/lookup", "found");
+    for (int globals : { 10, 100, 1000, 10000 })
+    {
+        for (int depth : { 1, 8, 32 })
+        {
+            _Benchmark(globals, depth, lookups, rounds);
+        }
+    }
+
+    return 0;
+}
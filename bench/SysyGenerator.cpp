@@ -0,0 +1,692 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+/*
+ * Generator of valid SysY programs for scaling tests. The programs pass
+ * semantic analysis, so they can drive every stage of the compiler.
+ *
+ * Usage: SysyGenerator [options] [-o output]
+ *   --functions=n     number of functions besides main (10)
+ *   --depth=n         max nesting depth of blocks (3)
+ *   --statements=n    statements in each block (6)
+ *   --exp-length=n    operands in each expression (6)
+ *   --array-size=n    size of each array dimension, 0 for no array (8)
+ *   --printf=n        printf calls in each function (2)
+ *   --getint=n        getint calls in each function (1)
+ *   --seed=n          seed of the random generator (1)
+ *
+ * All array dimensions have the same size, and initializers are complete,
+ * so the initializer size follows the array size. StandardAsmGenerator
+ * does not support arrays yet, so use --array-size=0 to reach IR.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Options
+{
+    int functions = 10;
+    int depth = 3;
+    int statements = 6;
+    int expLength = 6;
+    int arraySize = 8;
+    int printfs = 2;
+    int getints = 1;
+    unsigned seed = 1;
+    const char* output = nullptr;
+};
+
+
+class SysyGenerator
+{
+public:
+    explicit SysyGenerator(const Options& options) : _options(options), _random(options.seed), _indent(0)
+    {
+    }
+
+
+    std::string Generate();
+
+private:
+    struct Variable
+    {
+        std::string name;
+        int dim;        // 0 for scalar
+        bool constant;
+        bool counter;   // loop counter, not written in the loop
+    };
+
+
+    struct Function
+    {
+        std::string name;
+        bool returnInt;
+        std::vector<int> params;    // dimension of each parameter
+    };
+
+
+    int _Random(int n) { return static_cast<int>(_random() % n); }
+    bool _Chance(int percent) { return _Random(100) < percent; }
+
+    void _Line(const std::string& line);
+    std::string _NewName(const char* prefix);
+
+    const Variable* _Pick(int dim, bool writable);
+
+    void _GlobalDecls();
+    void _FunctionDef(int index);
+    void _MainFunction();
+
+    void _LocalDecls(int count);
+    void _ScalarDecl(bool constant);
+    void _ArrayDecl(int dim, bool constant);
+    std::string _Initializer(int dim, bool constant);
+
+    void _Block(int depth, bool inLoop);
+    void _Statement(int depth, bool inLoop);
+    void _Printf();
+    void _Getint();
+
+    std::string _Exp(int length, bool constant = false);
+    std::string _Operand(bool constant);
+    std::string _Call(const Function& function);
+    std::string _Cond();
+
+    Options _options;
+    std::mt19937 _random;
+
+    std::string _source;
+    int _indent;
+    int _nameCount = 0;
+
+    std::vector<Function> _functions;
+
+    // Visible variables, the last ones are in the innermost scope.
+    std::vector<Variable> _variables;
+
+    // Calls left in the current function.
+    int _printfLeft = 0;
+    int _getintLeft = 0;
+};
+
+
+std::string SysyGenerator::Generate()
+{
+    _source = "// Generated by SysyGenerator.\n\n";
+
+    _GlobalDecls();
+    for (int i = 0; i < _options.functions; i++)
+    {
+        _FunctionDef(i);
+    }
+    _MainFunction();
+
+    return _source;
+}
+
+
+void SysyGenerator::_Line(const std::string& line)
+{
+    _source.append(_indent * 4, ' ');
+    _source += line;
+    _source += '\n';
+}
+
+
+std::string SysyGenerator::_NewName(const char* prefix)
+{
+    return prefix + std::to_string(_nameCount++);
+}
+
+
+// Pick a random visible variable, nullptr if there is none.
+const SysyGenerator::Variable* SysyGenerator::_Pick(int dim, bool writable)
+{
+    std::vector<const Variable*> candidates;
+    for (const auto& variable : _variables)
+    {
+        if ((variable.dim == dim) && !(writable && (variable.constant || variable.counter)))
+        {
+            candidates.push_back(&variable);
+        }
+    }
+    if (candidates.empty())
+    {
+        return nullptr;
+    }
+
+    // Prefer inner scopes, where most variables are.
+    return candidates[candidates.size() - 1 - _Random(std::min<int>(candidates.size(), 8))];
+}
+
+
+/*
+ * ================================ Declarations ================================
+ */
+
+void SysyGenerator::_GlobalDecls()
+{
+    _ScalarDecl(true);
+    _ScalarDecl(false);
+    if (_options.arraySize > 0)
+    {
+        // So that array parameters always have arguments.
+        _ArrayDecl(1, true);
+        _ArrayDecl(1, false);
+        _ArrayDecl(2, false);
+    }
+    _Line("");
+}
+
+
+void SysyGenerator::_LocalDecls(int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const int kind = _Random(10);
+        if ((_options.arraySize > 0) && (kind == 0))
+        {
+            _ArrayDecl(1 + _Random(2), _Chance(30));
+        }
+        else
+        {
+            _ScalarDecl(kind < 3);
+        }
+    }
+}
+
+
+void SysyGenerator::_ScalarDecl(bool constant)
+{
+    // Global initializers must be constant, too.
+    const bool constInit = constant || (_indent == 0);
+    Variable variable = { _NewName(constant ? "c" : "v"), 0, constant };
+    _Line(std::string(constant ? "const int " : "int ") + variable.name + " = " + _Exp(_options.expLength, constInit) + ";");
+    _variables.push_back(variable);
+}
+
+
+void SysyGenerator::_ArrayDecl(int dim, bool constant)
+{
+    Variable variable = { _NewName(constant ? "ca" : "a"), dim, constant };
+    std::string line = constant ? "const int " : "int ";
+    line += variable.name;
+    for (int i = 0; i < dim; i++)
+    {
+        line += "[" + std::to_string(_options.arraySize) + "]";
+    }
+    line += " = " + _Initializer(dim, constant || (_indent == 0)) + ";";
+    _Line(line);
+    _variables.push_back(variable);
+}
+
+
+std::string SysyGenerator::_Initializer(int dim, bool constant)
+{
+    if (dim == 0)
+    {
+        // Keep elements short, or initializers dominate the source.
+        return _Exp(std::max(1, _options.expLength / 3), constant);
+    }
+
+    std::string init = "{";
+    for (int i = 0; i < _options.arraySize; i++)
+    {
+        if (i > 0)
+        {
+            init += ", ";
+        }
+        init += _Initializer(dim - 1, constant);
+    }
+    init += "}";
+
+    return init;
+}
+
+
+/*
+ * ================================ Functions ================================
+ */
+
+void SysyGenerator::_FunctionDef(int index)
+{
+    Function function = { "func" + std::to_string(index), _Chance(70), {} };
+
+    const size_t scope = _variables.size();
+    std::string params;
+    const int count = _Random(4);
+    for (int i = 0; i < count; i++)
+    {
+        const int dim = (_options.arraySize > 0) ? _Random(3) : 0;
+        Variable param = { _NewName("p"), dim, false };
+        if (i > 0)
+        {
+            params += ", ";
+        }
+        params += "int " + param.name;
+        if (dim > 0)
+        {
+            params += "[]";
+        }
+        if (dim > 1)
+        {
+            params += "[" + std::to_string(_options.arraySize) + "]";
+        }
+        function.params.push_back(dim);
+        _variables.push_back(param);
+    }
+
+    _Line(std::string(function.returnInt ? "int " : "void ") + function.name + "(" + params + ")");
+    _Line("{");
+    _indent++;
+
+    _printfLeft = _options.printfs;
+    _getintLeft = _options.getints;
+    _LocalDecls(2 + _Random(3));
+    for (int i = 0; i < _options.statements; i++)
+    {
+        _Statement(_options.depth, false);
+    }
+    while (_printfLeft > 0)
+    {
+        _Printf();
+    }
+    while (_getintLeft > 0)
+    {
+        _Getint();
+    }
+    // Int function must end with a return statement.
+    _Line(function.returnInt ? "return " + _Exp(_options.expLength) + ";" : "return;");
+
+    _indent--;
+    _Line("}");
+    _Line("");
+
+    _variables.resize(scope);
+    _functions.push_back(function);
+}
+
+
+void SysyGenerator::_MainFunction()
+{
+    _Line("int main()");
+    _Line("{");
+    _indent++;
+
+    const size_t scope = _variables.size();
+    _printfLeft = _options.printfs;
+    _getintLeft = _options.getints;
+    _LocalDecls(2);
+    for (const auto& function : _functions)
+    {
+        if (function.returnInt)
+        {
+            const Variable* target = _Pick(0, true);
+            _Line(target->name + " = " + _Call(function) + ";");
+        }
+        else
+        {
+            _Line(_Call(function) + ";");
+        }
+    }
+    for (int i = 0; i < _options.statements; i++)
+    {
+        _Statement(_options.depth, false);
+    }
+    while (_printfLeft > 0)
+    {
+        _Printf();
+    }
+    while (_getintLeft > 0)
+    {
+        _Getint();
+    }
+    _Line("return 0;");
+
+    _indent--;
+    _Line("}");
+
+    _variables.resize(scope);
+}
+
+
+/*
+ * ================================ Statements ================================
+ */
+
+void SysyGenerator::_Block(int depth, bool inLoop)
+{
+    _Line("{");
+    _indent++;
+
+    // Loop counters are not writable, so there is always one left.
+    const size_t scope = _variables.size();
+    _ScalarDecl(false);
+    _LocalDecls(_Random(3));
+    const int count = std::max(1, _options.statements / 2);
+    for (int i = 0; i < count; i++)
+    {
+        _Statement(depth, inLoop);
+    }
+    _variables.resize(scope);
+
+    _indent--;
+    _Line("}");
+}
+
+
+void SysyGenerator::_Statement(int depth, bool inLoop)
+{
+    const int kind = (depth > 0) ? _Random(10) : _Random(5);
+    switch (kind)
+    {
+    case 0:
+        if (_printfLeft > 0)
+        {
+            _Printf();
+            break;
+        }
+        // fall through
+    case 1:
+        if (_getintLeft > 0)
+        {
+            _Getint();
+            break;
+        }
+        // fall through
+    case 2:
+    {
+        const Variable* array = _Pick(1, true);
+        if (array && _Chance(50))
+        {
+            _Line(array->name + "[" + std::to_string(_Random(_options.arraySize)) + "] = " + _Exp(_options.expLength) + ";");
+            break;
+        }
+    }
+        // fall through
+    case 3:
+        _Line(_Pick(0, true)->name + " = " + _Exp(_options.expLength) + ";");
+        break;
+    case 4:
+        if (inLoop)
+        {
+            _Line("if (" + _Cond() + ") " + (_Chance(50) ? "break;" : "continue;"));
+        }
+        else if (!_functions.empty() && _Chance(50))
+        {
+            _Line(_Call(_functions[_Random(_functions.size())]) + ";");
+        }
+        else
+        {
+            _Line(_Exp(_options.expLength) + ";");
+        }
+        break;
+    case 5:
+    case 6:
+        _Line("if (" + _Cond() + ")");
+        _Block(depth - 1, inLoop);
+        if (_Chance(50))
+        {
+            _Line("else");
+            _Block(depth - 1, inLoop);
+        }
+        break;
+    case 7:
+    case 8:
+    {
+        // Variables may be added in the block, so keep the index.
+        const size_t index = _Pick(0, true) - _variables.data();
+        const std::string var = _variables[index].name;
+        _Line("for (" + var + " = 0; " + var + " < " + std::to_string(1 + _Random(10)) + "; " + var + " = " + var + " + 1)");
+        _variables[index].counter = true;
+        _Block(depth - 1, true);
+        _variables[index].counter = false;
+        break;
+    }
+    default:
+        _Block(depth - 1, inLoop);
+        break;
+    }
+}
+
+
+void SysyGenerator::_Printf()
+{
+    std::string format = "\"";
+    std::string args;
+    const int count = _Random(4);
+    for (int i = 0; i < count; i++)
+    {
+        format += "v" + std::to_string(i) + " = %d ";
+        args += ", " + _Exp(_options.expLength);
+    }
+    format += "\\n\"";
+    _Line("printf(" + format + args + ");");
+    _printfLeft--;
+}
+
+
+void SysyGenerator::_Getint()
+{
+    _Line(_Pick(0, true)->name + " = getint();");
+    _getintLeft--;
+}
+
+
+/*
+ * ================================ Expressions ================================
+ */
+
+std::string SysyGenerator::_Exp(int length, bool constant)
+{
+    static const char* const OPS[] = { " + ", " - ", " * ", " / ", " % " };
+
+    std::string exp = _Operand(constant);
+    for (int i = 1; i < length; i++)
+    {
+        const char* op = OPS[_Random(5)];
+        if ((op[1] == '/') || (op[1] == '%'))
+        {
+            // Avoid division by zero.
+            exp += op + std::to_string(1 + _Random(9));
+        }
+        else if ((i + 2 < length) && _Chance(20))
+        {
+            // A parenthesized sub-expression.
+            const int sub = 2 + _Random(length - i - 1);
+            exp += op + ("(" + _Exp(sub, constant) + ")");
+            i += sub - 1;
+        }
+        else
+        {
+            exp += op + _Operand(constant);
+        }
+    }
+
+    return exp;
+}
+
+
+std::string SysyGenerator::_Operand(bool constant)
+{
+    const int kind = _Random(10);
+    if (kind < 3)
+    {
+        return std::to_string(_Random(100));
+    }
+    if (kind == 3)
+    {
+        return "-" + std::to_string(_Random(100));
+    }
+
+    if (!constant && (kind == 4) && (_options.arraySize > 0))
+    {
+        const int dim = 1 + _Random(2);
+        const Variable* array = _Pick(dim, false);
+        if (array)
+        {
+            std::string element = array->name;
+            for (int i = 0; i < dim; i++)
+            {
+                element += "[" + std::to_string(_Random(_options.arraySize)) + "]";
+            }
+            return element;
+        }
+    }
+
+    if (!constant && (kind == 5) && !_functions.empty())
+    {
+        const Function& function = _functions[_Random(_functions.size())];
+        if (function.returnInt)
+        {
+            return _Call(function);
+        }
+    }
+
+    // Constant expressions can only refer to constants.
+    std::vector<const Variable*> candidates;
+    for (const auto& variable : _variables)
+    {
+        if ((variable.dim == 0) && (!constant || variable.constant))
+        {
+            candidates.push_back(&variable);
+        }
+    }
+    if (candidates.empty())
+    {
+        return std::to_string(_Random(100));
+    }
+
+    return candidates[candidates.size() - 1 - _Random(std::min<int>(candidates.size(), 8))]->name;
+}
+
+
+// Arguments are short to keep calls from nesting too deep.
+std::string SysyGenerator::_Call(const Function& function)
+{
+    std::string call = function.name + "(";
+    for (size_t i = 0; i < function.params.size(); i++)
+    {
+        if (i > 0)
+        {
+            call += ", ";
+        }
+        const int dim = function.params[i];
+        if (dim == 0)
+        {
+            // The semantic analyzer takes an array argument after a const
+            // one as const, so no constants here.
+            const Variable* variable = _Pick(0, true);
+            call += (variable && _Chance(50)) ? variable->name : std::to_string(_Random(100));
+        }
+        else if ((dim == 1) && _Chance(30) && _Pick(2, true))
+        {
+            // A row of a 2D array.
+            call += _Pick(2, true)->name + "[" + std::to_string(_Random(_options.arraySize)) + "]";
+        }
+        else
+        {
+            // Constant arrays cannot be passed.
+            call += _Pick(dim, true)->name;
+        }
+    }
+    call += ")";
+
+    return call;
+}
+
+
+std::string SysyGenerator::_Cond()
+{
+    static const char* const REL_OPS[] = { " < ", " > ", " <= ", " >= ", " == ", " != " };
+
+    std::string cond;
+    const int count = 1 + _Random(3);
+    for (int i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            cond += _Chance(50) ? " && " : " || ";
+        }
+        const int length = std::max(1, _options.expLength / 2);
+        if (_Chance(20))
+        {
+            cond += "!" + _Operand(false);
+        }
+        else
+        {
+            cond += _Exp(length) + REL_OPS[_Random(6)] + _Exp(length);
+        }
+    }
+
+    return cond;
+}
+
+
+/*
+ * ================================ Main ================================
+ */
+
+static bool _ParseInt(const char* arg, const char* name, int* value)
+{
+    const size_t length = strlen(name);
+    if ((strncmp(arg, name, length) != 0) || (arg[length] != '='))
+    {
+        return false;
+    }
+    *value = std::max(0, atoi(arg + length + 1));
+    return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    int seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        if ((strcmp(arg, "-o") == 0) && (i + 1 < argc))
+        {
+            options.output = argv[++i];
+        }
+        else if (!(_ParseInt(arg, "--functions", &options.functions)
+                   || _ParseInt(arg, "--depth", &options.depth)
+                   || _ParseInt(arg, "--statements", &options.statements)
+                   || _ParseInt(arg, "--exp-length", &options.expLength)
+                   || _ParseInt(arg, "--array-size", &options.arraySize)
+                   || _ParseInt(arg, "--printf", &options.printfs)
+                   || _ParseInt(arg, "--getint", &options.getints)
+                   || _ParseInt(arg, "--seed", &seed)))
+        {
+            fprintf(stderr, "Unknown parameter \"%s\"\n", arg);
+            return 1;
+        }
+    }
+    options.expLength = std::max(1, options.expLength);
+    options.seed = static_cast<unsigned>(seed);
+
+    const std::string source = SysyGenerator(options).Generate();
+
+    FILE* fp = options.output ? fopen(options.output, "w") : stdout;
+    if (!fp)
+    {
+        fprintf(stderr, "Cannot open %s\n", options.output);
+        return 1;
+    }
+    fwrite(source.data(), 1, source.length(), fp);
+    if (options.output)
+    {
+        fclose(fp);
+    }
+
+    return 0;
+}
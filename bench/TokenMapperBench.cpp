@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+/*
+ * Micro benchmark of keyword lookup on identifier-heavy source.
+ * All words in the source are looked up by DefaultTokenMapper, and by a
+ * std::unordered_map with a std::string built for each word, which is what
+ * the lexer did before.
+ *
+ * Usage: TokenMapperBench [source file] [rounds]
+ * If no source file is given, a synthetic one is used.
+ */
+
+#include <tomic/lexer/impl/token/DefaultTokenMapper.h>
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace tomic;
+
+static std::string _LoadSource(const char* path)
+{
+    std::string source;
+
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        exit(1);
+    }
+
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+    {
+        source.append(buffer, count);
+    }
+    fclose(fp);
+
+    return source;
+}
+
+
+static std::string _SyntheticSource()
+{
+    static const char* const STATEMENTS[] = {
+        "int counter_%d = value_%d + offset_%d * scale;\n",
+        "if (index_%d < limit_%d) { total = total + item_%d; }\n",
+        "for (i_%d = 0; i_%d < length; i_%d = i_%d + 1) continue;\n",
+        "const int size_%d = 10; void helper_%d(int a, int b) { return; }\n",
+        "result_%d = getint(); printf(\"%%d\", result_%d); break;\n",
+    };
+
+    std::string source;
+    char line[256];
+    for (int i = 0; i < 200000; i++)
+    {
+        snprintf(line, sizeof(line), STATEMENTS[i % 5], i, i, i, i);
+        source += line;
+    }
+
+    return source;
+}
+
+
+static bool _IsWordBegin(char ch)
+{
+    return isalpha(static_cast<unsigned char>(ch)) || (ch == '_');
+}
+
+
+static bool _IsWord(char ch)
+{
+    return isalnum(static_cast<unsigned char>(ch)) || (ch == '_');
+}
+
+
+// Split the source into words, just like identifiers in the lexer.
+static std::vector<std::string_view> _SplitWords(const std::string& source)
+{
+    std::vector<std::string_view> words;
+
+    size_t i = 0;
+    while (i < source.length())
+    {
+        if (!_IsWordBegin(source[i]))
+        {
+            i++;
+            continue;
+        }
+        size_t begin = i;
+        while ((i < source.length()) && _IsWord(source[i]))
+        {
+            i++;
+        }
+        words.emplace_back(source.data() + begin, i - begin);
+    }
+
+    return words;
+}
+
+
+template<typename TFunc>
+static double _Measure(const std::vector<std::string_view>& words, int rounds, TFunc func, int* keywords)
+{
+    int count = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+        for (auto word : words)
+        {
+            if (func(word) != TokenType::TK_UNKNOWN)
+            {
+                count++;
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    *keywords = count / rounds;
+    return std::chrono::duration<double>(end - start).count();
+}
+
+
+int main(int argc, char* argv[])
+{
+    std::string source = (argc > 1) ? _LoadSource(argv[1]) : _SyntheticSource();
+    int rounds = (argc > 2) ? atoi(argv[2]) : 10;
+    if (rounds <= 0)
+    {
+        rounds = 1;
+    }
+
+    auto words = _SplitWords(source);
+    printf("%zu bytes, %zu words, %d rounds\n", source.length(), words.size(), rounds);
+
+    DefaultTokenMapper mapper;
+
+    std::unordered_map<std::string, TokenType> table;
+    for (auto word : { "main", "return", "getint", "printf", "if", "else",
+                       "for", "break", "continue", "const", "int", "void" })
+    {
+        table[word] = mapper.Type(word);
+    }
+
+    int keywords;
+    double seconds = _Measure(words, rounds, [&table](std::string_view word) {
+        auto iter = table.find(std::string(word));
+        return (iter == table.end()) ? TokenType::TK_UNKNOWN : iter->second;
+    }, &keywords);
+    printf("%-16s %8.3f ms  %8.2f ns/word  %d keywords\n",
+           "unordered_map", seconds * 1e3, seconds * 1e9 / (words.size() * rounds), keywords);
+
+    seconds = _Measure(words, rounds, [&mapper](std::string_view word) {
+        return mapper.Type(word);
+    }, &keywords);
+    printf("%-16s %8.3f ms  %8.2f ns/word  %d keywords\n",
+           "perfect hash", seconds * 1e3, seconds * 1e9 / (words.size() * rounds), keywords);
+
+    return 0;
+}
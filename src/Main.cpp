@@ -22,6 +22,11 @@ static bool HandleLongOpt(const char* opt, const char* arg, ConfigPtr config);
  *           --enable-error[=filename] --verbose-error
  *           --emit-ast[=filename] --complete-ast
  *           --emit-llvm[=filename] --verbose-llvm
+ *           --lex-threads=n
+ *           --max-depth=n
+ *           --parse-threads=n
+ *           --time-report[=filename]
+ *           --trace[=filename]
  *
  *   --help, -h:           show help
  *   --target, -t:         specify the target type
@@ -32,6 +37,11 @@ static bool HandleLongOpt(const char* opt, const char* arg, ConfigPtr config);
  *   --complete-ast, -c:   complete ast
  *   --emit-llvm, -i:      emit llvm ir
  *   --verbose-llvm:       verbose llvm ir (-v occupied by verbose error)
+ *   --lex-threads:        lex large source with n threads
+ *   --max-depth:          max nesting depth of statements and expressions
+ *   --parse-threads:      parse function definitions with n threads
+ *   --time-report:        time of each phase, table on stderr or JSON to file
+ *   --trace:              Chrome trace events of compiler internals
  */
 int main(int argc, char* argv[])
 {
@@ -73,6 +83,11 @@ Usage: ToMiCompiler <input> [-o output]
           --enable-error[=filename] --verbose-error
           --emit-ast[=filename] --complete-ast
           --emit-llvm[=filename]
+          --lex-threads=n
+          --max-depth=n
+          --parse-threads=n
+          --time-report[=filename]
+          --trace[=filename]
 
   --target, -t:         specify the target type
   --enable-logger, -l:  enable logger
@@ -81,6 +96,11 @@ Usage: ToMiCompiler <input> [-o output]
   --emit-ast, -a:       emit ast
   --complete-ast, -c:   complete ast
   --emit-llvm, -i:      emit llvm ir
+  --lex-threads:        lex large source with n threads
+  --max-depth:          max nesting depth of statements and expressions
+  --parse-threads:      parse function definitions with n threads
+  --time-report:        time of each phase, table on stderr or JSON to file
+  --trace:              Chrome trace events of compiler internals
   --help, -h:           show help
     )";
     printf("%s\n", HELP);
@@ -233,6 +253,49 @@ static bool HandleLongOpt(const char* opt, const char* arg, ConfigPtr config)
     {
         config->EnableVerboseLlvm = true;
     }
+    else if (Equals(opt, "lex-threads"))
+    {
+        int threads;
+        if (!ToInt(arg, &threads) || (threads < 1))
+        {
+            fprintf(stderr, "Invalid thread count \"%s\"\n", IsNullOrEmpty(arg) ? "" : arg);
+            return false;
+        }
+        config->LexThreads = threads;
+    }
+    else if (Equals(opt, "max-depth"))
+    {
+        int depth;
+        if (!ToInt(arg, &depth) || (depth < 1))
+        {
+            fprintf(stderr, "Invalid max depth \"%s\"\n", IsNullOrEmpty(arg) ? "" : arg);
+            return false;
+        }
+        config->MaxDepth = depth;
+    }
+    else if (Equals(opt, "parse-threads"))
+    {
+        int threads;
+        if (!ToInt(arg, &threads) || (threads < 1))
+        {
+            fprintf(stderr, "Invalid thread count \"%s\"\n", IsNullOrEmpty(arg) ? "" : arg);
+            return false;
+        }
+        config->ParseThreads = threads;
+    }
+    else if (Equals(opt, "time-report"))
+    {
+        config->EnableTimeReport = true;
+        config->TimeReportOutput = IsNullOrEmpty(arg) ? "stderr" : arg;
+    }
+    else if (Equals(opt, "trace"))
+    {
+#ifndef TOMIC_ENABLE_TRACE
+        fprintf(stderr, "Trace is not built in, rebuild with TOMIC_ENABLE_TRACE=ON\n");
+#endif
+        config->EnableTrace = true;
+        config->TraceOutput = IsNullOrEmpty(arg) ? "trace.json" : arg;
+    }
     else if (Equals(opt, "help"))
     {
         showHelp = true;
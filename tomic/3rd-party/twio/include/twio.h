@@ -6,12 +6,15 @@
 #include <twio/core/Reader.h>
 #include <twio/core/Writer.h>
 #include <twio/core/AdvancedReader.h>
+#include <twio/core/MemoryReader.h>
+#include <twio/core/LineIndex.h>
 
 #include <twio/stream/IStream.h>
 #include <twio/stream/BufferInputStream.h>
 #include <twio/stream/BufferOutputStream.h>
 #include <twio/stream/FileInputStream.h>
 #include <twio/stream/FileOutputStream.h>
+#include <twio/stream/MappedInputStream.h>
 
 #include <twio/utils/Printer.h>
 #include <twio/utils/Unwrapper.h>
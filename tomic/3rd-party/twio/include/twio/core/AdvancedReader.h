@@ -14,13 +14,17 @@
 TWIO_BEGIN
 
 
+// If indexed, the reader only records offsets of newlines, and line and
+// char number are got from the index by binary search on demand. So there
+// is no bookkeeping for each character. In this mode, '\r' is counted as
+// a character.
 class AdvancedReader final : public IAdvancedReader, public ReaderBuffer
 {
 public:
-    explicit AdvancedReader(IInputStreamPtr stream);
+    explicit AdvancedReader(IInputStreamPtr stream, bool indexed = false);
     ~AdvancedReader() override;
 
-    static std::shared_ptr<AdvancedReader> New(const IInputStreamPtr& stream);
+    static std::shared_ptr<AdvancedReader> New(const IInputStreamPtr& stream, bool indexed = false);
 
     bool HasNext() override;
 
@@ -33,6 +37,9 @@ public:
     int Line() const override;
     int Char() const override;
 
+    size_t Offset() const override { return _offset; }
+    LineIndexPtr Lines() const override { return _lines; }
+
     IInputStreamPtr Stream() const override;
 
     void Close() override;
@@ -43,6 +50,10 @@ private:
 
     IInputStreamPtr _stream;
 
+    bool _indexed;
+    size_t _offset;
+    LineIndexPtr _lines;
+
     std::stack<int> _lastChar;
 
     int _lineNo;
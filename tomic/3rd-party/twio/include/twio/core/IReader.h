@@ -4,6 +4,7 @@
 #define _TWIO_IREADER_H_
 
 #include <twio/Common.h>
+#include <twio/core/LineIndex.h>
 #include <twio/stream/IStream.h>
 #include <memory>
 
@@ -43,6 +44,12 @@ public:
 
     virtual int Line() const = 0;
     virtual int Char() const = 0;
+
+    // Number of characters read so far, and offsets of newlines in them.
+    // Together they can replace Line() and Char() when positions are only
+    // needed occasionally.
+    virtual size_t Offset() const = 0;
+    virtual LineIndexPtr Lines() const = 0;
 };
 
 
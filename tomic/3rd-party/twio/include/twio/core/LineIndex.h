@@ -0,0 +1,65 @@
+// Copyright (C) 2018 - 2023 Tony's Studio. All rights reserved.
+
+#pragma once
+
+#ifndef _TWIO_LINE_INDEX_H_
+#define _TWIO_LINE_INDEX_H_
+
+#include <twio/Common.h>
+#include <memory>
+#include <vector>
+
+TWIO_BEGIN
+
+
+// Sorted offsets of all newlines in a source. With it, line and char
+// number of an offset can be got by binary search when needed, so that
+// readers do not have to update them for every character.
+// Line and char number of an offset are those after offset characters
+// are read, the same as IAdvancedReader::Line() and Char().
+class LineIndex final
+{
+public:
+    LineIndex() = default;
+    ~LineIndex() = default;
+
+    static std::shared_ptr<LineIndex> New();
+
+    // Record a newline. Offsets not greater than the last one are ignored,
+    // so that characters read again after rewinding are not recorded twice.
+    void Add(size_t offset)
+    {
+        if (_newlines.empty() || (offset > _newlines.back()))
+        {
+            _newlines.push_back(offset);
+        }
+    }
+
+
+    // Record all newlines in data, whose first character is at offset base.
+    void Scan(const char* data, size_t size, size_t base);
+
+    // Replace length characters at offset with data of size, and move
+    // newlines after them, e.g. when the source is edited.
+    void Replace(size_t offset, size_t length, const char* data, size_t size);
+
+    int Line(size_t offset) const;
+    int Char(size_t offset) const;
+    void Locate(size_t offset, int* line, int* ch) const;
+
+    size_t Count() const { return _newlines.size(); }
+
+private:
+    // Number of newlines before offset.
+    size_t _Rank(size_t offset) const;
+
+    std::vector<size_t> _newlines;
+};
+
+
+using LineIndexPtr = std::shared_ptr<LineIndex>;
+
+
+TWIO_END
+
+#endif // _TWIO_LINE_INDEX_H_
@@ -0,0 +1,79 @@
+// Copyright (C) 2018 - 2023 Tony's Studio. All rights reserved.
+
+#pragma once
+
+#ifndef _TWIO_MEMORY_READER_H_
+#define _TWIO_MEMORY_READER_H_
+
+#include <twio/core/IReader.h>
+#include <twio/stream/IStream.h>
+#include <memory>
+#include <stack>
+
+TWIO_BEGIN
+
+
+// An advanced reader that works directly on the contiguous content of
+// a stream, e.g. MappedInputStream or BufferInputStream. Read and Rewind
+// are only cursor movements, so there is no ring buffer and no stream
+// call for each character. Line and char are tracked the same way as
+// AdvancedReader.
+class MemoryReader final : public IAdvancedReader
+{
+public:
+    // The stream must provide a contiguous view via Data().
+    explicit MemoryReader(IInputStreamPtr stream);
+    ~MemoryReader() override;
+
+    static std::shared_ptr<MemoryReader> New(const IInputStreamPtr& stream);
+
+    bool HasNext() override;
+
+    size_t Read(char* buffer, size_t size) override;
+    const char* ReadLine(char* buffer) override;
+    int Read() override;
+
+    // Unlike AdvancedReader, there is no limit on how far to rewind.
+    int Rewind() override;
+
+    int Line() const override;
+    int Char() const override;
+
+    // The whole content is scanned for the index on first call.
+    size_t Offset() const override { return _next; }
+    LineIndexPtr Lines() const override;
+
+    IInputStreamPtr Stream() const override;
+
+    void Close() override;
+
+public:
+    // Raw access for those who scan the content on their own.
+    const char* Data() const { return _data; }
+    size_t Size() const { return _size; }
+
+private:
+    void _MoveForward(char ch);
+    void _MoveBackward(char ch);
+
+    IInputStreamPtr _stream;
+
+    const char* _data;
+    size_t _size;
+    size_t _next;
+
+    mutable LineIndexPtr _lines;
+
+    std::stack<int> _lastChar;
+
+    int _lineNo;
+    int _charNo;
+};
+
+
+using MemoryReaderPtr = std::shared_ptr<MemoryReader>;
+
+
+TWIO_END
+
+#endif // _TWIO_MEMORY_READER_H_
@@ -53,6 +53,9 @@ public:
     size_t Read(char* buffer) override;
     int Read() override;
 
+    const char* Data() const override { return _buffer.get(); }
+    size_t Size() const override { return _size; }
+
     void Accept(RedirectRequestPtr request) override;
 
 private:
@@ -39,6 +39,12 @@ public:
     // Read one character from the stream.
     virtual int Read() = 0;
 
+    // Contiguous view of the whole stream content, which lets readers
+    // work on raw memory instead of calling Read() for each character.
+    // Default implementation has no such view, and returns nullptr.
+    virtual const char* Data() const { return nullptr; }
+    virtual size_t Size() const { return 0; }
+
     // Default implementation is not implemented.
     virtual void Accept(RedirectRequestPtr request)
     {
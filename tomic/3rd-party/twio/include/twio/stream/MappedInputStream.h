@@ -0,0 +1,69 @@
+// Copyright (C) 2018 - 2023 Tony's Studio. All rights reserved.
+
+#pragma once
+
+#ifndef _TWIO_MAPPED_INPUT_STREAM_H_
+#define _TWIO_MAPPED_INPUT_STREAM_H_
+
+#include <twio/Common.h>
+#include <twio/stream/IStream.h>
+#include <memory>
+
+TWIO_BEGIN
+
+
+// Input stream that maps the whole file into memory, so that the content
+// can be accessed as a contiguous range without copying. On platforms
+// without mmap, the file is read into a buffer once instead.
+class MappedInputStream final : public IInputStream
+{
+public:
+    // Initialize via a file path, the mapping is released on close.
+    explicit MappedInputStream(const char* path);
+
+    // Copy is prohibited.
+    MappedInputStream(const MappedInputStream&) = delete;
+    MappedInputStream(MappedInputStream&& other) noexcept;
+    MappedInputStream& operator=(const MappedInputStream&) = delete;
+    MappedInputStream& operator=(MappedInputStream&& other) noexcept;
+
+    // Ensure the mapping is released.
+    ~MappedInputStream() override;
+
+    static std::shared_ptr<MappedInputStream> New(const char* path);
+
+public:
+    // Release the mapping.
+    void Close() override;
+
+    // Check if the file is mapped.
+    bool IsReady() const override;
+
+    bool HasNext() const override;
+
+    size_t Read(char* buffer, size_t size) override;
+    size_t Read(char* buffer) override;
+    int Read() override;
+
+    const char* Data() const override { return _data; }
+    size_t Size() const override { return _size; }
+
+private:
+    void _Map(const char* path);
+    void _Unmap();
+
+    const char* _data;
+    size_t _size;
+    size_t _next;
+
+    // Whether _data is mapped, or owned as a plain buffer.
+    bool _mapped;
+};
+
+
+using MappedInputStreamPtr = std::shared_ptr<MappedInputStream>;
+
+
+TWIO_END
+
+#endif // _TWIO_MAPPED_INPUT_STREAM_H_
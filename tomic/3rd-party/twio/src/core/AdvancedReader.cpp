@@ -5,8 +5,9 @@
 
 TWIO_BEGIN
 
-AdvancedReader::AdvancedReader(IInputStreamPtr stream)
-    : _stream(std::move(stream)), _lineNo(1), _charNo(0)
+AdvancedReader::AdvancedReader(IInputStreamPtr stream, bool indexed)
+    : _stream(std::move(stream)), _indexed(indexed), _offset(0), _lines(LineIndex::New()),
+    _lineNo(1), _charNo(0)
 {
 }
 
@@ -14,9 +15,9 @@ AdvancedReader::AdvancedReader(IInputStreamPtr stream)
 AdvancedReader::~AdvancedReader() = default;
 
 
-std::shared_ptr<AdvancedReader> AdvancedReader::New(const IInputStreamPtr& stream)
+std::shared_ptr<AdvancedReader> AdvancedReader::New(const IInputStreamPtr& stream, bool indexed)
 {
-    return std::make_shared<AdvancedReader>(stream);
+    return std::make_shared<AdvancedReader>(stream, indexed);
 }
 
 
@@ -30,13 +31,14 @@ size_t AdvancedReader::Read(char* buffer, size_t size)
 {
     TWIO_ASSERT(buffer != nullptr);
 
-    const size_t bufferRead = 0;
+    size_t bufferRead = 0;
     char ch;
     while (bufferRead < size && _HasNext())
     {
         ch = _Get();
         *(buffer++) = ch;
         _MoveForward(ch);
+        bufferRead++;
     }
 
     // All from remain.
@@ -112,13 +114,13 @@ int AdvancedReader::Rewind()
 
 int AdvancedReader::Line() const
 {
-    return _lineNo;
+    return _indexed ? _lines->Line(_offset) : _lineNo;
 }
 
 
 int AdvancedReader::Char() const
 {
-    return _charNo;
+    return _indexed ? _lines->Char(_offset) : _charNo;
 }
 
 
@@ -140,6 +142,17 @@ void AdvancedReader::Close()
 // Currently will ignore '\r'.
 void AdvancedReader::_MoveForward(char ch)
 {
+    if (ch == '\n')
+    {
+        _lines->Add(_offset);
+    }
+    _offset++;
+
+    if (_indexed)
+    {
+        return;
+    }
+
     if (ch == '\n')
     {
         _lineNo++;
@@ -155,6 +168,13 @@ void AdvancedReader::_MoveForward(char ch)
 
 void AdvancedReader::_MoveBackward(char ch)
 {
+    _offset--;
+
+    if (_indexed)
+    {
+        return;
+    }
+
     if (ch == '\n')
     {
         _lineNo--;
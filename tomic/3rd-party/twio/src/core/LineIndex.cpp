@@ -0,0 +1,90 @@
+// Copyright (C) 2018 - 2023 Tony's Studio. All rights reserved.
+
+#include <twio/core/LineIndex.h>
+#include <algorithm>
+#include <cstring>
+
+TWIO_BEGIN
+
+std::shared_ptr<LineIndex> LineIndex::New()
+{
+    return std::make_shared<LineIndex>();
+}
+
+
+void LineIndex::Scan(const char* data, size_t size, size_t base)
+{
+    TWIO_ASSERT(data != nullptr);
+
+    const char* end = data + size;
+    const char* p = data;
+    while ((p = static_cast<const char*>(memchr(p, '\n', end - p))) != nullptr)
+    {
+        Add(base + (p - data));
+        p++;
+    }
+}
+
+
+void LineIndex::Replace(size_t offset, size_t length, const char* data, size_t size)
+{
+    TWIO_ASSERT(data != nullptr);
+
+    auto first = std::lower_bound(_newlines.begin(), _newlines.end(), offset);
+    auto last = std::lower_bound(first, _newlines.end(), offset + length);
+    for (auto it = last; it != _newlines.end(); ++it)
+    {
+        *it = *it - length + size;
+    }
+
+    std::vector<size_t> inserted;
+    const char* end = data + size;
+    const char* p = data;
+    while ((p = static_cast<const char*>(memchr(p, '\n', end - p))) != nullptr)
+    {
+        inserted.push_back(offset + (p - data));
+        p++;
+    }
+
+    auto it = _newlines.erase(first, last);
+    _newlines.insert(it, inserted.begin(), inserted.end());
+}
+
+
+int LineIndex::Line(size_t offset) const
+{
+    return static_cast<int>(_Rank(offset)) + 1;
+}
+
+
+int LineIndex::Char(size_t offset) const
+{
+    const size_t rank = _Rank(offset);
+    const size_t begin = (rank == 0) ? 0 : _newlines[rank - 1] + 1;
+    return static_cast<int>(offset - begin);
+}
+
+
+void LineIndex::Locate(size_t offset, int* line, int* ch) const
+{
+    const size_t rank = _Rank(offset);
+    const size_t begin = (rank == 0) ? 0 : _newlines[rank - 1] + 1;
+
+    if (line)
+    {
+        *line = static_cast<int>(rank) + 1;
+    }
+    if (ch)
+    {
+        *ch = static_cast<int>(offset - begin);
+    }
+}
+
+
+size_t LineIndex::_Rank(size_t offset) const
+{
+    return std::lower_bound(_newlines.begin(), _newlines.end(), offset) - _newlines.begin();
+}
+
+
+TWIO_END
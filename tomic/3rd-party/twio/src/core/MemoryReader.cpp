@@ -0,0 +1,178 @@
+// Copyright (C) 2018 - 2023 Tony's Studio. All rights reserved.
+
+#include <twio/core/MemoryReader.h>
+#include <cstdio>   // EOF
+
+TWIO_BEGIN
+
+MemoryReader::MemoryReader(IInputStreamPtr stream)
+    : _stream(std::move(stream)), _next(0), _lineNo(1), _charNo(0)
+{
+    TWIO_ASSERT(_stream != nullptr);
+    TWIO_ASSERT(_stream->Data() != nullptr);
+
+    _data = _stream->Data();
+    _size = _stream->Size();
+}
+
+
+MemoryReader::~MemoryReader() = default;
+
+
+std::shared_ptr<MemoryReader> MemoryReader::New(const IInputStreamPtr& stream)
+{
+    return std::make_shared<MemoryReader>(stream);
+}
+
+
+bool MemoryReader::HasNext()
+{
+    return _next < _size;
+}
+
+
+size_t MemoryReader::Read(char* buffer, size_t size)
+{
+    TWIO_ASSERT(buffer != nullptr);
+
+    size_t count = 0;
+    while ((count < size) && (_next < _size))
+    {
+        const char ch = _data[_next++];
+        buffer[count++] = ch;
+        _MoveForward(ch);
+    }
+    buffer[count] = '\0';
+
+    return count;
+}
+
+
+const char* MemoryReader::ReadLine(char* buffer)
+{
+    TWIO_ASSERT(buffer != nullptr);
+
+    int ch = Read();
+    if (ch == EOF)
+    {
+        return nullptr;
+    }
+
+    char* p = buffer;
+    while (ch != EOF && ch != '\n')
+    {
+        *(p++) = ch;
+        ch = Read();
+    }
+
+    *p = '\0';
+    return buffer;
+}
+
+
+// Same as fgetc, character is returned as unsigned char.
+int MemoryReader::Read()
+{
+    if (_next >= _size)
+    {
+        return EOF;
+    }
+
+    const char ch = _data[_next++];
+    _MoveForward(ch);
+
+    return static_cast<unsigned char>(ch);
+}
+
+
+int MemoryReader::Rewind()
+{
+    if (_next == 0)
+    {
+        return EOF;
+    }
+
+    const char ch = _data[--_next];
+    _MoveBackward(ch);
+
+    return static_cast<unsigned char>(ch);
+}
+
+
+int MemoryReader::Line() const
+{
+    return _lineNo;
+}
+
+
+int MemoryReader::Char() const
+{
+    return _charNo;
+}
+
+
+LineIndexPtr MemoryReader::Lines() const
+{
+    if (!_lines)
+    {
+        _lines = LineIndex::New();
+        if (_data)
+        {
+            _lines->Scan(_data, _size, 0);
+        }
+    }
+    return _lines;
+}
+
+
+IInputStreamPtr MemoryReader::Stream() const
+{
+    return _stream;
+}
+
+
+void MemoryReader::Close()
+{
+    if (_stream)
+    {
+        _stream->Close();
+    }
+
+    _data = nullptr;
+    _size = 0;
+    _next = 0;
+}
+
+
+// Keep it the same as AdvancedReader, '\r' is ignored.
+void MemoryReader::_MoveForward(char ch)
+{
+    if (ch == '\n')
+    {
+        _lineNo++;
+        _lastChar.push(_charNo);
+        _charNo = 0;
+    }
+    else if (ch != '\r')
+    {
+        _charNo++;
+    }
+}
+
+
+void MemoryReader::_MoveBackward(char ch)
+{
+    if (ch == '\n')
+    {
+        _lineNo--;
+        _charNo = _lastChar.top() + 1;
+        _lastChar.pop();
+    }
+    else if (ch != '\r')
+    {
+        _charNo--;
+    }
+}
+
+
+TWIO_END
@@ -118,6 +118,7 @@ size_t BufferInputStream::Read(char* buffer, size_t size)
 
     memcpy(buffer, _buffer.get() + _next, size);
     buffer[size] = '\0';
+    _next += size;
 
     return size;
 }
@@ -0,0 +1,240 @@
+// Copyright (C) 2018 - 2023 Tony's Studio. All rights reserved.
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <twio/stream/MappedInputStream.h>
+#include <twio/utils/FileUtil.h>
+#include <algorithm>
+#include <cstdio>   // EOF
+#include <cstring>
+
+#if _TWIO_FOR_WIN32
+// No mmap here, fall back to reading the whole file. :(
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+TWIO_BEGIN
+
+
+// Empty files cannot be mapped, so they all share this one.
+static const char _EMPTY_CONTENT[] = "";
+
+
+MappedInputStream::MappedInputStream(const char* path)
+    : _data(nullptr), _size(0), _next(0), _mapped(false)
+{
+    _Map(path);
+
+    // _data must not be null
+    TWIO_ASSERT(_data);
+}
+
+
+MappedInputStream::MappedInputStream(MappedInputStream&& other) noexcept
+{
+    _data = other._data;
+    _size = other._size;
+    _next = other._next;
+    _mapped = other._mapped;
+
+    other._data = nullptr;
+    other._size = 0;
+    other._next = 0;
+    other._mapped = false;
+}
+
+
+MappedInputStream& MappedInputStream::operator=(MappedInputStream&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+
+        _data = other._data;
+        _size = other._size;
+        _next = other._next;
+        _mapped = other._mapped;
+
+        other._data = nullptr;
+        other._size = 0;
+        other._next = 0;
+    other._mapped = false;
+    }
+
+    return *this;
+}
+
+
+std::shared_ptr<MappedInputStream> MappedInputStream::New(const char* path)
+{
+    return std::make_shared<MappedInputStream>(path);
+}
+
+
+MappedInputStream::~MappedInputStream()
+{
+    Close();
+}
+
+
+void MappedInputStream::Close()
+{
+    if (_data)
+    {
+        _Unmap();
+        _data = nullptr;
+        _size = 0;
+        _next = 0;
+        _mapped = false;
+    }
+}
+
+
+bool MappedInputStream::IsReady() const
+{
+    return _data != nullptr;
+}
+
+
+bool MappedInputStream::HasNext() const
+{
+    return IsReady() && (_next < _size);
+}
+
+
+size_t MappedInputStream::Read(char* buffer, size_t size)
+{
+    TWIO_ASSERT(IsReady());
+
+    // adjust size
+    size = std::min(size, _size - _next);
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    memcpy(buffer, _data + _next, size);
+    buffer[size] = '\0';
+    _next += size;
+
+    return size;
+}
+
+
+size_t MappedInputStream::Read(char* buffer)
+{
+    TWIO_ASSERT(IsReady());
+
+    if (_next >= _size)
+    {
+        *buffer = '\0';
+        return 0;
+    }
+
+    *buffer = _data[_next++];
+
+    return 1;
+}
+
+
+// Same as fgetc, character is returned as unsigned char.
+int MappedInputStream::Read()
+{
+    TWIO_ASSERT(IsReady());
+
+    if (_next >= _size)
+    {
+        return EOF;
+    }
+
+    return static_cast<unsigned char>(_data[_next++]);
+}
+
+
+#if _TWIO_FOR_WIN32
+void MappedInputStream::_Map(const char* path)
+{
+    FILE* fp = OpenFile(path, "rb");
+    if (!fp)
+    {
+        return;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    const long length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    if (length <= 0)
+    {
+        CloseFile(fp);
+        _data = _EMPTY_CONTENT;
+        return;
+    }
+
+    char* buffer = new char[length];
+    _size = fread(buffer, sizeof(char), length, fp);
+    _data = buffer;
+    _mapped = false;
+
+    CloseFile(fp);
+}
+
+
+void MappedInputStream::_Unmap()
+{
+    if (_data != _EMPTY_CONTENT)
+    {
+        delete[] _data;
+    }
+}
+#else
+void MappedInputStream::_Map(const char* path)
+{
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size <= 0))
+    {
+        close(fd);
+        _data = _EMPTY_CONTENT;
+        return;
+    }
+
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+
+    if (addr == MAP_FAILED)
+    {
+        return;
+    }
+
+    // We only go through it from front to back.
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+
+    _data = static_cast<const char*>(addr);
+    _size = st.st_size;
+    _mapped = true;
+}
+
+
+void MappedInputStream::_Unmap()
+{
+    if (_mapped)
+    {
+        munmap(const_cast<char*>(_data), _size);
+    }
+}
+#endif
+
+
+TWIO_END
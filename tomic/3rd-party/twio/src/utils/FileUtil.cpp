@@ -25,7 +25,9 @@ void CloseFile(FILE* fp)
 {
     if (fp != nullptr)
     {
-        TWIO_ASSERT(fclose(fp) == 0);
+        // Not in the assertion, which may be compiled out.
+        int ret = fclose(fp);
+        TWIO_ASSERT(ret == 0);
     }
 }
 
@@ -41,6 +41,14 @@ public:
     std::string Input;
     std::string Output;
 
+    // lexer, 1 for serial lexing
+    int LexThreads;
+
+    // parser, max nesting depth of statements and expressions
+    int MaxDepth;
+    // parser, 1 for serial parsing
+    int ParseThreads;
+
     // AST
     bool EnableCompleteAst;
     bool EmitAst;
@@ -59,6 +67,14 @@ public:
     bool EnableError;
     bool EnableVerboseError;
     std::string ErrorOutput;
+
+    // time report, table on stderr or JSON to file
+    bool EnableTimeReport;
+    std::string TimeReportOutput;
+
+    // trace events, only recorded if built with TOMIC_ENABLE_TRACE
+    bool EnableTrace;
+    std::string TraceOutput;
 };
 
 
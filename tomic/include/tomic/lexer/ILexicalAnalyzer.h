@@ -20,6 +20,9 @@ public:
 
     virtual ILexicalAnalyzer* SetReader(twio::IAdvancedReaderPtr reader) = 0;
 
+    // Tokens will be allocated in the given arena.
+    virtual ILexicalAnalyzer* SetArena(TokenArenaPtr arena) = 0;
+
     virtual TokenPtr Next() = 0;
 };
 
@@ -10,6 +10,7 @@
 #include <memory>
 #include <tomic/lexer/token/Token.h>
 #include <tomic/Shared.h>
+#include <vector>
 
 TOMIC_BEGIN
 
@@ -21,6 +22,13 @@ public:
 
     virtual ILexicalParser* SetReader(twio::IAdvancedReaderPtr reader) = 0;
 
+    // Add tokens to an existing arena instead of a new one, e.g. when part
+    // of a source is lexed again. The line index of the arena is kept.
+    virtual ILexicalParser* SetReader(twio::IAdvancedReaderPtr reader, TokenArenaPtr arena) = 0;
+
+    // The arena that owns all tokens read from the current reader.
+    virtual TokenArenaPtr Arena() const = 0;
+
     virtual TokenPtr Current() = 0;
 
     // Shall not return nullptr.
@@ -29,6 +37,11 @@ public:
 
     virtual int SetCheckPoint() = 0;
     virtual void Rollback(int checkpoint) = 0;
+
+    // Read all remaining tokens in advance, and return all tokens read so
+    // far without moving the current one. Unknown tokens are skipped, but
+    // still reported when Next gets past them, as if not read in advance.
+    virtual const std::vector<TokenPtr>& Prefetch() = 0;
 };
 
 
@@ -40,8 +40,9 @@ public:
     // Use to check if the TokenPtr is properly ended or not.
     virtual bool EndsWith(int end) const = 0;
 
-    // Accept the reader from LexicalAnalyser, and return the next TokenPtr.
-    virtual TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader) = 0;
+    // Accept the reader from LexicalAnalyser, and return the next TokenPtr,
+    // which is allocated in the given arena.
+    virtual TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena) = 0;
 
 protected:
     ITokenMapperPtr _tokenMapper;
@@ -62,6 +63,7 @@ public:
     ~DefaultLexicalAnalyzer() override = default;
 
     DefaultLexicalAnalyzer* SetReader(twio::IAdvancedReaderPtr reader) override;
+    DefaultLexicalAnalyzer* SetArena(TokenArenaPtr arena) override;
 
     TokenPtr Next() override;
 
@@ -70,6 +72,7 @@ private:
     TokenPtr _Next();
 
     twio::IAdvancedReaderPtr _reader;
+    TokenArenaPtr _arena;
     std::vector<LexicalTaskPtr> _tasks;
     ITokenMapperPtr _mapper;
 };
@@ -90,7 +93,7 @@ public:
 
     bool BeginsWith(int begin) const override;
     bool EndsWith(int end) const override;
-    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader) override;
+    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena) override;
 };
 
 
@@ -106,7 +109,7 @@ public:
 
     bool BeginsWith(int begin) const override;
     bool EndsWith(int end) const override;
-    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader) override;
+    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena) override;
 };
 
 
@@ -121,7 +124,7 @@ public:
 
     bool BeginsWith(int begin) const override;
     bool EndsWith(int end) const override;
-    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader) override;
+    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena) override;
 
 private:
     bool _IsNormalChar(int ch) const;
@@ -142,7 +145,7 @@ public:
 
     bool BeginsWith(int begin) const override;
     bool EndsWith(int end) const override;
-    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader) override;
+    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena) override;
 };
 
 
@@ -158,7 +161,7 @@ public:
 
     bool BeginsWith(int begin) const override;
     bool EndsWith(int end) const override;
-    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader) override;
+    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena) override;
 };
 
 
@@ -173,7 +176,7 @@ public:
 
     bool BeginsWith(int begin) const override;
     bool EndsWith(int end) const override;
-    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader) override;
+    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena) override;
 };
 
 
@@ -187,7 +190,7 @@ public:
 
     bool BeginsWith(int begin) const override;
     bool EndsWith(int end) const override;
-    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader) override;
+    TokenPtr Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena) override;
 };
 
 
@@ -13,6 +13,7 @@
 #include <tomic/logger/debug/ILogger.h>
 #include <tomic/logger/error/IErrorLogger.h>
 #include <tomic/Shared.h>
+#include <utility>
 #include <vector>
 
 TOMIC_BEGIN
@@ -24,6 +25,9 @@ public:
     ~DefaultLexicalParser() override = default;
 
     DefaultLexicalParser* SetReader(twio::IAdvancedReaderPtr reader) override;
+    DefaultLexicalParser* SetReader(twio::IAdvancedReaderPtr reader, TokenArenaPtr arena) override;
+
+    TokenArenaPtr Arena() const override { return _arena; }
 
     TokenPtr Current() override;
     TokenPtr Next() override;
@@ -32,17 +36,29 @@ public:
     int SetCheckPoint() override;
     void Rollback(int checkpoint) override;
 
+    const std::vector<TokenPtr>& Prefetch() override;
+
 private:
     void _LogUnexpectedToken(TokenPtr token);
     void _RaiseUnexpectedTokenError(TokenPtr token);
 
+    // Report unknown tokens prefetched before the index-th token.
+    void _ReportUnknown(size_t index);
+
 private:
     ILexicalAnalyzerPtr _analyzer;
     IErrorLoggerPtr _errorLogger;
     ILoggerPtr _logger;
 
+    TokenArenaPtr _arena;
     std::vector<TokenPtr> _tokens;
     std::vector<TokenPtr>::iterator _current;
+    TokenPtr _terminator;
+
+    // Unknown tokens prefetched, with the index of the token after them,
+    // and the first one not reported yet.
+    std::vector<std::pair<size_t, TokenPtr>> _unknown;
+    size_t _nextUnknown;
 };
 
 
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_PARALLEL_LEXICAL_ANALYZER_H_
+#define _TOMIC_PARALLEL_LEXICAL_ANALYZER_H_
+
+#include <tomic/lexer/ILexicalAnalyzer.h>
+#include <tomic/lexer/token/ITokenMapper.h>
+#include <tomic/utils/ThreadPool.h>
+#include <tomic/Shared.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+TOMIC_BEGIN
+
+/*
+ * ParallelLexicalAnalyzer lexes the whole source as soon as the reader is
+ * set, and Next only hands out the tokens in order. The source is split
+ * into chunks at newlines, and each chunk is lexed by a TableLexicalAnalyzer
+ * on a thread pool into its own arena. Then the chunks are appended to the
+ * arena one by one.
+ *
+ * A chunk may start inside a string, which is the only token that can span
+ * whitespace. This is found when stitching: if the last token of previous
+ * chunks ends after the start of a chunk, the chunk is lexed again from
+ * there. So the tokens are always the same as serial lexing, unknown ones
+ * included. Positions are offsets in the whole source, so line and char
+ * numbers need no correction.
+ *
+ * If the reader is not a MemoryReader, e.g. StreamingPreprocessor, it is
+ * drained to a buffer first, so it must not have been read before.
+ */
+class ParallelLexicalAnalyzer : public ILexicalAnalyzer
+{
+public:
+    ParallelLexicalAnalyzer(ITokenMapperPtr mapper, int threads);
+    ~ParallelLexicalAnalyzer() override = default;
+
+    static std::shared_ptr<ParallelLexicalAnalyzer> New(ITokenMapperPtr mapper, int threads);
+
+    ParallelLexicalAnalyzer* SetReader(twio::IAdvancedReaderPtr reader) override;
+    ParallelLexicalAnalyzer* SetArena(TokenArenaPtr arena) override;
+
+    TokenPtr Next() override;
+
+private:
+    struct Chunk
+    {
+        size_t begin;       // where lexing starts
+        size_t limit;       // tokens starting from here belong to the next chunk
+        size_t end;         // where the last token ends
+        size_t count;       // number of tokens of this chunk
+        TokenArenaPtr arena;
+    };
+
+
+    void _Lex(size_t offset);
+    void _Split(size_t offset);
+    void _LexChunk(Chunk& chunk);
+    void _Stitch();
+
+    // Chunks smaller than this are not worth a thread.
+    static constexpr size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+    ITokenMapperPtr _mapper;
+    ThreadPoolPtr _pool;
+    int _threads;
+
+    twio::IAdvancedReaderPtr _reader;
+    TokenArenaPtr _arena;
+
+    // Only used if the reader has no contiguous content.
+    std::string _buffer;
+    const char* _data;
+    size_t _size;
+
+    std::vector<Chunk> _chunks;
+
+    // Tokens lexed are [_first, _first + _count) in the arena.
+    uint32_t _first;
+    uint32_t _count;
+    uint32_t _next;
+};
+
+
+using ParallelLexicalAnalyzerPtr = std::shared_ptr<ParallelLexicalAnalyzer>;
+
+TOMIC_END
+
+#endif // _TOMIC_PARALLEL_LEXICAL_ANALYZER_H_
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_SPAN_LEXICAL_PARSER_H_
+#define _TOMIC_SPAN_LEXICAL_PARSER_H_
+
+#include <tomic/lexer/ILexicalParser.h>
+#include <tomic/Shared.h>
+
+#include <memory>
+#include <vector>
+
+TOMIC_BEGIN
+
+/*
+ * SpanLexicalParser hands out a span of tokens already read by another
+ * lexical parser, so that a part of the source can be parsed on its own,
+ * e.g. on another thread. It reads no source, so SetReader is not
+ * supported. Past the span, the given terminator is returned, and it is
+ * remembered, since the part may be parsed differently with more tokens.
+ */
+class SpanLexicalParser : public ILexicalParser
+{
+public:
+    SpanLexicalParser(TokenArenaPtr arena, const TokenPtr* begin, const TokenPtr* end, TokenPtr terminator);
+    ~SpanLexicalParser() override = default;
+
+    static std::shared_ptr<SpanLexicalParser> New(TokenArenaPtr arena,
+                                                  const TokenPtr* begin,
+                                                  const TokenPtr* end,
+                                                  TokenPtr terminator);
+
+    SpanLexicalParser* SetReader(twio::IAdvancedReaderPtr reader) override;
+    SpanLexicalParser* SetReader(twio::IAdvancedReaderPtr reader, TokenArenaPtr arena) override;
+
+    TokenArenaPtr Arena() const override { return _arena; }
+
+    TokenPtr Current() override;
+    TokenPtr Next() override;
+    TokenPtr Rewind() override;
+
+    int SetCheckPoint() override;
+    void Rollback(int checkpoint) override;
+
+    const std::vector<TokenPtr>& Prefetch() override;
+
+public:
+    // Whether any token past the span is requested.
+    bool IsOverrun() const { return _overrun; }
+
+private:
+    TokenArenaPtr _arena;
+    const TokenPtr* _begin;
+    const TokenPtr* _end;
+    const TokenPtr* _current;
+    TokenPtr _terminator;
+    bool _overrun;
+
+    // Only filled by Prefetch.
+    std::vector<TokenPtr> _tokens;
+};
+
+
+using SpanLexicalParserPtr = std::shared_ptr<SpanLexicalParser>;
+
+TOMIC_END
+
+#endif // _TOMIC_SPAN_LEXICAL_PARSER_H_
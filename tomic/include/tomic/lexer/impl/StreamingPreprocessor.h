@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_STREAMING_PREPROCESSOR_H_
+#define _TOMIC_STREAMING_PREPROCESSOR_H_
+
+#include <tomic/Shared.h>
+
+#include <memory>
+
+TOMIC_BEGIN
+
+/*
+ * StreamingPreprocessor does the same as HeaderPreprocessor, but as an
+ * advanced reader. Instead of writing the whole preprocessed source to a
+ * buffer first, it strips comments and include directives on demand when
+ * the lexer reads from it. So only a small window of the source is kept,
+ * which is the same as twio::AdvancedReader, to support rewind.
+ * Only newlines are recorded, and line and char number are got from the
+ * line index on demand.
+ * Offsets start from the given one, so that a part of a source can be
+ * processed on its own, with the same positions as in the whole source.
+ */
+class StreamingPreprocessor final : public twio::IAdvancedReader, public twio::ReaderBuffer
+{
+public:
+    explicit StreamingPreprocessor(twio::IReaderPtr reader, size_t offset = 0);
+    ~StreamingPreprocessor() override = default;
+
+    static std::shared_ptr<StreamingPreprocessor> New(const twio::IReaderPtr& reader, size_t offset = 0);
+
+    bool HasNext() override;
+
+    size_t Read(char* buffer, size_t size) override;
+    const char* ReadLine(char* buffer) override;
+    int Read() override;
+
+    int Rewind() override;
+
+    int Line() const override;
+    int Char() const override;
+
+    size_t Offset() const override { return _offset; }
+    twio::LineIndexPtr Lines() const override { return _lines; }
+
+    twio::IInputStreamPtr Stream() const override;
+
+    void Close() override;
+
+private:
+    // Get next preprocessed character, EOF if source is exhausted.
+    int _Produce();
+
+    void _MoveForward(char ch);
+    void _MoveBackward();
+
+    // Same as HeaderPreprocessor, but put characters to _pending.
+    void _Process(int ch);
+    void _ProcessAny(int ch);
+    void _ProcessSlash(int ch);
+    void _ProcessLineComment(int ch);
+    void _ProcessBlockCommentLeft(int ch);
+    void _ProcessBlockCommentRight(int ch);
+    void _ProcessQuote(int ch);
+
+    void _Emit(char ch) { _pending[_pendingSize++] = ch; }
+
+    twio::IReaderPtr _reader;
+
+    // One source character produces at most two output characters.
+    char _pending[2];
+    int _pendingSize;
+    int _pendingNext;
+    bool _exhausted;
+
+    size_t _offset;
+    twio::LineIndexPtr _lines;
+
+    static const char FILLING = ' ';
+
+
+    enum class StateType
+    {
+        ANY,                    // any state
+        SLASH,                  // '/'
+        LINE_COMMENT,           // '//'
+        BLOCK_COMMENT_LEFT,     // '/*'
+        BLOCK_COMMENT_RIGHT,    // '*' (waiting for '/')
+        QUOTE                   // ' or ", with value set
+    };
+
+
+    struct State
+    {
+        StateType type;
+        int value;
+    } _state;
+};
+
+
+using StreamingPreprocessorPtr = std::shared_ptr<StreamingPreprocessor>;
+
+TOMIC_END
+
+#endif // _TOMIC_STREAMING_PREPROCESSOR_H_
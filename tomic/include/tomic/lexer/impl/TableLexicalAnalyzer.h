@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_TABLE_LEXICAL_ANALYZER_H_
+#define _TOMIC_TABLE_LEXICAL_ANALYZER_H_
+
+#include <tomic/lexer/ILexicalAnalyzer.h>
+#include <tomic/lexer/token/ITokenMapper.h>
+#include <tomic/Shared.h>
+
+#include <memory>
+#include <string>
+
+TOMIC_BEGIN
+
+/*
+ * TableLexicalAnalyzer is a table-driven implementation of ILexicalAnalyzer.
+ * Instead of asking each LexicalTask in turn, it classifies characters with a
+ * 256-entry table and runs a single DFA loop over a contiguous range.
+ * It produces exactly the same tokens as DefaultLexicalAnalyzer, including the
+ * unknown tokens used for error recovery.
+ *
+ * If the reader is a MemoryReader, its content is used in place. Otherwise,
+ * characters are pulled from the reader into a small window on demand, so
+ * that it can work with streaming readers like StreamingPreprocessor.
+ * Line and char number are not tracked. Tokens only record their offsets,
+ * which are resolved by the line index of the reader.
+ */
+class TableLexicalAnalyzer : public ILexicalAnalyzer
+{
+public:
+    TableLexicalAnalyzer(ITokenMapperPtr mapper);
+    ~TableLexicalAnalyzer() override = default;
+
+    TableLexicalAnalyzer* SetReader(twio::IAdvancedReaderPtr reader) override;
+    TableLexicalAnalyzer* SetArena(TokenArenaPtr arena) override;
+
+    TokenPtr Next() override;
+
+public:
+    // Lex content in place from offset, without a reader. Token positions
+    // are offsets in content. The content must outlive the analyzer.
+    TableLexicalAnalyzer* SetContent(const char* data, size_t size, size_t offset);
+
+    // Offset of the next character to read, i.e. where the last token ends.
+    size_t Offset() const { return _Offset(_current); }
+
+private:
+    void _InitTypes();
+
+    // Make sure at least size characters are available from _current.
+    bool _Ensure(size_t size)
+    {
+        return (static_cast<size_t>(_end - _current) >= size) || _Fill(size);
+    }
+
+
+    bool _Fill(size_t size);
+
+    void _Forward() { _current++; }
+
+    // Reader offset of a character in the window or content.
+    size_t _Offset(const char* p) const { return _base + (p - _origin); }
+
+    twio::IAdvancedReaderPtr _reader;
+    TokenArenaPtr _arena;
+    ITokenMapperPtr _mapper;
+
+    // Only used when the reader has no contiguous content.
+    static constexpr size_t WINDOW_SIZE = 4096;
+    std::string _window;
+    bool _streaming;
+
+    // Current token is [_begin, _current), and [_current, _end) are
+    // characters not consumed yet.
+    const char* _begin;
+    const char* _current;
+    const char* _end;
+
+    // _origin is at reader offset _base.
+    const char* _origin;
+    size_t _base;
+
+    // Token types of single and double character operators, and delimiters.
+    // Indexed by the first character.
+    TokenType _singleTypes[256];
+    TokenType _doubleTypes[256];
+};
+
+
+TOMIC_END
+
+#endif // _TOMIC_TABLE_LEXICAL_ANALYZER_H_
@@ -7,17 +7,21 @@
 #ifndef _TOMIC_DEFAULT_TOKEN_MAPPER_H_
 #define _TOMIC_DEFAULT_TOKEN_MAPPER_H_
 
-#include <string>
 #include <tomic/lexer/token/ITokenMapper.h>
 #include <tomic/Shared.h>
-#include <unordered_map>
 
 TOMIC_BEGIN
 
+/*
+ * All lexemes and descriptions are fixed, so they are kept in constant
+ * tables built at compile time. Lexemes are found by a perfect hash, and
+ * lexemes and descriptions of a type are indexed by the type directly.
+ * So none of the lookups allocates or hashes a string.
+ */
 class DefaultTokenMapper : public ITokenMapper
 {
 public:
-    DefaultTokenMapper();
+    DefaultTokenMapper() = default;
     ~DefaultTokenMapper() override = default;
 
     DefaultTokenMapper(const DefaultTokenMapper&) = delete;
@@ -26,24 +30,12 @@ public:
     DefaultTokenMapper& operator=(DefaultTokenMapper&&) = delete;
 
 public:
-    TokenType Type(const std::string& lexeme) const override;
+    TokenType Type(std::string_view lexeme) const override;
     const char* Lexeme(TokenType type) const override;
 
     const char* Description(TokenType type) const override;
 
-    bool IsKeyword(const std::string& lexeme) const override;
-
-private:
-    void _Init();
-    void _InitLexemeToType();
-    void _InitTypeToLexeme();
-    void _InitTypeToDescription();
-    void _InitLexemeToIsKeyword();
-
-    std::unordered_map<std::string, TokenType> _lexemeToType;
-    std::unordered_map<TokenType, std::string> _typeToLexeme;
-    std::unordered_map<TokenType, std::string> _typeToDescription;
-    std::unordered_map<std::string, bool> _lexemeToIsKeyword;
+    bool IsKeyword(std::string_view lexeme) const override;
 };
 
 
@@ -8,6 +8,7 @@
 #define _TOMIC__TOKEN_MAPPER_H_
 
 #include <memory>
+#include <string_view>
 #include <tomic/lexer/token/Token.h>
 #include <tomic/Shared.h>
 
@@ -22,13 +23,13 @@ public:
     virtual ~ITokenMapper() = default;
 
     // Only support token with fixed lexeme, or externally added lexeme.
-    virtual TokenType Type(const std::string& lexeme) const = 0;
+    virtual TokenType Type(std::string_view lexeme) const = 0;
     // Only support type with fixed lexeme! Externally added lexeme.
     virtual const char* Lexeme(TokenType type) const = 0;
 
     virtual const char* Description(TokenType type) const = 0;
 
-    virtual bool IsKeyword(const std::string& lexeme) const = 0;
+    virtual bool IsKeyword(std::string_view lexeme) const = 0;
 };
 
 
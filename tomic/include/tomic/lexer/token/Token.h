@@ -7,13 +7,16 @@
 #ifndef _TOMIC_TOKEN_H_
 #define _TOMIC_TOKEN_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <tomic/Shared.h>
+#include <vector>
 
 TOMIC_BEGIN
 
-enum class TokenType
+enum class TokenType : uint32_t
 {
     TK_UNKNOWN,        // unknown token
     TK_TERMINATOR,     // terminator
@@ -65,47 +68,194 @@ enum class TokenType
 };
 
 
-// For now, memory layout is not considered.
+class TokenPtr;
+
+/*
+ * Token is a 12-byte POD, so that tokens can be stored contiguously in a
+ * TokenArena. The lexeme is not owned by the token, but kept by the arena,
+ * and is referred to by offset and length.
+ * Position is the reader offset right after the first character of the
+ * token is read. Line and char number are only got from it when needed.
+ * After the source is edited, the arena may keep it relative to a delta,
+ * so it should be got by TokenPtr::Position().
+ */
 struct Token
 {
-    TokenType type;     // The type of the token.
+    TokenType type : 8;     // The type of the token.
+    uint32_t length : 24;   // The length of the lexeme.
+    uint32_t offset;        // The offset of the lexeme in the arena.
+    uint32_t position;      // The position of the token in the source.
+
+    // Pseudo tokens are not in the source.
+    static constexpr uint32_t NO_POSITION = UINT32_MAX;
+
+    static TokenType Type(const TokenPtr& token);
+};
+
+
+static_assert(sizeof(Token) == 12, "Token should be 12 bytes");
+
+
+/*
+ * TokenArena owns all tokens of a source file, and their lexemes. It is
+ * created by the lexical parser, and kept by the syntax tree, so tokens
+ * are valid as long as the syntax tree is.
+ * Lexemes are copied into fixed-size blocks, and end with '\0'. Blocks are
+ * never moved, so a lexeme got from the arena will not be invalidated by
+ * new tokens.
+ * The arena also keeps the line index of the source, so that line and char
+ * number of a token can be got by binary search when reporting errors or
+ * printing the AST, instead of being tracked for every character.
+ */
+class TokenArena
+{
+public:
+    TokenArena();
+    ~TokenArena() = default;
+
+    // Prohibit copying and cloning.
+    TokenArena(const TokenArena&) = delete;
+    TokenArena& operator=(const TokenArena&) = delete;
+    TokenArena(TokenArena&&) = delete;
+    TokenArena& operator=(TokenArena&&) = delete;
 
-    std::string lexeme; // The actual string that is read from the source code.
+    static std::shared_ptr<TokenArena> New();
 
-    int lineNo; // The line number of the token.
-    int charNo; // The character number of the token.
+public:
+    TokenPtr NewToken(TokenType type, const char* lexeme, size_t length, size_t position);
+    TokenPtr NewToken(TokenType type, const std::string& lexeme, size_t position);
 
-    Token(TokenType type, std::string lexeme, int lineNo = 0, int charNo = 0)
-        : type(type), lexeme(lexeme), lineNo(lineNo), charNo(charNo)
+    // A pseudo token with empty lexeme, used in error recovery.
+    TokenPtr NewToken(TokenType type);
+
+    // Move the first count tokens of other to the end of this arena, with
+    // their lexemes. Lexemes are not copied, but the blocks are taken over,
+    // so other must not be used afterwards.
+    TokenArena* Append(TokenArena& other, size_t count);
+
+    const Token& At(uint32_t index) const { return _tokens[index]; }
+
+    const char* Lexeme(uint32_t index) const
     {
+        const Token& token = _tokens[index];
+        return _blocks[token.offset >> BLOCK_BITS] + (token.offset & (BLOCK_SIZE - 1));
     }
 
 
-    static std::shared_ptr<Token> New(TokenType type, std::string lexeme, int lineNo = 0, int charNo = 0)
+    // Position of the token in the source, see Token::position.
+    uint32_t Position(uint32_t index) const
     {
-        return std::make_shared<Token>(type, std::move(lexeme), lineNo, charNo);
+        const uint32_t position = _tokens[index].position;
+        if (position == Token::NO_POSITION)
+        {
+            return position;
+        }
+        return static_cast<uint32_t>(position + _shifts[index >> SHIFT_BITS].delta);
     }
 
 
-    static std::shared_ptr<Token> New(TokenType type)
+    // 0 for pseudo tokens, or if there is no line index.
+    int LineNo(uint32_t index) const;
+    int CharNo(uint32_t index) const;
+
+    TokenArena* SetLines(twio::LineIndexPtr lines);
+    twio::LineIndexPtr Lines() const { return _lines; }
+
+    // Move tokens that start at or after offset by delta, e.g. when text
+    // before them is edited. Pseudo tokens are not moved.
+    TokenArena* Shift(size_t offset, ptrdiff_t delta);
+
+    size_t Size() const { return _tokens.size(); }
+
+private:
+    uint32_t _NewLexeme(const char* lexeme, size_t length);
+    TokenPtr _Push(Token token);
+
+    /*
+     * Tokens are grouped in blocks of positions, each with a delta added to
+     * all its tokens. So an edit moves most tokens after it block by block,
+     * and only those in blocks across it one by one. Min and max are those
+     * of the stored positions in the block, i.e. without delta.
+     */
+    struct ShiftBlock
     {
-        return std::make_shared<Token>(type, "", 0, 0);
-    }
+        int64_t delta;
+        uint32_t min;
+        uint32_t max;
+    };
+
+
+    // Add delta of a block to its tokens, and reset it to 0.
+    void _Normalize(ShiftBlock& block, size_t index);
 
+    static constexpr uint32_t SHIFT_BITS = 10;
+    static constexpr uint32_t SHIFT_SIZE = 1 << SHIFT_BITS;
+    std::vector<ShiftBlock> _shifts;
 
-    static TokenType Type(const std::shared_ptr<Token>& token)
+    static constexpr uint32_t BLOCK_BITS = 16;
+    static constexpr uint32_t BLOCK_SIZE = 1 << BLOCK_BITS;
+
+    std::vector<Token> _tokens;
+
+    // Each entry covers BLOCK_SIZE bytes of offset. A lexeme larger than
+    // a block takes several entries, which point into the same storage.
+    std::vector<char*> _blocks;
+    std::vector<std::unique_ptr<char[]>> _storage;
+    uint32_t _used;
+
+    twio::LineIndexPtr _lines;
+};
+
+
+using TokenArenaPtr = std::shared_ptr<TokenArena>;
+
+
+/*
+ * TokenPtr is a handle to a token in a TokenArena, instead of a smart
+ * pointer. It is cheap to copy and can be used just like a pointer.
+ * The arena must outlive all handles to it.
+ */
+class TokenPtr
+{
+public:
+    TokenPtr() : _arena(nullptr), _index(0) {}
+    TokenPtr(std::nullptr_t) : _arena(nullptr), _index(0) {}
+    TokenPtr(const TokenArena* arena, uint32_t index) : _arena(arena), _index(index) {}
+
+    const Token* operator->() const { return &_arena->At(_index); }
+    const Token& operator*() const { return _arena->At(_index); }
+
+    explicit operator bool() const { return _arena != nullptr; }
+
+    bool operator==(const TokenPtr& other) const
     {
-        return token ? token->type : TokenType::TK_UNKNOWN;
+        return (_arena == other._arena) && (_index == other._index);
     }
-};
 
 
-using TokenPtr = std::shared_ptr<Token>;
+    bool operator!=(const TokenPtr& other) const { return !(*this == other); }
+
+    // The lexeme of the token, which is null-terminated.
+    const char* Lexeme() const { return _arena->Lexeme(_index); }
+
+    uint32_t Position() const { return _arena->Position(_index); }
+
+    int LineNo() const { return _arena->LineNo(_index); }
+    int CharNo() const { return _arena->CharNo(_index); }
 
-// For example, the Token for 'int' can be:
-// { TK_INT, "int", 1, 1 }
-// The Token for 'number' can be:
-// { TK_IDENT, "number", 3, 5 }
+    // Index of the token in its arena.
+    uint32_t Index() const { return _index; }
+
+private:
+    const TokenArena* _arena;
+    uint32_t _index;
+};
+
+
+inline TokenType Token::Type(const TokenPtr& token)
+{
+    return token ? token->type : TokenType::TK_UNKNOWN;
+}
 
 
 TOMIC_END
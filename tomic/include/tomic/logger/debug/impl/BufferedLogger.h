@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_BUFFERED_LOGGER_H_
+#define _TOMIC_BUFFERED_LOGGER_H_
+
+#include <tomic/logger/debug/ILogger.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+TOMIC_BEGIN
+
+/*
+ * BufferedLogger is the debug counterpart of BufferedErrorLogger. Logs are
+ * kept in order, and only passed to another logger on Flush, so that logs
+ * made on other threads come out as if made in order on one.
+ */
+class BufferedLogger : public ILogger
+{
+public:
+    BufferedLogger() = default;
+    ~BufferedLogger() override = default;
+
+    static std::shared_ptr<BufferedLogger> New();
+
+    void LogFormat(LogLevel level, const char* format, ...) override;
+    void LogVFormat(LogLevel level, const char* format, va_list args) override;
+
+    int Count(LogLevel level) override;
+
+    // Logs are filtered by the logger flushed to.
+    BufferedLogger* SetLogLevel(LogLevel level) override { return this; }
+    BufferedLogger* SetWriter(twio::IWriterPtr writer) override { return this; }
+
+public:
+    // Pass all logs to logger, and clear them.
+    void Flush(ILogger* logger);
+    void Clear() { _entries.clear(); }
+
+private:
+    std::vector<std::pair<LogLevel, std::string>> _entries;
+};
+
+
+using BufferedLoggerPtr = std::shared_ptr<BufferedLogger>;
+
+TOMIC_END
+
+#endif // _TOMIC_BUFFERED_LOGGER_H_
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_BUFFERED_ERROR_LOGGER_H_
+#define _TOMIC_BUFFERED_ERROR_LOGGER_H_
+
+#include <tomic/logger/error/IErrorLogger.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+TOMIC_BEGIN
+
+class BufferedErrorEntry
+{
+public:
+    BufferedErrorEntry(int line, int column, ErrorType type, const char* msg)
+        : _line(line), _column(column), _type(type), _msg(msg)
+    {
+    }
+
+
+    int _line;
+    int _column;
+    ErrorType _type;
+    std::string _msg;
+};
+
+
+/*
+ * BufferedErrorLogger keeps errors in order, and only passes them to
+ * another logger on Flush. So errors of a parse can be dropped if it is
+ * abandoned, or be put in order if it is done in pieces.
+ */
+class BufferedErrorLogger : public IErrorLogger
+{
+public:
+    BufferedErrorLogger() = default;
+    ~BufferedErrorLogger() override = default;
+
+    static std::shared_ptr<BufferedErrorLogger> New();
+
+    void LogFormat(int line, int column, ErrorType type, const char* format, ...) override;
+    void LogVFormat(int line, int column, ErrorType type, const char* format, va_list args) override;
+
+    void Dumps(twio::IWriterPtr writer) override;
+
+    int Count() override;
+
+public:
+    // Pass all errors to logger, and clear them.
+    void Flush(IErrorLogger* logger);
+    void Clear() { _entries.clear(); }
+
+private:
+    std::vector<BufferedErrorEntry> _entries;
+};
+
+
+using BufferedErrorLoggerPtr = std::shared_ptr<BufferedErrorLogger>;
+
+TOMIC_END
+
+#endif // _TOMIC_BUFFERED_ERROR_LOGGER_H_
@@ -17,14 +17,47 @@ class SyntaxTree;
 using SyntaxTreePtr = std::shared_ptr<SyntaxTree>;
 
 
+// An edit of the source, which replaces length characters at offset with
+// newLength ones. Offset and length are those before the edit.
+struct SourceEdit
+{
+    size_t offset;
+    size_t length;
+    size_t newLength;
+};
+
+
 class ISyntacticParser
 {
 public:
+    // Far beyond any hand-written program, and a few MB of native stack is
+    // enough for all stages at this depth.
+    static constexpr int DEFAULT_MAX_DEPTH = 1000;
+
     virtual ~ISyntacticParser() = default;
 
     virtual ISyntacticParser* SetReader(twio::IAdvancedReaderPtr reader) = 0;
 
+    // Max nesting depth of statements, expressions and initializers. The
+    // parse fails on deeper input instead of running out of native stack.
+    virtual ISyntacticParser* SetMaxDepth(int depth) = 0;
+
+    // Parse top-level function definitions with this many threads, 1 for
+    // serial parsing. The tree and errors are the same either way.
+    virtual ISyntacticParser* SetThreads(int threads) = 0;
+
     virtual SyntaxTreePtr Parse() = 0;
+
+    /*
+     * Parse the source again after an edit. Only top-level declarations and
+     * function definitions touched by the edit are lexed and parsed again,
+     * and the others in tree are kept as they are. Source is the whole
+     * source after the edit, and is only preprocessed around the edit.
+     * Tree is updated in place and returned. If the edit cannot be applied
+     * locally, the source is parsed in full, and a new tree is returned.
+     * Either way, the old tree is no longer valid.
+     */
+    virtual SyntaxTreePtr Reparse(SyntaxTreePtr tree, twio::MemoryReaderPtr source, const SourceEdit& edit) = 0;
 };
 
 
@@ -22,6 +22,15 @@ using SyntaxTreePtr = std::shared_ptr<SyntaxTree>;
 class AstVisitor;
 using AstVisitorPtr = AstVisitor*;
 
+class CompactSyntaxTree;
+using CompactSyntaxTreePtr = std::shared_ptr<CompactSyntaxTree>;
+
+class CompactAstVisitor;
+using CompactAstVisitorPtr = CompactAstVisitor*;
+
+class BinarySyntaxTree;
+using BinarySyntaxTreePtr = std::shared_ptr<BinarySyntaxTree>;
+
 TOMIC_END
 
 #endif // _TOMIC_AST_H_
@@ -0,0 +1,355 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_BINARY_SYNTAX_TREE_H_
+#define _TOMIC_BINARY_SYNTAX_TREE_H_
+
+#include <tomic/lexer/token/Token.h>
+#include <tomic/parser/ast/AstForward.h>
+#include <tomic/parser/ast/SyntaxAttribute.h>
+#include <tomic/parser/ast/SyntaxType.h>
+#include <tomic/Shared.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+TOMIC_BEGIN
+
+/*
+ * ==================== Binary AST Format ====================
+ * A binary AST is a header followed by sections of fixed-size records,
+ * each aligned to 8 bytes. Records are in native byte order, which is
+ * marked in the header, so that an image is used as is where it is read.
+ *
+ *   header      BinaryAstHeader
+ *   nodes       BinaryAstNode in preorder, the root is 0
+ *   tokens      BinaryAstToken of terminals
+ *   typed       BinaryAstTypedAttribute, of each node in turn
+ *   named       BinaryAstNamedAttribute, of each node in turn
+ *   strings     lexemes and named attributes, each ends with '\0'
+ *
+ * Links and strings are 32-bit indices and offsets, with NONE for none.
+ * Equal strings are stored once.
+ */
+struct BinaryAstHeader
+{
+    char magic[8];              // "TOMICAST"
+    uint32_t version;
+    uint32_t byteOrder;         // ENDIAN_MARK as written
+
+    uint32_t nodeCount;
+    uint32_t tokenCount;
+    uint32_t typedCount;
+    uint32_t namedCount;
+    uint64_t stringSize;
+
+    // Offsets of sections from the beginning of the image.
+    uint64_t nodes;
+    uint64_t tokens;
+    uint64_t typed;
+    uint64_t named;
+    uint64_t strings;
+
+    static constexpr char MAGIC[8] = { 'T', 'O', 'M', 'I', 'C', 'A', 'S', 'T' };
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_MARK = 0x01020304;
+    static constexpr uint32_t NONE = UINT32_MAX;
+};
+
+
+struct BinaryAstNode
+{
+    uint32_t parent;
+    uint32_t firstChild;
+    uint32_t nextSibling;
+    uint32_t token;             // index of the token, NONE if not terminal
+
+    // Attributes are in [begin, begin + count) of their sections, typed
+    // ones ordered by attribute and named ones by name.
+    uint32_t typedBegin;
+    uint32_t namedBegin;
+    uint16_t namedCount;
+    uint8_t typedCount;
+
+    uint8_t kind;               // Kind below
+    uint32_t type;              // SyntaxType
+
+    enum Kind : uint8_t
+    {
+        NON_TERMINAL,
+        TERMINAL,
+        EPSILON
+    };
+};
+
+
+// Line and char number are resolved when written, so no line index is
+// needed to read them.
+struct BinaryAstToken
+{
+    uint32_t type;              // TokenType
+    uint32_t lexeme;            // offset in strings
+    uint32_t length;
+    uint32_t position;          // Token::NO_POSITION for pseudo tokens
+    int32_t lineNo;
+    int32_t charNo;
+};
+
+
+struct BinaryAstTypedAttribute
+{
+    uint32_t attr;              // SyntaxAttribute
+    int32_t value;
+};
+
+
+struct BinaryAstNamedAttribute
+{
+    uint32_t name;              // offset in strings
+    uint32_t value;             // offset in strings
+};
+
+
+static_assert(sizeof(BinaryAstHeader) == 80, "Unexpected binary AST header size");
+static_assert(sizeof(BinaryAstNode) == 32, "Unexpected binary AST node size");
+static_assert(sizeof(BinaryAstToken) == 24, "Unexpected binary AST token size");
+
+
+/*
+ * A handle to a token in a BinarySyntaxTree.
+ */
+class BinaryToken
+{
+public:
+    BinaryToken() : _tree(nullptr), _record(nullptr) {}
+    BinaryToken(const BinarySyntaxTree* tree, const BinaryAstToken* record) : _tree(tree), _record(record) {}
+
+    explicit operator bool() const { return _record != nullptr; }
+
+    TokenType Type() const { return static_cast<TokenType>(_record->type); }
+    const char* Lexeme() const;
+    uint32_t Length() const { return _record->length; }
+    uint32_t Position() const { return _record->position; }
+    int LineNo() const { return _record->lineNo; }
+    int CharNo() const { return _record->charNo; }
+
+private:
+    const BinarySyntaxTree* _tree;
+    const BinaryAstToken* _record;
+};
+
+
+/*
+ * A handle to a node in BinarySyntaxTree, with the same read-only interface
+ * as CompactSyntaxNode, except that tokens are BinaryToken.
+ */
+class BinarySyntaxNode
+{
+public:
+    BinarySyntaxNode() : _tree(nullptr), _id(0) {}
+    BinarySyntaxNode(const BinarySyntaxTree* tree, uint32_t id) : _tree(tree), _id(id) {}
+
+    explicit operator bool() const { return _tree != nullptr; }
+
+    const BinarySyntaxNode* operator->() const { return this; }
+
+    bool operator==(const BinarySyntaxNode& other) const
+    {
+        return (_tree == other._tree) && (_id == other._id);
+    }
+
+
+    bool operator!=(const BinarySyntaxNode& other) const { return !(*this == other); }
+
+    uint32_t Id() const { return _id; }
+
+    bool IsNonTerminal() const;
+    bool IsTerminal() const;
+    bool IsEpsilon() const;
+
+    SyntaxType Type() const;
+    BinaryToken Token() const;
+
+    bool HasChildren() const;
+    bool HasManyChildren() const;
+
+    BinarySyntaxNode Parent() const;
+    BinarySyntaxNode FirstChild() const;
+    BinarySyntaxNode NextSibling() const;
+
+    // Linear in the number of children, prefer NextSibling.
+    BinarySyntaxNode LastChild() const;
+
+    bool HasAttribute(SyntaxAttribute attr) const;
+    int IntAttribute(SyntaxAttribute attr, int defaultValue = 0) const;
+    bool BoolAttribute(SyntaxAttribute attr, bool defaultValue = false) const;
+
+    bool HasAttribute(const char* name) const;
+    const char* Attribute(const char* name, const char* defaultValue = nullptr) const;
+
+    // Get all attributes as strings, ordered by name.
+    std::vector<std::pair<std::string, std::string>> Attributes() const;
+
+private:
+    const BinaryAstNode& _Record() const;
+
+    const BinarySyntaxTree* _tree;
+    uint32_t _id;
+};
+
+
+/*
+ * BinarySyntaxTree is a read-only view of a binary AST image, which is
+ * usually a file mapped into memory. Nothing is parsed or copied on load,
+ * only the header is checked, so the image must come from Write.
+ * The image is kept by the input stream, which must not be closed.
+ */
+class BinarySyntaxTree
+{
+    friend class BinaryToken;
+    friend class BinarySyntaxNode;
+
+public:
+    BinarySyntaxTree(twio::IInputStreamPtr stream);
+    ~BinarySyntaxTree() = default;
+
+    // Prohibit copying and cloning.
+    BinarySyntaxTree(const BinarySyntaxTree&) = delete;
+    BinarySyntaxTree& operator=(const BinarySyntaxTree&) = delete;
+    BinarySyntaxTree(BinarySyntaxTree&&) = delete;
+    BinarySyntaxTree& operator=(BinarySyntaxTree&&) = delete;
+
+    // Return nullptr if the stream has no contiguous data, or it is not
+    // a binary AST of this version and byte order.
+    static std::shared_ptr<BinarySyntaxTree> New(twio::IInputStreamPtr stream);
+
+    // Map the file, and return nullptr if it is not a valid image.
+    static std::shared_ptr<BinarySyntaxTree> Load(const char* path);
+
+    // Write the image of a tree, in one pass over it.
+    static void Write(const CompactSyntaxTree& tree, twio::IWriterPtr writer);
+
+public:
+    size_t Size() const { return _header->nodeCount; }
+
+    BinarySyntaxNode Root() const { return (Size() == 0) ? BinarySyntaxNode() : Node(0); }
+    BinarySyntaxNode Node(uint32_t id) const { return { this, id }; }
+
+private:
+    static bool _IsValid(const char* data, size_t size);
+
+    twio::IInputStreamPtr _stream;
+
+    const BinaryAstHeader* _header;
+    const BinaryAstNode* _nodes;
+    const BinaryAstToken* _tokens;
+    const BinaryAstTypedAttribute* _typed;
+    const BinaryAstNamedAttribute* _named;
+    const char* _strings;
+};
+
+
+inline const char* BinaryToken::Lexeme() const
+{
+    return _tree->_strings + _record->lexeme;
+}
+
+
+inline const BinaryAstNode& BinarySyntaxNode::_Record() const
+{
+    return _tree->_nodes[_id];
+}
+
+
+inline bool BinarySyntaxNode::IsNonTerminal() const
+{
+    return _Record().kind == BinaryAstNode::NON_TERMINAL;
+}
+
+
+inline bool BinarySyntaxNode::IsTerminal() const
+{
+    return _Record().kind == BinaryAstNode::TERMINAL;
+}
+
+
+inline bool BinarySyntaxNode::IsEpsilon() const
+{
+    return _Record().kind == BinaryAstNode::EPSILON;
+}
+
+
+inline SyntaxType BinarySyntaxNode::Type() const
+{
+    return static_cast<SyntaxType>(_Record().type);
+}
+
+
+inline BinaryToken BinarySyntaxNode::Token() const
+{
+    uint32_t index = _Record().token;
+    return (index == BinaryAstHeader::NONE) ? BinaryToken() : BinaryToken(_tree, _tree->_tokens + index);
+}
+
+
+inline bool BinarySyntaxNode::HasChildren() const
+{
+    return _Record().firstChild != BinaryAstHeader::NONE;
+}
+
+
+inline bool BinarySyntaxNode::HasManyChildren() const
+{
+    return HasChildren() && (_tree->_nodes[_Record().firstChild].nextSibling != BinaryAstHeader::NONE);
+}
+
+
+inline BinarySyntaxNode BinarySyntaxNode::Parent() const
+{
+    uint32_t parent = _Record().parent;
+    return (parent == BinaryAstHeader::NONE) ? BinarySyntaxNode() : _tree->Node(parent);
+}
+
+
+inline BinarySyntaxNode BinarySyntaxNode::FirstChild() const
+{
+    uint32_t child = _Record().firstChild;
+    return (child == BinaryAstHeader::NONE) ? BinarySyntaxNode() : _tree->Node(child);
+}
+
+
+inline BinarySyntaxNode BinarySyntaxNode::NextSibling() const
+{
+    uint32_t next = _Record().nextSibling;
+    return (next == BinaryAstHeader::NONE) ? BinarySyntaxNode() : _tree->Node(next);
+}
+
+
+inline int BinarySyntaxNode::IntAttribute(SyntaxAttribute attr, int defaultValue) const
+{
+    const BinaryAstNode& record = _Record();
+    for (uint32_t i = record.typedBegin; i < record.typedBegin + record.typedCount; i++)
+    {
+        if (_tree->_typed[i].attr == static_cast<uint32_t>(attr))
+        {
+            return _tree->_typed[i].value;
+        }
+    }
+    return defaultValue;
+}
+
+
+inline bool BinarySyntaxNode::BoolAttribute(SyntaxAttribute attr, bool defaultValue) const
+{
+    return IntAttribute(attr, defaultValue ? 1 : 0) != 0;
+}
+
+
+TOMIC_END
+
+#endif // _TOMIC_BINARY_SYNTAX_TREE_H_
@@ -0,0 +1,35 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_COMPACT_AST_VISITOR_H_
+#define _TOMIC_COMPACT_AST_VISITOR_H_
+
+#include <tomic/parser/ast/AstForward.h>
+#include <tomic/parser/ast/CompactSyntaxTree.h>
+#include <tomic/Shared.h>
+
+TOMIC_BEGIN
+
+// The same as AstVisitor, but for CompactSyntaxTree.
+class CompactAstVisitor
+{
+public:
+    virtual ~CompactAstVisitor() = default;
+
+    // Called when enter a syntax node.
+    virtual bool VisitEnter(CompactSyntaxNode node) { return true; }
+
+    // Called when exit a syntax node.
+    virtual bool VisitExit(CompactSyntaxNode node) { return true; }
+
+    // Called when visit a syntax node, usually a terminal one.
+    virtual bool Visit(CompactSyntaxNode node) { return true; }
+};
+
+
+TOMIC_END
+
+#endif // _TOMIC_COMPACT_AST_VISITOR_H_
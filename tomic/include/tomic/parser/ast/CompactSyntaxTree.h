@@ -0,0 +1,266 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_COMPACT_SYNTAX_TREE_H_
+#define _TOMIC_COMPACT_SYNTAX_TREE_H_
+
+#include <tomic/lexer/token/Token.h>
+#include <tomic/parser/ast/AstForward.h>
+#include <tomic/parser/ast/SyntaxAttribute.h>
+#include <tomic/parser/ast/SyntaxType.h>
+#include <tomic/Shared.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+TOMIC_BEGIN
+
+// Index of a node in a CompactSyntaxTree, which is its preorder number.
+using CompactNodeId = uint32_t;
+
+
+/*
+ * A handle to a node in CompactSyntaxTree. It has the same read-only
+ * interface as SyntaxNode, and can be used with ->, so that code reading
+ * the tree can be shared by both representations.
+ */
+class CompactSyntaxNode
+{
+public:
+    CompactSyntaxNode() : _tree(nullptr), _id(0) {}
+    CompactSyntaxNode(const CompactSyntaxTree* tree, CompactNodeId id) : _tree(tree), _id(id) {}
+
+    explicit operator bool() const { return _tree != nullptr; }
+
+    const CompactSyntaxNode* operator->() const { return this; }
+
+    bool operator==(const CompactSyntaxNode& other) const
+    {
+        return (_tree == other._tree) && (_id == other._id);
+    }
+
+
+    bool operator!=(const CompactSyntaxNode& other) const { return !(*this == other); }
+
+    CompactNodeId Id() const { return _id; }
+
+    bool IsNonTerminal() const;
+    bool IsTerminal() const;
+    bool IsEpsilon() const;
+
+    SyntaxType Type() const;
+    TokenPtr Token() const;
+
+    bool HasChildren() const;
+    bool HasManyChildren() const;
+
+    CompactSyntaxNode Parent() const;
+    CompactSyntaxNode FirstChild() const;
+    CompactSyntaxNode NextSibling() const;
+
+    // Linear in the number of children, prefer NextSibling.
+    CompactSyntaxNode LastChild() const;
+
+    bool HasAttribute(SyntaxAttribute attr) const;
+    int IntAttribute(SyntaxAttribute attr, int defaultValue = 0) const;
+    bool BoolAttribute(SyntaxAttribute attr, bool defaultValue = false) const;
+
+    bool HasAttribute(const char* name) const;
+    const char* Attribute(const char* name, const char* defaultValue = nullptr) const;
+
+    // Get all attributes as strings, ordered by name.
+    std::vector<std::pair<std::string, std::string>> Attributes() const;
+
+private:
+    const CompactSyntaxTree* _tree;
+    CompactNodeId _id;
+};
+
+
+/*
+ * CompactSyntaxTree is a read-only copy of a SyntaxTree, whose nodes are
+ * stored as struct of arrays in preorder. So a traversal is a linear scan,
+ * and the children of a node are all in [id + 1, End(id)).
+ *
+ * Links are 32-bit indices instead of pointers, and a node takes about 25
+ * bytes without attributes. Terminals keep token indices into the arena
+ * of the original tree, which is shared.
+ */
+class CompactSyntaxTree
+{
+    friend class CompactSyntaxNode;
+    friend class BinarySyntaxTree;
+
+public:
+    // Convert a SyntaxTree, which can be released afterwards.
+    explicit CompactSyntaxTree(const SyntaxTree& tree);
+    ~CompactSyntaxTree() = default;
+
+    // Prohibit copying and cloning.
+    CompactSyntaxTree(const CompactSyntaxTree&) = delete;
+    CompactSyntaxTree& operator=(const CompactSyntaxTree&) = delete;
+    CompactSyntaxTree(CompactSyntaxTree&&) = delete;
+    CompactSyntaxTree& operator=(CompactSyntaxTree&&) = delete;
+
+    static std::shared_ptr<CompactSyntaxTree> New(SyntaxTreePtr tree);
+
+public:
+    static constexpr CompactNodeId NONE = UINT32_MAX;
+
+    size_t Size() const { return _types.size(); }
+
+    CompactSyntaxNode Root() const { return _types.empty() ? CompactSyntaxNode() : Node(0); }
+    CompactSyntaxNode Node(CompactNodeId id) const { return { this, id }; }
+
+    // One past the last node in the sub-tree of id.
+    CompactNodeId End(CompactNodeId id) const { return _ends[id]; }
+
+    TokenArenaPtr Tokens() const { return _tokens; }
+
+    // Same as SyntaxTree::Accept.
+    bool Accept(CompactAstVisitorPtr visitor) const;
+
+private:
+    enum class NodeKind : uint8_t
+    {
+        NON_TERMINAL,
+        TERMINAL,
+        EPSILON
+    };
+
+
+    struct TypedAttribute
+    {
+        SyntaxAttribute attr;
+        int value;
+    };
+
+
+    CompactNodeId _Append(SyntaxNodePtr node, CompactNodeId parent);
+
+    std::vector<SyntaxType> _types;
+    std::vector<NodeKind> _kinds;
+    std::vector<CompactNodeId> _parents;
+    std::vector<CompactNodeId> _ends;
+
+    // Token index of terminals, NONE for others.
+    std::vector<uint32_t> _tokenIndices;
+    TokenArenaPtr _tokens;
+
+    // Attributes of node id are in [begins[id], begins[id + 1]), typed ones
+    // are ordered by attribute and named ones by name.
+    std::vector<uint32_t> _typedBegins;
+    std::vector<TypedAttribute> _typedAttributes;
+    std::vector<uint32_t> _namedBegins;
+    std::vector<std::pair<std::string, std::string>> _namedAttributes;
+};
+
+
+inline bool CompactSyntaxNode::IsNonTerminal() const
+{
+    return _tree->_kinds[_id] == CompactSyntaxTree::NodeKind::NON_TERMINAL;
+}
+
+
+inline bool CompactSyntaxNode::IsTerminal() const
+{
+    return _tree->_kinds[_id] == CompactSyntaxTree::NodeKind::TERMINAL;
+}
+
+
+inline bool CompactSyntaxNode::IsEpsilon() const
+{
+    return _tree->_kinds[_id] == CompactSyntaxTree::NodeKind::EPSILON;
+}
+
+
+inline SyntaxType CompactSyntaxNode::Type() const
+{
+    return _tree->_types[_id];
+}
+
+
+inline TokenPtr CompactSyntaxNode::Token() const
+{
+    uint32_t index = _tree->_tokenIndices[_id];
+    return (index == CompactSyntaxTree::NONE) ? TokenPtr() : TokenPtr(_tree->_tokens.get(), index);
+}
+
+
+inline bool CompactSyntaxNode::HasChildren() const
+{
+    return _tree->_ends[_id] > _id + 1;
+}
+
+
+inline bool CompactSyntaxNode::HasManyChildren() const
+{
+    return HasChildren() && (_tree->_ends[_id + 1] < _tree->_ends[_id]);
+}
+
+
+inline CompactSyntaxNode CompactSyntaxNode::Parent() const
+{
+    CompactNodeId parent = _tree->_parents[_id];
+    return (parent == CompactSyntaxTree::NONE) ? CompactSyntaxNode() : _tree->Node(parent);
+}
+
+
+inline CompactSyntaxNode CompactSyntaxNode::FirstChild() const
+{
+    return HasChildren() ? _tree->Node(_id + 1) : CompactSyntaxNode();
+}
+
+
+inline CompactSyntaxNode CompactSyntaxNode::NextSibling() const
+{
+    CompactNodeId parent = _tree->_parents[_id];
+    CompactNodeId next = _tree->_ends[_id];
+    if ((parent == CompactSyntaxTree::NONE) || (next >= _tree->_ends[parent]))
+    {
+        return {};
+    }
+    return _tree->Node(next);
+}
+
+
+inline bool CompactSyntaxNode::HasAttribute(SyntaxAttribute attr) const
+{
+    for (uint32_t i = _tree->_typedBegins[_id]; i < _tree->_typedBegins[_id + 1]; i++)
+    {
+        if (_tree->_typedAttributes[i].attr == attr)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+inline int CompactSyntaxNode::IntAttribute(SyntaxAttribute attr, int defaultValue) const
+{
+    for (uint32_t i = _tree->_typedBegins[_id]; i < _tree->_typedBegins[_id + 1]; i++)
+    {
+        if (_tree->_typedAttributes[i].attr == attr)
+        {
+            return _tree->_typedAttributes[i].value;
+        }
+    }
+    return defaultValue;
+}
+
+
+inline bool CompactSyntaxNode::BoolAttribute(SyntaxAttribute attr, bool defaultValue) const
+{
+    return IntAttribute(attr, defaultValue ? 1 : 0) != 0;
+}
+
+
+TOMIC_END
+
+#endif // _TOMIC_COMPACT_SYNTAX_TREE_H_
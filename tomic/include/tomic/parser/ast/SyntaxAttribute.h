@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_SYNTAX_ATTRIBUTE_H_
+#define _TOMIC_SYNTAX_ATTRIBUTE_H_
+
+#include <tomic/Shared.h>
+
+TOMIC_BEGIN
+
+/*
+ * Typed attributes of syntax nodes, which are stored in place as int.
+ * Keep them in alphabetical order of their names, which is the order
+ * printers output attributes.
+ */
+enum class SyntaxAttribute
+{
+    SA_ARGC,
+    SA_BAD,         // bool
+    SA_CONST,       // bool
+    SA_CORRUPTED,   // bool
+    SA_DET,         // bool
+    SA_DIM,
+    SA_GLOBAL,      // bool
+    SA_LOOP,        // bool
+    SA_SIZE,
+    SA_TBL,
+    SA_TYPE,
+    SA_VALUE,
+
+    SA_COUNT
+};
+
+
+inline const char* SyntaxAttributeName(SyntaxAttribute attr)
+{
+    static const char* const NAMES[] = {
+        "argc", "bad", "const", "corrupted", "det", "dim",
+        "global", "loop", "size", "tbl", "type", "value"
+    };
+    static_assert(sizeof(NAMES) / sizeof(NAMES[0]) == static_cast<int>(SyntaxAttribute::SA_COUNT),
+                  "Missing attribute name");
+
+    return NAMES[static_cast<int>(attr)];
+}
+
+
+inline bool IsBoolSyntaxAttribute(SyntaxAttribute attr)
+{
+    switch (attr)
+    {
+    case SyntaxAttribute::SA_BAD:
+    case SyntaxAttribute::SA_CONST:
+    case SyntaxAttribute::SA_CORRUPTED:
+    case SyntaxAttribute::SA_DET:
+    case SyntaxAttribute::SA_GLOBAL:
+    case SyntaxAttribute::SA_LOOP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+TOMIC_END
+
+#endif // _TOMIC_SYNTAX_ATTRIBUTE_H_
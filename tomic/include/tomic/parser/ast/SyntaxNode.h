@@ -13,11 +13,14 @@
 
 #include <tomic/lexer/token/Token.h>
 #include <tomic/parser/ast/AstForward.h>
+#include <tomic/parser/ast/SyntaxAttribute.h>
 #include <tomic/parser/ast/SyntaxType.h>
 #include <tomic/Shared.h>
 
+#include <cstdint>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 TOMIC_BEGIN
@@ -25,6 +28,7 @@ TOMIC_BEGIN
 class SyntaxNode
 {
     friend class SyntaxTree;
+    friend class CompactSyntaxTree;
 
 public:
     bool IsNonTerminal() const { return _nodeType == SyntaxNodeType::NON_TERMINAL; }
@@ -68,31 +72,67 @@ private:
 
     /*
      * ==================== AST Attributes ====================
+     * Int and bool attributes are typed, and are stored in place. Other
+     * attributes are strings, e.g. names, which are stored in a map.
      */
 public:
+    bool HasAttribute(SyntaxAttribute attr) const { return _slotMask & _Bit(attr); }
+
+    // Get the attribute value, or defaultValue if not found.
+    int IntAttribute(SyntaxAttribute attr, int defaultValue = 0) const
+    {
+        return HasAttribute(attr) ? _slots[static_cast<int>(attr)] : defaultValue;
+    }
+
+
+    bool BoolAttribute(SyntaxAttribute attr, bool defaultValue = false) const
+    {
+        return HasAttribute(attr) ? (_slots[static_cast<int>(attr)] != 0) : defaultValue;
+    }
+
+
+    bool QueryIntAttribute(SyntaxAttribute attr, int* value, int defaultValue = 0) const;
+    bool QueryBoolAttribute(SyntaxAttribute attr, bool* value, bool defaultValue = false) const;
+
+    SyntaxNodePtr SetIntAttribute(SyntaxAttribute attr, int value)
+    {
+        _slots[static_cast<int>(attr)] = value;
+        _slotMask |= _Bit(attr);
+        return this;
+    }
+
+
+    SyntaxNodePtr SetBoolAttribute(SyntaxAttribute attr, bool value)
+    {
+        return SetIntAttribute(attr, value ? 1 : 0);
+    }
+
+
+    SyntaxNodePtr RemoveAttribute(SyntaxAttribute attr)
+    {
+        _slotMask &= ~_Bit(attr);
+        return this;
+    }
+
+
     bool HasAttribute(const char* name) const;
 
     // Get the attribute value, or defaultValue if not found.
     const char* Attribute(const char* name, const char* defaultValue = nullptr) const;
-    int IntAttribute(const char* name, int defaultValue = 0) const;
-    bool BoolAttribute(const char* name, bool defaultValue = false) const;
-
     bool QueryAttribute(const char* name, const char** value, const char* defaultValue = nullptr) const;
-    bool QueryIntAttribute(const char* name, int* value, int defaultValue = 0) const;
-    bool QueryBoolAttribute(const char* name, bool* value, bool defaultValue = false) const;
 
     // Set the attribute value.
     SyntaxNodePtr SetAttribute(const char* name, const char* value);
-    SyntaxNodePtr SetIntAttribute(const char* name, int value);
-    SyntaxNodePtr SetBoolAttribute(const char* name, bool value);
 
     // Remove the attribute.
     SyntaxNodePtr RemoveAttribute(const char* name);
 
-    // Get all attributes.
-    const std::map<std::string, std::string>& Attributes() const { return _attributes; }
+    // Get all attributes as strings, ordered by name.
+    std::vector<std::pair<std::string, std::string>> Attributes() const;
 
 private:
+    static uint16_t _Bit(SyntaxAttribute attr) { return static_cast<uint16_t>(1u << static_cast<int>(attr)); }
+
     bool _FindAttribute(const char* name, std::map<std::string, std::string>::iterator* attr);
     bool _FindOrCreateAttribute(const char* name, std::map<std::string, std::string>::iterator* attr);
 
@@ -126,6 +166,12 @@ protected:
     // AST properties.
     SyntaxType _type;
     TokenPtr _token;
+
+    // Typed attributes, only those in the mask are set.
+    static_assert(static_cast<int>(SyntaxAttribute::SA_COUNT) <= 16, "Too many typed attributes");
+    int _slots[static_cast<int>(SyntaxAttribute::SA_COUNT)];
+    uint16_t _slotMask;
+
     std::map<std::string, std::string> _attributes;
 
 private:
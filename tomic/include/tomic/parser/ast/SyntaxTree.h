@@ -12,7 +12,7 @@
 #include <tomic/parser/ast/SyntaxType.h>
 
 #include <memory>
-#include <unordered_set>
+#include <vector>
 
 TOMIC_BEGIN
 
@@ -23,11 +23,19 @@ TOMIC_BEGIN
  * smart pointer are not used here.
  * Although under ast directory, it is actually not an AST, since it contains all
  * non-terminal nodes. But I guess it is OK to treat it as an AST. :?
+ *
+ * Nodes are allocated from slabs in allocation order, so they are close to
+ * each other in memory, and are released with the slabs all at once.
+ * Deleted nodes are recycled by a free list.
+ *
+ * A tree is not thread-safe. To build one with several threads, each thread
+ * allocates nodes from its own fork, whose nodes already belong to the tree
+ * and can be linked to it. The tree takes over the slabs of a fork on Join.
  */
 class SyntaxTree
 {
 public:
-    SyntaxTree() = default;
+    SyntaxTree();
     ~SyntaxTree();
 
     // Prohibit copying and cloning.
@@ -47,17 +55,51 @@ public:
 
     void DeleteNode(SyntaxNodePtr node);
 
+    // A tree of no root sharing the tokens of this one, whose nodes are
+    // created for this one. Nodes of different forks can be created at the
+    // same time, but each fork must only be used by one thread at a time.
+    std::shared_ptr<SyntaxTree> Fork();
+
+    // Take over all nodes of the fork, which must not be used afterwards.
+    // Must not run at the same time as the fork or this tree is used.
+    void Join(SyntaxTree& fork);
+
     SyntaxNodePtr Root() const { return _root; }
     SyntaxNodePtr SetRoot(SyntaxNodePtr root);
 
+    // Terminal nodes only keep handles to tokens, so the tree has to keep
+    // the arena alive.
+    TokenArenaPtr Tokens() const { return _tokens; }
+    SyntaxTree* SetTokens(TokenArenaPtr tokens);
+
     // For visitor pattern. A utility function to traverse the tree.
     bool Accept(AstVisitorPtr visitor);
 
 private:
+    void* _Allocate();
+    void _Free(SyntaxNodePtr node);
     void _ClearUp();
 
     SyntaxNodePtr _root;
-    std::unordered_set<SyntaxNodePtr> _nodes;
+    TokenArenaPtr _tokens;
+
+    // The tree nodes are created for, itself unless it is a fork.
+    SyntaxTree* _owner;
+
+    // Each slab holds SLAB_SIZE nodes, and the first used ones are taken.
+    // Slabs taken over from forks may not be full.
+    struct Slab
+    {
+        std::unique_ptr<unsigned char[]> storage;
+        size_t used;
+    };
+
+
+    static constexpr size_t SLAB_SIZE = 4096;
+    std::vector<Slab> _slabs;
+
+    // Free list of deleted nodes, linked through their storage.
+    void* _free;
 };
 
 
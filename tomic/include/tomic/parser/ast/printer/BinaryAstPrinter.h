@@ -0,0 +1,33 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_BINARY_AST_PRINTER_H_
+#define _TOMIC_BINARY_AST_PRINTER_H_
+
+#include <tomic/parser/ast/AstForward.h>
+#include <tomic/parser/ast/printer/IAstPrinter.h>
+#include <tomic/Shared.h>
+
+TOMIC_BEGIN
+
+/*
+ * Print the AST as a binary image, which can be mapped back by
+ * BinarySyntaxTree. All nodes are kept, whatever the syntax mapper.
+ */
+class BinaryAstPrinter : public IAstPrinter
+{
+public:
+    BinaryAstPrinter() = default;
+    ~BinaryAstPrinter() override = default;
+
+    void Print(SyntaxTreePtr tree, twio::IWriterPtr writer) override;
+    void Print(CompactSyntaxTreePtr tree, twio::IWriterPtr writer) override;
+};
+
+
+TOMIC_END
+
+#endif // _TOMIC_BINARY_AST_PRINTER_H_
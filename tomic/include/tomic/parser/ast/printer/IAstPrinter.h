@@ -14,6 +14,7 @@
 #ifndef _TOMIC_AST_PRINTER_H_
 #define _TOMIC_AST_PRINTER_H_
 
+#include <tomic/parser/ast/AstForward.h>
 #include <tomic/Shared.h>
 
 #include <memory>
@@ -27,6 +28,7 @@ public:
     virtual ~IAstPrinter() = default;
 
     virtual void Print(SyntaxTreePtr tree, twio::IWriterPtr writer) = 0;
+    virtual void Print(CompactSyntaxTreePtr tree, twio::IWriterPtr writer) = 0;
 };
 
 
@@ -9,6 +9,7 @@
 
 #include <tomic/lexer/token/ITokenMapper.h>
 #include <tomic/parser/ast/AstVisitor.h>
+#include <tomic/parser/ast/CompactAstVisitor.h>
 #include <tomic/parser/ast/mapper/ISyntaxMapper.h>
 #include <tomic/parser/ast/printer/IAstPrinter.h>
 #include <tomic/Shared.h>
@@ -19,22 +20,32 @@ TOMIC_BEGIN
  * This one is for the barnacle online judge. It shows how powerful
  * Dependency Injection is. Just so easy for the pluggable design.
  */
-class StandardAstPrinter : public IAstPrinter, private AstVisitor
+class StandardAstPrinter : public IAstPrinter, private AstVisitor, private CompactAstVisitor
 {
 public:
     StandardAstPrinter(ISyntaxMapperPtr syntaxMapperPtr, ITokenMapperPtr tokenMapper);
     ~StandardAstPrinter() override = default;
 
     void Print(SyntaxTreePtr tree, twio::IWriterPtr writer) override;
+    void Print(CompactSyntaxTreePtr tree, twio::IWriterPtr writer) override;
 
 private:
     bool VisitEnter(SyntaxNodePtr node) override;
     bool VisitExit(SyntaxNodePtr node) override;
     bool Visit(SyntaxNodePtr node) override;
 
-    void _VisitNonTerminal(SyntaxNodePtr node);
-    void _VisitTerminal(SyntaxNodePtr node);
-    void _VisitEpsilon(SyntaxNodePtr node);
+    bool VisitEnter(CompactSyntaxNode node) override;
+    bool VisitExit(CompactSyntaxNode node) override;
+    bool Visit(CompactSyntaxNode node) override;
+
+    // TNode is either SyntaxNodePtr or CompactSyntaxNode.
+    template<typename TNode> bool _VisitEnter(TNode node);
+    template<typename TNode> bool _VisitExit(TNode node);
+    template<typename TNode> bool _Visit(TNode node);
+
+    template<typename TNode> void _VisitNonTerminal(TNode node);
+    template<typename TNode> void _VisitTerminal(TNode node);
+    template<typename TNode> void _VisitEpsilon(TNode node);
 
     twio::IWriterPtr _writer;
     ISyntaxMapperPtr _syntaxMapper;
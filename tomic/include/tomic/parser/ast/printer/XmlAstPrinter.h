@@ -10,33 +10,46 @@
 #include <tomic/lexer/token/ITokenMapper.h>
 #include <tomic/parser/ast/AstForward.h>
 #include <tomic/parser/ast/AstVisitor.h>
+#include <tomic/parser/ast/CompactAstVisitor.h>
 #include <tomic/parser/ast/mapper/ISyntaxMapper.h>
 #include <tomic/parser/ast/printer/IAstPrinter.h>
+#include <tomic/utils/OutputBuffer.h>
 #include <tomic/Shared.h>
 
 TOMIC_BEGIN
 
-class XmlAstPrinter : public IAstPrinter, private AstVisitor
+class XmlAstPrinter : public IAstPrinter, private AstVisitor, private CompactAstVisitor
 {
 public:
     XmlAstPrinter(ISyntaxMapperPtr syntaxMapperPtr, ITokenMapperPtr tokenMapper);
     ~XmlAstPrinter() override = default;
 
     void Print(SyntaxTreePtr tree, twio::IWriterPtr writer) override;
+    void Print(CompactSyntaxTreePtr tree, twio::IWriterPtr writer) override;
 
 private:
     bool VisitEnter(SyntaxNodePtr node) override;
     bool VisitExit(SyntaxNodePtr node) override;
     bool Visit(SyntaxNodePtr node) override;
 
-    void _VisitNonTerminal(SyntaxNodePtr node);
-    void _VisitTerminal(SyntaxNodePtr node);
-    void _VisitEpsilon(SyntaxNodePtr node);
+    bool VisitEnter(CompactSyntaxNode node) override;
+    bool VisitExit(CompactSyntaxNode node) override;
+    bool Visit(CompactSyntaxNode node) override;
 
+    // TNode is either SyntaxNodePtr or CompactSyntaxNode.
+    template<typename TNode> bool _VisitEnter(TNode node);
+    template<typename TNode> bool _VisitExit(TNode node);
+    template<typename TNode> bool _Visit(TNode node);
+
+    template<typename TNode> void _VisitNonTerminal(TNode node);
+    template<typename TNode> void _VisitTerminal(TNode node);
+    template<typename TNode> void _VisitEpsilon(TNode node);
+
+    template<typename TNode> void _PrintAttributes(TNode node);
     void _PrintIndent(int depth);
 
 private:
-    twio::IWriterPtr _writer;
+    OutputBuffer _out;
     ISyntaxMapperPtr _syntaxMapper;
     ITokenMapperPtr _tokenMapper;
     int _depth;
@@ -0,0 +1,36 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_GRAMMAR_H_
+#define _TOMIC_GRAMMAR_H_
+
+#include <tomic/parser/ast/SyntaxType.h>
+#include <tomic/parser/grammar/TokenSet.h>
+#include <tomic/Shared.h>
+
+TOMIC_BEGIN
+
+/*
+ * The grammar of SysY that the syntactic parsers follow. FIRST and FOLLOW
+ * sets of its non-terminals are computed from the productions at compile
+ * time, see Grammar.cpp.
+ * Parsers use FIRST sets to choose productions, and FOLLOW sets tell where
+ * a construct may end, which is where error recovery can resume.
+ */
+class Grammar
+{
+public:
+    static TokenSet First(SyntaxType type);
+    static TokenSet Follow(SyntaxType type);
+
+    // Whether the non-terminal can derive epsilon.
+    static bool IsNullable(SyntaxType type);
+};
+
+
+TOMIC_END
+
+#endif // _TOMIC_GRAMMAR_H_
@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_TOKEN_SET_H_
+#define _TOMIC_TOKEN_SET_H_
+
+#include <tomic/lexer/token/Token.h>
+#include <tomic/Shared.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+TOMIC_BEGIN
+
+constexpr int TOKEN_TYPE_COUNT = static_cast<int>(TokenType::TK_RIGHT_BRACKET) + 1;
+
+
+/*
+ * A set of token types as a bit mask, so that testing a token against a
+ * FIRST or FOLLOW set is a single bit test.
+ */
+class TokenSet
+{
+public:
+    constexpr TokenSet() : _bits(0) {}
+
+    constexpr TokenSet(std::initializer_list<TokenType> types) : _bits(0)
+    {
+        for (auto type : types)
+        {
+            _bits |= _Bit(type);
+        }
+    }
+
+
+    constexpr bool Contains(TokenType type) const { return (_bits & _Bit(type)) != 0; }
+    bool Contains(const TokenPtr& token) const { return Contains(Token::Type(token)); }
+
+    constexpr bool Empty() const { return _bits == 0; }
+
+    constexpr TokenSet operator|(const TokenSet& other) const
+    {
+        TokenSet set;
+        set._bits = _bits | other._bits;
+        return set;
+    }
+
+
+    constexpr TokenSet& operator|=(const TokenSet& other)
+    {
+        _bits |= other._bits;
+        return *this;
+    }
+
+
+    // Token types in this set but not in the other.
+    constexpr TokenSet operator-(const TokenSet& other) const
+    {
+        TokenSet set;
+        set._bits = _bits & ~other._bits;
+        return set;
+    }
+
+
+    constexpr bool operator==(const TokenSet& other) const { return _bits == other._bits; }
+    constexpr bool operator!=(const TokenSet& other) const { return _bits != other._bits; }
+
+    // Token types in the set, in the order of TokenType.
+    std::vector<TokenType> Types() const
+    {
+        std::vector<TokenType> types;
+        for (int i = 0; i < TOKEN_TYPE_COUNT; i++)
+        {
+            if (Contains(static_cast<TokenType>(i)))
+            {
+                types.push_back(static_cast<TokenType>(i));
+            }
+        }
+        return types;
+    }
+
+
+private:
+    static constexpr uint64_t _Bit(TokenType type)
+    {
+        return static_cast<uint64_t>(1) << static_cast<int>(type);
+    }
+
+
+    static_assert(TOKEN_TYPE_COUNT <= 64, "Too many token types for TokenSet");
+
+    uint64_t _bits;
+};
+
+
+TOMIC_END
+
+#endif // _TOMIC_TOKEN_SET_H_
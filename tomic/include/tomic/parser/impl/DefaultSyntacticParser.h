@@ -13,6 +13,7 @@
 #include <tomic/parser/ast/mapper/ISyntaxMapper.h>
 #include <tomic/parser/ast/SyntaxNode.h>
 #include <tomic/parser/ast/SyntaxTree.h>
+#include <tomic/parser/grammar/TokenSet.h>
 #include <tomic/parser/ISyntacticParser.h>
 #include <tomic/Shared.h>
 
@@ -34,8 +35,11 @@ public:
     ~DefaultSyntacticParser() override = default;
 
     DefaultSyntacticParser* SetReader(twio::IAdvancedReaderPtr reader) override;
+    DefaultSyntacticParser* SetMaxDepth(int depth) override;
+    DefaultSyntacticParser* SetThreads(int threads) override;
 
     SyntaxTreePtr Parse() override;
+    SyntaxTreePtr Reparse(SyntaxTreePtr tree, twio::MemoryReaderPtr source, const SourceEdit& edit) override;
 
 private:
     ILexicalParserPtr _lexicalParser;
@@ -48,6 +52,44 @@ private:
     // set may happen, so we make it int, and use it as a counter.
     int _tryParse;
 
+    /*
+     * Packrat memo of sub-trees parsed in try-parse mode, keyed by syntax
+     * type and starting token, so that an alternative tried after a rollback
+     * can reuse them instead of parsing again. It is indexed by the token
+     * offset from _memoBase, where try-parse starts, and keeps one entry per
+     * token. Failed sub-trees are kept in _discarded until try-parse ends,
+     * as memorized nodes may be inside.
+     */
+    struct MemoEntry
+    {
+        SyntaxType type = SyntaxType::ST_UNKNOWN;
+        SyntaxNodePtr node = nullptr;
+        int end = 0;
+    };
+
+
+    std::vector<MemoEntry> _memo;
+    int _memoBase;
+    std::vector<SyntaxNodePtr> _discarded;
+
+    // Nesting depth of statements, expressions and initializers, which
+    // bounds the depth of recursion. Once it exceeds _maxDepth, the parse
+    // fails all the way up.
+    int _depth;
+    int _maxDepth;
+    bool _depthExceeded;
+
+    // Increase nesting depth in its lifetime.
+    class NestingScope
+    {
+    public:
+        NestingScope(int* depth) : _depth(depth) { (*_depth)++; }
+        ~NestingScope() { (*_depth)--; }
+
+    private:
+        int* _depth;
+    };
+
 private:
     // Return current token.
     TokenPtr _Current();
@@ -57,18 +99,26 @@ private:
     // n must greater than 0!
     TokenPtr _Lookahead(int n = 1);
     bool _Match(TokenType type, TokenPtr token);
-    bool _MatchAny(const std::vector<TokenType>& types, TokenPtr token);
+    bool _MatchAny(const TokenSet& types, TokenPtr token);
     void _PostParseError(int checkpoint, SyntaxNodePtr node);
 
     void _SetTryParse(bool tryParse);
     bool _IsTryParse() const { return _tryParse > 0; }
 
+    // Reuse the memorized sub-tree at checkpoint, and skip its tokens.
+    SyntaxNodePtr _Recall(SyntaxType type, int checkpoint);
+    SyntaxNodePtr _Memorize(SyntaxType type, int checkpoint, SyntaxNodePtr node);
+    void _ClearMemo();
+
+    // Return false if nesting is too deep.
+    bool _CheckDepth();
+
     void _Log(LogLevel level, TokenPtr position, const char* format, ...);
     void _Log(LogLevel level, TokenPtr position, const char* format, va_list argv);
     void _Log(LogLevel level, const char* format, ...);
     void _LogFailedToParse(SyntaxType type, LogLevel level = LogLevel::INFO);
     void _LogExpect(TokenType expected, LogLevel level = LogLevel::ERROR);
-    void _LogExpect(const std::vector<TokenType>& expected, LogLevel level = LogLevel::ERROR);
+    void _LogExpect(const TokenSet& expected, LogLevel level = LogLevel::ERROR);
     void _LogExpectAfter(TokenType expected, LogLevel level = LogLevel::ERROR);
 
 private:
@@ -125,9 +175,6 @@ private:
     SyntaxNodePtr _ParseExp();
     SyntaxNodePtr _ParseConstExp();
     SyntaxNodePtr _ParseAddExp();
-    SyntaxNodePtr _ParseAddExpAux();
-    SyntaxNodePtr _ParseMulExp();
-    SyntaxNodePtr _ParseMulExpAux();
     SyntaxNodePtr _ParseUnaryExp();
     SyntaxNodePtr _ParseUnaryOp();
     SyntaxNodePtr _ParsePrimaryExp();
@@ -135,13 +182,9 @@ private:
     SyntaxNodePtr _ParseNumber();
 
     SyntaxNodePtr _ParseOrExp();
-    SyntaxNodePtr _ParseOrExpAux();
-    SyntaxNodePtr _ParseAndExp();
-    SyntaxNodePtr _ParseAndExpAux();
-    SyntaxNodePtr _ParseEqExp();
-    SyntaxNodePtr _ParseEqExpAux();
-    SyntaxNodePtr _ParseRelExp();
-    SyntaxNodePtr _ParseRelExpAux();
+
+    // OrExp, AndExp, EqExp, RelExp, AddExp and MulExp.
+    SyntaxNodePtr _ParseBinaryExp(int level);
 };
 
 
@@ -10,13 +10,20 @@
 #include <tomic/lexer/ILexicalParser.h>
 #include <tomic/lexer/token/ITokenMapper.h>
 #include <tomic/logger/debug/ILogger.h>
+#include <tomic/logger/debug/impl/BufferedLogger.h>
 #include <tomic/logger/error/IErrorLogger.h>
+#include <tomic/logger/error/impl/BufferedErrorLogger.h>
 #include <tomic/parser/ast/mapper/ISyntaxMapper.h>
 #include <tomic/parser/ast/SyntaxNode.h>
 #include <tomic/parser/ast/SyntaxTree.h>
+#include <tomic/parser/grammar/TokenSet.h>
 #include <tomic/parser/ISyntacticParser.h>
+#include <tomic/utils/ThreadPool.h>
 #include <tomic/Shared.h>
 
+#include <future>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 TOMIC_BEGIN
@@ -33,8 +40,11 @@ public:
     ~ResilientSyntacticParser() override = default;
 
     ResilientSyntacticParser* SetReader(twio::IAdvancedReaderPtr reader) override;
+    ResilientSyntacticParser* SetMaxDepth(int depth) override;
+    ResilientSyntacticParser* SetThreads(int threads) override;
 
     SyntaxTreePtr Parse() override;
+    SyntaxTreePtr Reparse(SyntaxTreePtr tree, twio::MemoryReaderPtr source, const SourceEdit& edit) override;
 
 private:
     ILexicalParserPtr _lexicalParser;
@@ -49,6 +59,101 @@ private:
     // set may happen, so we make it int, and use it as a counter.
     int _tryParse;
 
+    /*
+     * Packrat memo of sub-trees parsed in try-parse mode, keyed by syntax
+     * type and starting token, so that an alternative tried after a rollback
+     * can reuse them instead of parsing again. It is indexed by the token
+     * offset from _memoBase, where try-parse starts, and keeps one entry per
+     * token. Failed sub-trees are kept in _discarded until try-parse ends,
+     * as memorized nodes may be inside.
+     */
+    struct MemoEntry
+    {
+        SyntaxType type = SyntaxType::ST_UNKNOWN;
+        SyntaxNodePtr node = nullptr;
+        int end = 0;
+    };
+
+
+    std::vector<MemoEntry> _memo;
+    int _memoBase;
+    std::vector<SyntaxNodePtr> _discarded;
+
+    // Nesting depth of statements, expressions and initializers, which
+    // bounds the depth of recursion. Once it exceeds _maxDepth, the parse
+    // fails all the way up.
+    int _depth;
+    int _maxDepth;
+    bool _depthExceeded;
+
+    // Increase nesting depth in its lifetime.
+    class NestingScope
+    {
+    public:
+        NestingScope(int* depth) : _depth(depth) { (*_depth)++; }
+        ~NestingScope() { (*_depth)--; }
+
+    private:
+        int* _depth;
+    };
+
+    /*
+     * Panic-mode recovery. When a block item or a global declaration fails,
+     * tokens are skipped to the next statement or declaration boundary, and
+     * parsing goes on from there. _recoveryCost counts tokens rolled back by
+     * failures outside try-parse, that is, tokens to be read again. Recovery
+     * gives up once it exceeds a budget proportional to the tokens read, so
+     * that the parse stays linear on any input.
+     */
+    int _recoveryCost;
+    bool _recoveryExhausted;
+
+    // Top-level nodes of the last tree, in source order, so that those
+    // touched by an edit can be found by binary search.
+    std::weak_ptr<SyntaxTree> _itemsTree;
+    std::vector<SyntaxNodePtr> _items;
+    // Recovery cost of the last tree, see _recoveryCost.
+    int _itemsCost;
+    // Whether the last tree has a quote in an unknown token, in which case
+    // edits are always parsed in full.
+    bool _strayQuote;
+
+    /*
+     * Parallel parse. Top-level function definitions are found by matching
+     * braces in advance, and each one is parsed by a worker parser on the
+     * thread pool, into a fork of the tree. The serial parse takes them in
+     * order where it would parse them itself, so errors are also reported
+     * in order. A span is only taken if it is sure to be parsed the same
+     * as by the serial parse, or it is parsed again.
+     */
+    struct Span
+    {
+        int begin;      // index of the first token
+        int end;        // index past the last token
+
+        // Results, only valid once done.
+        SyntaxNodePtr node;
+        int cost;
+        BufferedErrorLoggerPtr errors;
+        BufferedLoggerPtr logs;
+        std::future<void> done;
+    };
+
+
+    int _threads;
+    ThreadPoolPtr _pool;
+    std::vector<Span> _spans;
+    size_t _nextSpan;
+
+    // Forks of the tree, and those not used by any worker now.
+    std::vector<SyntaxTreePtr> _forks;
+    std::vector<SyntaxTreePtr> _idleForks;
+    std::mutex _forkMutex;
+
+    // Pseudo tokens are shared in a tree, one for each type, so that no
+    // token is added to the arena while workers are running.
+    std::vector<TokenPtr> _pseudoTokens;
+
 private:
     // Return current token.
     TokenPtr _Current();
@@ -58,18 +163,26 @@ private:
     // n must greater than 0!
     TokenPtr _Lookahead(int n = 1);
     bool _Match(TokenType type, TokenPtr token);
-    bool _MatchAny(const std::vector<TokenType>& types, TokenPtr token);
+    bool _MatchAny(const TokenSet& types, TokenPtr token);
     void _PostParseError(int checkpoint, SyntaxNodePtr node);
 
     void _SetTryParse(bool tryParse);
     bool _IsTryParse() const { return _tryParse > 0; }
 
+    // Reuse the memorized sub-tree at checkpoint, and skip its tokens.
+    SyntaxNodePtr _Recall(SyntaxType type, int checkpoint);
+    SyntaxNodePtr _Memorize(SyntaxType type, int checkpoint, SyntaxNodePtr node);
+    void _ClearMemo();
+
+    // Return false if nesting is too deep.
+    bool _CheckDepth();
+
     void _Log(LogLevel level, TokenPtr position, const char* format, ...);
     void _Log(LogLevel level, TokenPtr position, const char* format, va_list argv);
     void _Log(LogLevel level, const char* format, ...);
     void _LogFailedToParse(SyntaxType type, LogLevel level = LogLevel::INFO);
     void _LogExpect(TokenType expected, LogLevel level = LogLevel::ERROR);
-    void _LogExpect(const std::vector<TokenType>& expected, LogLevel level = LogLevel::ERROR);
+    void _LogExpect(const TokenSet& expected, LogLevel level = LogLevel::ERROR);
     void _LogExpectAfter(TokenType expected, LogLevel level = LogLevel::ERROR);
 
     // Try to recover from missing token.
@@ -77,10 +190,41 @@ private:
     void _RecoverFromMissingToken(SyntaxNodePtr node, TokenType expected);
     void _MarkCorrupted(SyntaxNodePtr node);
 
+    // Skip at least one token, and then to the next one in syncSet or past
+    // the next ';', at the same brace level. Return false if recovery is
+    // not possible, and nothing is skipped.
+    bool _Synchronize(const TokenSet& syncSet);
+
+    void _Reset();
+    void _IndexItems(SyntaxTreePtr tree);
+
+    // Lex and parse again top-level nodes touched by the edit, and splice
+    // them into tree. Return false if the edit cannot be applied locally.
+    bool _Reparse(SyntaxTreePtr tree, twio::MemoryReaderPtr source, const SourceEdit& edit);
+
+    TokenPtr _PseudoToken(TokenType type);
+
+    // Find and submit spans, return false if not worth it.
+    bool _StartSpans();
+    void _Prescan(const std::vector<TokenPtr>& tokens, int begin);
+    // Run on a worker thread.
+    void _ParseSpan(Span* span, const std::vector<TokenPtr>& tokens);
+    // The FuncDef at current token, or nullptr if it is to be parsed here.
+    SyntaxNodePtr _TakeSpan();
+    // Wait for all workers, and take over their nodes.
+    void _JoinSpans();
+
 private:
     SyntaxNodePtr _ParseCompUnit();
     bool _MatchDecl();
     bool _MatchFuncDef();
+    bool _MatchMainFuncDef();
+
+    // Parse Decl, FuncDef and MainFuncDef until EOF, MainFuncDef, or a
+    // token starting at or after end. funcDefs tells whether Decl is no
+    // longer parsed, and is updated on return. Return false if they cannot
+    // be parsed even with recovery.
+    bool _ParseCompUnitItems(std::vector<SyntaxNodePtr>* items, size_t end, bool* funcDefs);
 
     ////////// Decl
     SyntaxNodePtr _ParseDecl();
@@ -133,9 +277,6 @@ private:
     SyntaxNodePtr _ParseExp();
     SyntaxNodePtr _ParseConstExp();
     SyntaxNodePtr _ParseAddExp();
-    SyntaxNodePtr _ParseAddExpAux();
-    SyntaxNodePtr _ParseMulExp();
-    SyntaxNodePtr _ParseMulExpAux();
     SyntaxNodePtr _ParseUnaryExp();
     SyntaxNodePtr _ParseUnaryOp();
     SyntaxNodePtr _ParsePrimaryExp();
@@ -143,13 +284,9 @@ private:
     SyntaxNodePtr _ParseNumber();
 
     SyntaxNodePtr _ParseOrExp();
-    SyntaxNodePtr _ParseOrExpAux();
-    SyntaxNodePtr _ParseAndExp();
-    SyntaxNodePtr _ParseAndExpAux();
-    SyntaxNodePtr _ParseEqExp();
-    SyntaxNodePtr _ParseEqExpAux();
-    SyntaxNodePtr _ParseRelExp();
-    SyntaxNodePtr _ParseRelExpAux();
+
+    // OrExp, AndExp, EqExp, RelExp, AddExp and MulExp.
+    SyntaxNodePtr _ParseBinaryExp(int level);
 };
 
 
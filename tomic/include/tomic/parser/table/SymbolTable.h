@@ -11,16 +11,16 @@
 #include <tomic/Shared.h>
 
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 TOMIC_BEGIN
 
 class SymbolTable
 {
 public:
-    SymbolTable() : _nextId(0)
-    {
-    }
+    SymbolTable() = default;
 
 
     ~SymbolTable() = default;
@@ -39,9 +39,18 @@ public:
 
     SymbolTableBlockPtr GetBlock(int id) const;
 
+    /*
+     * Names are interned as symbol ids, so that blocks index entries by
+     * id, and a name is hashed once per lookup however deep the scope is.
+     * FindSymbol returns -1 if the name is not in any block.
+     */
+    int InternSymbol(const std::string& name);
+    int FindSymbol(const std::string& name) const;
+
 private:
-    std::unordered_map<int, SymbolTableBlockSmartPtr> _blocks;
-    int _nextId;
+    // Block ids are allocated in turn, so they index the blocks.
+    std::vector<SymbolTableBlockSmartPtr> _blocks;
+    std::unordered_map<std::string, int> _symbols;
 };
 
 
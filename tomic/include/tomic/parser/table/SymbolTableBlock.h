@@ -12,7 +12,7 @@
 
 #include <memory>
 #include <string>
-#include <vector>
+#include <unordered_map>
 
 TOMIC_BEGIN
 
@@ -26,10 +26,12 @@ public:
     int Id() const { return _id; }
     SymbolTableBlockPtr Parent() const { return _parent; }
 
-    // Warning: Add entry do not check legality.
+    // Warning: Add entry do not check legality. If the name is already
+    // in this block, the first entry is kept. Do not alter the name of an
+    // entry once it is added.
     SymbolTableBlockPtr AddEntry(SymbolTableEntryPtr entry);
 
-    // Find entry in this block and its ancestors.
+    // Find entry in this block and its ancestors, one probe per block.
     SymbolTableEntryPtr FindEntry(const std::string& name) const;
     // Find entry in this block only.
     SymbolTableEntryPtr FindLocalEntry(const std::string& name) const;
@@ -47,13 +49,16 @@ private:
         return std::shared_ptr<SymbolTableBlock>(new SymbolTableBlock(id, table, parent));
     }
 
+    SymbolTableEntryPtr _FindLocalEntry(int symbol) const;
+
 private:
     int _id;
 
     SymbolTable* _table;
     SymbolTableBlockPtr _parent;
 
-    std::vector<SymbolTableEntryPtr> _entries;
+    // Indexed by symbol id of the table.
+    std::unordered_map<int, SymbolTableEntryPtr> _entries;
 };
 
 
@@ -211,6 +211,15 @@ public:
     int Value(int index) const { return _props.values[0][index]; }
     int Value(int index1, int index2) const { return _props.values[index1][index2]; }
 
+    // Whether the index is within the values, which may be out of bounds
+    // in an erroneous source.
+    bool HasValue(int index) const { return HasValue(0, index); }
+    bool HasValue(int index1, int index2) const
+    {
+        return (index1 >= 0) && (index1 < static_cast<int>(_props.values.size())) &&
+            (index2 >= 0) && (index2 < static_cast<int>(_props.values[index1].size()));
+    }
+
 private:
     ConstantEntry(const std::string& name)
         : SymbolTableEntry(name, SymbolTableEntryType::ET_CONSTANT)
@@ -0,0 +1,104 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_OUTPUT_BUFFER_H_
+#define _TOMIC_OUTPUT_BUFFER_H_
+
+#include <tomic/Shared.h>
+
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+TOMIC_BEGIN
+
+/*
+ * Characters to escape, and what each one is replaced with. Find scans for
+ * them 16 bytes at a time where SSE2 is available, so a string with nothing
+ * to escape is copied as a whole.
+ */
+class EscapeTable
+{
+public:
+    EscapeTable(std::initializer_list<std::pair<char, const char*>> escapes);
+
+    // Return the first character to escape in [begin, end), or end.
+    const char* Find(const char* begin, const char* end) const;
+
+    // Return nullptr if ch is not escaped.
+    const char* Escape(char ch) const { return _escapes[static_cast<unsigned char>(ch)]; }
+
+private:
+    static constexpr int MAX_SPECIALS = 4;
+
+    const char* _escapes[256];
+    char _specials[MAX_SPECIALS];
+    int _specialCount;
+};
+
+
+/*
+ * A growable buffer in front of a writer, so that output made of many small
+ * pieces goes to the stream in large blocks, with no formatting on the way.
+ * It is flushed once it grows past the block size, and when closed.
+ */
+class OutputBuffer
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    OutputBuffer();
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    // Flush to the previous writer if any, and start on a new one.
+    void Open(twio::IWriterPtr writer);
+    // Flush and release the writer.
+    void Close();
+    void Flush();
+
+    void Append(const char* str, size_t length)
+    {
+        _buffer.append(str, length);
+        _FlushIfFull();
+    }
+
+
+    void Append(const char* str) { Append(str, strlen(str)); }
+    void Append(const std::string& str) { Append(str.data(), str.length()); }
+
+    void Append(char ch)
+    {
+        _buffer.push_back(ch);
+        _FlushIfFull();
+    }
+
+
+    void AppendRepeat(char ch, int count);
+    void AppendInt(int value);
+    void AppendEscaped(const char* str, size_t length, const EscapeTable& table);
+
+private:
+    void _FlushIfFull()
+    {
+        if (_buffer.length() >= BLOCK_SIZE)
+        {
+            Flush();
+        }
+    }
+
+
+    twio::IWriterPtr _writer;
+    std::string _buffer;
+};
+
+
+TOMIC_END
+
+#endif // _TOMIC_OUTPUT_BUFFER_H_
@@ -43,26 +43,29 @@ bool HasParent(SyntaxNodePtr node, SyntaxType type);
 
 // Get attribute of node itself.
 bool HasAttribute(SyntaxNodePtr node, const char* name);
+bool HasAttribute(SyntaxNodePtr node, SyntaxAttribute attr);
 const char* GetAttribute(SyntaxNodePtr node, const char* name, const char* defaultValue = nullptr);
-int GetIntAttribute(SyntaxNodePtr node, const char* name, int defaultValue = 0);
-bool GetBoolAttribute(SyntaxNodePtr node, const char* name, bool defaultValue = false);
+int GetIntAttribute(SyntaxNodePtr node, SyntaxAttribute attr, int defaultValue = 0);
+bool GetBoolAttribute(SyntaxNodePtr node, SyntaxAttribute attr, bool defaultValue = false);
 
 bool QueryAttribute(SyntaxNodePtr node, const char* name, const char** value, const char* defaultValue = nullptr);
-bool QueryIntAttribute(SyntaxNodePtr node, const char* name, int* value, int defaultValue = 0);
-bool QueryBoolAttribute(SyntaxNodePtr node, const char* name, bool* value, bool defaultValue = false);
+bool QueryIntAttribute(SyntaxNodePtr node, SyntaxAttribute attr, int* value, int defaultValue = 0);
+bool QueryBoolAttribute(SyntaxNodePtr node, SyntaxAttribute attr, bool* value, bool defaultValue = false);
 
 // Get Inherited Attribute value
 bool HasInheritedAttribute(SyntaxNodePtr node, const char* name);
+bool HasInheritedAttribute(SyntaxNodePtr node, SyntaxAttribute attr);
 const char* GetInheritedAttribute(SyntaxNodePtr node, const char* name, const char* defaultValue = nullptr);
-int GetInheritedIntAttribute(SyntaxNodePtr node, const char* name, int defaultValue = 0);
-bool GetInheritedBoolAttribute(SyntaxNodePtr node, const char* name, bool defaultValue = false);
+int GetInheritedIntAttribute(SyntaxNodePtr node, SyntaxAttribute attr, int defaultValue = 0);
+bool GetInheritedBoolAttribute(SyntaxNodePtr node, SyntaxAttribute attr, bool defaultValue = false);
 
 // Get Synthesized Attribute value
 // Synthesized attributes comes from nodes in front of the current node.
 bool HasSynthesizedAttribute(SyntaxNodePtr node, const char* name);
+bool HasSynthesizedAttribute(SyntaxNodePtr node, SyntaxAttribute attr);
 const char* GetSynthesizedAttribute(SyntaxNodePtr node, const char* name, const char* defaultValue = nullptr);
-int GetSynthesizedIntAttribute(SyntaxNodePtr node, const char* name, int defaultValue = 0);
-bool GetSynthesizedBoolAttribute(SyntaxNodePtr node, const char* name, bool defaultValue = false);
+int GetSynthesizedIntAttribute(SyntaxNodePtr node, SyntaxAttribute attr, int defaultValue = 0);
+bool GetSynthesizedBoolAttribute(SyntaxNodePtr node, SyntaxAttribute attr, bool defaultValue = false);
 
 // Array serialization
 // The format is like this:
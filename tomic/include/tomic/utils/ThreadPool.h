@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_THREAD_POOL_H_
+#define _TOMIC_THREAD_POOL_H_
+
+#include <tomic/Shared.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+TOMIC_BEGIN
+
+/*
+ * A fixed-size pool of worker threads. Tasks are run in the order they are
+ * submitted, and Wait blocks until all submitted tasks are finished.
+ * Tasks should not throw.
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static std::shared_ptr<ThreadPool> New(int threads);
+
+    void Submit(std::function<void()> task);
+    void Wait();
+
+    int Size() const { return static_cast<int>(_workers.size()); }
+
+private:
+    void _Work();
+
+    std::vector<std::thread> _workers;
+    std::queue<std::function<void()>> _tasks;
+
+    std::mutex _mutex;
+    std::condition_variable _taskReady;
+    std::condition_variable _allDone;
+
+    // Tasks queued or running.
+    int _pending;
+    bool _stopped;
+};
+
+
+using ThreadPoolPtr = std::shared_ptr<ThreadPool>;
+
+TOMIC_END
+
+#endif // _TOMIC_THREAD_POOL_H_
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_TIME_REPORT_H_
+#define _TOMIC_TIME_REPORT_H_
+
+#include <tomic/Shared.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+TOMIC_BEGIN
+
+/*
+ * TimeReport records wall and CPU time of compilation phases. Phases can
+ * nest, and a phase begun inside another one is its sub-phase. Peak RSS
+ * is taken when a phase ends, and allocations are those made during the
+ * phase, sub-phases included.
+ *
+ * Allocations are counted by replacing the global operator new, so the
+ * counters are process-wide and include other threads.
+ */
+class TimeReport
+{
+public:
+    struct Phase
+    {
+        std::string name;
+        int depth;
+        double wall;        // seconds
+        double cpu;         // seconds
+        size_t peakRss;     // bytes, 0 if not available
+        size_t allocCount;
+        size_t allocBytes;
+    };
+
+
+    // Begin and end a phase with the lifetime of a scope. Report can be
+    // nullptr, so that it does nothing if time report is not enabled.
+    class Scope
+    {
+    public:
+        Scope(TimeReport* report, const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        TimeReport* _report;
+    };
+
+
+    TimeReport() = default;
+    ~TimeReport() = default;
+
+    static std::shared_ptr<TimeReport> New();
+
+    void Begin(const char* name);
+    void End();
+
+    // Phases in the order they begin.
+    const std::vector<Phase>& Phases() const { return _phases; }
+
+    void Print(twio::IWriterPtr writer) const;
+    void PrintJson(twio::IWriterPtr writer) const;
+
+    static double CpuTime();
+    static size_t PeakRss();
+    static size_t AllocCount();
+    static size_t AllocBytes();
+
+private:
+    size_t _PrintJson(twio::IWriterPtr writer, size_t index) const;
+
+    struct Mark
+    {
+        size_t index;
+        std::chrono::steady_clock::time_point wall;
+        double cpu;
+        size_t allocCount;
+        size_t allocBytes;
+    };
+
+
+    std::vector<Phase> _phases;
+    std::vector<Mark> _marks;
+};
+
+
+using TimeReportPtr = std::shared_ptr<TimeReport>;
+
+TOMIC_END
+
+#endif // _TOMIC_TIME_REPORT_H_
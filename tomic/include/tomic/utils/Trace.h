@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#ifndef _TOMIC_TRACE_H_
+#define _TOMIC_TRACE_H_
+
+#include <tomic/Shared.h>
+
+#include <atomic>
+#include <cstdint>
+
+TOMIC_BEGIN
+
+/*
+ * Tracer collects scoped events of compiler internals, and dumps them in
+ * Chrome trace_event JSON, which can be viewed in Perfetto.
+ *
+ * Instrument a scope with TOMIC_TRACE(category, name). The name must be
+ * a string literal or __func__, since only the pointer is kept. Events are
+ * recorded only between Start and Stop, and each thread has its own buffer.
+ *
+ * The macros are only defined with TOMIC_ENABLE_TRACE, otherwise they
+ * expand to nothing, so there is no cost at all in hot paths.
+ */
+class Tracer
+{
+public:
+    static void Start();
+    static void Stop();
+
+    static bool Enabled() { return _enabled.load(std::memory_order_relaxed); }
+
+    // Nanoseconds since Start.
+    static uint64_t Now();
+
+    // Argument is only recorded if argName is not nullptr.
+    static void Record(const char* category, const char* name, const char* argName, int arg,
+                       uint64_t begin, uint64_t end);
+
+    // Call only after Stop, when no other thread is recording.
+    static void Dump(twio::IWriterPtr writer);
+
+private:
+    static std::atomic<bool> _enabled;
+};
+
+
+class TraceScope
+{
+public:
+    TraceScope(const char* category, const char* name, const char* argName = nullptr, int arg = 0)
+        : _category(category), _name(name), _argName(argName), _arg(arg),
+        _begin(Tracer::Enabled() ? Tracer::Now() : 0), _active(Tracer::Enabled())
+    {
+    }
+
+
+    ~TraceScope()
+    {
+        if (_active)
+        {
+            Tracer::Record(_category, _name, _argName, _arg, _begin, Tracer::Now());
+        }
+    }
+
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* _category;
+    const char* _name;
+    const char* _argName;
+    int _arg;
+    uint64_t _begin;
+    bool _active;
+};
+
+
+TOMIC_END
+
+#ifdef TOMIC_ENABLE_TRACE
+
+#define _TOMIC_TRACE_CONCAT_AUX(a, b) a##b
+#define _TOMIC_TRACE_CONCAT(a, b) _TOMIC_TRACE_CONCAT_AUX(a, b)
+
+#define TOMIC_TRACE(category, name) \
+    TOMIC TraceScope _TOMIC_TRACE_CONCAT(_traceScope, __LINE__)(category, name)
+#define TOMIC_TRACE_ARG(category, name, argName, arg) \
+    TOMIC TraceScope _TOMIC_TRACE_CONCAT(_traceScope, __LINE__)(category, name, argName, arg)
+#else
+#define TOMIC_TRACE(category, name)
+#define TOMIC_TRACE_ARG(category, name, argName, arg)
+#endif
+
+#endif // _TOMIC_TRACE_H_
@@ -5,18 +5,24 @@
  */
 
 #include <tomic/Config.h>
+#include <tomic/parser/ISyntacticParser.h>
 
 TOMIC_BEGIN
 
 Config::Config()
     : Target(TargetType::Initial),
+      LexThreads(1),
+      MaxDepth(ISyntacticParser::DEFAULT_MAX_DEPTH),
+      ParseThreads(1),
       EnableCompleteAst(false),
       EmitAst(false),
       EmitLlvm(false),
       EnableVerboseLlvm(false),
       EnableLog(false),
       EnableError(false),
-      EnableVerboseError(false)
+      EnableVerboseError(false),
+      EnableTimeReport(false),
+      EnableTrace(false)
 {
 }
 
@@ -11,6 +11,9 @@
 #include <tomic/lexer/impl/DefaultLexicalParser.h>
 #include <tomic/lexer/impl/DefaultPreprocessor.h>
 #include <tomic/lexer/impl/HeaderPreprocessor.h>
+#include <tomic/lexer/impl/ParallelLexicalAnalyzer.h>
+#include <tomic/lexer/impl/StreamingPreprocessor.h>
+#include <tomic/lexer/impl/TableLexicalAnalyzer.h>
 #include <tomic/lexer/impl/token/DefaultTokenMapper.h>
 #include <tomic/lexer/IPreprocessor.h>
 #include <tomic/lexer/token/ITokenMapper.h>
@@ -30,6 +33,7 @@
 #include <tomic/parser/ast/mapper/CompleteSyntaxMapper.h>
 #include <tomic/parser/ast/mapper/ISyntaxMapper.h>
 #include <tomic/parser/ast/mapper/ReducedSyntaxMapper.h>
+#include <tomic/parser/ast/printer/BinaryAstPrinter.h>
 #include <tomic/parser/ast/printer/IAstPrinter.h>
 #include <tomic/parser/ast/printer/JsonAstPrinter.h>
 #include <tomic/parser/ast/printer/StandardAstPrinter.h>
@@ -43,10 +47,13 @@
 #include <tomic/Shared.h>
 #include <tomic/ToMiCompiler.h>
 #include <tomic/utils/StringUtil.h>
+#include <tomic/utils/TimeReport.h>
+#include <tomic/utils/Trace.h>
+#include <twio/utils/FileUtil.h>
 
 TOMIC_BEGIN
 
-static twio::IWriterPtr BuildWriter(const char* filename);
+static twio::IWriterPtr BuildWriter(const char* filename, bool binary = false);
 static void OutputSyntaxTree(const char* filename, IAstPrinterPtr printer, SyntaxTreePtr tree);
 static void OutputLlvmAsm(const char* filename, llvm::IAsmPrinterPtr printer, llvm::ModuleSmartPtr module);
 
@@ -81,16 +88,23 @@ public:
     void Compile();
 
 private:
-    bool _Preprocess(twio::IWriterPtr* outWriter);
+    void _Compile();
+
+    bool _Preprocess(twio::IAdvancedReaderPtr* outReader);
     bool _SyntacticParse(twio::IAdvancedReaderPtr reader, SyntaxTreePtr* outAst);
     bool _SemanticParse(SyntaxTreePtr ast, SymbolTablePtr* outTable);
 
     bool _GenerateLlvmAsm(SyntaxTreePtr ast, SymbolTablePtr table, llvm::ModuleSmartPtr* outModule);
 
     void _LogError();
+    void _OutputTimeReport();
+    void _OutputTrace();
 
     ConfigPtr _config;
     mioc::ServiceContainerPtr _container;
+
+    // nullptr if time report is not enabled.
+    TimeReportPtr _report;
 };
 
 
@@ -127,6 +141,11 @@ void ToMiCompiler::Compile()
     auto config = _impl->_config;
     // Logger
     _impl->Configure([=](mioc::ServiceContainerPtr container) {
+        // Trace events are recorded from here on.
+        if (config->EnableTrace)
+        {
+            Tracer::Start();
+        }
         if (config->EnableLog)
         {
             if (config->LogOutput.empty())
@@ -166,10 +185,19 @@ void ToMiCompiler::Compile()
     // Lexical
     _impl->Configure([=](mioc::ServiceContainerPtr container) {
         container->AddSingleton<ITokenMapper, DefaultTokenMapper>()
-            ->AddTransient<IPreprocessor, HeaderPreprocessor>()
-            //->AddTransient<IPreprocessor, DefaultPreprocessor>()
-            ->AddTransient<ILexicalAnalyzer, DefaultLexicalAnalyzer, ITokenMapper>()
-            ->AddTransient<ILexicalParser, DefaultLexicalParser, ILexicalAnalyzer, IErrorLogger, ILogger>();
+            ->AddTransient<IPreprocessor, HeaderPreprocessor>();
+        //->AddTransient<IPreprocessor, DefaultPreprocessor>()
+        if (config->LexThreads > 1)
+        {
+            auto analyzer = ParallelLexicalAnalyzer::New(container->Resolve<ITokenMapper>(), config->LexThreads);
+            container->AddSingleton<ILexicalAnalyzer>(analyzer);
+        }
+        else
+        {
+            //container->AddTransient<ILexicalAnalyzer, DefaultLexicalAnalyzer, ITokenMapper>();
+            container->AddTransient<ILexicalAnalyzer, TableLexicalAnalyzer, ITokenMapper>();
+        }
+        container->AddTransient<ILexicalParser, DefaultLexicalParser, ILexicalAnalyzer, IErrorLogger, ILogger>();
     });
     // Ast printer (Might be used by Syntactic and Semantic.
     _impl->Configure([=](mioc::ServiceContainerPtr container) {
@@ -188,6 +216,10 @@ void ToMiCompiler::Compile()
             {
                 container->AddTransient<IAstPrinter, JsonAstPrinter, ISyntaxMapper, ITokenMapper>();
             }
+            else if (StringUtil::EndsWith(astFilename, ".bin"))
+            {
+                container->AddTransient<IAstPrinter, BinaryAstPrinter>();
+            }
             else
             {
                 container->AddTransient<IAstPrinter, StandardAstPrinter, ISyntaxMapper, ITokenMapper>();
@@ -233,12 +265,29 @@ void ToMiCompiler::Compile()
  * ================================ Implementation ================================
  */
 void ToMiCompilerImpl::Compile()
+{
+    if (_config->EnableTimeReport)
+    {
+        _report = TimeReport::New();
+    }
+
+    {
+        TimeReport::Scope scope(_report.get(), "total");
+        _Compile();
+    }
+
+    _OutputTimeReport();
+    _OutputTrace();
+}
+
+
+void ToMiCompilerImpl::_Compile()
 {
     auto logger = _container->Resolve<ILogger>();
 
     // Preprocess
-    twio::IWriterPtr output;
-    if (!_Preprocess(&output))
+    twio::IAdvancedReaderPtr syntaxReader;
+    if (!_Preprocess(&syntaxReader))
     {
         _LogError();
         return;
@@ -246,7 +295,6 @@ void ToMiCompilerImpl::Compile()
 
     // Syntax parse
     SyntaxTreePtr ast;
-    auto syntaxReader = twio::AdvancedReader::New(twio::BufferInputStream::New(output->Stream()->Yield()));
     if (!_SyntacticParse(syntaxReader, &ast))
     {
         _LogError();
@@ -275,38 +323,37 @@ void ToMiCompilerImpl::Compile()
 }
 
 
-bool ToMiCompilerImpl::_Preprocess(twio::IWriterPtr* outWriter)
+bool ToMiCompilerImpl::_Preprocess(twio::IAdvancedReaderPtr* outReader)
 {
     if (_config->Target < Config::TargetType::Preprocess)
     {
         return false;
     }
+    TimeReport::Scope scope(_report.get(), "preprocess");
+    TOMIC_TRACE("compile", "preprocess");
 
     auto logger = _container->Resolve<ILogger>();
     logger->LogFormat(LogLevel::DEBUG, "Preprocessing \"%s\"...", _config->Input.c_str());
 
-    // ===============
-    auto srcReader = twio::AdvancedReader::New(twio::FileInputStream::New(_config->Input.c_str()));
-    auto srcWriter = BuildWriter(nullptr);
-    _container->Resolve<IPreprocessor>()->SetReader(srcReader)->SetWriter(srcWriter)->Process();
-    // ===============
+    auto srcReader = twio::MemoryReader::New(twio::MappedInputStream::New(_config->Input.c_str()));
 
     if (_config->Target == Config::TargetType::Preprocess)
     {
         // Output preprocessed file.
-        auto tempReader = twio::AdvancedReader::New(twio::BufferInputStream::New(srcWriter->Stream()->Yield()));
         auto tempWriter = BuildWriter(_config->Output.c_str());
         if (tempWriter)
         {
-            twio::Printer::New(tempReader, tempWriter)->Print();
+            _container->Resolve<IPreprocessor>()->SetReader(srcReader)->SetWriter(tempWriter)->Process();
         }
         logger->LogFormat(LogLevel::DEBUG, "Preprocessed file \"%s\" generated", _config->Output.c_str());
         return false;
     }
 
-    if (outWriter)
+    // For later stages, preprocess is done on the fly when the lexer reads
+    // from it, so there is no intermediate buffer of the whole source.
+    if (outReader)
     {
-        *outWriter = srcWriter;
+        *outReader = StreamingPreprocessor::New(srcReader);
     }
 
     return true;
@@ -319,11 +366,23 @@ bool ToMiCompilerImpl::_SyntacticParse(twio::IAdvancedReaderPtr reader, SyntaxTr
     {
         return false;
     }
+    TimeReport::Scope scope(_report.get(), "syntactic");
+    TOMIC_TRACE("compile", "syntactic");
+
     auto logger = _container->Resolve<ILogger>();
     logger->LogFormat(LogLevel::DEBUG, "Parsing \"%s\"...", _config->Input.c_str());
 
     // ===============
-    auto ast = _container->Resolve<ISyntacticParser>()->SetReader(reader)->Parse();
+    // Source is preprocessed and lexed on the fly when parsing.
+    SyntaxTreePtr ast;
+    {
+        TimeReport::Scope parseScope(_report.get(), "parse");
+        ast = _container->Resolve<ISyntacticParser>()
+                  ->SetReader(reader)
+                  ->SetMaxDepth(_config->MaxDepth)
+                  ->SetThreads(_config->ParseThreads)
+                  ->Parse();
+    }
     if (!ast)
     {
         logger->LogFormat(LogLevel::FATAL, "Syntactic parse failed, compilation aborted");
@@ -340,6 +399,7 @@ bool ToMiCompilerImpl::_SyntacticParse(twio::IAdvancedReaderPtr reader, SyntaxTr
     {
         if (_config->EmitAst)
         {
+            TimeReport::Scope printScope(_report.get(), "print ast");
             OutputSyntaxTree(_config->AstOutput.c_str(), _container->Resolve<IAstPrinter>(), ast);
         }
     }
@@ -359,15 +419,23 @@ bool ToMiCompilerImpl::_SemanticParse(SyntaxTreePtr ast, SymbolTablePtr* outTabl
     {
         return false;
     }
+    TimeReport::Scope scope(_report.get(), "semantic");
+    TOMIC_TRACE("compile", "semantic");
+
     auto logger = _container->Resolve<ILogger>();
     logger->LogFormat(LogLevel::DEBUG, "Performing semantic analyzing on \"%s\"...", _config->Input.c_str());
 
     // ===============
-    auto table = _container->Resolve<ISemanticParser>()->Parse(ast);
+    SymbolTablePtr table;
+    {
+        TimeReport::Scope analyzeScope(_report.get(), "analyze");
+        table = _container->Resolve<ISemanticParser>()->Parse(ast);
+    }
     // ===============
 
     if (_config->EmitAst)
     {
+        TimeReport::Scope printScope(_report.get(), "print ast");
         OutputSyntaxTree(_config->AstOutput.c_str(), _container->Resolve<IAstPrinter>(), ast);
     }
 
@@ -395,11 +463,17 @@ bool ToMiCompilerImpl::_GenerateLlvmAsm(SyntaxTreePtr ast, SymbolTablePtr table,
     {
         return false;
     }
+    TimeReport::Scope scope(_report.get(), "ir");
+    TOMIC_TRACE("compile", "ir");
+
     auto logger = _container->Resolve<ILogger>();
     logger->LogFormat(LogLevel::DEBUG, "Generating LLVM IR...");
 
-    auto asmGenerator = _container->Resolve<llvm::IAsmGenerator>();
-    auto module = asmGenerator->Generate(ast, table, _config->Input.c_str());
+    llvm::ModuleSmartPtr module;
+    {
+        TimeReport::Scope generateScope(_report.get(), "generate");
+        module = _container->Resolve<llvm::IAsmGenerator>()->Generate(ast, table, _config->Input.c_str());
+    }
 
     if (!module)
     {
@@ -414,6 +488,7 @@ bool ToMiCompilerImpl::_GenerateLlvmAsm(SyntaxTreePtr ast, SymbolTablePtr table,
 
     if (_config->EmitLlvm)
     {
+        TimeReport::Scope printScope(_report.get(), "print ir");
         OutputLlvmAsm(_config->LlvmOutput.c_str(), _container->Resolve<llvm::IAsmPrinter>(), module);
     }
 
@@ -445,7 +520,49 @@ void ToMiCompilerImpl::_LogError()
 }
 
 
-static twio::IWriterPtr BuildWriter(const char* filename)
+// Table goes to stderr, and JSON to a file.
+void ToMiCompilerImpl::_OutputTimeReport()
+{
+    if (!_report)
+    {
+        return;
+    }
+
+    const char* filename = _config->TimeReportOutput.c_str();
+    auto writer = BuildWriter(filename);
+    if (!writer)
+    {
+        return;
+    }
+
+    if (StringUtil::Equals(filename, "stderr") || StringUtil::Equals(filename, "stdout"))
+    {
+        _report->Print(writer);
+    }
+    else
+    {
+        _report->PrintJson(writer);
+    }
+}
+
+
+void ToMiCompilerImpl::_OutputTrace()
+{
+    if (!_config->EnableTrace)
+    {
+        return;
+    }
+
+    Tracer::Stop();
+    auto writer = BuildWriter(_config->TraceOutput.c_str());
+    if (writer)
+    {
+        Tracer::Dump(writer);
+    }
+}
+
+
+static twio::IWriterPtr BuildWriter(const char* filename, bool binary)
 {
     if (!filename)
     {
@@ -467,6 +584,11 @@ static twio::IWriterPtr BuildWriter(const char* filename)
         return twio::Writer::New(twio::FileOutputStream::New(stderr, false));
     }
 
+    if (binary)
+    {
+        return twio::Writer::New(twio::FileOutputStream::New(twio::OpenFile(filename, "wb")));
+    }
+
     return twio::Writer::New(twio::FileOutputStream::New(filename));
 }
 
@@ -475,7 +597,7 @@ static void OutputSyntaxTree(const char* filename, IAstPrinterPtr printer, Synta
 {
     TOMIC_ASSERT(printer && "Missing AST Printer");
     // Output syntax tree.
-    auto writer = BuildWriter(filename);
+    auto writer = BuildWriter(filename, StringUtil::EndsWith(filename, ".bin"));
     if (writer)
     {
         printer->Print(tree, writer);
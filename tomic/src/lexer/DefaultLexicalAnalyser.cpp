@@ -33,6 +33,13 @@ DefaultLexicalAnalyzer* DefaultLexicalAnalyzer::SetReader(twio::IAdvancedReaderP
 }
 
 
+DefaultLexicalAnalyzer* DefaultLexicalAnalyzer::SetArena(TokenArenaPtr arena)
+{
+    _arena = std::move(arena);
+    return this;
+}
+
+
 TokenPtr DefaultLexicalAnalyzer::Next()
 {
     TokenPtr token;
@@ -75,7 +82,7 @@ TokenPtr DefaultLexicalAnalyzer::_Next()
     // If end of file is reached, return a terminator token.
     if (lookahead == EOF)
     {
-        return Token::New(TokenType::TK_TERMINATOR, "", _reader->Line(), _reader->Char());
+        return _arena->NewToken(TokenType::TK_TERMINATOR, "", 0, _reader->Offset());
     }
 
     // Find a task to analyse the character.
@@ -87,7 +94,7 @@ TokenPtr DefaultLexicalAnalyzer::_Next()
             // Put lookahead back to the stream.
             _reader->Rewind();
 
-            token = task->Analyse(_reader);
+            token = task->Analyse(_reader, _arena);
             break;
         }
     }
@@ -122,11 +129,10 @@ bool NumberLexicalTask::EndsWith(int end) const
 }
 
 
-TokenPtr NumberLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
+TokenPtr NumberLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena)
 {
     int ch = reader->Read();
-    int lineNo = reader->Line();
-    int charNo = reader->Char();
+    size_t position = reader->Offset();
     std::string lexeme;
 
     while (ch != EOF && StringUtil::Contains(_DIGITS, ch))
@@ -148,7 +154,7 @@ TokenPtr NumberLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
         }
 
         // TODO: Error handling.
-        return Token::New(TokenType::TK_UNKNOWN, lexeme, lineNo, charNo);
+        return arena->NewToken(TokenType::TK_UNKNOWN, lexeme, position);
     }
 
     if (ch != EOF)
@@ -156,7 +162,7 @@ TokenPtr NumberLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
         reader->Rewind();
     }
 
-    return Token::New(TokenType::TK_INTEGER, lexeme, lineNo, charNo);
+    return arena->NewToken(TokenType::TK_INTEGER, lexeme, position);
 }
 
 
@@ -177,11 +183,10 @@ bool IdentifierLexicalTask::EndsWith(int end) const
 }
 
 
-TokenPtr IdentifierLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
+TokenPtr IdentifierLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena)
 {
     int ch = reader->Read();
-    int lineNo = reader->Line();
-    int charNo = reader->Char();
+    size_t position = reader->Offset();
     std::string lexeme;
 
     // The first one must be a letter or underscore.
@@ -204,7 +209,7 @@ TokenPtr IdentifierLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
             reader->Rewind();
         }
 
-        return Token::New(TokenType::TK_UNKNOWN, lexeme, lineNo, charNo);
+        return arena->NewToken(TokenType::TK_UNKNOWN, lexeme, position);
     }
 
     if (ch != EOF)
@@ -212,12 +217,12 @@ TokenPtr IdentifierLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
         reader->Rewind();
     }
 
-    auto token = Token::New(_tokenMapper->Type(lexeme), lexeme, lineNo, charNo);
-    if (token->type == TokenType::TK_UNKNOWN)
+    TokenType type = _tokenMapper->Type(lexeme);
+    if (type == TokenType::TK_UNKNOWN)
     {
-        token->type = TokenType::TK_IDENTIFIER;
+        type = TokenType::TK_IDENTIFIER;
     }
-    return token;
+    return arena->NewToken(type, lexeme, position);
 }
 
 
@@ -234,11 +239,10 @@ bool StringLexicalTask::EndsWith(int end) const
 }
 
 
-TokenPtr StringLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
+TokenPtr StringLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena)
 {
     int ch = reader->Read();
-    int lineNo = reader->Line();
-    int charNo = reader->Char();
+    size_t position = reader->Offset();
     std::string lexeme;
     bool error = false;
 
@@ -288,10 +292,10 @@ TokenPtr StringLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
     if (error)
     {
         // TODO: Report error
-        return Token::New(TokenType::TK_UNKNOWN, lexeme, lineNo, charNo);
+        return arena->NewToken(TokenType::TK_UNKNOWN, lexeme, position);
     }
 
-    return Token::New(TokenType::TK_FORMAT, lexeme, lineNo, charNo);
+    return arena->NewToken(TokenType::TK_FORMAT, lexeme, position);
 }
 
 
@@ -358,17 +362,16 @@ bool SingleOpLexicalTask::EndsWith(int end) const
 }
 
 
-TokenPtr SingleOpLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
+TokenPtr SingleOpLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena)
 {
     int ch = reader->Read();
-    int lineNo = reader->Line();
-    int charNo = reader->Char();
+    size_t position = reader->Offset();
     std::string lexeme;
 
     // The first one must be a single-character operator.
     lexeme += ch;
 
-    return Token::New(_tokenMapper->Type(lexeme), lexeme, lineNo, charNo);
+    return arena->NewToken(_tokenMapper->Type(lexeme), lexeme, position);
 }
 
 
@@ -385,12 +388,11 @@ bool DoubleOpLexicalTask::EndsWith(int end) const
 }
 
 
-TokenPtr DoubleOpLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
+TokenPtr DoubleOpLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena)
 {
     int ch = reader->Read();
     int next;
-    int lineNo = reader->Line();
-    int charNo = reader->Char();
+    size_t position = reader->Offset();
     std::string lexeme;
 
     // The first one must be a double-character operator.
@@ -437,7 +439,7 @@ TokenPtr DoubleOpLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
         TOMIC_PANIC("Unknown double-character operator.");
     }
 
-    return Token::New(_tokenMapper->Type(lexeme), lexeme, lineNo, charNo);
+    return arena->NewToken(_tokenMapper->Type(lexeme), lexeme, position);
 }
 
 
@@ -454,17 +456,16 @@ bool DelimiterLexicalTask::EndsWith(int end) const
 }
 
 
-TokenPtr DelimiterLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
+TokenPtr DelimiterLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena)
 {
     int ch = reader->Read();
-    int lineNo = reader->Line();
-    int charNo = reader->Char();
+    size_t position = reader->Offset();
     std::string lexeme;
 
     // The first one must be a delimiter.
     lexeme += ch;
 
-    return Token::New(_tokenMapper->Type(lexeme), lexeme, lineNo, charNo);
+    return arena->NewToken(_tokenMapper->Type(lexeme), lexeme, position);
 }
 
 
@@ -481,16 +482,15 @@ bool UnknownLexicalTask::EndsWith(int end) const
 }
 
 
-TokenPtr UnknownLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader)
+TokenPtr UnknownLexicalTask::Analyse(const twio::IAdvancedReaderPtr& reader, const TokenArenaPtr& arena)
 {
     int ch = reader->Read();
-    int lineNo = reader->Line();
-    int charNo = reader->Char();
+    size_t position = reader->Offset();
     std::string lexeme;
 
     lexeme += ch;
 
-    return Token::New(TokenType::TK_UNKNOWN, lexeme, lineNo, charNo);
+    return arena->NewToken(TokenType::TK_UNKNOWN, lexeme, position);
 }
 
 
@@ -9,7 +9,7 @@
 TOMIC_BEGIN
 
 DefaultLexicalParser::DefaultLexicalParser(ILexicalAnalyzerPtr analyzer, IErrorLoggerPtr errorLogger, ILoggerPtr logger)
-    : _analyzer(analyzer), _errorLogger(errorLogger), _logger(logger)
+    : _analyzer(analyzer), _errorLogger(errorLogger), _logger(logger), _nextUnknown(0)
 {
     TOMIC_ASSERT(_analyzer);
     TOMIC_ASSERT(_errorLogger);
@@ -21,7 +21,28 @@ DefaultLexicalParser::DefaultLexicalParser(ILexicalAnalyzerPtr analyzer, IErrorL
 
 DefaultLexicalParser* DefaultLexicalParser::SetReader(twio::IAdvancedReaderPtr reader)
 {
+    // Each source has its own tokens.
+    auto arena = TokenArena::New();
+    arena->SetLines(reader->Lines());
+
+    return SetReader(reader, arena);
+}
+
+
+DefaultLexicalParser* DefaultLexicalParser::SetReader(twio::IAdvancedReaderPtr reader, TokenArenaPtr arena)
+{
+    TOMIC_ASSERT(arena);
+
+    _arena = std::move(arena);
+    _tokens.clear();
+    _current = _tokens.end();
+    _unknown.clear();
+    _nextUnknown = 0;
+    _terminator = nullptr;
+
+    _analyzer->SetArena(_arena);
     _analyzer->SetReader(reader);
+
     return this;
 }
 
@@ -38,8 +59,19 @@ TokenPtr DefaultLexicalParser::Current()
 
 TokenPtr DefaultLexicalParser::Next()
 {
+    if (_nextUnknown < _unknown.size())
+    {
+        _ReportUnknown(_current - _tokens.begin());
+    }
+
     if (_current == _tokens.end())
     {
+        // Once EOF is reached, no token is added to the arena any more.
+        if (_terminator)
+        {
+            return _terminator;
+        }
+
         TokenPtr token = _analyzer->Next();
         while (token->type == TokenType::TK_UNKNOWN)
         {
@@ -51,6 +83,7 @@ TokenPtr DefaultLexicalParser::Next()
         if (token->type == TokenType::TK_TERMINATOR)
         {
             // _current is still _tokens.end()
+            _terminator = token;
             return token;
         }
 
@@ -85,13 +118,51 @@ void DefaultLexicalParser::Rollback(int checkpoint)
 }
 
 
+const std::vector<TokenPtr>& DefaultLexicalParser::Prefetch()
+{
+    const auto offset = _current - _tokens.begin();
+
+    while (!_terminator)
+    {
+        TokenPtr token = _analyzer->Next();
+        if (token->type == TokenType::TK_TERMINATOR)
+        {
+            _terminator = token;
+        }
+        else if (token->type == TokenType::TK_UNKNOWN)
+        {
+            _unknown.emplace_back(_tokens.size(), token);
+        }
+        else
+        {
+            _tokens.push_back(token);
+        }
+    }
+
+    _current = _tokens.begin() + offset;
+
+    return _tokens;
+}
+
+
+void DefaultLexicalParser::_ReportUnknown(size_t index)
+{
+    while ((_nextUnknown < _unknown.size()) && (_unknown[_nextUnknown].first <= index))
+    {
+        TokenPtr token = _unknown[_nextUnknown++].second;
+        _RaiseUnexpectedTokenError(token);
+        _LogUnexpectedToken(token);
+    }
+}
+
+
 void DefaultLexicalParser::_LogUnexpectedToken(TokenPtr token)
 {
     TOMIC_ASSERT(token);
     _logger->LogFormat(LogLevel::ERROR, "(%d:%d) Unexpected token %s",
-                       token->lineNo,
-                       token->charNo,
-                       token->lexeme.c_str());
+                       token.LineNo(),
+                       token.CharNo(),
+                       token.Lexeme());
 }
 
 
@@ -99,11 +170,11 @@ void DefaultLexicalParser::_RaiseUnexpectedTokenError(TokenPtr token)
 {
     TOMIC_ASSERT(token);
     _errorLogger->LogFormat(
-        token->lineNo,
-        token->charNo,
+        token.LineNo(),
+        token.CharNo(),
         ErrorType::ERR_UNEXPECTED_TOKEN,
         "Unexpected token %s",
-        token->lexeme.c_str());
+        token.Lexeme());
 }
 
 
@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/lexer/impl/ParallelLexicalAnalyzer.h>
+#include <tomic/lexer/impl/TableLexicalAnalyzer.h>
+#include <tomic/utils/Trace.h>
+
+#include <algorithm>
+#include <cstring>
+
+TOMIC_BEGIN
+
+ParallelLexicalAnalyzer::ParallelLexicalAnalyzer(ITokenMapperPtr mapper, int threads)
+    : _mapper(mapper), _threads(std::max(threads, 1)),
+    _data(nullptr), _size(0),
+    _first(0), _count(0), _next(0)
+{
+    TOMIC_ASSERT(_mapper);
+    if (_threads > 1)
+    {
+        _pool = ThreadPool::New(_threads);
+    }
+}
+
+
+std::shared_ptr<ParallelLexicalAnalyzer> ParallelLexicalAnalyzer::New(ITokenMapperPtr mapper, int threads)
+{
+    return std::make_shared<ParallelLexicalAnalyzer>(mapper, threads);
+}
+
+
+ParallelLexicalAnalyzer* ParallelLexicalAnalyzer::SetReader(twio::IAdvancedReaderPtr reader)
+{
+    TOMIC_ASSERT(_arena);
+
+    _reader = std::move(reader);
+    _buffer.clear();
+
+    size_t offset;
+    auto memoryReader = std::dynamic_pointer_cast<twio::MemoryReader>(_reader);
+    if (memoryReader)
+    {
+        _data = memoryReader->Data();
+        _size = memoryReader->Size();
+        offset = memoryReader->Offset();
+    }
+    else
+    {
+        TOMIC_ASSERT(_reader->Offset() == 0);
+
+        // Read will append a '\0'.
+        char buffer[4096 + 1];
+        size_t count;
+        while ((count = _reader->Read(buffer, sizeof(buffer) - 1)) > 0)
+        {
+            _buffer.append(buffer, count);
+        }
+        _data = _buffer.data();
+        _size = _buffer.size();
+        offset = 0;
+    }
+
+    _Lex(offset);
+
+    return this;
+}
+
+
+ParallelLexicalAnalyzer* ParallelLexicalAnalyzer::SetArena(TokenArenaPtr arena)
+{
+    _arena = std::move(arena);
+    return this;
+}
+
+
+TokenPtr ParallelLexicalAnalyzer::Next()
+{
+    if (_next < _count)
+    {
+        return { _arena.get(), _first + _next++ };
+    }
+
+    // All trailing whitespaces are skipped, the same as serial lexing.
+    return _arena->NewToken(TokenType::TK_TERMINATOR, "", 0, _size);
+}
+
+
+void ParallelLexicalAnalyzer::_Lex(size_t offset)
+{
+    _Split(offset);
+
+    if (_chunks.size() == 1)
+    {
+        _LexChunk(_chunks.front());
+    }
+    else
+    {
+        for (auto& chunk : _chunks)
+        {
+            _pool->Submit([this, &chunk] { _LexChunk(chunk); });
+        }
+        _pool->Wait();
+    }
+
+    _Stitch();
+    _chunks.clear();
+}
+
+
+/*
+ * Chunks are about the same size, and each one ends at a newline, so that
+ * no token other than a string is broken.
+ */
+void ParallelLexicalAnalyzer::_Split(size_t offset)
+{
+    _chunks.clear();
+
+    const size_t length = _size - offset;
+    const size_t count = std::max<size_t>(1, std::min<size_t>(_threads, length / MIN_CHUNK_SIZE));
+    const size_t size = length / count;
+
+    size_t begin = offset;
+    for (size_t i = 1; (i < count) && (begin < _size); i++)
+    {
+        size_t limit = std::max(begin + 1, offset + i * size);
+        auto newline = static_cast<const char*>(memchr(_data + limit, '\n', _size - limit));
+        limit = newline ? (newline - _data) : _size;
+        _chunks.push_back({ begin, limit, begin, 0, nullptr });
+        begin = limit;
+    }
+    if ((begin < _size) || _chunks.empty())
+    {
+        _chunks.push_back({ begin, _size, begin, 0, nullptr });
+    }
+}
+
+
+/*
+ * Lex tokens starting before the limit of the chunk. The last one may end
+ * after the limit, which is exactly what a serial lexer does.
+ */
+void ParallelLexicalAnalyzer::_LexChunk(Chunk& chunk)
+{
+    TOMIC_TRACE("lex", __func__);
+
+    chunk.arena = TokenArena::New();
+    chunk.count = 0;
+    chunk.end = chunk.begin;
+
+    TableLexicalAnalyzer analyzer(_mapper);
+    analyzer.SetArena(chunk.arena)->SetContent(_data, _size, chunk.begin);
+
+    for (;;)
+    {
+        TokenPtr token = analyzer.Next();
+        if ((token->type == TokenType::TK_TERMINATOR) || (token.Position() - 1 >= chunk.limit))
+        {
+            break;
+        }
+        chunk.count++;
+        chunk.end = analyzer.Offset();
+    }
+}
+
+
+void ParallelLexicalAnalyzer::_Stitch()
+{
+    TOMIC_TRACE("lex", __func__);
+
+    _first = static_cast<uint32_t>(_arena->Size());
+    _next = 0;
+
+    // Where the last stitched token ends.
+    size_t end = 0;
+    for (auto& chunk : _chunks)
+    {
+        if (chunk.begin < end)
+        {
+            // Previous token runs into this chunk, so it was started in
+            // a wrong state. Only happens when splitting inside a string.
+            // If it runs over the whole chunk, nothing is left.
+            chunk.begin = end;
+            _LexChunk(chunk);
+        }
+        if (chunk.count > 0)
+        {
+            end = chunk.end;
+        }
+        _arena->Append(*chunk.arena, chunk.count);
+        chunk.arena.reset();
+    }
+
+    _count = static_cast<uint32_t>(_arena->Size() - _first);
+}
+
+
+TOMIC_END
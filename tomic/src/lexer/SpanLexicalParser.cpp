@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/lexer/impl/SpanLexicalParser.h>
+
+TOMIC_BEGIN
+
+SpanLexicalParser::SpanLexicalParser(TokenArenaPtr arena, const TokenPtr* begin, const TokenPtr* end, TokenPtr terminator)
+    : _arena(arena), _begin(begin), _end(end), _current(begin), _terminator(terminator), _overrun(false)
+{
+    TOMIC_ASSERT(_arena);
+    TOMIC_ASSERT(_begin <= _end);
+    TOMIC_ASSERT(_terminator);
+}
+
+
+std::shared_ptr<SpanLexicalParser> SpanLexicalParser::New(TokenArenaPtr arena,
+                                                          const TokenPtr* begin,
+                                                          const TokenPtr* end,
+                                                          TokenPtr terminator)
+{
+    return std::make_shared<SpanLexicalParser>(arena, begin, end, terminator);
+}
+
+
+SpanLexicalParser* SpanLexicalParser::SetReader(twio::IAdvancedReaderPtr reader)
+{
+    TOMIC_PANIC("SpanLexicalParser has no reader");
+    return this;
+}
+
+
+SpanLexicalParser* SpanLexicalParser::SetReader(twio::IAdvancedReaderPtr reader, TokenArenaPtr arena)
+{
+    TOMIC_PANIC("SpanLexicalParser has no reader");
+    return this;
+}
+
+
+TokenPtr SpanLexicalParser::Current()
+{
+    if (_current == _begin)
+    {
+        return nullptr;
+    }
+    return *(_current - 1);
+}
+
+
+TokenPtr SpanLexicalParser::Next()
+{
+    if (_current == _end)
+    {
+        _overrun = true;
+        return _terminator;
+    }
+    return *(_current++);
+}
+
+
+TokenPtr SpanLexicalParser::Rewind()
+{
+    if (_current != _begin)
+    {
+        return *(--_current);
+    }
+    return nullptr;
+}
+
+
+int SpanLexicalParser::SetCheckPoint()
+{
+    return static_cast<int>(_current - _begin);
+}
+
+
+void SpanLexicalParser::Rollback(int checkpoint)
+{
+    _current = _begin + checkpoint;
+}
+
+
+const std::vector<TokenPtr>& SpanLexicalParser::Prefetch()
+{
+    _tokens.assign(_begin, _end);
+    return _tokens;
+}
+
+
+TOMIC_END
@@ -0,0 +1,370 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/lexer/impl/StreamingPreprocessor.h>
+
+#include <cstdio>   // EOF
+
+TOMIC_BEGIN
+
+StreamingPreprocessor::StreamingPreprocessor(twio::IReaderPtr reader, size_t offset)
+    : _reader(std::move(reader)),
+    _pendingSize(0), _pendingNext(0), _exhausted(false),
+    _offset(offset), _lines(twio::LineIndex::New()),
+    _state({ StateType::ANY, 0 })
+{
+    TOMIC_ASSERT(_reader);
+}
+
+
+std::shared_ptr<StreamingPreprocessor> StreamingPreprocessor::New(const twio::IReaderPtr& reader, size_t offset)
+{
+    return std::make_shared<StreamingPreprocessor>(reader, offset);
+}
+
+
+bool StreamingPreprocessor::HasNext()
+{
+    if (_HasNext())
+    {
+        return true;
+    }
+
+    const int ch = _Produce();
+    if (ch == EOF)
+    {
+        return false;
+    }
+
+    // Put it back to pending characters, so that it will be read next time.
+    _pendingNext--;
+
+    return true;
+}
+
+
+size_t StreamingPreprocessor::Read(char* buffer, size_t size)
+{
+    TOMIC_ASSERT(buffer != nullptr);
+
+    size_t count = 0;
+    while (count < size)
+    {
+        const int ch = Read();
+        if (ch == EOF)
+        {
+            break;
+        }
+        buffer[count++] = static_cast<char>(ch);
+    }
+    buffer[count] = '\0';
+
+    return count;
+}
+
+
+const char* StreamingPreprocessor::ReadLine(char* buffer)
+{
+    TOMIC_ASSERT(buffer != nullptr);
+
+    int ch = Read();
+    if (ch == EOF)
+    {
+        return nullptr;
+    }
+
+    char* p = buffer;
+    while (ch != EOF && ch != '\n')
+    {
+        *(p++) = ch;
+        ch = Read();
+    }
+
+    *p = '\0';
+    return buffer;
+}
+
+
+int StreamingPreprocessor::Read()
+{
+    if (_HasNext())
+    {
+        const int ch = _Get();
+        _MoveForward(ch);
+        return static_cast<unsigned char>(ch);
+    }
+
+    const int ch = _Produce();
+    if (ch != EOF)
+    {
+        _Push(ch);
+        _MoveForward(ch);
+    }
+
+    return ch;
+}
+
+
+int StreamingPreprocessor::Rewind()
+{
+    const int ch = _Pop();
+    _MoveBackward();
+    return ch;
+}
+
+
+int StreamingPreprocessor::Line() const
+{
+    return _lines->Line(_offset);
+}
+
+
+int StreamingPreprocessor::Char() const
+{
+    return _lines->Char(_offset);
+}
+
+
+twio::IInputStreamPtr StreamingPreprocessor::Stream() const
+{
+    return _reader->Stream();
+}
+
+
+void StreamingPreprocessor::Close()
+{
+    _reader->Close();
+}
+
+
+int StreamingPreprocessor::_Produce()
+{
+    while (_pendingNext == _pendingSize)
+    {
+        if (_exhausted)
+        {
+            return EOF;
+        }
+
+        _pendingSize = _pendingNext = 0;
+
+        const int ch = _reader->Read();
+        if (ch == '\r')
+        {
+            // filter unnecessary '\r'
+            continue;
+        }
+        if (ch == EOF)
+        {
+            _exhausted = true;
+        }
+        _Process(ch);
+    }
+
+    return static_cast<unsigned char>(_pending[_pendingNext++]);
+}
+
+
+// '\r' is already filtered, so every character counts.
+void StreamingPreprocessor::_MoveForward(char ch)
+{
+    if (ch == '\n')
+    {
+        _lines->Add(_offset);
+    }
+    _offset++;
+}
+
+
+void StreamingPreprocessor::_MoveBackward()
+{
+    _offset--;
+}
+
+
+/*
+ * The following is the same state machine as HeaderPreprocessor.
+ */
+void StreamingPreprocessor::_Process(int ch)
+{
+    switch (_state.type)
+    {
+    case StateType::ANY:
+        _ProcessAny(ch);
+        break;
+    case StateType::SLASH:
+        _ProcessSlash(ch);
+        break;
+    case StateType::LINE_COMMENT:
+        _ProcessLineComment(ch);
+        break;
+    case StateType::BLOCK_COMMENT_LEFT:
+        _ProcessBlockCommentLeft(ch);
+        break;
+    case StateType::BLOCK_COMMENT_RIGHT:
+        _ProcessBlockCommentRight(ch);
+        break;
+    case StateType::QUOTE:
+        _ProcessQuote(ch);
+        break;
+    default:
+        TOMIC_PANIC("Unknown state type");
+    }
+}
+
+
+void StreamingPreprocessor::_ProcessAny(int ch)
+{
+    switch (ch)
+    {
+    case '/':
+        _state.type = StateType::SLASH;
+        break;
+    case '\'':
+    case '\"':
+        _state.type = StateType::QUOTE;
+        _state.value = ch;
+        _Emit(ch);
+        break;
+    case '#':
+        _state.type = StateType::LINE_COMMENT;
+        _Emit(FILLING);     // replace '#'
+        break;
+    case EOF:
+        break;
+    default:
+        _Emit(ch);
+        break;
+    }
+}
+
+
+void StreamingPreprocessor::_ProcessSlash(int ch)
+{
+    switch (ch)
+    {
+    case '/':
+        _state.type = StateType::LINE_COMMENT;
+        _Emit(FILLING);     // replace previous '/', too
+        _Emit(FILLING);
+        break;
+    case '*':
+        _state.type = StateType::BLOCK_COMMENT_LEFT;
+        _Emit(FILLING);     // replace previous '/', too
+        _Emit(FILLING);
+        break;
+    case '\'':
+    case '\"':
+        _state.type = StateType::QUOTE;
+        _state.value = ch;
+        _Emit('/');         // add the previous wrong '/'
+        _Emit(ch);
+        break;
+    case EOF:
+        // unfinished /
+        _Emit('/');
+        break;
+    default:
+        _state.type = StateType::ANY;
+        _Emit('/');
+        _Emit(ch);
+        break;
+    }
+}
+
+
+void StreamingPreprocessor::_ProcessLineComment(int ch)
+{
+    switch (ch)
+    {
+    case '\n':
+        _state.type = StateType::ANY;
+        _Emit('\n');
+        break;
+    case EOF:
+        break;
+    default:
+        _Emit(FILLING);
+        break;
+    }
+}
+
+
+void StreamingPreprocessor::_ProcessBlockCommentLeft(int ch)
+{
+    switch (ch)
+    {
+    case '*':
+        _state.type = StateType::BLOCK_COMMENT_RIGHT;
+        break;
+    case '\n':
+        _Emit('\n');
+        break;
+    case EOF:
+        break;
+    default:
+        _Emit(FILLING);
+    }
+}
+
+
+void StreamingPreprocessor::_ProcessBlockCommentRight(int ch)
+{
+    switch (ch)
+    {
+    case '/':
+        _state.type = StateType::ANY;
+        _Emit(FILLING);     // *
+        _Emit(FILLING);     // /
+        break;
+    case '*':
+        // State should remain unchanged.
+        _state.type = StateType::BLOCK_COMMENT_RIGHT;
+        _Emit(FILLING);     // replace the old *
+        break;
+    case '\n':
+        _state.type = StateType::BLOCK_COMMENT_LEFT;
+        _Emit(FILLING);     // wrong *
+        _Emit('\n');
+        break;
+    case EOF:
+        _Emit(FILLING);     // wrong *
+        break;
+    default:
+        _state.type = StateType::BLOCK_COMMENT_LEFT;
+        _Emit(FILLING);     // wrong *
+        _Emit(FILLING);
+        break;
+    }
+}
+
+
+void StreamingPreprocessor::_ProcessQuote(int ch)
+{
+    if (ch == EOF)
+    {
+        return;
+    }
+
+    switch (ch)
+    {
+    case '\'':
+    case '\"':
+        if (ch == _state.value)
+        {
+            // quote matches
+            _state.type = StateType::ANY;
+        }
+        break;
+    default:
+        break;
+    }
+
+    _Emit(ch);
+}
+
+
+TOMIC_END
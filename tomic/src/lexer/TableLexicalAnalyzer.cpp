@@ -0,0 +1,387 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/lexer/impl/TableLexicalAnalyzer.h>
+#include <tomic/lexer/token/ITokenMapper.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>   // EOF
+#include <cstring>
+
+TOMIC_BEGIN
+
+/*
+ * Character classes. The lower bits is the class that decides which
+ * state to start with, and the higher bits are flags used inside states.
+ */
+enum CharClass : unsigned char
+{
+    CC_OTHER = 0,
+    CC_WHITESPACE,
+    CC_DIGIT,
+    CC_LETTER,
+    CC_QUOTE,
+    CC_SINGLE_OP,       // + - * / %
+    CC_DOUBLE_OP,       // & | = < > !
+    CC_DELIMITER,       // , ; ( ) [ ] { }
+
+    CC_MASK = 0x0F
+};
+
+
+enum CharFlag : unsigned char
+{
+    CF_BOUNDARY = 0x10,     // ends a number or an identifier
+    CF_WORD = 0x20,         // can be part of an identifier
+    CF_PRINTABLE = 0x40     // can be in a format string as is
+};
+
+
+static constexpr void _SetClass(std::array<unsigned char, 256>& table, const char* chars, unsigned char value)
+{
+    for (; *chars; chars++)
+    {
+        table[static_cast<unsigned char>(*chars)] = value;
+    }
+}
+
+
+static constexpr std::array<unsigned char, 256> _BuildCharTable()
+{
+    std::array<unsigned char, 256> table {};
+
+    // Same as StringUtil::Contains, '\0' is treated as whitespace.
+    table[0] = CC_WHITESPACE | CF_BOUNDARY;
+    _SetClass(table, " \t\r\n\v\f", CC_WHITESPACE | CF_BOUNDARY);
+    _SetClass(table, "+-*/%", CC_SINGLE_OP | CF_BOUNDARY);
+    _SetClass(table, "&|=<>!", CC_DOUBLE_OP | CF_BOUNDARY);
+    _SetClass(table, ",;()[]{}", CC_DELIMITER | CF_BOUNDARY);
+    _SetClass(table, "0123456789", CC_DIGIT | CF_WORD);
+    _SetClass(table, "_", CC_LETTER | CF_WORD);
+    for (int ch = 'a'; ch <= 'z'; ch++)
+    {
+        table[ch] = CC_LETTER | CF_WORD;
+        table[ch - 'a' + 'A'] = CC_LETTER | CF_WORD;
+    }
+    table['"'] = CC_QUOTE;
+
+    // Normal characters in format string: 32, 33, 40 ~ 126 except 92 ('\').
+    table[32] |= CF_PRINTABLE;
+    table[33] |= CF_PRINTABLE;
+    for (int ch = 40; ch <= 126; ch++)
+    {
+        if (ch != 92)
+        {
+            table[ch] |= CF_PRINTABLE;
+        }
+    }
+
+    return table;
+}
+
+
+static constexpr std::array<unsigned char, 256> _CHAR_TABLE = _BuildCharTable();
+
+
+static inline unsigned char _Class(int ch)
+{
+    return _CHAR_TABLE[ch] & CC_MASK;
+}
+
+
+static inline bool _HasFlag(int ch, CharFlag flag)
+{
+    return (ch != EOF) && (_CHAR_TABLE[ch] & flag);
+}
+
+
+static inline bool _IsBoundary(int ch)
+{
+    return (ch == EOF) || (_CHAR_TABLE[ch] & CF_BOUNDARY);
+}
+
+
+TableLexicalAnalyzer::TableLexicalAnalyzer(ITokenMapperPtr mapper)
+    : _mapper(mapper), _streaming(false),
+    _begin(nullptr), _current(nullptr), _end(nullptr),
+    _origin(nullptr), _base(0)
+{
+    TOMIC_ASSERT(mapper);
+    _InitTypes();
+}
+
+
+TableLexicalAnalyzer* TableLexicalAnalyzer::SetReader(twio::IAdvancedReaderPtr reader)
+{
+    _reader = std::move(reader);
+
+    auto memoryReader = std::dynamic_pointer_cast<twio::MemoryReader>(_reader);
+    if (memoryReader)
+    {
+        return SetContent(memoryReader->Data(), memoryReader->Size(), memoryReader->Offset());
+    }
+
+    _streaming = true;
+    _window.resize(WINDOW_SIZE + 1);
+    _origin = _current = _end = _window.data();
+    _base = _reader->Offset();
+    _begin = _current;
+
+    return this;
+}
+
+
+TableLexicalAnalyzer* TableLexicalAnalyzer::SetContent(const char* data, size_t size, size_t offset)
+{
+    TOMIC_ASSERT(offset <= size);
+
+    _streaming = false;
+    _origin = data;
+    _base = 0;
+    _current = _begin = _origin + offset;
+    _end = _origin + size;
+
+    return this;
+}
+
+
+TableLexicalAnalyzer* TableLexicalAnalyzer::SetArena(TokenArenaPtr arena)
+{
+    _arena = std::move(arena);
+    return this;
+}
+
+
+/*
+ * The DFA loop. States are the same as those LexicalTasks in the
+ * DefaultLexicalAnalyzer, so are the unknown tokens it returns.
+ */
+TokenPtr TableLexicalAnalyzer::Next()
+{
+    _begin = _current;
+    while (_Ensure(1) && (_Class(static_cast<unsigned char>(*_current)) == CC_WHITESPACE))
+    {
+        _Forward();
+        _begin = _current;
+    }
+
+    if (!_Ensure(1))
+    {
+        return _arena->NewToken(TokenType::TK_TERMINATOR, "", 0, _Offset(_current));
+    }
+
+    enum class State
+    {
+        NUMBER,
+        IDENTIFIER,
+        UNKNOWN_WORD,   // bad number or identifier, swallow till boundary
+        STRING
+    };
+
+    const int first = static_cast<unsigned char>(*_begin);
+    _Forward();
+
+    // Position of a token is that after its first character is read.
+    const size_t position = _Offset(_current);
+
+    State state;
+    switch (_Class(first))
+    {
+    case CC_DIGIT:
+        state = State::NUMBER;
+        break;
+    case CC_LETTER:
+        state = State::IDENTIFIER;
+        break;
+    case CC_QUOTE:
+        state = State::STRING;
+        break;
+    case CC_SINGLE_OP:
+    case CC_DELIMITER:
+        return _arena->NewToken(_singleTypes[first], _begin, 1, position);
+    case CC_DOUBLE_OP:
+    {
+        const char second = ((first == '&') || (first == '|') || (first == '=')) ? first : '=';
+        if (_Ensure(1) && (*_current == second))
+        {
+            _Forward();
+            return _arena->NewToken(_doubleTypes[first], _begin, 2, position);
+        }
+        return _arena->NewToken(_singleTypes[first], _begin, 1, position);
+    }
+    default:
+        return _arena->NewToken(TokenType::TK_UNKNOWN, _begin, 1, position);
+    }
+
+    // Only used by string, as '\n' is combined into one character.
+    std::string lexeme;
+    bool error = false;
+
+    if (state == State::STRING)
+    {
+        lexeme += '"';
+    }
+
+    for (;;)
+    {
+        const int ch = _Ensure(1) ? static_cast<unsigned char>(*_current) : EOF;
+        switch (state)
+        {
+        case State::NUMBER:
+            if ((ch != EOF) && (_Class(ch) == CC_DIGIT))
+            {
+                _Forward();
+            }
+            else if (_IsBoundary(ch))
+            {
+                return _arena->NewToken(TokenType::TK_INTEGER, _begin, _current - _begin, position);
+            }
+            else
+            {
+                state = State::UNKNOWN_WORD;
+            }
+            break;
+        case State::IDENTIFIER:
+            if (_HasFlag(ch, CF_WORD))
+            {
+                _Forward();
+            }
+            else if (_IsBoundary(ch))
+            {
+                TokenType type = _mapper->Type(std::string_view(_begin, _current - _begin));
+                if (type == TokenType::TK_UNKNOWN)
+                {
+                    type = TokenType::TK_IDENTIFIER;
+                }
+                return _arena->NewToken(type, _begin, _current - _begin, position);
+            }
+            else
+            {
+                state = State::UNKNOWN_WORD;
+            }
+            break;
+        case State::UNKNOWN_WORD:
+            if (_IsBoundary(ch))
+            {
+                return _arena->NewToken(TokenType::TK_UNKNOWN, _begin, _current - _begin, position);
+            }
+            _Forward();
+            break;
+        case State::STRING:
+            if (ch == EOF)
+            {
+                // Unfinished string.
+                return _arena->NewToken(TokenType::TK_UNKNOWN, lexeme, position);
+            }
+            if (ch == '"')
+            {
+                _Forward();
+                lexeme += '"';
+                return _arena->NewToken(error ? TokenType::TK_UNKNOWN : TokenType::TK_FORMAT, lexeme, position);
+            }
+
+            if (_HasFlag(ch, CF_PRINTABLE))
+            {
+                lexeme += static_cast<char>(ch);
+                _Forward();
+            }
+            else if ((ch == '\\') && _Ensure(2) && (_current[1] == 'n'))
+            {
+                // Combined to the real '\n', the same as DefaultLexicalAnalyzer.
+                lexeme += '\n';
+                _Forward();
+                _Forward();
+            }
+            else if ((ch == '%') && _Ensure(2) && (_current[1] == 'd'))
+            {
+                lexeme += "%d";
+                _Forward();
+                _Forward();
+            }
+            else
+            {
+                lexeme += static_cast<char>(ch);
+                error = true;
+                _Forward();
+            }
+            break;
+        }
+    }
+}
+
+
+void TableLexicalAnalyzer::_InitTypes()
+{
+    for (int i = 0; i < 256; i++)
+    {
+        _singleTypes[i] = TokenType::TK_UNKNOWN;
+        _doubleTypes[i] = TokenType::TK_UNKNOWN;
+    }
+
+    for (const char* p = "+-*/%&|=<>!,;()[]{}"; *p; p++)
+    {
+        _singleTypes[static_cast<unsigned char>(*p)] = _mapper->Type(std::string_view(p, 1));
+    }
+    for (const char* op : { "&&", "||", "==", "<=", ">=", "!=" })
+    {
+        _doubleTypes[static_cast<unsigned char>(*op)] = _mapper->Type(op);
+    }
+}
+
+
+/*
+ * Pull more characters from a streaming reader. Characters of the current
+ * token, i.e. from _begin, are kept and moved to the front of the window.
+ * The window only grows if a single token is larger than it.
+ */
+bool TableLexicalAnalyzer::_Fill(size_t size)
+{
+    if (!_streaming)
+    {
+        return false;
+    }
+
+    const size_t kept = _end - _begin;
+    const size_t offset = _current - _begin;
+    const size_t beginOffset = _Offset(_begin);
+    const size_t capacity = std::max(WINDOW_SIZE, kept + WINDOW_SIZE);
+    if (_window.size() < capacity + 1)
+    {
+        std::string window(capacity + 1, '\0');
+        memcpy(&window[0], _begin, kept);
+        _window.swap(window);
+    }
+    else if (_begin != _window.data())
+    {
+        memmove(&_window[0], _begin, kept);
+    }
+
+    char* base = &_window[0];
+    size_t available = kept;
+    while (available < capacity)
+    {
+        // Read will append a '\0', so the window has one more byte.
+        const size_t count = _reader->Read(base + available, capacity - available);
+        if (count == 0)
+        {
+            _streaming = false;
+            break;
+        }
+        available += count;
+    }
+
+    _base = beginOffset;
+    _origin = base;
+    _begin = base;
+    _current = base + offset;
+    _end = base + available;
+
+    return static_cast<size_t>(_end - _current) >= size;
+}
+
+
+TOMIC_END
@@ -6,189 +6,251 @@
 
 #include <tomic/lexer/impl/token/DefaultTokenMapper.h>
 
+#include <array>
+
 TOMIC_BEGIN
 
-DefaultTokenMapper::DefaultTokenMapper()
+struct FixedLexeme
+{
+    std::string_view lexeme;
+    TokenType type;
+    bool keyword;
+};
+
+
+struct FixedDescription
+{
+    TokenType type;
+    const char* description;
+};
+
+
+static constexpr FixedLexeme _FIXED_LEXEMES[] = {
+    { "main", TokenType::TK_MAIN, true },
+    { "return", TokenType::TK_RETURN, true },
+    { "getint", TokenType::TK_GETINT, true },
+    { "printf", TokenType::TK_PRINTF, true },
+
+    { "if", TokenType::TK_IF, true },
+    { "else", TokenType::TK_ELSE, true },
+
+    { "for", TokenType::TK_FOR, true },
+    { "break", TokenType::TK_BREAK, true },
+    { "continue", TokenType::TK_CONTINUE, true },
+
+    { "const", TokenType::TK_CONST, true },
+    { "int", TokenType::TK_INT, true },
+    { "void", TokenType::TK_VOID, true },
+
+    { "!", TokenType::TK_NOT, false },
+    { "&&", TokenType::TK_AND, false },
+    { "||", TokenType::TK_OR, false },
+    { "+", TokenType::TK_PLUS, false },
+    { "-", TokenType::TK_MINUS, false },
+    { "*", TokenType::TK_MULTIPLY, false },
+    { "/", TokenType::TK_DIVIDE, false },
+    { "%", TokenType::TK_MOD, false },
+    { "<", TokenType::TK_LESS, false },
+    { "<=", TokenType::TK_LESS_EQUAL, false },
+    { ">", TokenType::TK_GREATER, false },
+    { ">=", TokenType::TK_GREATER_EQUAL, false },
+    { "==", TokenType::TK_EQUAL, false },
+    { "!=", TokenType::TK_NOT_EQUAL, false },
+    { "=", TokenType::TK_ASSIGN, false },
+
+    { ";", TokenType::TK_SEMICOLON, false },
+    { ",", TokenType::TK_COMMA, false },
+
+    { "(", TokenType::TK_LEFT_PARENTHESIS, false },
+    { ")", TokenType::TK_RIGHT_PARENTHESIS, false },
+    { "{", TokenType::TK_LEFT_BRACE, false },
+    { "}", TokenType::TK_RIGHT_BRACE, false },
+    { "[", TokenType::TK_LEFT_BRACKET, false },
+    { "]", TokenType::TK_RIGHT_BRACKET, false },
+};
+
+
+static constexpr FixedDescription _FIXED_DESCRIPTIONS[] = {
+    { TokenType::TK_UNKNOWN, "UNKNOWN" },
+    { TokenType::TK_IDENTIFIER, "IDENFR" },
+    { TokenType::TK_INTEGER, "INTCON" },
+    { TokenType::TK_FORMAT, "STRCON" },
+    { TokenType::TK_MAIN, "MAINTK" },
+    { TokenType::TK_RETURN, "RETURNTK" },
+    { TokenType::TK_GETINT, "GETINTTK" },
+    { TokenType::TK_PRINTF, "PRINTFTK" },
+
+    { TokenType::TK_IF, "IFTK" },
+    { TokenType::TK_ELSE, "ELSETK" },
+
+    { TokenType::TK_FOR, "FORTK" },
+    { TokenType::TK_BREAK, "BREAKTK" },
+    { TokenType::TK_CONTINUE, "CONTINUETK" },
+
+    { TokenType::TK_CONST, "CONSTTK" },
+    { TokenType::TK_INT, "INTTK" },
+    { TokenType::TK_VOID, "VOIDTK" },
+
+    { TokenType::TK_NOT, "NOT" },
+    { TokenType::TK_AND, "AND" },
+    { TokenType::TK_OR, "OR" },
+    { TokenType::TK_PLUS, "PLUS" },
+    { TokenType::TK_MINUS, "MINU" },
+    { TokenType::TK_MULTIPLY, "MULT" },
+    { TokenType::TK_DIVIDE, "DIV" },
+    { TokenType::TK_MOD, "MOD" },
+    { TokenType::TK_LESS, "LSS" },
+    { TokenType::TK_LESS_EQUAL, "LEQ" },
+    { TokenType::TK_GREATER, "GRE" },
+    { TokenType::TK_GREATER_EQUAL, "GEQ" },
+    { TokenType::TK_EQUAL, "EQL" },
+    { TokenType::TK_NOT_EQUAL, "NEQ" },
+    { TokenType::TK_ASSIGN, "ASSIGN" },
+
+    { TokenType::TK_SEMICOLON, "SEMICN" },
+    { TokenType::TK_COMMA, "COMMA" },
+
+    { TokenType::TK_LEFT_PARENTHESIS, "LPARENT" },
+    { TokenType::TK_RIGHT_PARENTHESIS, "RPARENT" },
+    { TokenType::TK_LEFT_BRACE, "LBRACE" },
+    { TokenType::TK_RIGHT_BRACE, "RBRACE" },
+    { TokenType::TK_LEFT_BRACKET, "LBRACK" },
+    { TokenType::TK_RIGHT_BRACKET, "RBRACK" },
+};
+
+
+static constexpr int _FIXED_LEXEME_COUNT = sizeof(_FIXED_LEXEMES) / sizeof(FixedLexeme);
+static constexpr int _TYPE_COUNT = static_cast<int>(TokenType::TK_RIGHT_BRACKET) + 1;
+
+
+/*
+ * The hash only looks at the first and the last character, and the length.
+ * The coefficients are chosen so that there is no collision among all fixed
+ * lexemes in a table of HASH_SIZE, which is checked at compile time.
+ */
+static constexpr size_t HASH_SIZE = 128;
+
+
+static constexpr size_t _Hash(std::string_view lexeme)
 {
-    _Init();
+    return (static_cast<unsigned char>(lexeme.front())
+        + 10 * static_cast<unsigned char>(lexeme.back())
+        + 14 * lexeme.length()) & (HASH_SIZE - 1);
 }
 
 
-TokenType DefaultTokenMapper::Type(const std::string& lexeme) const
+// Each slot is the index in _FIXED_LEXEMES, or -1 if empty.
+static constexpr std::array<int, HASH_SIZE> _BuildHashTable()
 {
-    auto iter = _lexemeToType.find(lexeme);
-    if (iter == _lexemeToType.end())
+    std::array<int, HASH_SIZE> table {};
+    for (size_t i = 0; i < HASH_SIZE; i++)
     {
-        return TokenType::TK_UNKNOWN;
+        table[i] = -1;
     }
-    return iter->second;
+    for (int i = 0; i < _FIXED_LEXEME_COUNT; i++)
+    {
+        table[_Hash(_FIXED_LEXEMES[i].lexeme)] = i;
+    }
+    return table;
 }
 
 
-const char* DefaultTokenMapper::Lexeme(TokenType type) const
+static constexpr std::array<int, HASH_SIZE> _HASH_TABLE = _BuildHashTable();
+
+
+static constexpr bool _IsPerfectHash()
 {
-    auto iter = _typeToLexeme.find(type);
-    if (iter == _typeToLexeme.end())
+    int count = 0;
+    for (size_t i = 0; i < HASH_SIZE; i++)
     {
-        return nullptr;
+        if (_HASH_TABLE[i] >= 0)
+        {
+            count++;
+        }
     }
-    return iter->second.c_str();
+    return count == _FIXED_LEXEME_COUNT;
 }
 
 
-const char* DefaultTokenMapper::Description(TokenType type) const
+static_assert(_IsPerfectHash(), "Hash of fixed lexemes collides, choose other coefficients");
+
+
+static constexpr std::array<const char*, _TYPE_COUNT> _BuildLexemeTable()
 {
-    auto iter = _typeToDescription.find(type);
-    if (iter == _typeToDescription.end())
+    std::array<const char*, _TYPE_COUNT> table {};
+    for (int i = 0; i < _FIXED_LEXEME_COUNT; i++)
     {
-        return nullptr;
+        table[static_cast<int>(_FIXED_LEXEMES[i].type)] = _FIXED_LEXEMES[i].lexeme.data();
     }
-    return iter->second.c_str();
+    return table;
 }
 
 
-bool DefaultTokenMapper::IsKeyword(const std::string& lexeme) const
+static constexpr std::array<const char*, _TYPE_COUNT> _BuildDescriptionTable()
 {
-    auto iter = _lexemeToIsKeyword.find(lexeme);
-    if (iter == _lexemeToIsKeyword.end())
+    std::array<const char*, _TYPE_COUNT> table {};
+    for (const auto& entry : _FIXED_DESCRIPTIONS)
     {
-        return false;
+        table[static_cast<int>(entry.type)] = entry.description;
     }
-    return iter->second;
+    return table;
 }
 
 
-void DefaultTokenMapper::_Init()
+static constexpr std::array<const char*, _TYPE_COUNT> _LEXEME_TABLE = _BuildLexemeTable();
+static constexpr std::array<const char*, _TYPE_COUNT> _DESCRIPTION_TABLE = _BuildDescriptionTable();
+
+
+static const FixedLexeme* _Find(std::string_view lexeme)
 {
-    _InitLexemeToType();
-    _InitTypeToLexeme();
-    _InitTypeToDescription();
-    _InitLexemeToIsKeyword();
+    if (lexeme.empty())
+    {
+        return nullptr;
+    }
+
+    const int index = _HASH_TABLE[_Hash(lexeme)];
+    if ((index < 0) || (_FIXED_LEXEMES[index].lexeme != lexeme))
+    {
+        return nullptr;
+    }
+
+    return &_FIXED_LEXEMES[index];
 }
 
 
-void DefaultTokenMapper::_InitLexemeToType()
+TokenType DefaultTokenMapper::Type(std::string_view lexeme) const
 {
-    _lexemeToType["main"] = TokenType::TK_MAIN;
-    _lexemeToType["return"] = TokenType::TK_RETURN;
-    _lexemeToType["getint"] = TokenType::TK_GETINT;
-    _lexemeToType["printf"] = TokenType::TK_PRINTF;
-
-    _lexemeToType["if"] = TokenType::TK_IF;
-    _lexemeToType["else"] = TokenType::TK_ELSE;
-
-    _lexemeToType["for"] = TokenType::TK_FOR;
-    _lexemeToType["break"] = TokenType::TK_BREAK;
-    _lexemeToType["continue"] = TokenType::TK_CONTINUE;
-
-    _lexemeToType["const"] = TokenType::TK_CONST;
-    _lexemeToType["int"] = TokenType::TK_INT;
-    _lexemeToType["void"] = TokenType::TK_VOID;
-
-    _lexemeToType["!"] = TokenType::TK_NOT;
-    _lexemeToType["&&"] = TokenType::TK_AND;
-    _lexemeToType["||"] = TokenType::TK_OR;
-    _lexemeToType["+"] = TokenType::TK_PLUS;
-    _lexemeToType["-"] = TokenType::TK_MINUS;
-    _lexemeToType["*"] = TokenType::TK_MULTIPLY;
-    _lexemeToType["/"] = TokenType::TK_DIVIDE;
-    _lexemeToType["%"] = TokenType::TK_MOD;
-    _lexemeToType["<"] = TokenType::TK_LESS;
-    _lexemeToType["<="] = TokenType::TK_LESS_EQUAL;
-    _lexemeToType[">"] = TokenType::TK_GREATER;
-    _lexemeToType[">="] = TokenType::TK_GREATER_EQUAL;
-    _lexemeToType["=="] = TokenType::TK_EQUAL;
-    _lexemeToType["!="] = TokenType::TK_NOT_EQUAL;
-    _lexemeToType["="] = TokenType::TK_ASSIGN;
-
-    _lexemeToType[";"] = TokenType::TK_SEMICOLON;
-    _lexemeToType[","] = TokenType::TK_COMMA;
-
-    _lexemeToType["("] = TokenType::TK_LEFT_PARENTHESIS;
-    _lexemeToType[")"] = TokenType::TK_RIGHT_PARENTHESIS;
-    _lexemeToType["{"] = TokenType::TK_LEFT_BRACE;
-    _lexemeToType["}"] = TokenType::TK_RIGHT_BRACE;
-    _lexemeToType["["] = TokenType::TK_LEFT_BRACKET;
-    _lexemeToType["]"] = TokenType::TK_RIGHT_BRACKET;
+    const FixedLexeme* entry = _Find(lexeme);
+    return entry ? entry->type : TokenType::TK_UNKNOWN;
 }
 
 
-void DefaultTokenMapper::_InitTypeToLexeme()
+const char* DefaultTokenMapper::Lexeme(TokenType type) const
 {
-    for (auto& pair : _lexemeToType)
+    const int index = static_cast<int>(type);
+    if ((index < 0) || (index >= _TYPE_COUNT))
     {
-        _typeToLexeme[pair.second] = pair.first;
+        return nullptr;
     }
+    return _LEXEME_TABLE[index];
 }
 
 
-void DefaultTokenMapper::_InitTypeToDescription()
+const char* DefaultTokenMapper::Description(TokenType type) const
 {
-    _typeToDescription[TokenType::TK_UNKNOWN] = "UNKNOWN";
-    _typeToDescription[TokenType::TK_IDENTIFIER] = "IDENFR";
-    _typeToDescription[TokenType::TK_INTEGER] = "INTCON";
-    _typeToDescription[TokenType::TK_FORMAT] = "STRCON";
-    _typeToDescription[TokenType::TK_MAIN] = "MAINTK";
-    _typeToDescription[TokenType::TK_RETURN] = "RETURNTK";
-    _typeToDescription[TokenType::TK_GETINT] = "GETINTTK";
-    _typeToDescription[TokenType::TK_PRINTF] = "PRINTFTK";
-
-    _typeToDescription[TokenType::TK_IF] = "IFTK";
-    _typeToDescription[TokenType::TK_ELSE] = "ELSETK";
-
-    _typeToDescription[TokenType::TK_FOR] = "FORTK";
-    _typeToDescription[TokenType::TK_BREAK] = "BREAKTK";
-    _typeToDescription[TokenType::TK_CONTINUE] = "CONTINUETK";
-
-    _typeToDescription[TokenType::TK_CONST] = "CONSTTK";
-    _typeToDescription[TokenType::TK_INT] = "INTTK";
-    _typeToDescription[TokenType::TK_VOID] = "VOIDTK";
-
-    _typeToDescription[TokenType::TK_NOT] = "NOT";
-    _typeToDescription[TokenType::TK_AND] = "AND";
-    _typeToDescription[TokenType::TK_OR] = "OR";
-    _typeToDescription[TokenType::TK_PLUS] = "PLUS";
-    _typeToDescription[TokenType::TK_MINUS] = "MINU";
-    _typeToDescription[TokenType::TK_MULTIPLY] = "MULT";
-    _typeToDescription[TokenType::TK_DIVIDE] = "DIV";
-    _typeToDescription[TokenType::TK_MOD] = "MOD";
-    _typeToDescription[TokenType::TK_LESS] = "LSS";
-    _typeToDescription[TokenType::TK_LESS_EQUAL] = "LEQ";
-    _typeToDescription[TokenType::TK_GREATER] = "GRE";
-    _typeToDescription[TokenType::TK_GREATER_EQUAL] = "GEQ";
-    _typeToDescription[TokenType::TK_EQUAL] = "EQL";
-    _typeToDescription[TokenType::TK_NOT_EQUAL] = "NEQ";
-    _typeToDescription[TokenType::TK_ASSIGN] = "ASSIGN";
-
-    _typeToDescription[TokenType::TK_SEMICOLON] = "SEMICN";
-    _typeToDescription[TokenType::TK_COMMA] = "COMMA";
-
-    _typeToDescription[TokenType::TK_LEFT_PARENTHESIS] = "LPARENT";
-    _typeToDescription[TokenType::TK_RIGHT_PARENTHESIS] = "RPARENT";
-    _typeToDescription[TokenType::TK_LEFT_BRACE] = "LBRACE";
-    _typeToDescription[TokenType::TK_RIGHT_BRACE] = "RBRACE";
-    _typeToDescription[TokenType::TK_LEFT_BRACKET] = "LBRACK";
-    _typeToDescription[TokenType::TK_RIGHT_BRACKET] = "RBRACK";
-};
+    const int index = static_cast<int>(type);
+    if ((index < 0) || (index >= _TYPE_COUNT))
+    {
+        return nullptr;
+    }
+    return _DESCRIPTION_TABLE[index];
+}
 
 
-void DefaultTokenMapper::_InitLexemeToIsKeyword()
+bool DefaultTokenMapper::IsKeyword(std::string_view lexeme) const
 {
-    _lexemeToIsKeyword["main"] = true;
-    _lexemeToIsKeyword["return"] = true;
-    _lexemeToIsKeyword["getint"] = true;
-    _lexemeToIsKeyword["printf"] = true;
-
-    _lexemeToIsKeyword["if"] = true;
-    _lexemeToIsKeyword["else"] = true;
-
-    _lexemeToIsKeyword["for"] = true;
-    _lexemeToIsKeyword["break"] = true;
-    _lexemeToIsKeyword["continue"] = true;
-
-    _lexemeToIsKeyword["const"] = true;
-    _lexemeToIsKeyword["int"] = true;
-    _lexemeToIsKeyword["void"] = true;
+    const FixedLexeme* entry = _Find(lexeme);
+    return entry && entry->keyword;
 }
 
 
@@ -0,0 +1,253 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/lexer/token/Token.h>
+
+#include <algorithm>
+#include <cstring>
+
+TOMIC_BEGIN
+
+TokenArena::TokenArena() : _used(0)
+{
+}
+
+
+std::shared_ptr<TokenArena> TokenArena::New()
+{
+    return std::make_shared<TokenArena>();
+}
+
+
+TokenPtr TokenArena::NewToken(TokenType type, const char* lexeme, size_t length, size_t position)
+{
+    TOMIC_ASSERT(length < (1 << 24));
+    TOMIC_ASSERT(position < Token::NO_POSITION);
+
+    Token token;
+    token.type = type;
+    token.length = static_cast<uint32_t>(length);
+    token.offset = _NewLexeme(lexeme, length);
+    token.position = static_cast<uint32_t>(position);
+
+    return _Push(token);
+}
+
+
+TokenPtr TokenArena::NewToken(TokenType type, const std::string& lexeme, size_t position)
+{
+    return NewToken(type, lexeme.c_str(), lexeme.length(), position);
+}
+
+
+TokenPtr TokenArena::NewToken(TokenType type)
+{
+    Token token;
+    token.type = type;
+    token.length = 0;
+    token.offset = _NewLexeme("", 0);
+    token.position = Token::NO_POSITION;
+
+    return _Push(token);
+}
+
+
+TokenArena* TokenArena::Append(TokenArena& other, size_t count)
+{
+    TOMIC_ASSERT(count <= other._tokens.size());
+
+    if (count == 0)
+    {
+        return this;
+    }
+
+    // Blocks of other are placed after ours, so their offsets are shifted
+    // by our capacity. The rest of our current block is wasted.
+    const uint32_t base = static_cast<uint32_t>(_blocks.size() * BLOCK_SIZE);
+    TOMIC_ASSERT(base + static_cast<size_t>(other._used) < UINT32_MAX);
+
+    _tokens.reserve(_tokens.size() + count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Token token = other._tokens[i];
+        token.offset += base;
+        token.position = other.Position(static_cast<uint32_t>(i));
+        _Push(token);
+    }
+
+    _blocks.insert(_blocks.end(), other._blocks.begin(), other._blocks.end());
+    for (auto& storage : other._storage)
+    {
+        _storage.push_back(std::move(storage));
+    }
+    _used = base + other._used;
+
+    other._tokens.clear();
+    other._shifts.clear();
+    other._blocks.clear();
+    other._storage.clear();
+    other._used = 0;
+
+    return this;
+}
+
+
+int TokenArena::LineNo(uint32_t index) const
+{
+    const uint32_t position = Position(index);
+    if (!_lines || (position == Token::NO_POSITION))
+    {
+        return 0;
+    }
+    return _lines->Line(position);
+}
+
+
+int TokenArena::CharNo(uint32_t index) const
+{
+    const uint32_t position = Position(index);
+    if (!_lines || (position == Token::NO_POSITION))
+    {
+        return 0;
+    }
+    return _lines->Char(position);
+}
+
+
+TokenArena* TokenArena::SetLines(twio::LineIndexPtr lines)
+{
+    _lines = std::move(lines);
+    return this;
+}
+
+
+// Position is one past the first character, so a token starts at or after
+// offset if its position is greater than offset.
+TokenArena* TokenArena::Shift(size_t offset, ptrdiff_t delta)
+{
+    const int64_t limit = static_cast<int64_t>(offset);
+    for (size_t k = 0; k < _shifts.size(); k++)
+    {
+        ShiftBlock& block = _shifts[k];
+        if (block.min > block.max)
+        {
+            // Only pseudo tokens.
+            continue;
+        }
+
+        if (block.min + block.delta > limit)
+        {
+            block.delta += delta;
+        }
+        else if (block.max + block.delta > limit)
+        {
+            const size_t first = k << SHIFT_BITS;
+            const size_t last = std::min(first + SHIFT_SIZE, _tokens.size());
+            _Normalize(block, first);
+            block.min = UINT32_MAX;
+            block.max = 0;
+            for (size_t i = first; i < last; i++)
+            {
+                Token& token = _tokens[i];
+                if (token.position == Token::NO_POSITION)
+                {
+                    continue;
+                }
+                if (token.position > offset)
+                {
+                    token.position = static_cast<uint32_t>(token.position + delta);
+                }
+                block.min = std::min(block.min, token.position);
+                block.max = std::max(block.max, token.position);
+            }
+        }
+    }
+
+    return this;
+}
+
+
+TokenPtr TokenArena::_Push(Token token)
+{
+    const size_t index = _tokens.size();
+    if ((index >> SHIFT_BITS) == _shifts.size())
+    {
+        _shifts.push_back({ 0, UINT32_MAX, 0 });
+    }
+
+    if (token.position != Token::NO_POSITION)
+    {
+        // New position is not relative to the delta.
+        ShiftBlock& block = _shifts.back();
+        if (block.delta != 0)
+        {
+            _Normalize(block, index & ~static_cast<size_t>(SHIFT_SIZE - 1));
+        }
+        block.min = std::min(block.min, token.position);
+        block.max = std::max(block.max, token.position);
+    }
+
+    _tokens.push_back(token);
+
+    return { this, static_cast<uint32_t>(index) };
+}
+
+
+void TokenArena::_Normalize(ShiftBlock& block, size_t index)
+{
+    if (block.delta == 0)
+    {
+        return;
+    }
+
+    const size_t last = std::min(index + SHIFT_SIZE, _tokens.size());
+    for (size_t i = index; i < last; i++)
+    {
+        Token& token = _tokens[i];
+        if (token.position != Token::NO_POSITION)
+        {
+            token.position = static_cast<uint32_t>(token.position + block.delta);
+        }
+    }
+    if (block.min <= block.max)
+    {
+        block.min = static_cast<uint32_t>(block.min + block.delta);
+        block.max = static_cast<uint32_t>(block.max + block.delta);
+    }
+    block.delta = 0;
+}
+
+
+uint32_t TokenArena::_NewLexeme(const char* lexeme, size_t length)
+{
+    const size_t size = length + 1;
+    const size_t capacity = _blocks.size() * BLOCK_SIZE;
+
+    if (capacity - _used < size)
+    {
+        // Not enough space in the current block, start a new one. The rest
+        // of the current block is wasted, which is acceptable.
+        const size_t count = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        _storage.emplace_back(new char[count * BLOCK_SIZE]);
+        char* block = _storage.back().get();
+        for (size_t i = 0; i < count; i++)
+        {
+            _blocks.push_back(block + i * BLOCK_SIZE);
+        }
+        _used = static_cast<uint32_t>(capacity);
+    }
+
+    const uint32_t offset = _used;
+    char* dest = _blocks[offset >> BLOCK_BITS] + (offset & (BLOCK_SIZE - 1));
+    memcpy(dest, lexeme, length);
+    dest[length] = '\0';
+    _used += static_cast<uint32_t>(size);
+
+    return offset;
+}
+
+
+TOMIC_END
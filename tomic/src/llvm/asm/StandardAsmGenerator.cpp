@@ -20,6 +20,7 @@
 #include <tomic/parser/table/SymbolTableBlock.h>
 #include <tomic/utils/SemanticUtil.h>
 #include <tomic/utils/StringUtil.h>
+#include <tomic/utils/Trace.h>
 
 TOMIC_LLVM_BEGIN
 
@@ -34,6 +35,8 @@ ModuleSmartPtr StandardAsmGenerator::Generate(
     SymbolTablePtr symbolTable,
     const char* name)
 {
+    TOMIC_TRACE("ir", "StandardAsmGenerator::Generate");
+
     _syntaxTree = syntaxTree;
     _symbolTable = symbolTable;
 
@@ -87,7 +90,7 @@ void StandardAsmGenerator::_ParseGlobalDecl(SyntaxNodePtr node)
 GlobalVariablePtr StandardAsmGenerator::_ParseGlobalVarDef(SyntaxNodePtr node)
 {
     // Get variable name.
-    const std::string& name = node->FirstChild()->Token()->lexeme;
+    const char* name = node->FirstChild()->Token().Lexeme();
     auto entry = _GetSymbolTableBlock(node)->FindEntry(name);
 
     /*
@@ -120,7 +123,7 @@ GlobalVariablePtr StandardAsmGenerator::_ParseGlobalVarDef(SyntaxNodePtr node)
 GlobalVariablePtr StandardAsmGenerator::_ParseGlobalConstantDef(SyntaxNodePtr node)
 {
     // Get constant name.
-    const std::string& name = node->FirstChild()->Token()->lexeme;
+    const char* name = node->FirstChild()->Token().Lexeme();
     auto entry = _GetSymbolTableBlock(node)->FindEntry(name);
     // Warning: Global values must be pointer type.
     auto type = _module->Context()->GetPointerType(_GetEntryType(entry));
@@ -149,15 +152,15 @@ GlobalVariablePtr StandardAsmGenerator::_ParseGlobalConstantDef(SyntaxNodePtr no
 // node is a InitVal or ConstInitVal.
 ConstantDataPtr StandardAsmGenerator::_ParseGlobalInitValue(SyntaxNodePtr node)
 {
-    if (!node->BoolAttribute("det"))
+    if (!node->BoolAttribute(SyntaxAttribute::SA_DET))
     {
         TOMIC_PANIC("Global initialization value must be deterministic");
     }
 
-    int dim = node->IntAttribute("dim");
+    int dim = node->IntAttribute(SyntaxAttribute::SA_DIM);
     if (dim == 0)
     {
-        return ConstantData::New(_module->Context()->GetInt32Ty(), node->IntAttribute("value"));
+        return ConstantData::New(_module->Context()->GetInt32Ty(), node->IntAttribute(SyntaxAttribute::SA_VALUE));
     }
 
     std::vector<ConstantDataPtr> values;
@@ -184,7 +187,7 @@ void StandardAsmGenerator::_ParseVariableDecl(SyntaxNodePtr node)
         {
             if (it->Type() == SyntaxType::ST_VAR_DEF || it->Type() == SyntaxType::ST_CONST_DEF)
             {
-                if (it->IntAttribute("dim") == 0)
+                if (it->IntAttribute(SyntaxAttribute::SA_DIM) == 0)
                 {
                     _ParseVariableDef(it);
                 }
@@ -205,7 +208,7 @@ void StandardAsmGenerator::_ParseVariableDecl(SyntaxNodePtr node)
 AllocaInstPtr StandardAsmGenerator::_ParseVariableDef(SyntaxNodePtr node)
 {
     // Get variable name.
-    const std::string& name = node->FirstChild()->Token()->lexeme;
+    const char* name = node->FirstChild()->Token().Lexeme();
     auto entry = _GetSymbolTableBlock(node)->FindEntry(name);
     auto type = _GetEntryType(entry);
     AllocaInstPtr address = AllocaInst::New(type);
@@ -301,7 +304,7 @@ static const char* _SplitFormat(const char* format);
 void StandardAsmGenerator::_ParseOutputStatement(SyntaxNodePtr node)
 {
     auto context = _module->Context();
-    const char* format = node->ChildAt(2)->Token()->lexeme.c_str();
+    const char* format = node->ChildAt(2)->Token().Lexeme();
     int paramNo = 0;
 
     const char* str = _SplitFormat(format);
@@ -374,9 +377,9 @@ ValuePtr StandardAsmGenerator::_ParseExpression(SyntaxNodePtr node)
 {
     auto context = _module->Context();
 
-    if (node->BoolAttribute("det"))
+    if (node->BoolAttribute(SyntaxAttribute::SA_DET))
     {
-        int value = node->IntAttribute("value");
+        int value = node->IntAttribute(SyntaxAttribute::SA_VALUE);
         auto type = IntegerType::Get(context, 32);
         return ConstantData::New(type, value);
     }
@@ -389,9 +392,9 @@ ValuePtr StandardAsmGenerator::_ParseAddExp(SyntaxNodePtr node)
 {
     auto context = _module->Context();
 
-    if (node->BoolAttribute("det"))
+    if (node->BoolAttribute(SyntaxAttribute::SA_DET))
     {
-        int value = node->IntAttribute("value");
+        int value = node->IntAttribute(SyntaxAttribute::SA_VALUE);
         auto type = IntegerType::Get(context, 32);
         return ConstantData::New(type, value);
     }
@@ -400,7 +403,7 @@ ValuePtr StandardAsmGenerator::_ParseAddExp(SyntaxNodePtr node)
     {
         // AddExp + MulExp
         auto lhs = _ParseAddExp(node->FirstChild());
-        auto op = node->ChildAt(1)->Token()->lexeme.c_str();
+        auto op = node->ChildAt(1)->Token().Lexeme();
         auto rhs = _ParseMulExp(node->LastChild());
         switch (op[0])
         {
@@ -423,9 +426,9 @@ ValuePtr StandardAsmGenerator::_ParseMulExp(SyntaxNodePtr node)
 {
     auto context = _module->Context();
 
-    if (node->BoolAttribute("det"))
+    if (node->BoolAttribute(SyntaxAttribute::SA_DET))
     {
-        int value = node->IntAttribute("value");
+        int value = node->IntAttribute(SyntaxAttribute::SA_VALUE);
         auto type = IntegerType::Get(context, 32);
         return ConstantData::New(type, value);
     }
@@ -434,7 +437,7 @@ ValuePtr StandardAsmGenerator::_ParseMulExp(SyntaxNodePtr node)
     {
         // MulExp * UnaryExp
         auto lhs = _ParseMulExp(node->FirstChild());
-        auto op = node->ChildAt(1)->Token()->lexeme.c_str();
+        auto op = node->ChildAt(1)->Token().Lexeme();
         auto rhs = _ParseUnaryExp(node->LastChild());
 
         switch (op[0])
@@ -532,7 +535,7 @@ ValuePtr StandardAsmGenerator::_ParseFunctionCall(SyntaxNodePtr node)
 ValuePtr StandardAsmGenerator::_ParseLVal(SyntaxNodePtr node)
 {
     // TODO: Add support for array!
-    if (node->IntAttribute("dim") != 0)
+    if (node->IntAttribute(SyntaxAttribute::SA_DIM) != 0)
     {
         TOMIC_PANIC("Not implemented yet");
         return nullptr;
@@ -544,13 +547,13 @@ ValuePtr StandardAsmGenerator::_ParseLVal(SyntaxNodePtr node)
 
 ValuePtr StandardAsmGenerator::_ParseNumber(SyntaxNodePtr node)
 {
-    if (!node->BoolAttribute("det"))
+    if (!node->BoolAttribute(SyntaxAttribute::SA_DET))
     {
         TOMIC_PANIC("Number must be deterministic");
         return nullptr;
     }
 
-    return ConstantData::New(_module->Context()->GetInt32Ty(), node->IntAttribute("value"));
+    return ConstantData::New(_module->Context()->GetInt32Ty(), node->IntAttribute(SyntaxAttribute::SA_VALUE));
 }
 
 
@@ -18,6 +18,7 @@
 #include <tomic/parser/ast/SyntaxTree.h>
 #include <tomic/parser/table/SymbolTable.h>
 #include <tomic/parser/table/SymbolTableBlock.h>
+#include <tomic/utils/Trace.h>
 #include <tomic/parser/table/SymbolTableEntry.h>
 #include <tomic/utils/SemanticUtil.h>
 #include <vector>
@@ -95,6 +96,8 @@ FunctionPtr StandardAsmGenerator::_ParseMainFunction(SyntaxNodePtr node)
 // node is a FuncDef
 FunctionPtr StandardAsmGenerator::_ParseFunction(SyntaxNodePtr node)
 {
+    TOMIC_TRACE("ir", __func__);
+
     // Get return type.
     auto decl = node->FirstChild();
     TypePtr returnType = _GetNodeType(decl);
@@ -119,7 +122,7 @@ FunctionPtr StandardAsmGenerator::_ParseFunction(SyntaxNodePtr node)
     }
 
     // Get function.
-    const std::string& name = decl->ChildAt(1)->Token()->lexeme;
+    const char* name = decl->ChildAt(1)->Token().Lexeme();
     auto entry = _GetSymbolTableBlock(node)->FindEntry(name);
     FunctionPtr function = Function::New(returnType, name, args);
     auto body = _InitFunctionParams(function, block);
@@ -229,7 +232,11 @@ void StandardAsmGenerator::_ParseStatement(SyntaxNodePtr node)
         _ParseAssignStatement(node);
         break;
     case SyntaxType::ST_EXP_STMT:
-        _ParseExpression(node->FirstChild());
+        // An empty statement has only ';'.
+        if (node->FirstChild()->Type() == SyntaxType::ST_EXP)
+        {
+            _ParseExpression(node->FirstChild());
+        }
         break;
     case SyntaxType::ST_IN_STMT:
         _ParseInputStatement(node);
@@ -251,7 +258,7 @@ SymbolTableBlockPtr StandardAsmGenerator::_GetSymbolTableBlock(SyntaxNodePtr nod
 {
     TOMIC_ASSERT(node);
 
-    int tbl = SemanticUtil::GetInheritedIntAttribute(node, "tbl", -1);
+    int tbl = SemanticUtil::GetInheritedIntAttribute(node, SyntaxAttribute::SA_TBL, -1);
     auto block = _symbolTable->GetBlock(tbl);
 
     TOMIC_ASSERT(block);
@@ -288,7 +295,7 @@ ValuePtr StandardAsmGenerator::_GetValue(SymbolTableEntryPtr entry)
 ValuePtr StandardAsmGenerator::_GetLValValue(SyntaxNodePtr node)
 {
     auto block = _GetSymbolTableBlock(node);
-    auto entry = block->FindEntry(node->FirstChild()->Token()->lexeme);
+    auto entry = block->FindEntry(node->FirstChild()->Token().Lexeme());
 
     return _GetValue(entry);
 }
@@ -298,7 +305,7 @@ ValuePtr StandardAsmGenerator::_GetLValValue(SyntaxNodePtr node)
 FunctionPtr StandardAsmGenerator::_GetFunction(SyntaxNodePtr node)
 {
     auto block = _GetSymbolTableBlock(node);
-    auto entry = block->FindEntry(node->FirstChild()->Token()->lexeme);
+    auto entry = block->FindEntry(node->FirstChild()->Token().Lexeme());
 
     return _GetValue(entry)->As<Function>();
 }
@@ -336,9 +343,9 @@ TypePtr StandardAsmGenerator::_GetEntryType(SymbolTableEntryPtr entry)
 
 TypePtr StandardAsmGenerator::_GetNodeType(SyntaxNodePtr node)
 {
-    TOMIC_ASSERT(node->HasAttribute("type"));
+    TOMIC_ASSERT(node->HasAttribute(SyntaxAttribute::SA_TYPE));
 
-    switch (static_cast<SymbolValueType>(node->IntAttribute("type")))
+    switch (static_cast<SymbolValueType>(node->IntAttribute(SyntaxAttribute::SA_TYPE)))
     {
     case SymbolValueType::VT_INT:
         return IntegerType::Get(_module->Context(), 32);
@@ -9,11 +9,14 @@
 #include <tomic/llvm/ir/Module.h>
 #include <tomic/llvm/ir/value/Function.h>
 #include <tomic/llvm/ir/value/GlobalVariable.h>
+#include <tomic/utils/Trace.h>
 
 TOMIC_LLVM_BEGIN
 
 void StandardAsmPrinter::Print(ModulePtr module, twio::IWriterPtr writer)
 {
+    TOMIC_TRACE("print", "StandardAsmPrinter::Print");
+
     auto asmWriter = StandardAsmWriter::New(writer);
     _PrintModule(asmWriter, module);
 }
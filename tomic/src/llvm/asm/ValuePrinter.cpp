@@ -16,6 +16,7 @@
 #include <tomic/llvm/ir/value/inst/InstructionTypes.h>
 #include <tomic/llvm/ir/value/Value.h>
 #include <tomic/utils/StringUtil.h>
+#include <tomic/utils/Trace.h>
 
 TOMIC_LLVM_BEGIN
 
@@ -216,6 +217,8 @@ void GlobalString::PrintAsm(IAsmWriterPtr writer)
  */
 void Function::PrintAsm(IAsmWriterPtr writer)
 {
+    TOMIC_TRACE("print", "Function::PrintAsm");
+
     auto rawType = GetType();
     TOMIC_ASSERT(rawType->IsFunctionTy());
     auto type = rawType->As<FunctionType>();
@@ -9,11 +9,14 @@
 #include <tomic/llvm/ir/Module.h>
 #include <tomic/llvm/ir/value/Function.h>
 #include <tomic/llvm/ir/value/GlobalVariable.h>
+#include <tomic/utils/Trace.h>
 
 TOMIC_LLVM_BEGIN
 
 void VerboseAsmPrinter::Print(ModulePtr module, twio::IWriterPtr writer)
 {
+    TOMIC_TRACE("print", "VerboseAsmPrinter::Print");
+
     auto asmWriter = VerboseAsmWriter::New(writer);
 
     _PrintHeader(asmWriter);
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/logger/debug/impl/BufferedLogger.h>
+
+#include <cstdarg>
+#include <cstdio>
+
+TOMIC_BEGIN
+
+std::shared_ptr<BufferedLogger> BufferedLogger::New()
+{
+    return std::make_shared<BufferedLogger>();
+}
+
+
+void BufferedLogger::LogFormat(LogLevel level, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    LogVFormat(level, format, args);
+    va_end(args);
+}
+
+
+void BufferedLogger::LogVFormat(LogLevel level, const char* format, va_list args)
+{
+    // Not static, so that each thread can have its own logger.
+    char buffer[1024];
+    if (format)
+    {
+        vsnprintf(buffer, sizeof(buffer), format, args);
+    }
+    else
+    {
+        buffer[0] = '\0';
+    }
+    _entries.emplace_back(level, buffer);
+}
+
+
+int BufferedLogger::Count(LogLevel level)
+{
+    int count = 0;
+    for (const auto& entry : _entries)
+    {
+        if (entry.first == level)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+
+void BufferedLogger::Flush(ILogger* logger)
+{
+    TOMIC_ASSERT(logger);
+
+    for (const auto& entry : _entries)
+    {
+        logger->LogFormat(entry.first, "%s", entry.second.c_str());
+    }
+    _entries.clear();
+}
+
+
+TOMIC_END
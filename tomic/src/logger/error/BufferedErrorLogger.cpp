@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/logger/error/impl/BufferedErrorLogger.h>
+
+#include <cstdarg>
+#include <cstdio>
+
+TOMIC_BEGIN
+
+std::shared_ptr<BufferedErrorLogger> BufferedErrorLogger::New()
+{
+    return std::make_shared<BufferedErrorLogger>();
+}
+
+
+void BufferedErrorLogger::LogFormat(int line, int column, ErrorType type, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    LogVFormat(line, column, type, format, args);
+    va_end(args);
+}
+
+
+void BufferedErrorLogger::LogVFormat(int line, int column, ErrorType type, const char* format, va_list args)
+{
+    // Not static, so that each thread can have its own logger.
+    char buffer[1024];
+    if (format)
+    {
+        vsnprintf(buffer, sizeof(buffer), format, args);
+    }
+    else
+    {
+        buffer[0] = '\0';
+    }
+    _entries.emplace_back(line, column, type, buffer);
+}
+
+
+void BufferedErrorLogger::Dumps(twio::IWriterPtr writer)
+{
+    for (const auto& entry : _entries)
+    {
+        writer->WriteFormat("(%d:%d) %s\n", entry._line, entry._column, entry._msg.c_str());
+    }
+}
+
+
+int BufferedErrorLogger::Count()
+{
+    return _entries.size();
+}
+
+
+void BufferedErrorLogger::Flush(IErrorLogger* logger)
+{
+    TOMIC_ASSERT(logger);
+
+    for (const auto& entry : _entries)
+    {
+        logger->LogFormat(entry._line, entry._column, entry._type, "%s", entry._msg.c_str());
+    }
+    _entries.clear();
+}
+
+
+TOMIC_END
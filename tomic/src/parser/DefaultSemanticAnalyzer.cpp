@@ -10,6 +10,7 @@
 #include <tomic/utils/SemanticUtil.h>
 #include <tomic/utils/StringUtil.h>
 #include <tomic/utils/SymbolTableUtil.h>
+#include <tomic/utils/Trace.h>
 
 #include <algorithm> // for std::min
 #include <utility>
@@ -48,6 +49,8 @@ static DefaultSemanticAnalyzerActionMapper mapper;
 
 bool DefaultSemanticAnalyzer::VisitEnter(SyntaxNodePtr node)
 {
+    TOMIC_TRACE_ARG("semantic", "Enter", "type", static_cast<int>(node->Type()));
+
     _nodeStack.push(node);
 
     if (_AnalyzePreamble(node))
@@ -62,6 +65,8 @@ bool DefaultSemanticAnalyzer::VisitEnter(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::VisitExit(SyntaxNodePtr node)
 {
+    TOMIC_TRACE_ARG("semantic", "Exit", "type", static_cast<int>(node->Type()));
+
     auto action = mapper.GetExitAction(node->Type());
 
     bool ret = (this->*action)(node);
@@ -89,7 +94,7 @@ bool DefaultSemanticAnalyzer::_AnalyzePreamble(SyntaxNodePtr node)
     TOMIC_ASSERT(node);
     TOMIC_ASSERT(_table);
 
-    bool corrupted = node->BoolAttribute("corrupted");
+    bool corrupted = node->BoolAttribute(SyntaxAttribute::SA_CORRUPTED);
 
     return !corrupted;
 }
@@ -100,7 +105,7 @@ SymbolTableBlockPtr DefaultSemanticAnalyzer::_GetOrCreateBlock(SyntaxNodePtr nod
     TOMIC_ASSERT(node);
     TOMIC_ASSERT(_table);
 
-    int blockId = node->IntAttribute("tbl", -1);
+    int blockId = node->IntAttribute(SyntaxAttribute::SA_TBL, -1);
     if (blockId != -1)
     {
         return _table->GetBlock(blockId);
@@ -110,12 +115,12 @@ SymbolTableBlockPtr DefaultSemanticAnalyzer::_GetOrCreateBlock(SyntaxNodePtr nod
     if (_currentBlock)
     {
         block = _currentBlock->NewChild();
-        node->SetIntAttribute("tbl", block->Id());
+        node->SetIntAttribute(SyntaxAttribute::SA_TBL, block->Id());
     }
     else
     {
         block = _table->NewRoot();
-        node->SetIntAttribute("tbl", block->Id());
+        node->SetIntAttribute(SyntaxAttribute::SA_TBL, block->Id());
     }
 
     _currentBlock = block;
@@ -145,20 +150,20 @@ bool DefaultSemanticAnalyzer::_AddToSymbolTable(SymbolTableEntryPtr entry)
 
 int DefaultSemanticAnalyzer::_ValidateConstSubscription(SyntaxNodePtr constExp)
 {
-    if (!constExp->BoolAttribute("det"))
+    if (!constExp->BoolAttribute(SyntaxAttribute::SA_DET))
     {
         _Log(LogLevel::ERROR, "Undetermined expression as subscription.");
         _LogError(ErrorType::ERR_UNKNOWN, "Undetermined expression as subscription.");
     }
 
-    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(constExp, "type"));
+    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(constExp, SyntaxAttribute::SA_TYPE));
     if (type != SymbolValueType::VT_INT)
     {
         _Log(LogLevel::ERROR, "Invalid subscription type: %d.", type);
         _LogError(ErrorType::ERR_UNKNOWN, "Invalid subscription type: %d", type);
     }
 
-    int size = constExp->IntAttribute("value");
+    int size = constExp->IntAttribute(SyntaxAttribute::SA_VALUE);
     if (size < 0)
     {
         _Log(LogLevel::ERROR, "Invalid subscription size: %d", size);
@@ -172,7 +177,7 @@ int DefaultSemanticAnalyzer::_ValidateConstSubscription(SyntaxNodePtr constExp)
 
 void DefaultSemanticAnalyzer::_ValidateSubscription(SyntaxNodePtr exp)
 {
-    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(exp, "type"));
+    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(exp, SyntaxAttribute::SA_TYPE));
     if (type != SymbolValueType::VT_INT)
     {
         _Log(LogLevel::ERROR, "Invalid subscription type: %d", type);
@@ -193,8 +198,8 @@ void DefaultSemanticAnalyzer::_Log(LogLevel level, const char* format, ...)
 
     auto node = _errorCandidate ? _errorCandidate : _nodeStack.top();
     auto terminator = SemanticUtil::GetChildNode(node, SyntaxType::ST_TERMINATOR);
-    int line = terminator->Token()->lineNo;
-    int column = terminator->Token()->charNo;
+    int line = terminator->Token().LineNo();
+    int column = terminator->Token().CharNo();
 
     va_list args;
     va_start(args, format);
@@ -211,8 +216,8 @@ void DefaultSemanticAnalyzer::_LogError(ErrorType type, const char* format, ...)
 
     auto node = _errorCandidate ? _errorCandidate : _nodeStack.top();
     auto terminator = SemanticUtil::GetChildNode(node, SyntaxType::ST_TERMINATOR);
-    int line = terminator->Token()->lineNo;
-    int column = terminator->Token()->charNo;
+    int line = terminator->Token().LineNo();
+    int column = terminator->Token().CharNo();
 
     va_list args;
     va_start(args, format);
@@ -251,7 +256,7 @@ bool DefaultSemanticAnalyzer::_EnterDecl(SyntaxNodePtr node)
     if (parent->Type() == SyntaxType::ST_COMP_UNIT)
     {
         // Global variable.
-        node->SetBoolAttribute("global", true);
+        node->SetBoolAttribute(SyntaxAttribute::SA_GLOBAL, true);
     }
 
     return true;
@@ -261,10 +266,10 @@ bool DefaultSemanticAnalyzer::_EnterDecl(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitBType(SyntaxNodePtr node)
 {
     SymbolValueType type = SymbolValueType::VT_INT;
-    node->SetIntAttribute("type", static_cast<int>(type));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
 
     // Well, BType should have a parent.
-    node->Parent()->SetIntAttribute("type", static_cast<int>(type));
+    node->Parent()->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
 
     return true;
 }
@@ -272,7 +277,7 @@ bool DefaultSemanticAnalyzer::_ExitBType(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_EnterConstDecl(SyntaxNodePtr node)
 {
-    node->SetBoolAttribute("const", true);
+    node->SetBoolAttribute(SyntaxAttribute::SA_CONST, true);
     return true;
 }
 
@@ -283,15 +288,15 @@ bool DefaultSemanticAnalyzer::_ExitConstDef(SyntaxNodePtr node)
     SyntaxNodePtr constInitVal = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_CONST_INIT_VAL);
 
     SyntaxNodePtr ident = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_TERMINATOR);
-    ConstantEntryBuilder builder(ident->Token()->lexeme.c_str());
+    ConstantEntryBuilder builder(ident->Token().Lexeme());
     if (dim == 0)
     {
-        builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, "type")));
+        builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, SyntaxAttribute::SA_TYPE)));
     }
     else if (dim == 1)
     {
         int size = _ValidateConstSubscription(SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_CONST_EXP));
-        builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, "type")))
+        builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, SyntaxAttribute::SA_TYPE)))
             ->Size(size);
     }
     else if (dim == 2)
@@ -299,7 +304,7 @@ bool DefaultSemanticAnalyzer::_ExitConstDef(SyntaxNodePtr node)
         int size1 = _ValidateConstSubscription(SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_CONST_EXP));
         int size2 = _ValidateConstSubscription(SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_CONST_EXP, 2));
 
-        builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, "type")))
+        builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, SyntaxAttribute::SA_TYPE)))
             ->Size(size1, size2);
     }
     else
@@ -308,11 +313,11 @@ bool DefaultSemanticAnalyzer::_ExitConstDef(SyntaxNodePtr node)
         _LogError(ErrorType::ERR_UNKNOWN, "Invalid dimension: %d", dim);
     }
 
-    if (constInitVal->BoolAttribute("det"))
+    if (constInitVal->BoolAttribute(SyntaxAttribute::SA_DET))
     {
         if (dim == 0)
         {
-            builder.Value(constInitVal->IntAttribute("value"));
+            builder.Value(constInitVal->IntAttribute(SyntaxAttribute::SA_VALUE));
         }
         else
         {
@@ -320,10 +325,10 @@ bool DefaultSemanticAnalyzer::_ExitConstDef(SyntaxNodePtr node)
         }
     }
 
-    if (dim != constInitVal->IntAttribute("dim"))
+    if (dim != constInitVal->IntAttribute(SyntaxAttribute::SA_DIM))
     {
-        _Log(LogLevel::ERROR, "Dimension mismatch: %d != %d", dim, constInitVal->IntAttribute("dim"));
-        _LogError(ErrorType::ERR_UNKNOWN, "Dimension mismatch: %d != %d", dim, constInitVal->IntAttribute("dim"));
+        _Log(LogLevel::ERROR, "Dimension mismatch: %d != %d", dim, constInitVal->IntAttribute(SyntaxAttribute::SA_DIM));
+        _LogError(ErrorType::ERR_UNKNOWN, "Dimension mismatch: %d != %d", dim, constInitVal->IntAttribute(SyntaxAttribute::SA_DIM));
     }
 
     _AddToSymbolTable(builder.Build());
@@ -336,11 +341,11 @@ bool DefaultSemanticAnalyzer::_ExitConstInitVal(SyntaxNodePtr node)
 {
     if (node->FirstChild()->Type() == SyntaxType::ST_CONST_EXP)
     {
-        node->SetIntAttribute("dim", 0);
-        if (node->FirstChild()->BoolAttribute("det"))
+        node->SetIntAttribute(SyntaxAttribute::SA_DIM, 0);
+        if (node->FirstChild()->BoolAttribute(SyntaxAttribute::SA_DET))
         {
-            node->SetBoolAttribute("det", true);
-            node->SetIntAttribute("value", node->FirstChild()->IntAttribute("value"));
+            node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
+            node->SetIntAttribute(SyntaxAttribute::SA_VALUE, node->FirstChild()->IntAttribute(SyntaxAttribute::SA_VALUE));
         }
         return true;
     }
@@ -348,41 +353,42 @@ bool DefaultSemanticAnalyzer::_ExitConstInitVal(SyntaxNodePtr node)
     std::vector<SyntaxNodePtr> children;
     SemanticUtil::GetDirectChildNodes(node, SyntaxType::ST_CONST_INIT_VAL, children);
     int size = children.size();
-    int childDim = children[0]->IntAttribute("dim");
-    int childSize = children[0]->IntAttribute("size");
+    // '{}' is taken as an empty one-dimension array.
+    int childDim = children.empty() ? 0 : children[0]->IntAttribute(SyntaxAttribute::SA_DIM);
+    int childSize = children.empty() ? 0 : children[0]->IntAttribute(SyntaxAttribute::SA_SIZE);
     bool det = true;
 
     for (auto& child : children)
     {
-        if (child->IntAttribute("dim") != childDim)
+        if (child->IntAttribute(SyntaxAttribute::SA_DIM) != childDim)
         {
-            _Log(LogLevel::ERROR, "Dimension mismatch: %d != %d", child->IntAttribute("dim"), childDim);
-            _LogError(ErrorType::ERR_UNKNOWN, "Dimension mismatch: %d != %d", child->IntAttribute("dim"), childDim);
+            _Log(LogLevel::ERROR, "Dimension mismatch: %d != %d", child->IntAttribute(SyntaxAttribute::SA_DIM), childDim);
+            _LogError(ErrorType::ERR_UNKNOWN, "Dimension mismatch: %d != %d", child->IntAttribute(SyntaxAttribute::SA_DIM), childDim);
         }
-        if (child->IntAttribute("size") != childSize)
+        if (child->IntAttribute(SyntaxAttribute::SA_SIZE) != childSize)
         {
-            _Log(LogLevel::ERROR, "Size mismatch: %d != %d", child->IntAttribute("size"), childSize);
-            _LogError(ErrorType::ERR_UNKNOWN, "Size mismatch: %d != %d", child->IntAttribute("size"), childSize);
+            _Log(LogLevel::ERROR, "Size mismatch: %d != %d", child->IntAttribute(SyntaxAttribute::SA_SIZE), childSize);
+            _LogError(ErrorType::ERR_UNKNOWN, "Size mismatch: %d != %d", child->IntAttribute(SyntaxAttribute::SA_SIZE), childSize);
         }
-        if (!child->BoolAttribute("det"))
+        if (!child->BoolAttribute(SyntaxAttribute::SA_DET))
         {
             det = false;
         }
     }
 
     int dim = childDim + 1;
-    node->SetIntAttribute("dim", dim);
-    node->SetIntAttribute("size", size);
+    node->SetIntAttribute(SyntaxAttribute::SA_DIM, dim);
+    node->SetIntAttribute(SyntaxAttribute::SA_SIZE, size);
     std::vector<std::vector<int>> values;
     if (det)
     {
-        node->SetBoolAttribute("det", true);
+        node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
         if (dim == 1)
         {
             values.emplace_back();
             for (auto& child : children)
             {
-                values[0].push_back(child->IntAttribute("value"));
+                values[0].push_back(child->IntAttribute(SyntaxAttribute::SA_VALUE));
             }
         }
         else if (dim == 2)
@@ -396,7 +402,7 @@ bool DefaultSemanticAnalyzer::_ExitConstInitVal(SyntaxNodePtr node)
     }
     else
     {
-        node->SetBoolAttribute("det", false);
+        node->SetBoolAttribute(SyntaxAttribute::SA_DET, false);
         _Log(LogLevel::ERROR, "Undetermined value in const initial value.");
         _LogError(ErrorType::ERR_UNKNOWN, "Undetermined value in const initial value.");
     }
@@ -408,11 +414,11 @@ bool DefaultSemanticAnalyzer::_ExitConstInitVal(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitVarDef(SyntaxNodePtr node)
 {
     SyntaxNodePtr initVal = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_INIT_VAL);
-    bool global = SemanticUtil::GetInheritedBoolAttribute(node, "global");
+    bool global = SemanticUtil::GetInheritedBoolAttribute(node, SyntaxAttribute::SA_GLOBAL);
 
     if (global)
     {
-        if (initVal && !initVal->BoolAttribute("det"))
+        if (initVal && !initVal->BoolAttribute(SyntaxAttribute::SA_DET))
         {
             _Log(LogLevel::ERROR, "Global variable should be initialized with const value.");
             _LogError(ErrorType::ERR_UNKNOWN, "Global variable should be initialized with const value.");
@@ -422,10 +428,10 @@ bool DefaultSemanticAnalyzer::_ExitVarDef(SyntaxNodePtr node)
     int dim = SemanticUtil::CountDirectTerminalNode(node, TokenType::TK_LEFT_BRACKET);
     if (initVal)
     {
-        if (dim != initVal->IntAttribute("dim"))
+        if (dim != initVal->IntAttribute(SyntaxAttribute::SA_DIM))
         {
-            _Log(LogLevel::ERROR, "Dimension mismatch: %d != %d", dim, initVal->IntAttribute("dim"));
-            _LogError(ErrorType::ERR_UNKNOWN, "Dimension mismatch: %d != %d", dim, initVal->IntAttribute("dim"));
+            _Log(LogLevel::ERROR, "Dimension mismatch: %d != %d", dim, initVal->IntAttribute(SyntaxAttribute::SA_DIM));
+            _LogError(ErrorType::ERR_UNKNOWN, "Dimension mismatch: %d != %d", dim, initVal->IntAttribute(SyntaxAttribute::SA_DIM));
         }
     }
 
@@ -433,16 +439,16 @@ bool DefaultSemanticAnalyzer::_ExitVarDef(SyntaxNodePtr node)
 
     SyntaxNodePtr ident = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_TERMINATOR);
     VariableEntryPtr entry;
-    VariableEntryBuilder builder(ident->Token()->lexeme.c_str());
+    VariableEntryBuilder builder(ident->Token().Lexeme());
     if (dim == 0)
     {
-        entry = builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, "type")))
+        entry = builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, SyntaxAttribute::SA_TYPE)))
             ->Build();
     }
     else if (dim == 1)
     {
         int size = _ValidateConstSubscription(SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_CONST_EXP));
-        entry = builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, "type")))
+        entry = builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, SyntaxAttribute::SA_TYPE)))
             ->Size(size)
             ->Build();
     }
@@ -451,7 +457,7 @@ bool DefaultSemanticAnalyzer::_ExitVarDef(SyntaxNodePtr node)
         int size1 = _ValidateConstSubscription(SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_CONST_EXP));
         int size2 = _ValidateConstSubscription(SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_CONST_EXP, 2));
 
-        entry = builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, "type")))
+        entry = builder.Type(static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, SyntaxAttribute::SA_TYPE)))
             ->Size(size1, size2)
             ->Build();
     }
@@ -461,7 +467,7 @@ bool DefaultSemanticAnalyzer::_ExitVarDef(SyntaxNodePtr node)
         _LogError(ErrorType::ERR_UNKNOWN, "Invalid dimension: %d", dim);
     }
 
-    node->SetIntAttribute("dim", dim);
+    node->SetIntAttribute(SyntaxAttribute::SA_DIM, dim);
 
     _AddToSymbolTable(entry);
 
@@ -473,19 +479,19 @@ bool DefaultSemanticAnalyzer::_ExitInitVal(SyntaxNodePtr node)
 {
     if (node->FirstChild()->Type() == SyntaxType::ST_EXP)
     {
-        node->SetIntAttribute("dim", 0);
-        if (node->FirstChild()->BoolAttribute("det"))
+        node->SetIntAttribute(SyntaxAttribute::SA_DIM, 0);
+        if (node->FirstChild()->BoolAttribute(SyntaxAttribute::SA_DET))
         {
-            node->SetBoolAttribute("det", true);
-            node->SetIntAttribute("value", node->FirstChild()->IntAttribute("value"));
+            node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
+            node->SetIntAttribute(SyntaxAttribute::SA_VALUE, node->FirstChild()->IntAttribute(SyntaxAttribute::SA_VALUE));
         }
     }
     else
     {
         int size = SemanticUtil::CountDirectChildNode(node, SyntaxType::ST_INIT_VAL);
         auto child = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_INIT_VAL);
-        int dim = child->IntAttribute("dim");
-        int childSize = child->IntAttribute("size");
+        int dim = child->IntAttribute(SyntaxAttribute::SA_DIM);
+        int childSize = child->IntAttribute(SyntaxAttribute::SA_SIZE);
         bool det = true;
         for (child = node->FirstChild(); child; child = child->NextSibling())
         {
@@ -493,26 +499,26 @@ bool DefaultSemanticAnalyzer::_ExitInitVal(SyntaxNodePtr node)
             {
                 continue;
             }
-            if (child->IntAttribute("dim") != dim)
+            if (child->IntAttribute(SyntaxAttribute::SA_DIM) != dim)
             {
-                _Log(LogLevel::ERROR, "Dimension mismatch: %d != %d", child->IntAttribute("dim"), dim);
-                _LogError(ErrorType::ERR_UNKNOWN, "Dimension mismatch: %d != %d", child->IntAttribute("dim"), dim);
+                _Log(LogLevel::ERROR, "Dimension mismatch: %d != %d", child->IntAttribute(SyntaxAttribute::SA_DIM), dim);
+                _LogError(ErrorType::ERR_UNKNOWN, "Dimension mismatch: %d != %d", child->IntAttribute(SyntaxAttribute::SA_DIM), dim);
             }
-            if (child->IntAttribute("size") != childSize)
+            if (child->IntAttribute(SyntaxAttribute::SA_SIZE) != childSize)
             {
-                _Log(LogLevel::ERROR, "Size mismatch: %d != %d", child->IntAttribute("size"), childSize);
-                _LogError(ErrorType::ERR_UNKNOWN, "Size mismatch: %d != %d", child->IntAttribute("size"), childSize);
+                _Log(LogLevel::ERROR, "Size mismatch: %d != %d", child->IntAttribute(SyntaxAttribute::SA_SIZE), childSize);
+                _LogError(ErrorType::ERR_UNKNOWN, "Size mismatch: %d != %d", child->IntAttribute(SyntaxAttribute::SA_SIZE), childSize);
             }
-            if (!child->BoolAttribute("det"))
+            if (!child->BoolAttribute(SyntaxAttribute::SA_DET))
             {
                 det = false;
             }
         }
-        node->SetIntAttribute("dim", dim + 1);
-        node->SetIntAttribute("size", size);
+        node->SetIntAttribute(SyntaxAttribute::SA_DIM, dim + 1);
+        node->SetIntAttribute(SyntaxAttribute::SA_SIZE, size);
         if (det)
         {
-            node->SetBoolAttribute("det", true);
+            node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
         }
     }
 
@@ -523,13 +529,13 @@ bool DefaultSemanticAnalyzer::_ExitInitVal(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitFuncDef(SyntaxNodePtr node)
 {
     // If failed to declare, skip it.
-    if (node->BoolAttribute("bad"))
+    if (node->BoolAttribute(SyntaxAttribute::SA_BAD))
     {
         return true;
     }
 
     // Check return value of non-void function.
-    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(node, "type"));
+    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(node, SyntaxAttribute::SA_TYPE));
     if (type == SymbolValueType::VT_INT)
     {
         // Set error candidate to '}'.
@@ -551,15 +557,15 @@ bool DefaultSemanticAnalyzer::_ExitFuncDef(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_ExitFuncDecl(SyntaxNodePtr node)
 {
-    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(node, "type"));
+    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(node, SyntaxAttribute::SA_TYPE));
 
-    node->SetIntAttribute("type", static_cast<int>(type));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
     // Pull this attribute up. This parent must be a FuncDef.
-    node->Parent()->SetIntAttribute("type", static_cast<int>(type));
+    node->Parent()->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
 
     // Add function to symbol table.
     auto ident = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_TERMINATOR);
-    const char* name = ident->Token()->lexeme.c_str();
+    const char* name = ident->Token().Lexeme();
     FunctionEntryBuilder builder(name);
     builder.Type(type);
     auto params = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_FUNC_FPARAMS);
@@ -569,10 +575,10 @@ bool DefaultSemanticAnalyzer::_ExitFuncDecl(SyntaxNodePtr node)
         SemanticUtil::GetDirectChildNodes(params, SyntaxType::ST_FUNC_FPARAM, paramList);
         for (auto& param : paramList)
         {
-            SymbolValueType paramType = static_cast<SymbolValueType>(param->IntAttribute("type"));
-            int paramDim = param->IntAttribute("dim");
+            SymbolValueType paramType = static_cast<SymbolValueType>(param->IntAttribute(SyntaxAttribute::SA_TYPE));
+            int paramDim = param->IntAttribute(SyntaxAttribute::SA_DIM);
             const char* paramName = param->Attribute("name");
-            int paramSize = param->IntAttribute("size"); // it may not exist, but is OK
+            int paramSize = param->IntAttribute(SyntaxAttribute::SA_SIZE); // it may not exist, but is OK
             builder.AddParam(paramType, paramName, paramDim, paramSize);
         }
     }
@@ -581,7 +587,7 @@ bool DefaultSemanticAnalyzer::_ExitFuncDecl(SyntaxNodePtr node)
     // so that we can skip it.
     if (!_AddToSymbolTable(builder.Build()))
     {
-        node->Parent()->SetBoolAttribute("bad", true);
+        node->Parent()->SetBoolAttribute(SyntaxAttribute::SA_BAD, true);
     }
 
     return true;
@@ -605,10 +611,10 @@ bool DefaultSemanticAnalyzer::_ExitFuncType(SyntaxNodePtr node)
         break;
     }
 
-    node->SetIntAttribute("type", static_cast<int>(type));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
 
     // The same as BType, FType should have a parent.
-    node->Parent()->SetIntAttribute("type", static_cast<int>(type));
+    node->Parent()->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
 
     return true;
 }
@@ -617,7 +623,7 @@ bool DefaultSemanticAnalyzer::_ExitFuncType(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitFuncFParams(SyntaxNodePtr node)
 {
     int count = SemanticUtil::CountDirectChildNode(node, SyntaxType::ST_FUNC_FPARAM);
-    node->SetIntAttribute("argc", count);
+    node->SetIntAttribute(SyntaxAttribute::SA_ARGC, count);
 
     return true;
 }
@@ -626,24 +632,24 @@ bool DefaultSemanticAnalyzer::_ExitFuncFParams(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitFuncFParam(SyntaxNodePtr node)
 {
     auto ident = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_TERMINATOR);
-    node->SetAttribute("name", ident->Token()->lexeme.c_str());
+    node->SetAttribute("name", ident->Token().Lexeme());
     int dim = SemanticUtil::CountDirectTerminalNode(node, TokenType::TK_LEFT_BRACKET);
-    node->SetIntAttribute("dim", dim);
+    node->SetIntAttribute(SyntaxAttribute::SA_DIM, dim);
     if (dim > 0)
     {
-        node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_ARRAY));
+        node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_ARRAY));
     }
     else
     {
-        node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_INT));
+        node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_INT));
     }
 
     if (dim == 2)
     {
         auto constExp = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_CONST_EXP);
-        if (constExp->BoolAttribute("det"))
+        if (constExp->BoolAttribute(SyntaxAttribute::SA_DET))
         {
-            int size = constExp->IntAttribute("value");
+            int size = constExp->IntAttribute(SyntaxAttribute::SA_VALUE);
             if (size < 0)
             {
                 _Log(LogLevel::ERROR, "Invalid size: %d", size);
@@ -651,7 +657,7 @@ bool DefaultSemanticAnalyzer::_ExitFuncFParam(SyntaxNodePtr node)
             }
             else
             {
-                node->SetIntAttribute("size", size);
+                node->SetIntAttribute(SyntaxAttribute::SA_SIZE, size);
             }
         }
     }
@@ -663,7 +669,7 @@ bool DefaultSemanticAnalyzer::_ExitFuncFParam(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitFuncAParams(SyntaxNodePtr node)
 {
     int argc = SemanticUtil::CountDirectChildNode(node, SyntaxType::ST_FUNC_APARAM);
-    node->SetIntAttribute("argc", argc);
+    node->SetIntAttribute(SyntaxAttribute::SA_ARGC, argc);
     return true;
 }
 
@@ -671,16 +677,16 @@ bool DefaultSemanticAnalyzer::_ExitFuncAParams(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitFuncAParam(SyntaxNodePtr node)
 {
     auto exp = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_EXP);
-    auto type = static_cast<SymbolValueType>(exp->IntAttribute("type"));
-    node->SetIntAttribute("type", static_cast<int>(type));
+    auto type = static_cast<SymbolValueType>(exp->IntAttribute(SyntaxAttribute::SA_TYPE));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
 
     if (type == SymbolValueType::VT_ARRAY)
     {
-        int dim = exp->IntAttribute("dim");
-        node->SetIntAttribute("dim", dim);
+        int dim = exp->IntAttribute(SyntaxAttribute::SA_DIM);
+        node->SetIntAttribute(SyntaxAttribute::SA_DIM, dim);
         if (dim == 2)
         {
-            node->SetIntAttribute("size", exp->IntAttribute("size"));
+            node->SetIntAttribute(SyntaxAttribute::SA_SIZE, exp->IntAttribute(SyntaxAttribute::SA_SIZE));
         }
     }
 
@@ -695,7 +701,7 @@ bool DefaultSemanticAnalyzer::_EnterBlock(SyntaxNodePtr node)
     // Add function parameter if necessary
     if (node->Parent()->Type() == SyntaxType::ST_FUNC_DEF)
     {
-        if (node->Parent()->BoolAttribute("bad"))
+        if (node->Parent()->BoolAttribute(SyntaxAttribute::SA_BAD))
         {
             // The parent function declaration fails.
             return false;
@@ -730,7 +736,7 @@ bool DefaultSemanticAnalyzer::_ExitBlock(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_EnterMainFuncDef(SyntaxNodePtr node)
 {
-    node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_INT));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_INT));
     return true;
 }
 
@@ -757,21 +763,21 @@ bool DefaultSemanticAnalyzer::_ExitAssignmentStmt(SyntaxNodePtr node)
 {
     // Check LVal
     auto lval = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_LVAL);
-    SymbolValueType type = static_cast<SymbolValueType>(lval->IntAttribute("type"));
+    SymbolValueType type = static_cast<SymbolValueType>(lval->IntAttribute(SyntaxAttribute::SA_TYPE));
     if (type != SymbolValueType::VT_INT)
     {
         _Log(LogLevel::ERROR, "Invalid lvalue of type %d", static_cast<int>(type));
         _LogError(ErrorType::ERR_UNKNOWN, "Invalid lvalue of type %d", static_cast<int>(type));
         return true;
     }
-    if (lval->BoolAttribute("const"))
+    if (lval->BoolAttribute(SyntaxAttribute::SA_CONST))
     {
         _Log(LogLevel::ERROR, "Cannot assign to const");
         _LogError(ErrorType::ERR_ASSIGN_TO_CONST, "Cannot assign to const");
     }
 
     auto exp = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_EXP);
-    if (type != static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(exp, "type")))
+    if (type != static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(exp, SyntaxAttribute::SA_TYPE)))
     {
         _Log(LogLevel::ERROR, "Type mismatch");
         _LogError(ErrorType::ERR_UNKNOWN, "Type mismatch");
@@ -784,17 +790,17 @@ bool DefaultSemanticAnalyzer::_ExitAssignmentStmt(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitLVal(SyntaxNodePtr node)
 {
     SyntaxNodePtr ident = node->FirstChild();
-    const char* name = ident->Token()->lexeme.c_str();
+    const char* name = ident->Token().Lexeme();
     SymbolTableEntryPtr rawEntry = _currentBlock->FindEntry(name);
 
     // In case any error occurs, we set the type to int by default.
-    node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_INT));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_INT));
 
     if (!rawEntry)
     {
         _Log(LogLevel::ERROR, "Undefined variable: %s", name);
         _LogError(ErrorType::ERR_UNDEFINED_SYMBOL, "Undefined variable: %s", name);
-        node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_ANY));
+        node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_ANY));
         return true;
     }
 
@@ -802,7 +808,7 @@ bool DefaultSemanticAnalyzer::_ExitLVal(SyntaxNodePtr node)
     int size = 0;
     if (rawEntry->EntryType() == SymbolTableEntryType::ET_CONSTANT)
     {
-        node->SetBoolAttribute("const", true);
+        node->SetBoolAttribute(SyntaxAttribute::SA_CONST, true);
 
         ConstantEntryPtr entry = std::static_pointer_cast<ConstantEntry>(rawEntry);
         expectedDim = entry->Dimension();
@@ -825,7 +831,7 @@ bool DefaultSemanticAnalyzer::_ExitLVal(SyntaxNodePtr node)
         // Not a variable, so undefined symbol should be reported.
         _Log(LogLevel::ERROR, "Undefined variable: %s", name);
         _LogError(ErrorType::ERR_UNDEFINED_SYMBOL, "Undefined variable: %s", name);
-        node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_ANY));
+        node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_ANY));
         return true;
     }
 
@@ -849,17 +855,17 @@ bool DefaultSemanticAnalyzer::_ExitLVal(SyntaxNodePtr node)
      *    2       2           0
      */
     int finalDim = expectedDim - actualDim;
-    node->SetIntAttribute("dim", finalDim);
+    node->SetIntAttribute(SyntaxAttribute::SA_DIM, finalDim);
     if (finalDim == 0)
     {
-        node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_INT));
+        node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_INT));
     }
     else
     {
-        node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_ARRAY));
+        node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_ARRAY));
         if (finalDim == 2)
         {
-            node->SetIntAttribute("size", size);
+            node->SetIntAttribute(SyntaxAttribute::SA_SIZE, size);
         }
     }
 
@@ -879,11 +885,11 @@ bool DefaultSemanticAnalyzer::_ExitLVal(SyntaxNodePtr node)
         * Here, we're sure that the current block has a parent. If not, FindEntry
         * at the very beginning will fail.
         */
-        node->SetIntAttribute("tbl", _currentBlock->Parent()->Id());
+        node->SetIntAttribute(SyntaxAttribute::SA_TBL, _currentBlock->Parent()->Id());
     }
     else
     {
-        node->SetIntAttribute("tbl", _currentBlock->Id());
+        node->SetIntAttribute(SyntaxAttribute::SA_TBL, _currentBlock->Id());
     }
 
     return true;
@@ -892,7 +898,7 @@ bool DefaultSemanticAnalyzer::_ExitLVal(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_ExitCond(SyntaxNodePtr node)
 {
-    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(node, "type"));
+    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(node, SyntaxAttribute::SA_TYPE));
     if (type != SymbolValueType::VT_INT)
     {
         _Log(LogLevel::ERROR, "Wrong type for condition");
@@ -905,7 +911,7 @@ bool DefaultSemanticAnalyzer::_ExitCond(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_EnterForStmt(SyntaxNodePtr node)
 {
-    node->SetBoolAttribute("loop", true);
+    node->SetBoolAttribute(SyntaxAttribute::SA_LOOP, true);
     return true;
 }
 
@@ -914,14 +920,14 @@ bool DefaultSemanticAnalyzer::_ExitForInnerStmt(SyntaxNodePtr node)
 {
     // Check LVal
     auto lval = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_LVAL);
-    SymbolValueType type = static_cast<SymbolValueType>(lval->IntAttribute("type"));
+    SymbolValueType type = static_cast<SymbolValueType>(lval->IntAttribute(SyntaxAttribute::SA_TYPE));
     if (type != SymbolValueType::VT_INT)
     {
         _Log(LogLevel::ERROR, "Invalid lvalue of type %d", static_cast<int>(type));
         _LogError(ErrorType::ERR_UNKNOWN, "Invalid lvalue of type %d", static_cast<int>(type));
         return true;
     }
-    if (lval->BoolAttribute("const"))
+    if (lval->BoolAttribute(SyntaxAttribute::SA_CONST))
     {
         _Log(LogLevel::ERROR, "Cannot assign to const");
         _LogError(ErrorType::ERR_ASSIGN_TO_CONST, "Cannot assign to const");
@@ -929,7 +935,7 @@ bool DefaultSemanticAnalyzer::_ExitForInnerStmt(SyntaxNodePtr node)
 
     // Check Exp.
     auto exp = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_EXP);
-    if (type != static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(exp, "type")))
+    if (type != static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(exp, SyntaxAttribute::SA_TYPE)))
     {
         _Log(LogLevel::ERROR, "Type mismatch");
         _LogError(ErrorType::ERR_UNKNOWN, "Type mismatch");
@@ -941,7 +947,7 @@ bool DefaultSemanticAnalyzer::_ExitForInnerStmt(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_ExitBreakStmt(SyntaxNodePtr node)
 {
-    if (!SemanticUtil::GetInheritedBoolAttribute(node, "loop"))
+    if (!SemanticUtil::GetInheritedBoolAttribute(node, SyntaxAttribute::SA_LOOP))
     {
         _Log(LogLevel::ERROR, "Break outside loop.");
         _LogError(ErrorType::ERR_ILLEGAL_BREAK, "Break outside loop.");
@@ -953,7 +959,7 @@ bool DefaultSemanticAnalyzer::_ExitBreakStmt(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_ExitContinueStmt(SyntaxNodePtr node)
 {
-    if (!SemanticUtil::GetInheritedBoolAttribute(node, "loop"))
+    if (!SemanticUtil::GetInheritedBoolAttribute(node, SyntaxAttribute::SA_LOOP))
     {
         _Log(LogLevel::ERROR, "Continue outside loop.");
         _LogError(ErrorType::ERR_ILLEGAL_CONTINUE, "Continue outside loop.");
@@ -969,7 +975,7 @@ bool DefaultSemanticAnalyzer::_ExitReturnStmt(SyntaxNodePtr node)
     SymbolValueType type;
     if (exp)
     {
-        type = static_cast<SymbolValueType>(exp->IntAttribute("type"));
+        type = static_cast<SymbolValueType>(exp->IntAttribute(SyntaxAttribute::SA_TYPE));
     }
     else
     {
@@ -982,8 +988,8 @@ bool DefaultSemanticAnalyzer::_ExitReturnStmt(SyntaxNodePtr node)
      */
 
     // Check return value in void function.
-    SymbolValueType funcType = static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, "type"));
-    node->SetIntAttribute("type", static_cast<int>(type));
+    SymbolValueType funcType = static_cast<SymbolValueType>(SemanticUtil::GetInheritedIntAttribute(node, SyntaxAttribute::SA_TYPE));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
 
     // if (funcType == ValueType::VT_VOID && ((type != ValueType::VT_VOID) || exp))
     if (funcType == SymbolValueType::VT_VOID && (type != SymbolValueType::VT_VOID))
@@ -1004,13 +1010,13 @@ bool DefaultSemanticAnalyzer::_ExitReturnStmt(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitInStmt(SyntaxNodePtr node)
 {
     auto lval = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_LVAL);
-    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(lval, "type"));
+    SymbolValueType type = static_cast<SymbolValueType>(SemanticUtil::GetSynthesizedIntAttribute(lval, SyntaxAttribute::SA_TYPE));
     if (type != SymbolValueType::VT_INT)
     {
         _Log(LogLevel::ERROR, "Invalid lvalue of type %d", static_cast<int>(type));
         _LogError(ErrorType::ERR_UNKNOWN, "Invalid lvalue of type %d", static_cast<int>(type));
     }
-    if (lval->BoolAttribute("const"))
+    if (lval->BoolAttribute(SyntaxAttribute::SA_CONST))
     {
         _Log(LogLevel::ERROR, "Cannot assign to const");
         _LogError(ErrorType::ERR_ASSIGN_TO_CONST, "Cannot assign to const");
@@ -1029,7 +1035,7 @@ bool DefaultSemanticAnalyzer::_ExitOutStmt(SyntaxNodePtr node)
         _LogError(ErrorType::ERR_UNKNOWN, "Invalid format string");
         return true;
     }
-    const char* format = formatStr->Token()->lexeme.c_str();
+    const char* format = formatStr->Token().Lexeme();
 
     int formatArgc = SemanticUtil::GetFormatStringArgCount(format);
     std::vector<SyntaxNodePtr> args;
@@ -1043,7 +1049,7 @@ bool DefaultSemanticAnalyzer::_ExitOutStmt(SyntaxNodePtr node)
     }
     for (auto& arg : args)
     {
-        SymbolValueType type = static_cast<SymbolValueType>(arg->IntAttribute("type"));
+        SymbolValueType type = static_cast<SymbolValueType>(arg->IntAttribute(SyntaxAttribute::SA_TYPE));
         if (type != SymbolValueType::VT_INT)
         {
             _Log(LogLevel::ERROR, "Invalid argument type in OutStmt: %d", static_cast<int>(type));
@@ -1060,15 +1066,15 @@ bool DefaultSemanticAnalyzer::_ExitOutStmt(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_DefaultExitExp(SyntaxNodePtr node)
 {
     // In case any error occurs, this node will have a default int type.
-    node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_INT));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_INT));
 
     if (node->HasManyChildren())
     {
         // Combine all children's type.
         auto left = node->FirstChild();
-        SymbolValueType leftType = static_cast<SymbolValueType>(left->IntAttribute("type"));
+        SymbolValueType leftType = static_cast<SymbolValueType>(left->IntAttribute(SyntaxAttribute::SA_TYPE));
         auto right = node->LastChild();
-        SymbolValueType rightType = static_cast<SymbolValueType>(right->IntAttribute("type"));
+        SymbolValueType rightType = static_cast<SymbolValueType>(right->IntAttribute(SyntaxAttribute::SA_TYPE));
 
         if (leftType != rightType)
         {
@@ -1088,18 +1094,18 @@ bool DefaultSemanticAnalyzer::_DefaultExitExp(SyntaxNodePtr node)
             }
             else
             {
-                node->SetIntAttribute("type", static_cast<int>(leftType));
-                if (left->BoolAttribute("det") && right->BoolAttribute("det"))
+                node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(leftType));
+                if (left->BoolAttribute(SyntaxAttribute::SA_DET) && right->BoolAttribute(SyntaxAttribute::SA_DET))
                 {
-                    node->SetBoolAttribute("det", true);
+                    node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
 
-                    int leftValue = left->IntAttribute("value");
-                    int rightValue = right->IntAttribute("value");
+                    int leftValue = left->IntAttribute(SyntaxAttribute::SA_VALUE);
+                    int rightValue = right->IntAttribute(SyntaxAttribute::SA_VALUE);
                     auto opNode = SemanticUtil::GetDirectChildNode(node, SyntaxType::ST_TERMINATOR);
-                    const char* op = opNode->Token()->lexeme.c_str();
+                    const char* op = opNode->Token().Lexeme();
                     int value = SemanticUtil::EvaluateBinary(op, leftValue, rightValue);
 
-                    node->SetIntAttribute("value", value);
+                    node->SetIntAttribute(SyntaxAttribute::SA_VALUE, value);
                 }
             }
         }
@@ -1107,23 +1113,23 @@ bool DefaultSemanticAnalyzer::_DefaultExitExp(SyntaxNodePtr node)
     else
     {
         // Simple get the type from its single child.
-        SymbolValueType type = static_cast<SymbolValueType>(node->FirstChild()->IntAttribute("type"));
-        node->SetIntAttribute("type", static_cast<int>(type));
+        SymbolValueType type = static_cast<SymbolValueType>(node->FirstChild()->IntAttribute(SyntaxAttribute::SA_TYPE));
+        node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
         if (type == SymbolValueType::VT_ARRAY)
         {
-            int dim = node->FirstChild()->IntAttribute("dim");
-            node->SetIntAttribute("dim", dim);
-            if (node->IntAttribute("dim") == 2)
+            int dim = node->FirstChild()->IntAttribute(SyntaxAttribute::SA_DIM);
+            node->SetIntAttribute(SyntaxAttribute::SA_DIM, dim);
+            if (node->IntAttribute(SyntaxAttribute::SA_DIM) == 2)
             {
-                node->SetIntAttribute("size", node->FirstChild()->IntAttribute("size"));
+                node->SetIntAttribute(SyntaxAttribute::SA_SIZE, node->FirstChild()->IntAttribute(SyntaxAttribute::SA_SIZE));
             }
         }
         else if (type == SymbolValueType::VT_INT)
         {
-            if (node->FirstChild()->BoolAttribute("det"))
+            if (node->FirstChild()->BoolAttribute(SyntaxAttribute::SA_DET))
             {
-                node->SetBoolAttribute("det", true);
-                node->SetIntAttribute("value", node->FirstChild()->IntAttribute("value"));
+                node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
+                node->SetIntAttribute(SyntaxAttribute::SA_VALUE, node->FirstChild()->IntAttribute(SyntaxAttribute::SA_VALUE));
             }
         }
     }
@@ -1135,23 +1141,23 @@ bool DefaultSemanticAnalyzer::_DefaultExitExp(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitExp(SyntaxNodePtr node)
 {
     auto child = node->FirstChild();
-    SymbolValueType type = static_cast<SymbolValueType>(child->IntAttribute("type"));
+    SymbolValueType type = static_cast<SymbolValueType>(child->IntAttribute(SyntaxAttribute::SA_TYPE));
 
-    node->SetIntAttribute("type", static_cast<int>(type));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
 
-    if (child->BoolAttribute("det"))
+    if (child->BoolAttribute(SyntaxAttribute::SA_DET))
     {
-        node->SetBoolAttribute("det", true);
-        node->SetIntAttribute("value", child->IntAttribute("value"));
+        node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
+        node->SetIntAttribute(SyntaxAttribute::SA_VALUE, child->IntAttribute(SyntaxAttribute::SA_VALUE));
     }
     else
     {
         if (type == SymbolValueType::VT_ARRAY)
         {
-            node->SetIntAttribute("dim", child->IntAttribute("dim"));
-            if (node->IntAttribute("dim") == 2)
+            node->SetIntAttribute(SyntaxAttribute::SA_DIM, child->IntAttribute(SyntaxAttribute::SA_DIM));
+            if (node->IntAttribute(SyntaxAttribute::SA_DIM) == 2)
             {
-                node->SetIntAttribute("size", child->IntAttribute("size"));
+                node->SetIntAttribute(SyntaxAttribute::SA_SIZE, child->IntAttribute(SyntaxAttribute::SA_SIZE));
             }
         }
     }
@@ -1162,7 +1168,7 @@ bool DefaultSemanticAnalyzer::_ExitExp(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_EnterConstExp(SyntaxNodePtr node)
 {
-    node->SetBoolAttribute("const", true);
+    node->SetBoolAttribute(SyntaxAttribute::SA_CONST, true);
     return true;
 }
 
@@ -1171,7 +1177,7 @@ bool DefaultSemanticAnalyzer::_ExitConstExp(SyntaxNodePtr node)
 {
     _ExitExp(node);
 
-    if (!node->BoolAttribute("det"))
+    if (!node->BoolAttribute(SyntaxAttribute::SA_DET))
     {
         _Log(LogLevel::ERROR, "Undetermined const expression.");
         _LogError(ErrorType::ERR_UNKNOWN, "Undetermined const expression.");
@@ -1184,47 +1190,47 @@ bool DefaultSemanticAnalyzer::_ExitConstExp(SyntaxNodePtr node)
 bool DefaultSemanticAnalyzer::_ExitUnaryExp(SyntaxNodePtr node)
 {
     // Set a default type.
-    node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_INT));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_INT));
 
     if (node->HasManyChildren())
     {
         auto exp = node->LastChild();
-        SymbolValueType type = static_cast<SymbolValueType>(exp->IntAttribute("type"));
+        SymbolValueType type = static_cast<SymbolValueType>(exp->IntAttribute(SyntaxAttribute::SA_TYPE));
         if (type != SymbolValueType::VT_INT)
         {
             _Log(LogLevel::ERROR, "Invalid operand type: %d", static_cast<int>(type));
             _LogError(ErrorType::ERR_UNKNOWN, "Invalid operand type: %d", static_cast<int>(type));
         }
-        else if (exp->BoolAttribute("det"))
+        else if (exp->BoolAttribute(SyntaxAttribute::SA_DET))
         {
-            node->SetBoolAttribute("det", true);
+            node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
             // Compile-time calculation
-            int value = exp->IntAttribute("value");
+            int value = exp->IntAttribute(SyntaxAttribute::SA_VALUE);
             const char* op = node->FirstChild()->Attribute("op");
 
             // TODO: check '!' in non-condition statement.
-            node->SetIntAttribute("value", SemanticUtil::EvaluateUnary(op, value));
+            node->SetIntAttribute(SyntaxAttribute::SA_VALUE, SemanticUtil::EvaluateUnary(op, value));
         }
     }
     else
     {
         auto child = node->FirstChild();
-        SymbolValueType type = static_cast<SymbolValueType>(child->IntAttribute("type"));
-        node->SetIntAttribute("type", static_cast<int>(type));
+        SymbolValueType type = static_cast<SymbolValueType>(child->IntAttribute(SyntaxAttribute::SA_TYPE));
+        node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
         if (type == SymbolValueType::VT_INT)
         {
-            if (child->BoolAttribute("det"))
+            if (child->BoolAttribute(SyntaxAttribute::SA_DET))
             {
-                node->SetBoolAttribute("det", true);
-                node->SetIntAttribute("value", child->IntAttribute("value"));
+                node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
+                node->SetIntAttribute(SyntaxAttribute::SA_VALUE, child->IntAttribute(SyntaxAttribute::SA_VALUE));
             }
         }
         else if (type == SymbolValueType::VT_ARRAY)
         {
-            node->SetIntAttribute("dim", child->IntAttribute("dim"));
-            if (node->IntAttribute("dim") == 2)
+            node->SetIntAttribute(SyntaxAttribute::SA_DIM, child->IntAttribute(SyntaxAttribute::SA_DIM));
+            if (node->IntAttribute(SyntaxAttribute::SA_DIM) == 2)
             {
-                node->SetIntAttribute("size", child->IntAttribute("size"));
+                node->SetIntAttribute(SyntaxAttribute::SA_SIZE, child->IntAttribute(SyntaxAttribute::SA_SIZE));
             }
         }
     }
@@ -1235,14 +1241,14 @@ bool DefaultSemanticAnalyzer::_ExitUnaryExp(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_ExitUnaryOp(SyntaxNodePtr node)
 {
-    node->SetAttribute("op", node->FirstChild()->Token()->lexeme.c_str());
+    node->SetAttribute("op", node->FirstChild()->Token().Lexeme());
     return true;
 }
 
 
 bool DefaultSemanticAnalyzer::_ExitPrimaryExp(SyntaxNodePtr node)
 {
-    node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_INT));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_INT));
 
     SyntaxNodePtr child = node->FirstChild();
     if (node->HasManyChildren())
@@ -1253,14 +1259,14 @@ bool DefaultSemanticAnalyzer::_ExitPrimaryExp(SyntaxNodePtr node)
 
     if (child->Type() == SyntaxType::ST_LVAL)
     {
-        SymbolValueType type = static_cast<SymbolValueType>(child->IntAttribute("type"));
+        SymbolValueType type = static_cast<SymbolValueType>(child->IntAttribute(SyntaxAttribute::SA_TYPE));
         if (type != SymbolValueType::VT_INT)
         {
-            node->SetIntAttribute("type", static_cast<int>(type));
-            node->SetIntAttribute("dim", child->IntAttribute("dim"));
-            if (node->IntAttribute("dim") == 2)
+            node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
+            node->SetIntAttribute(SyntaxAttribute::SA_DIM, child->IntAttribute(SyntaxAttribute::SA_DIM));
+            if (node->IntAttribute(SyntaxAttribute::SA_DIM) == 2)
             {
-                node->SetIntAttribute("size", child->IntAttribute("size"));
+                node->SetIntAttribute(SyntaxAttribute::SA_SIZE, child->IntAttribute(SyntaxAttribute::SA_SIZE));
             }
         }
         else
@@ -1268,32 +1274,32 @@ bool DefaultSemanticAnalyzer::_ExitPrimaryExp(SyntaxNodePtr node)
             int value;
             if (SemanticUtil::TryEvaluateLVal(child, _currentBlock, &value))
             {
-                node->SetBoolAttribute("det", true);
-                node->SetIntAttribute("value", value);
+                node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
+                node->SetIntAttribute(SyntaxAttribute::SA_VALUE, value);
             }
         }
     }
     else if (child->Type() == SyntaxType::ST_NUMBER)
     {
-        node->SetBoolAttribute("det", true);
-        node->SetIntAttribute("value", child->IntAttribute("value"));
+        node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
+        node->SetIntAttribute(SyntaxAttribute::SA_VALUE, child->IntAttribute(SyntaxAttribute::SA_VALUE));
     }
     else    // Exp
     {
-        SymbolValueType type = static_cast<SymbolValueType>(child->IntAttribute("type"));
+        SymbolValueType type = static_cast<SymbolValueType>(child->IntAttribute(SyntaxAttribute::SA_TYPE));
         if (type != SymbolValueType::VT_INT)
         {
-            node->SetIntAttribute("type", static_cast<int>(type));
-            node->SetIntAttribute("dim", child->IntAttribute("dim"));
-            if (node->IntAttribute("dim") == 2)
+            node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(type));
+            node->SetIntAttribute(SyntaxAttribute::SA_DIM, child->IntAttribute(SyntaxAttribute::SA_DIM));
+            if (node->IntAttribute(SyntaxAttribute::SA_DIM) == 2)
             {
-                node->SetIntAttribute("size", child->IntAttribute("size"));
+                node->SetIntAttribute(SyntaxAttribute::SA_SIZE, child->IntAttribute(SyntaxAttribute::SA_SIZE));
             }
         }
-        else if (child->BoolAttribute("det"))
+        else if (child->BoolAttribute(SyntaxAttribute::SA_DET))
         {
-            node->SetBoolAttribute("det", true);
-            node->SetIntAttribute("value", child->IntAttribute("value"));
+            node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
+            node->SetIntAttribute(SyntaxAttribute::SA_VALUE, child->IntAttribute(SyntaxAttribute::SA_VALUE));
         }
     }
 
@@ -1303,22 +1309,22 @@ bool DefaultSemanticAnalyzer::_ExitPrimaryExp(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_ExitFuncCall(SyntaxNodePtr node)
 {
-    const char* name = node->FirstChild()->Token()->lexeme.c_str();
+    const char* name = node->FirstChild()->Token().Lexeme();
     auto rawEntry = _currentBlock->FindEntry(name);
     if (!rawEntry || (rawEntry->EntryType() != SymbolTableEntryType::ET_FUNCTION))
     {
         _Log(LogLevel::ERROR, "Undefined function: %s", name);
         _LogError(ErrorType::ERR_UNDEFINED_SYMBOL, "Undefined function: %s", name);
-        node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_ANY));
+        node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_ANY));
         return true;
     }
 
     auto entry = std::static_pointer_cast<FunctionEntry>(rawEntry);
 
-    node->SetIntAttribute("type", static_cast<int>(entry->Type()));
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(entry->Type()));
 
     // Check argc.
-    int argc = SemanticUtil::GetSynthesizedIntAttribute(node, "argc");
+    int argc = SemanticUtil::GetSynthesizedIntAttribute(node, SyntaxAttribute::SA_ARGC);
     if (argc != entry->ArgsCount())
     {
         _Log(LogLevel::ERROR, "Argument count mismatch: %d != %d", argc, entry->ArgsCount());
@@ -1336,7 +1342,7 @@ bool DefaultSemanticAnalyzer::_ExitFuncCall(SyntaxNodePtr node)
         for (int i = 0; i < upper; i++)
         {
             auto param = entry->Param(i);
-            SymbolValueType argType = static_cast<SymbolValueType>(args[i]->IntAttribute("type"));
+            SymbolValueType argType = static_cast<SymbolValueType>(args[i]->IntAttribute(SyntaxAttribute::SA_TYPE));
             if ((argType != param->type) && (argType != SymbolValueType::VT_ANY))
             {
                 _Log(LogLevel::ERROR,
@@ -1351,34 +1357,34 @@ bool DefaultSemanticAnalyzer::_ExitFuncCall(SyntaxNodePtr node)
             }
             if (argType == SymbolValueType::VT_ARRAY)
             {
-                if (args[i]->IntAttribute("dim") != param->dimension)
+                if (args[i]->IntAttribute(SyntaxAttribute::SA_DIM) != param->dimension)
                 {
                     _Log(LogLevel::ERROR,
                          "Argument dimension mismatch: %d != %d",
-                         args[i]->IntAttribute("dim"),
+                         args[i]->IntAttribute(SyntaxAttribute::SA_DIM),
                          param->dimension);
                     _LogError(ErrorType::ERR_ARGUMENT_TYPE_MISMATCH,
                               "Argument dimension mismatch: %d != %d",
-                              args[i]->IntAttribute("dim"),
+                              args[i]->IntAttribute(SyntaxAttribute::SA_DIM),
                               param->dimension);
                     continue;
                 }
                 if (param->dimension == 2)
                 {
-                    if (args[i]->IntAttribute("size") != param->size[1])
+                    if (args[i]->IntAttribute(SyntaxAttribute::SA_SIZE) != param->size[1])
                     {
                         _Log(LogLevel::ERROR,
                              "Argument size mismatch: %d != %d",
-                             args[i]->IntAttribute("size"),
+                             args[i]->IntAttribute(SyntaxAttribute::SA_SIZE),
                              param->size[1]);
                         _LogError(ErrorType::ERR_ARGUMENT_TYPE_MISMATCH,
                                   "Argument size mismatch: %d != %d",
-                                  args[i]->IntAttribute("size"),
+                                  args[i]->IntAttribute(SyntaxAttribute::SA_SIZE),
                                   param->size[1]);
                         continue;
                     }
                 }
-                if (SemanticUtil::GetSynthesizedBoolAttribute(args[i], "const"))
+                if (SemanticUtil::GetSynthesizedBoolAttribute(args[i], SyntaxAttribute::SA_CONST))
                 {
                     _Log(LogLevel::ERROR, "Cannot pass const array as argument.");
                     _LogError(ErrorType::ERR_ARGUMENT_TYPE_MISMATCH, "Cannot pass const array as argument.");
@@ -1393,15 +1399,15 @@ bool DefaultSemanticAnalyzer::_ExitFuncCall(SyntaxNodePtr node)
 
 bool DefaultSemanticAnalyzer::_ExitNumber(SyntaxNodePtr node)
 {
-    node->SetIntAttribute("type", static_cast<int>(SymbolValueType::VT_INT));
-    node->SetBoolAttribute("det", true);
+    node->SetIntAttribute(SyntaxAttribute::SA_TYPE, static_cast<int>(SymbolValueType::VT_INT));
+    node->SetBoolAttribute(SyntaxAttribute::SA_DET, true);
 
     int value;
-    if (!StringUtil::ToInt(node->FirstChild()->Token()->lexeme.c_str(), &value))
+    if (!StringUtil::ToInt(node->FirstChild()->Token().Lexeme(), &value))
     {
         value = 0;
     }
-    node->SetIntAttribute("value", value);
+    node->SetIntAttribute(SyntaxAttribute::SA_VALUE, value);
 
     return true;
 }
@@ -4,9 +4,11 @@
  *   For BUAA 2023 Compiler Technology
  */
 
-#include <tomic/parser/ast/trans/RightRecursiveAstTransformer.h>
+#include <tomic/lexer/impl/StreamingPreprocessor.h>
+#include <tomic/parser/grammar/Grammar.h>
 #include <tomic/parser/impl/DefaultSyntacticParser.h>
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 #include <iostream>
@@ -16,51 +18,17 @@
 
 TOMIC_BEGIN
 
-static char _logBuffer[1024];
+// Each thread has its own, so that parsers can run on several threads.
+static thread_local char _logBuffer[1024];
 
 /*
  * ==================== First Set ====================
  */
 
-static std::vector<TokenType> _declFirstSet = {
-    TokenType::TK_INT
-};
-
-static std::vector<TokenType> _funcDefFirstSet = {
-    TokenType::TK_INT,
-    TokenType::TK_VOID
-};
-
-static std::vector<TokenType> _addExpAuxFirstSet = {
-    TokenType::TK_PLUS,
-    TokenType::TK_MINUS
-};
-
-static std::vector<TokenType> _mulExpAuxFirstSet = {
-    TokenType::TK_MULTIPLY,
-    TokenType::TK_DIVIDE,
-    TokenType::TK_MOD
-};
-
-static std::vector<TokenType> _andExpAuxFirstSet = {
-    TokenType::TK_AND
-};
-
-static std::vector<TokenType> _orExpAuxFirstSet = {
-    TokenType::TK_OR
-};
-
-static std::vector<TokenType> _eqExpAuxFirstSet = {
-    TokenType::TK_EQUAL,
-    TokenType::TK_NOT_EQUAL
-};
-
-static std::vector<TokenType> _relExpAuxFirstSet = {
-    TokenType::TK_LESS,
-    TokenType::TK_LESS_EQUAL,
-    TokenType::TK_GREATER,
-    TokenType::TK_GREATER_EQUAL
-};
+static const TokenSet _bTypeFirstSet = Grammar::First(SyntaxType::ST_BTYPE);
+static const TokenSet _varDeclFirstSet = Grammar::First(SyntaxType::ST_VAR_DECL);
+static const TokenSet _funcDefFirstSet = Grammar::First(SyntaxType::ST_FUNC_DEF);
+static const TokenSet _unaryOpFirstSet = Grammar::First(SyntaxType::ST_UNARY_OP);
 
 
 /*
@@ -75,7 +43,8 @@ DefaultSyntacticParser::DefaultSyntacticParser(
     : _lexicalParser(lexicalParser),
       _syntaxMapper(syntaxMapper),
       _tokenMapper(tokenMapper),
-      _logger(logger)
+      _logger(logger),
+      _maxDepth(DEFAULT_MAX_DEPTH)
 {
 }
 
@@ -87,6 +56,22 @@ DefaultSyntacticParser* DefaultSyntacticParser::SetReader(twio::IAdvancedReaderP
 }
 
 
+DefaultSyntacticParser* DefaultSyntacticParser::SetMaxDepth(int depth)
+{
+    TOMIC_ASSERT(depth > 0);
+    _maxDepth = depth;
+    return this;
+}
+
+
+// Always parse serially.
+DefaultSyntacticParser* DefaultSyntacticParser::SetThreads(int threads)
+{
+    TOMIC_ASSERT(threads > 0);
+    return this;
+}
+
+
 TokenPtr DefaultSyntacticParser::_Current()
 {
     auto current = _lexicalParser->Current();
@@ -140,16 +125,9 @@ bool DefaultSyntacticParser::_Match(TokenType type, TokenPtr token)
 }
 
 
-bool DefaultSyntacticParser::_MatchAny(const std::vector<TokenType>& types, TokenPtr token)
+bool DefaultSyntacticParser::_MatchAny(const TokenSet& types, TokenPtr token)
 {
-    for (auto type : types)
-    {
-        if (_Match(type, token))
-        {
-            return true;
-        }
-    }
-    return false;
+    return types.Contains(token);
 }
 
 
@@ -161,7 +139,14 @@ void DefaultSyntacticParser::_PostParseError(int checkpoint, SyntaxNodePtr node)
     }
     if (node)
     {
-        _tree->DeleteNode(node);
+        if (_IsTryParse())
+        {
+            _discarded.push_back(node);
+        }
+        else
+        {
+            _tree->DeleteNode(node);
+        }
     }
 }
 
@@ -170,13 +155,105 @@ void DefaultSyntacticParser::_SetTryParse(bool tryParse)
 {
     if (tryParse)
     {
+        if (_tryParse == 0)
+        {
+            _memoBase = _lexicalParser->SetCheckPoint();
+        }
         _tryParse++;
     }
     else if (_tryParse > 0)
     {
         // Avoid illegal decrement.
         _tryParse--;
+        if (_tryParse == 0)
+        {
+            _ClearMemo();
+        }
+    }
+}
+
+
+SyntaxNodePtr DefaultSyntacticParser::_Recall(SyntaxType type, int checkpoint)
+{
+    if (!_IsTryParse())
+    {
+        return nullptr;
+    }
+
+    int index = checkpoint - _memoBase;
+    if ((index < 0) || (index >= static_cast<int>(_memo.size())))
+    {
+        return nullptr;
     }
+
+    const MemoEntry& entry = _memo[index];
+    if (!entry.node || (entry.type != type))
+    {
+        return nullptr;
+    }
+
+    // Only take it from a failed alternative, not from the one in progress.
+    SyntaxNodePtr node = entry.node;
+    SyntaxNodePtr top = node->Root();
+    if ((top != node) && (std::find(_discarded.begin(), _discarded.end(), top) == _discarded.end()))
+    {
+        return nullptr;
+    }
+
+    if (node->Parent())
+    {
+        node->Parent()->RemoveChild(node);
+    }
+    _lexicalParser->Rollback(entry.end);
+
+    return node;
+}
+
+
+SyntaxNodePtr DefaultSyntacticParser::_Memorize(SyntaxType type, int checkpoint, SyntaxNodePtr node)
+{
+    int index = checkpoint - _memoBase;
+    if (_IsTryParse() && (index >= 0))
+    {
+        if (index >= static_cast<int>(_memo.size()))
+        {
+            _memo.resize(index + 1);
+        }
+        _memo[index] = { type, node, _lexicalParser->SetCheckPoint() };
+    }
+    return node;
+}
+
+
+void DefaultSyntacticParser::_ClearMemo()
+{
+    for (auto node : _discarded)
+    {
+        _tree->DeleteNode(node);
+    }
+    _discarded.clear();
+    _memo.clear();
+}
+
+
+bool DefaultSyntacticParser::_CheckDepth()
+{
+    if (_depthExceeded)
+    {
+        return false;
+    }
+    if (_depth <= _maxDepth)
+    {
+        return true;
+    }
+
+    // Only report the first time, then every level fails on its way up.
+    _depthExceeded = true;
+    auto token = _Lookahead();
+    _logger->LogFormat(LogLevel::FATAL, "(%d:%d) Nesting deeper than %d, parse aborted",
+                       token.LineNo(), token.CharNo(), _maxDepth);
+
+    return false;
 }
 
 
@@ -200,8 +277,8 @@ void DefaultSyntacticParser::_Log(LogLevel level, TokenPtr position, const char*
     TOMIC_VSPRINTF(_logBuffer, format, argv);
 
     auto token = position;
-    int lineNo = token ? token->lineNo : 1;
-    int charNo = token ? token->charNo : 1;
+    int lineNo = token ? token.LineNo() : 1;
+    int charNo = token ? token.CharNo() : 1;
 
     _logger->LogFormat(level, "(%d:%d) %s", lineNo, charNo, _logBuffer);
 }
@@ -248,16 +325,16 @@ void DefaultSyntacticParser::_LogExpect(TokenType expected, LogLevel level)
     }
     else
     {
-        _Log(level, actual, "Expect %s, but got %s", expectedDescr, actual->lexeme.c_str());
+        _Log(level, actual, "Expect %s, but got %s", expectedDescr, actual.Lexeme());
     }
 }
 
 
-void DefaultSyntacticParser::_LogExpect(const std::vector<TokenType>& expected, LogLevel level)
+void DefaultSyntacticParser::_LogExpect(const TokenSet& expected, LogLevel level)
 {
     std::stringstream stream;
 
-    for (auto type : expected)
+    for (auto type : expected.Types())
     {
         auto descr = _tokenMapper->Lexeme(type);
         if (!descr)
@@ -267,7 +344,7 @@ void DefaultSyntacticParser::_LogExpect(const std::vector<TokenType>& expected,
         stream << " " << descr;
     }
 
-    _Log(level, "Expect one of %s, but got %s", stream.str().c_str(), _Current()->lexeme.c_str());
+    _Log(level, "Expect one of %s, but got %s", stream.str().c_str(), _Current().Lexeme());
 }
 
 
@@ -280,7 +357,7 @@ void DefaultSyntacticParser::_LogExpectAfter(TokenType expected, LogLevel level)
         expectedDescr = "MISSING";
     }
 
-    _Log(level, current, "Expect %s after %s", expectedDescr, current->lexeme.c_str());
+    _Log(level, current, "Expect %s after %s", expectedDescr, current.Lexeme());
 }
 
 
@@ -291,7 +368,13 @@ void DefaultSyntacticParser::_LogExpectAfter(TokenType expected, LogLevel level)
 SyntaxTreePtr DefaultSyntacticParser::Parse()
 {
     _tree = SyntaxTree::New();
+    _tree->SetTokens(_lexicalParser->Arena());
     _tryParse = 0;
+    _memo.clear();
+    _memoBase = 0;
+    _discarded.clear();
+    _depth = 0;
+    _depthExceeded = false;
 
     auto compUnit = _ParseCompUnit();
     if (!compUnit)
@@ -302,12 +385,22 @@ SyntaxTreePtr DefaultSyntacticParser::Parse()
     }
 
     _tree->SetRoot(compUnit);
-    RightRecursiveAstTransformer().Transform(_tree);
 
     return _tree;
 }
 
 
+// Incremental parse is not supported, the source is always parsed in full.
+SyntaxTreePtr DefaultSyntacticParser::Reparse(SyntaxTreePtr tree, twio::MemoryReaderPtr source, const SourceEdit& edit)
+{
+    TOMIC_ASSERT(source);
+
+    SetReader(StreamingPreprocessor::New(twio::MemoryReader::New(source->Stream())));
+
+    return Parse();
+}
+
+
 SyntaxNodePtr DefaultSyntacticParser::_ParseCompUnit()
 {
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_COMP_UNIT);
@@ -363,7 +456,7 @@ bool DefaultSyntacticParser::_MatchDecl()
 
     // int ident, ...
     // As long as the third one is not '(', it must be a declaration.
-    if (_MatchAny(_declFirstSet, _Lookahead()) && _Match(TokenType::TK_IDENTIFIER, _Lookahead(2)))
+    if (_MatchAny(_varDeclFirstSet, _Lookahead()) && _Match(TokenType::TK_IDENTIFIER, _Lookahead(2)))
     {
         return !_Match(TokenType::TK_LEFT_PARENTHESIS, _Lookahead(3));
     }
@@ -428,13 +521,13 @@ SyntaxNodePtr DefaultSyntacticParser::_ParseBType()
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_BTYPE);
 
     SyntaxNodePtr child;
-    if (_MatchAny(_declFirstSet, _Lookahead()))
+    if (_MatchAny(_bTypeFirstSet, _Lookahead()))
     {
         child = _tree->NewTerminalNode(_Next());
     }
     else
     {
-        _LogExpect(_declFirstSet);
+        _LogExpect(_bTypeFirstSet);
         _PostParseError(checkpoint, root);
         return nullptr;
     }
@@ -573,6 +666,12 @@ SyntaxNodePtr DefaultSyntacticParser::_ParseConstDef()
 
 SyntaxNodePtr DefaultSyntacticParser::_ParseConstInitVal()
 {
+    NestingScope nesting(&_depth);
+    if (!_CheckDepth())
+    {
+        return nullptr;
+    }
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_CONST_INIT_VAL);
 
@@ -739,7 +838,7 @@ SyntaxNodePtr DefaultSyntacticParser::_ParseVarDef()
     // Check existence of '=', if not, return success, because it's a declaration.
     if (!_Match(TokenType::TK_ASSIGN, _Lookahead()))
     {
-        _Log(LogLevel::WARNING, "No initial value for %s", identifier->Token()->lexeme.c_str());
+        _Log(LogLevel::WARNING, "No initial value for %s", identifier->Token().Lexeme());
         return root;
     }
     root->InsertEndChild(_tree->NewTerminalNode(_Next()));
@@ -760,6 +859,12 @@ SyntaxNodePtr DefaultSyntacticParser::_ParseVarDef()
 
 SyntaxNodePtr DefaultSyntacticParser::_ParseInitVal()
 {
+    NestingScope nesting(&_depth);
+    if (!_CheckDepth())
+    {
+        return nullptr;
+    }
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_INIT_VAL);
 
@@ -1121,7 +1226,7 @@ SyntaxNodePtr DefaultSyntacticParser::_ParseBlockItem()
         }
         root->InsertEndChild(constDecl);
     }
-    else if (_MatchAny(_declFirstSet, lookahead))
+    else if (_MatchAny(_varDeclFirstSet, lookahead))
     {
         auto varDecl = _ParseVarDecl();
         if (!varDecl)
@@ -1214,6 +1319,12 @@ SyntaxNodePtr DefaultSyntacticParser::_ParseMainFuncDef()
  */
 SyntaxNodePtr DefaultSyntacticParser::_ParseStmt()
 {
+    NestingScope nesting(&_depth);
+    if (!_CheckDepth())
+    {
+        return nullptr;
+    }
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_STMT);
     TokenPtr lookahead = _Lookahead();
@@ -1375,6 +1486,14 @@ SyntaxNodePtr DefaultSyntacticParser::_ParseAssignmentStmt()
 SyntaxNodePtr DefaultSyntacticParser::_ParseLVal()
 {
     auto checkpoint = _lexicalParser->SetCheckPoint();
+
+    // Stmt alternatives all start with LVal, so it may be parsed again.
+    auto memo = _Recall(SyntaxType::ST_LVAL, checkpoint);
+    if (memo)
+    {
+        return memo;
+    }
+
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_LVAL);
 
     // Identifier
@@ -1412,7 +1531,7 @@ SyntaxNodePtr DefaultSyntacticParser::_ParseLVal()
         root->InsertEndChild(_tree->NewTerminalNode(_Next()));
     }
 
-    return root;
+    return _Memorize(SyntaxType::ST_LVAL, checkpoint, root);
 }
 
 
@@ -1979,162 +2098,21 @@ SyntaxNodePtr DefaultSyntacticParser::_ParseConstExp()
 }
 
 
-SyntaxNodePtr DefaultSyntacticParser::_ParseAddExp()
-{
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_ADD_EXP);
-
-    auto mulExp = _ParseMulExp();
-    if (!mulExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_MUL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(mulExp);
-
-    auto addExpAux = _ParseAddExpAux();
-    if (!addExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that addExpAux can be epsilon.
-    if (!addExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(addExpAux);
-    }
-
-    return root;
-}
-
-
-SyntaxNodePtr DefaultSyntacticParser::_ParseAddExpAux()
-{
-    if (!_MatchAny(_addExpAuxFirstSet, _Lookahead()))
-    {
-        return _tree->NewEpsilonNode();
-    }
-
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_ADD_EXP);
-
-    // '+' or '-'
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    // MulExp
-    auto mulExp = _ParseMulExp();
-    if (!mulExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_MUL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(mulExp);
-
-    // AddExpAux
-    auto addExpAux = _ParseAddExpAux();
-    if (!addExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that addExpAux can be epsilon.
-    if (!addExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(addExpAux);
-    }
-
-    return root;
-}
-
-
-SyntaxNodePtr DefaultSyntacticParser::_ParseMulExp()
-{
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_MUL_EXP);
-
-    auto unaryExp = _ParseUnaryExp();
-    if (!unaryExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_UNARY_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(unaryExp);
-
-    auto mulExpAux = _ParseMulExpAux();
-    if (!mulExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_MUL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that mulExpAux can be epsilon.
-    if (!mulExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(mulExpAux);
-    }
-
-    return root;
-}
-
-
-SyntaxNodePtr DefaultSyntacticParser::_ParseMulExpAux()
+SyntaxNodePtr DefaultSyntacticParser::_ParseUnaryExp()
 {
-    if (!_MatchAny(_mulExpAuxFirstSet, _Lookahead()))
-    {
-        return _tree->NewEpsilonNode();
-    }
-
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_MUL_EXP);
-
-    // '*' or '/' or '%'
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    // UnaryExp
-    auto unaryExp = _ParseUnaryExp();
-    if (!unaryExp)
+    NestingScope nesting(&_depth);
+    if (!_CheckDepth())
     {
-        _LogFailedToParse(SyntaxType::ST_UNARY_EXP);
-        _PostParseError(checkpoint, root);
         return nullptr;
     }
-    root->InsertEndChild(unaryExp);
 
-    // MulExpAux
-    auto mulExpAux = _ParseMulExpAux();
-    if (!mulExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_MUL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that mulExpAux can be epsilon.
-    if (!mulExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(mulExpAux);
-    }
-
-    return root;
-}
-
-
-SyntaxNodePtr DefaultSyntacticParser::_ParseUnaryExp()
-{
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_UNARY_EXP);
 
     // UnaryExp -> UnaryOp UnaryExp
-    auto unaryOp = _ParseUnaryOp();
-    if (unaryOp)
+    if (_MatchAny(_unaryOpFirstSet, _Lookahead()))
     {
-        root->InsertEndChild(unaryOp);
+        root->InsertEndChild(_ParseUnaryOp());
         auto unaryExp = _ParseUnaryExp();
         if (!unaryExp)
         {
@@ -2336,292 +2314,90 @@ SyntaxNodePtr DefaultSyntacticParser::_ParseNumber()
 }
 
 
-SyntaxNodePtr DefaultSyntacticParser::_ParseOrExp()
+namespace
 {
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_OR_EXP);
-
-    auto andExp = _ParseAndExp();
-    if (!andExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_AND_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(andExp);
-
-    auto orExpAux = _ParseOrExpAux();
-    if (!orExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_OR_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that orExpAux can be epsilon.
-    if (!orExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(orExpAux);
-    }
-
-    return root;
-}
 
-
-SyntaxNodePtr DefaultSyntacticParser::_ParseOrExpAux()
+struct BinaryExpLevel
 {
-    if (!_MatchAny(_orExpAuxFirstSet, _Lookahead()))
-    {
-        return _tree->NewEpsilonNode();
-    }
-
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_OR_EXP);
+    SyntaxType type;
+    TokenSet operators;
+};
 
-    // '||'
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
 
-    // AndExp
-    auto andExp = _ParseAndExp();
-    if (!andExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_AND_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(andExp);
+// From the lowest precedence to the highest. Operands of the last level
+// are UnaryExp.
+constexpr BinaryExpLevel _binaryExpLevels[] = {
+    { SyntaxType::ST_OR_EXP, { TokenType::TK_OR } },
+    { SyntaxType::ST_AND_EXP, { TokenType::TK_AND } },
+    { SyntaxType::ST_EQ_EXP, { TokenType::TK_EQUAL, TokenType::TK_NOT_EQUAL } },
+    { SyntaxType::ST_REL_EXP,
+      { TokenType::TK_LESS, TokenType::TK_LESS_EQUAL, TokenType::TK_GREATER, TokenType::TK_GREATER_EQUAL } },
+    { SyntaxType::ST_ADD_EXP, { TokenType::TK_PLUS, TokenType::TK_MINUS } },
+    { SyntaxType::ST_MUL_EXP, { TokenType::TK_MULTIPLY, TokenType::TK_DIVIDE, TokenType::TK_MOD } }
+};
 
-    // OrExpAux
-    auto orExpAux = _ParseOrExpAux();
-    if (!orExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_OR_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that orExpAux can be epsilon.
-    if (!orExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(orExpAux);
-    }
+constexpr int BINARY_EXP_LEVEL_COUNT = sizeof(_binaryExpLevels) / sizeof(_binaryExpLevels[0]);
+constexpr int OR_EXP_LEVEL = 0;
+constexpr int ADD_EXP_LEVEL = 4;
 
-    return root;
 }
 
 
-SyntaxNodePtr DefaultSyntacticParser::_ParseAndExp()
+SyntaxNodePtr DefaultSyntacticParser::_ParseOrExp()
 {
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_AND_EXP);
-
-    auto eqExp = _ParseEqExp();
-    if (!eqExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_EQ_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(eqExp);
-
-    auto andExpAux = _ParseAndExpAux();
-    if (!andExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_AND_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that andExpAux can be epsilon.
-    if (!andExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(andExpAux);
-    }
-
-    return root;
+    return _ParseBinaryExp(OR_EXP_LEVEL);
 }
 
 
-SyntaxNodePtr DefaultSyntacticParser::_ParseAndExpAux()
-{
-    if (!_MatchAny(_andExpAuxFirstSet, _Lookahead()))
-    {
-        return _tree->NewEpsilonNode();
-    }
-
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_AND_EXP);
-
-    // '&&'
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    // EqExp
-    auto eqExp = _ParseEqExp();
-    if (!eqExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_EQ_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(eqExp);
-
-    // AndExpAux
-    auto andExpAux = _ParseAndExpAux();
-    if (!andExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_AND_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that andExpAux can be epsilon.
-    if (!andExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(andExpAux);
-    }
-
-    return root;
-}
-
-
-SyntaxNodePtr DefaultSyntacticParser::_ParseEqExp()
+SyntaxNodePtr DefaultSyntacticParser::_ParseAddExp()
 {
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_EQ_EXP);
-
-    auto relExp = _ParseRelExp();
-    if (!relExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_REL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(relExp);
-
-    auto eqExpAux = _ParseEqExpAux();
-    if (!eqExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_EQ_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that eqExpAux can be epsilon.
-    if (!eqExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(eqExpAux);
-    }
-
-    return root;
+    return _ParseBinaryExp(ADD_EXP_LEVEL);
 }
 
 
-SyntaxNodePtr DefaultSyntacticParser::_ParseEqExpAux()
+/*
+ * Binary expressions are parsed by precedence climbing. Each level parses
+ * operands of the next level, and for each operator, what is parsed so far
+ * becomes the left operand of a new node. So the tree is left-recursive
+ * right away, e.g. a + b - c gives AddExp(AddExp(AddExp(a) + b) - c).
+ */
+SyntaxNodePtr DefaultSyntacticParser::_ParseBinaryExp(int level)
 {
-    if (!_MatchAny(_eqExpAuxFirstSet, _Lookahead()))
-    {
-        return _tree->NewEpsilonNode();
-    }
-
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_EQ_EXP);
-
-    // '==' or '!='
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
+    TOMIC_ASSERT(level < BINARY_EXP_LEVEL_COUNT);
 
-    // RelExp
-    auto relExp = _ParseRelExp();
-    if (!relExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_REL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(relExp);
-
-    // EqExpAux
-    auto eqExpAux = _ParseEqExpAux();
-    if (!eqExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_EQ_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that eqExpAux can be epsilon.
-    if (!eqExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(eqExpAux);
-    }
+    const BinaryExpLevel& current = _binaryExpLevels[level];
+    const bool isLast = (level + 1 == BINARY_EXP_LEVEL_COUNT);
+    const SyntaxType operandType = isLast ? SyntaxType::ST_UNARY_EXP : _binaryExpLevels[level + 1].type;
 
-    return root;
-}
-
-
-SyntaxNodePtr DefaultSyntacticParser::_ParseRelExp()
-{
     auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_REL_EXP);
-
-    auto addExp = _ParseAddExp();
-    if (!addExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(addExp);
+    auto root = _tree->NewNonTerminalNode(current.type);
 
-    auto relExpAux = _ParseRelExpAux();
-    if (!relExpAux)
+    auto operand = isLast ? _ParseUnaryExp() : _ParseBinaryExp(level + 1);
+    if (!operand)
     {
-        _LogFailedToParse(SyntaxType::ST_REL_EXP);
+        _LogFailedToParse(operandType);
         _PostParseError(checkpoint, root);
         return nullptr;
     }
-    // Notice that relExpAux can be epsilon.
-    if (!relExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(relExpAux);
-    }
+    root->InsertEndChild(operand);
 
-    return root;
-}
-
-
-SyntaxNodePtr DefaultSyntacticParser::_ParseRelExpAux()
-{
-    if (!_MatchAny(_relExpAuxFirstSet, _Lookahead()))
+    while (_MatchAny(current.operators, _Lookahead()))
     {
-        return _tree->NewEpsilonNode();
-    }
+        auto left = root;
+        root = _tree->NewNonTerminalNode(current.type);
+        root->InsertEndChild(left);
 
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_REL_EXP);
-
-    // '<' or '<=' or '>' or '>='
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    // AddExp
-    auto addExp = _ParseAddExp();
-    if (!addExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(addExp);
+        // Operator, already checked in _MatchAny().
+        root->InsertEndChild(_tree->NewTerminalNode(_Next()));
 
-    // RelExpAux
-    auto relExpAux = _ParseRelExpAux();
-    if (!relExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_REL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that relExpAux can be epsilon.
-    if (!relExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(relExpAux);
+        operand = isLast ? _ParseUnaryExp() : _ParseBinaryExp(level + 1);
+        if (!operand)
+        {
+            _LogFailedToParse(operandType);
+            _PostParseError(checkpoint, root);
+            return nullptr;
+        }
+        root->InsertEndChild(operand);
     }
 
     return root;
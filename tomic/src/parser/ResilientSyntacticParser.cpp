@@ -4,18 +4,53 @@
  *   For BUAA 2023 Compiler Technology
  */
 
+#include <tomic/lexer/impl/SpanLexicalParser.h>
+#include <tomic/lexer/impl/StreamingPreprocessor.h>
 #include <tomic/logger/error/ErrorType.h>
-#include <tomic/parser/ast/trans/RightRecursiveAstTransformer.h>
+#include <tomic/logger/error/impl/BufferedErrorLogger.h>
+#include <tomic/parser/grammar/Grammar.h>
 #include <tomic/parser/impl/ResilientSyntacticParser.h>
+#include <tomic/utils/Trace.h>
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
+#include <cstring>
 #include <sstream>
 #include <string>
 
 TOMIC_BEGIN
 
-static char _logBuffer[1024];
+// Workers of a parallel parse log on their own threads.
+static thread_local char _logBuffer[1024];
+
+/*
+ * ==================== First Set ====================
+ */
+
+static const TokenSet _varDeclFirstSet = Grammar::First(SyntaxType::ST_VAR_DECL);
+static const TokenSet _funcDefFirstSet = Grammar::First(SyntaxType::ST_FUNC_DEF);
+static const TokenSet _unaryOpFirstSet = Grammar::First(SyntaxType::ST_UNARY_OP);
+
+/*
+ * ==================== Sync Set ====================
+ */
+
+// Statement and declaration keywords, '{' and '}', but not the tokens that
+// may also appear inside an expression. Function definitions are included
+// in case '}' of the enclosing function is missing.
+static const TokenSet _blockItemSyncSet =
+    (Grammar::First(SyntaxType::ST_BLOCK_ITEM) - Grammar::First(SyntaxType::ST_EXP) -
+        TokenSet{ TokenType::TK_SEMICOLON }) | TokenSet{ TokenType::TK_RIGHT_BRACE } | _funcDefFirstSet;
+static const TokenSet _blockEndSet = { TokenType::TK_RIGHT_BRACE, TokenType::TK_TERMINATOR };
+static const TokenSet _compUnitSyncSet = Grammar::First(SyntaxType::ST_DECL) | _funcDefFirstSet;
+
+// Recovery may read each token again this many times, plus a constant.
+static constexpr int _RECOVERY_BUDGET_FACTOR = 2;
+static constexpr int _RECOVERY_BUDGET_BASE = 1024;
+
+// Below this many tokens, a parallel parse is not worth the threads.
+static constexpr size_t _MIN_PARALLEL_TOKENS = 4096;
 
 
 ResilientSyntacticParser::ResilientSyntacticParser(
@@ -28,7 +63,12 @@ ResilientSyntacticParser::ResilientSyntacticParser(
     _syntaxMapper(syntaxMapper),
     _tokenMapper(tokenMapper),
     _errorLogger(errorLogger),
-    _logger(logger)
+    _logger(logger),
+    _maxDepth(DEFAULT_MAX_DEPTH),
+    _itemsCost(0),
+    _strayQuote(false),
+    _threads(1),
+    _nextSpan(0)
 {
 }
 
@@ -40,6 +80,26 @@ ResilientSyntacticParser* ResilientSyntacticParser::SetReader(twio::IAdvancedRea
 }
 
 
+ResilientSyntacticParser* ResilientSyntacticParser::SetMaxDepth(int depth)
+{
+    TOMIC_ASSERT(depth > 0);
+    _maxDepth = depth;
+    return this;
+}
+
+
+ResilientSyntacticParser* ResilientSyntacticParser::SetThreads(int threads)
+{
+    TOMIC_ASSERT(threads > 0);
+    _threads = threads;
+    if ((_threads > 1) && (!_pool || (_pool->Size() != _threads)))
+    {
+        _pool = ThreadPool::New(_threads);
+    }
+    return this;
+}
+
+
 TokenPtr ResilientSyntacticParser::_Current()
 {
     auto current = _lexicalParser->Current();
@@ -93,16 +153,9 @@ bool ResilientSyntacticParser::_Match(TokenType type, TokenPtr token)
 }
 
 
-bool ResilientSyntacticParser::_MatchAny(const std::vector<TokenType>& types, TokenPtr token)
+bool ResilientSyntacticParser::_MatchAny(const TokenSet& types, TokenPtr token)
 {
-    for (auto type : types)
-    {
-        if (_Match(type, token))
-        {
-            return true;
-        }
-    }
-    return false;
+    return types.Contains(token);
 }
 
 
@@ -110,11 +163,22 @@ void ResilientSyntacticParser::_PostParseError(int checkpoint, SyntaxNodePtr nod
 {
     if (checkpoint >= 0)
     {
+        if (!_IsTryParse())
+        {
+            _recoveryCost += _lexicalParser->SetCheckPoint() - checkpoint;
+        }
         _lexicalParser->Rollback(checkpoint);
     }
     if (node)
     {
-        _tree->DeleteNode(node);
+        if (_IsTryParse())
+        {
+            _discarded.push_back(node);
+        }
+        else
+        {
+            _tree->DeleteNode(node);
+        }
     }
 }
 
@@ -123,13 +187,108 @@ void ResilientSyntacticParser::_SetTryParse(bool tryParse)
 {
     if (tryParse)
     {
+        if (_tryParse == 0)
+        {
+            _memoBase = _lexicalParser->SetCheckPoint();
+        }
         _tryParse++;
     }
     else if (_tryParse > 0)
     {
         // Avoid illegal decrement.
         _tryParse--;
+        if (_tryParse == 0)
+        {
+            _ClearMemo();
+        }
+    }
+}
+
+
+SyntaxNodePtr ResilientSyntacticParser::_Recall(SyntaxType type, int checkpoint)
+{
+    if (!_IsTryParse())
+    {
+        return nullptr;
+    }
+
+    int index = checkpoint - _memoBase;
+    if ((index < 0) || (index >= static_cast<int>(_memo.size())))
+    {
+        return nullptr;
+    }
+
+    const MemoEntry& entry = _memo[index];
+    if (!entry.node || (entry.type != type))
+    {
+        return nullptr;
+    }
+
+    // Only take it from a failed alternative, not from the one in progress.
+    SyntaxNodePtr node = entry.node;
+    SyntaxNodePtr top = node->Root();
+    if ((top != node) && (std::find(_discarded.begin(), _discarded.end(), top) == _discarded.end()))
+    {
+        return nullptr;
+    }
+
+    if (node->Parent())
+    {
+        node->Parent()->RemoveChild(node);
+    }
+    _lexicalParser->Rollback(entry.end);
+
+    return node;
+}
+
+
+SyntaxNodePtr ResilientSyntacticParser::_Memorize(SyntaxType type, int checkpoint, SyntaxNodePtr node)
+{
+    int index = checkpoint - _memoBase;
+    if (_IsTryParse() && (index >= 0))
+    {
+        if (index >= static_cast<int>(_memo.size()))
+        {
+            _memo.resize(index + 1);
+        }
+        _memo[index] = { type, node, _lexicalParser->SetCheckPoint() };
+    }
+    return node;
+}
+
+
+void ResilientSyntacticParser::_ClearMemo()
+{
+    for (auto node : _discarded)
+    {
+        _tree->DeleteNode(node);
+    }
+    _discarded.clear();
+    _memo.clear();
+}
+
+
+bool ResilientSyntacticParser::_CheckDepth()
+{
+    if (_depthExceeded)
+    {
+        return false;
+    }
+    if (_depth <= _maxDepth)
+    {
+        return true;
     }
+
+    // Only report the first time, then every level fails on its way up.
+    _depthExceeded = true;
+    auto token = _Lookahead();
+    _errorLogger->LogFormat(
+        token.LineNo(), token.CharNo(), ErrorType::ERR_UNKNOWN,
+        "Nesting deeper than %d", _maxDepth);
+    _logger->LogFormat(LogLevel::FATAL, "(%d:%d) Nesting deeper than %d, parse aborted",
+                       token.LineNo(), token.CharNo(), _maxDepth);
+
+    return false;
 }
 
 
@@ -153,8 +312,8 @@ void ResilientSyntacticParser::_Log(LogLevel level, TokenPtr position, const cha
     TOMIC_VSPRINTF(_logBuffer, format, argv);
 
     auto token = position;
-    int lineNo = token ? token->lineNo : 1;
-    int charNo = token ? token->charNo : 1;
+    int lineNo = token ? token.LineNo() : 1;
+    int charNo = token ? token.CharNo() : 1;
 
     _logger->LogFormat(level, "(%d:%d) %s", lineNo, charNo, _logBuffer);
 }
@@ -201,16 +360,16 @@ void ResilientSyntacticParser::_LogExpect(TokenType expected, LogLevel level)
     }
     else
     {
-        _Log(level, actual, "Expect %s, but got %s", expectedDescr, actual->lexeme.c_str());
+        _Log(level, actual, "Expect %s, but got %s", expectedDescr, actual.Lexeme());
     }
 }
 
 
-void ResilientSyntacticParser::_LogExpect(const std::vector<TokenType>& expected, LogLevel level)
+void ResilientSyntacticParser::_LogExpect(const TokenSet& expected, LogLevel level)
 {
     std::stringstream stream;
 
-    for (auto type : expected)
+    for (auto type : expected.Types())
     {
         auto descr = _tokenMapper->Lexeme(type);
         if (!descr)
@@ -220,7 +379,7 @@ void ResilientSyntacticParser::_LogExpect(const std::vector<TokenType>& expected
         stream << " " << descr;
     }
 
-    _Log(level, "Expect one of %s, but got %s", stream.str().c_str(), _Current()->lexeme.c_str());
+    _Log(level, "Expect one of %s, but got %s", stream.str().c_str(), _Current().Lexeme());
 }
 
 
@@ -233,7 +392,7 @@ void ResilientSyntacticParser::_LogExpectAfter(TokenType expected, LogLevel leve
         expectedDescr = "MISSING";
     }
 
-    _Log(level, current, "Expect %s after %s", expectedDescr, current->lexeme.c_str());
+    _Log(level, current, "Expect %s after %s", expectedDescr, current.Lexeme());
 }
 
 
@@ -263,9 +422,9 @@ void ResilientSyntacticParser::_RecoverFromMissingToken(SyntaxNodePtr node, Toke
     if (current)
     {
         _errorLogger->LogFormat(
-            current->lineNo, current->charNo, type,
+            current.LineNo(), current.CharNo(), type,
             "Missing %s after %s",
-            _tokenMapper->Lexeme(expected), current->lexeme.c_str());
+            _tokenMapper->Lexeme(expected), current.Lexeme());
     }
     else
     {
@@ -276,13 +435,71 @@ void ResilientSyntacticParser::_RecoverFromMissingToken(SyntaxNodePtr node, Toke
     }
 
     // Insert a pseudo token.
-    node->InsertEndChild(_tree->NewTerminalNode(Token::New(expected)));
+    node->InsertEndChild(_tree->NewTerminalNode(_PseudoToken(expected)));
 }
 
 
 void ResilientSyntacticParser::_MarkCorrupted(SyntaxNodePtr node)
 {
-    node->SetBoolAttribute("corrupted", true);
+    node->SetBoolAttribute(SyntaxAttribute::SA_CORRUPTED, true);
+}
+
+
+bool ResilientSyntacticParser::_Synchronize(const TokenSet& syncSet)
+{
+    if (_IsTryParse() || _recoveryExhausted || _depthExceeded)
+    {
+        return false;
+    }
+
+    int checkpoint = _lexicalParser->SetCheckPoint();
+    if (_recoveryCost > checkpoint * _RECOVERY_BUDGET_FACTOR + _RECOVERY_BUDGET_BASE)
+    {
+        _recoveryExhausted = true;
+        _Log(LogLevel::FATAL, "Too many errors, stop recovering");
+        return false;
+    }
+
+    TokenPtr first = _Lookahead();
+    if (_Match(TokenType::TK_TERMINATOR, first))
+    {
+        return false;
+    }
+
+    // Always skip the first token, so that progress is guaranteed.
+    int depth = 0;
+    TokenPtr token = first;
+    for (;;)
+    {
+        _Next();
+        if (_Match(TokenType::TK_LEFT_BRACE, token))
+        {
+            depth++;
+        }
+        else if (_Match(TokenType::TK_RIGHT_BRACE, token) && (depth > 0))
+        {
+            depth--;
+        }
+        else if (_Match(TokenType::TK_SEMICOLON, token) && (depth == 0))
+        {
+            break;
+        }
+
+        token = _Lookahead();
+        if (_Match(TokenType::TK_TERMINATOR, token) || ((depth == 0) && _MatchAny(syncSet, token)))
+        {
+            break;
+        }
+    }
+
+    int skipped = _lexicalParser->SetCheckPoint() - checkpoint;
+    _errorLogger->LogFormat(
+        first.LineNo(), first.CharNo(), ErrorType::ERR_UNEXPECTED_TOKEN,
+        "Unexpected token %s, %d token(s) skipped",
+        first.Lexeme(), skipped);
+    _Log(LogLevel::ERROR, first, "Skipped %d token(s) to recover", skipped);
+
+    return true;
 }
 
 
@@ -292,10 +509,18 @@ void ResilientSyntacticParser::_MarkCorrupted(SyntaxNodePtr node)
 
 SyntaxTreePtr ResilientSyntacticParser::Parse()
 {
+    TOMIC_TRACE("parse", "ResilientSyntacticParser::Parse");
+
     _tree = SyntaxTree::New();
-    _tryParse = 0;
+    _tree->SetTokens(_lexicalParser->Arena());
+    _Reset();
 
+    bool parallel = (_threads > 1) && _StartSpans();
     auto compUnit = _ParseCompUnit();
+    if (parallel)
+    {
+        _JoinSpans();
+    }
     if (!compUnit)
     {
         // TODO: Error handling.
@@ -304,177 +529,802 @@ SyntaxTreePtr ResilientSyntacticParser::Parse()
     }
 
     _tree->SetRoot(compUnit);
-    RightRecursiveAstTransformer().Transform(_tree);
+    _IndexItems(_tree);
+    _itemsCost = _recoveryCost;
 
     return _tree;
 }
 
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseCompUnit()
+void ResilientSyntacticParser::_Reset()
 {
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_COMP_UNIT);
-    auto checkpoint = _lexicalParser->SetCheckPoint();
+    _tryParse = 0;
+    _memo.clear();
+    _memoBase = 0;
+    _discarded.clear();
+    _recoveryCost = 0;
+    _recoveryExhausted = false;
+    _depth = 0;
+    _depthExceeded = false;
+    _pseudoTokens.clear();
+}
+
 
-    // Parse Decl
-    while (_MatchDecl())
+TokenPtr ResilientSyntacticParser::_PseudoToken(TokenType type)
+{
+    const auto index = static_cast<size_t>(type);
+    if (index >= _pseudoTokens.size())
     {
-        SyntaxNodePtr decl = _ParseDecl();
-        if (!decl)
-        {
-            _LogFailedToParse(SyntaxType::ST_DECL);
-            _PostParseError(checkpoint, root);
-            return nullptr;
-        }
-        root->InsertEndChild(decl);
+        _pseudoTokens.resize(index + 1);
     }
-
-    // Parse FuncDef
-    while (_MatchFuncDef())
+    if (!_pseudoTokens[index])
     {
-        SyntaxNodePtr funcDef = _ParseFuncDef();
-        if (!funcDef)
-        {
-            _LogFailedToParse(SyntaxType::ST_FUNC_DEF);
-            _PostParseError(checkpoint, root);
-            return nullptr;
-        }
-        root->InsertEndChild(funcDef);
+        _pseudoTokens[index] = _tree->Tokens()->NewToken(type);
     }
+    return _pseudoTokens[index];
+}
 
-    // Parse MainFuncDef
-    SyntaxNodePtr mainFuncDef = _ParseMainFuncDef();
-    if (!mainFuncDef)
+
+/*
+ * The preprocessor skips comments in quotes, while the lexer only knows
+ * strings. They agree unless a quote is in an unknown token, e.g. 'a' or
+ * a"b, after which the preprocessor may keep a comment that was skipped
+ * before the edit, or the other way round. Such sources are parsed in full.
+ */
+static bool _IsStrayQuote(const TokenArena& arena, uint32_t index)
+{
+    const Token& token = arena.At(index);
+    if (token.type != TokenType::TK_UNKNOWN)
     {
-        _Log(LogLevel::ERROR, "Failed to parse <MainFuncDef>");
-        _PostParseError(checkpoint, root);
-        return nullptr;
+        return false;
     }
-    root->InsertEndChild(mainFuncDef);
-
-    return root;
+    const char* lexeme = arena.Lexeme(index);
+    return memchr(lexeme, '"', token.length) || memchr(lexeme, '\'', token.length);
 }
 
 
-bool ResilientSyntacticParser::_MatchDecl()
+void ResilientSyntacticParser::_IndexItems(SyntaxTreePtr tree)
 {
-    // const ...
-    if (_Match(TokenType::TK_CONST, _Lookahead()))
+    _itemsTree = tree;
+    _items.clear();
+    for (auto item = tree->Root()->FirstChild(); item; item = item->NextSibling())
     {
-        return true;
+        _items.push_back(item);
     }
 
-    // int ident, ...
-    // As long as the third one is not '(', it must be a declaration.
-    if (_Match(TokenType::TK_INT, _Lookahead()) && _Match(TokenType::TK_IDENTIFIER, _Lookahead(2)))
+    // Unknown unless set by Parse.
+    _itemsCost = _RECOVERY_BUDGET_BASE + 1;
+
+    auto arena = tree->Tokens();
+    _strayQuote = false;
+    for (uint32_t i = 0; !_strayQuote && (i < arena->Size()); i++)
     {
-        return !_Match(TokenType::TK_LEFT_PARENTHESIS, _Lookahead(3));
+        _strayQuote = _IsStrayQuote(*arena, i);
     }
-
-    return false;
 }
 
 
-static std::vector<TokenType> _funcDefFirstSet = {
-    TokenType::TK_INT,
-    TokenType::TK_VOID
-};
-
-
-bool ResilientSyntacticParser::_MatchFuncDef()
+SyntaxTreePtr ResilientSyntacticParser::Reparse(SyntaxTreePtr tree, twio::MemoryReaderPtr source, const SourceEdit& edit)
 {
-    if (!_MatchAny(_funcDefFirstSet, _Lookahead()))
+    TOMIC_TRACE("parse", "ResilientSyntacticParser::Reparse");
+    TOMIC_ASSERT(source);
+
+    if (tree && tree->Root() && _Reparse(tree, source, edit))
     {
-        return false;
+        return tree;
     }
 
-    return _Match(TokenType::TK_IDENTIFIER, _Lookahead(2)) &&
-        _Match(TokenType::TK_LEFT_PARENTHESIS, _Lookahead(3));
+    _logger->LogFormat(LogLevel::DEBUG, "Edit cannot be applied locally, parse in full");
+    SetReader(StreamingPreprocessor::New(twio::MemoryReader::New(source->Stream())));
+
+    return Parse();
 }
 
 
 /*
- * ==================== Decl ====================
+ * ========== Incremental Parse ==========
  */
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseDecl()
+// First or last token of a node in the source, pseudo tokens are skipped.
+static TokenPtr _EdgeToken(SyntaxNodePtr root, bool last)
 {
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_DECL);
-
-    TokenPtr lookahead = _Lookahead();
-
-    if (_Match(TokenType::TK_CONST, lookahead))
+    SyntaxNodePtr node = root;
+    for (;;)
     {
-        auto constDecl = _ParseConstDecl();
-        if (!constDecl)
+        while (node->HasChildren())
         {
-            _LogFailedToParse(SyntaxType::ST_CONST_DECL);
-            _PostParseError(checkpoint, root);
-            return nullptr;
+            node = last ? node->LastChild() : node->FirstChild();
         }
-        root->InsertEndChild(constDecl);
-    }
-    else
-    {
-        auto varDecl = _ParseVarDecl();
-        if (!varDecl)
+        if (node->IsTerminal() && (node->Token().Position() != Token::NO_POSITION))
+        {
+            return node->Token();
+        }
+
+        while ((node != root) && !(last ? node->PrevSibling() : node->NextSibling()))
+        {
+            node = node->Parent();
+        }
+        if (node == root)
         {
-            _LogFailedToParse(SyntaxType::ST_VAR_DECL);
-            _PostParseError(checkpoint, root);
             return nullptr;
         }
-        root->InsertEndChild(varDecl);
+        node = last ? node->PrevSibling() : node->NextSibling();
     }
-
-    return root;
 }
 
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseBType()
+// A node ending with a pseudo token is recovered by looking at tokens after
+// it, so it is parsed again if they are edited.
+static bool _IsClosed(SyntaxNodePtr node)
 {
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_BTYPE);
-
-    SyntaxNodePtr child;
-    if (_Match(TokenType::TK_INT, _Lookahead()))
-    {
-        child = _tree->NewTerminalNode(_Next());
-    }
-    else
+    while (node->HasChildren())
     {
-        _LogExpect(TokenType::TK_INT);
-        _PostParseError(checkpoint, root);
-        return nullptr;
+        node = node->LastChild();
     }
-    root->InsertEndChild(child);
+    return node->IsTerminal() && (node->Token().Position() != Token::NO_POSITION);
+}
 
-    return root;
+
+static size_t _Begin(TokenPtr token)
+{
+    return token.Position() - 1;
 }
 
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseConstDecl()
+static size_t _End(TokenPtr token)
 {
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_CONST_DECL);
+    return token.Position() - 1 + token->length;
+}
 
-    // const
-    if (!_Match(TokenType::TK_CONST, _Lookahead()))
+
+static bool _MatchSource(const char* data, size_t size, size_t offset, TokenPtr token)
+{
+    return (offset + token->length <= size) && (memcmp(data + offset, token.Lexeme(), token->length) == 0);
+}
+
+
+/*
+ * Top-level nodes that end before the edit or start after it are kept. The
+ * region between the last one before and the first one after is lexed and
+ * parsed again. It always starts right after a token, so it is never in a
+ * comment or a string. The first token of the next node is lexed with it,
+ * and it must come out the same, so that the edit does not run into it,
+ * e.g. by an unclosed comment. Parsing must stop right there, and must not
+ * look past it, so that nodes after are parsed the same as before.
+ * Top-level nodes are found by binary search, and tokens after the edit
+ * are moved by the arena mostly block by block. So the cost hardly grows
+ * with the source, but with the nodes parsed again.
+ */
+bool ResilientSyntacticParser::_Reparse(SyntaxTreePtr tree, twio::MemoryReaderPtr source, const SourceEdit& edit)
+{
+    const char* data = source->Data();
+    const size_t size = source->Size();
+    const size_t editEnd = edit.offset + edit.length;
+    const ptrdiff_t delta = static_cast<ptrdiff_t>(edit.newLength) - static_cast<ptrdiff_t>(edit.length);
+
+    if (edit.offset + edit.newLength > size)
     {
-        _LogExpect(TokenType::TK_CONST);
-        _PostParseError(checkpoint, root);
-        return nullptr;
+        return false;
     }
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
 
-    // BType
-    SyntaxNodePtr type = _ParseBType();
-    if (!type)
+    SyntaxNodePtr root = tree->Root();
+    SyntaxNodePtr prev = nullptr;
+    SyntaxNodePtr next = nullptr;
+    TokenPtr prevToken = nullptr;
+    TokenPtr nextToken = nullptr;
+    if ((_itemsTree.lock() != tree) || _items.empty() ||
+        (_items.front() != root->FirstChild()) || (_items.back() != root->LastChild()))
     {
-        _LogFailedToParse(SyntaxType::ST_BTYPE);
-        _PostParseError(checkpoint, root);
-        return nullptr;
+        _IndexItems(tree);
+    }
+    if (_strayQuote)
+    {
+        return false;
     }
-    root->InsertEndChild(type);
+
+    // Index of the first node after the edit.
+    const size_t nextIndex = std::upper_bound(_items.begin(), _items.end(), editEnd,
+                                    [](size_t offset, SyntaxNodePtr item) {
+                                        TokenPtr first = _EdgeToken(item, false);
+                                        return first && (offset < _Begin(first));
+                                    }) - _items.begin();
+    if (nextIndex < _items.size())
+    {
+        next = _items[nextIndex];
+        nextToken = _EdgeToken(next, false);
+    }
+    size_t firstIndex = nextIndex;
+    while (firstIndex > 0)
+    {
+        TokenPtr last = _EdgeToken(_items[firstIndex - 1], true);
+        if (last && (_End(last) < edit.offset) && _IsClosed(_items[firstIndex - 1]))
+        {
+            prev = _items[firstIndex - 1];
+            prevToken = last;
+            break;
+        }
+        firstIndex--;
+    }
+
+    // Tokens around must be the same in the source, or the tree is not of
+    // it. The preprocessor drops '\r', which breaks positions.
+    const size_t begin = prevToken ? _End(prevToken) : 0;
+    const size_t end = nextToken ? _Begin(nextToken) + delta : size;
+    const size_t limit = nextToken ? end + nextToken->length : size;
+    if ((prevToken && !_MatchSource(data, size, _Begin(prevToken), prevToken)) ||
+        (nextToken && !_MatchSource(data, size, end, nextToken)) ||
+        memchr(data + begin, '\r', limit - begin))
+    {
+        return false;
+    }
+
+    auto arena = tree->Tokens();
+    arena->Shift(editEnd, delta);
+    if (arena->Lines())
+    {
+        arena->Lines()->Replace(edit.offset, edit.length, data + edit.offset, edit.newLength);
+    }
+
+    // Anything after MainFuncDef is not parsed at all.
+    if (prev && (prev->Type() == SyntaxType::ST_MAIN_FUNC_DEF))
+    {
+        return true;
+    }
+
+    auto stream = twio::BufferInputStream::New(data + begin, limit - begin);
+    _lexicalParser->SetReader(StreamingPreprocessor::New(twio::MemoryReader::New(stream), begin), arena);
+
+    _tree = tree;
+    _Reset();
+
+    // Errors are only reported if the region is spliced.
+    auto errorLogger = _errorLogger;
+    auto buffer = BufferedErrorLogger::New();
+    _errorLogger = buffer;
+
+    // Parsing goes on from prev as in a full parse, where Decl is no longer
+    // parsed once FuncDef is.
+    std::vector<SyntaxNodePtr> items;
+    bool funcDefs = prev && (prev->Type() == SyntaxType::ST_FUNC_DEF);
+    const uint32_t tokens = static_cast<uint32_t>(arena->Size());
+    bool spliced = _ParseCompUnitItems(&items, end, &funcDefs);
+    if (spliced && next)
+    {
+        // Parsing must stop right at next, in the phase next was parsed in,
+        // and must not have looked past it, as the region ends there.
+        TokenPtr token = _Lookahead();
+        spliced = (token->type == nextToken->type) && (_Begin(token) == end) &&
+                  (token->length == nextToken->length) &&
+                  (items.empty() || (items.back()->Type() != SyntaxType::ST_MAIN_FUNC_DEF)) &&
+                  !(funcDefs && (next->Type() == SyntaxType::ST_DECL));
+        for (uint32_t i = tokens; spliced && (i < arena->Size()); i++)
+        {
+            spliced = arena->At(i).type != TokenType::TK_TERMINATOR;
+        }
+    }
+    else if (spliced)
+    {
+        spliced = !items.empty() && (items.back()->Type() == SyntaxType::ST_MAIN_FUNC_DEF);
+    }
+    for (uint32_t i = tokens; spliced && (i < arena->Size()); i++)
+    {
+        spliced = !_IsStrayQuote(*arena, i);
+    }
+
+    // Recovery gives up on a budget of the whole source. If the cost stays
+    // within its base, it never does, and the region is recovered the same
+    // as in a full parse. The cost of the old region is not subtracted, so
+    // it is an upper bound.
+    spliced = spliced && (_itemsCost + _recoveryCost <= _RECOVERY_BUDGET_BASE);
+
+    _errorLogger = errorLogger;
+
+    if (!spliced)
+    {
+        for (auto item : items)
+        {
+            _tree->DeleteNode(item);
+        }
+        return false;
+    }
+
+    for (size_t i = firstIndex; i < nextIndex; i++)
+    {
+        _tree->DeleteNode(_items[i]);
+    }
+    SyntaxNodePtr after = prev;
+    for (auto node : items)
+    {
+        after = root->InsertAfterChild(node, after);
+    }
+
+    _itemsCost += _recoveryCost;
+
+    auto it = _items.erase(_items.begin() + firstIndex, _items.begin() + nextIndex);
+    _items.insert(it, items.begin(), items.end());
+
+    buffer->Flush(_errorLogger.get());
+
+    return true;
+}
+
+/*
+ * ========== Parallel Parse ==========
+ *
+ * Each span is a FuncDef from its return type to its matching '}', found
+ * by brace matching alone, and parsed on its own by a worker. A worker
+ * parser starts with no context, so its result is only kept if it ends
+ * right at the end of the span, never looks past it, and neither nesting
+ * nor recovery gives up. Then the serial parse would have done the same
+ * from there, since what it parses depends only on the tokens it looks at.
+ * Tokens are all read in advance, and pseudo tokens are made before any
+ * worker starts, so no token is added to the arena while they run.
+ */
+bool ResilientSyntacticParser::_StartSpans()
+{
+    TOMIC_TRACE("parse", __func__);
+
+    const int begin = _lexicalParser->SetCheckPoint();
+    const std::vector<TokenPtr>& tokens = _lexicalParser->Prefetch();
+    if (tokens.size() < begin + _MIN_PARALLEL_TOKENS)
+    {
+        return false;
+    }
+
+    _Prescan(tokens, begin);
+    if (_spans.size() < 2)
+    {
+        _spans.clear();
+        return false;
+    }
+
+    for (auto type : { TokenType::TK_TERMINATOR,
+                       TokenType::TK_SEMICOLON,
+                       TokenType::TK_RIGHT_PARENTHESIS,
+                       TokenType::TK_RIGHT_BRACKET,
+                       TokenType::TK_RIGHT_BRACE })
+    {
+        _PseudoToken(type);
+    }
+
+    const size_t forks = std::min(_spans.size(), static_cast<size_t>(_pool->Size()));
+    for (size_t i = 0; i < forks; i++)
+    {
+        _forks.push_back(_tree->Fork());
+    }
+    _idleForks = _forks;
+
+    for (auto& span : _spans)
+    {
+        auto task = std::make_shared<std::packaged_task<void()>>([this, &span, &tokens] {
+            _ParseSpan(&span, tokens);
+        });
+        span.done = task->get_future();
+        _pool->Submit([task] { (*task)(); });
+    }
+
+    return true;
+}
+
+
+void ResilientSyntacticParser::_Prescan(const std::vector<TokenPtr>& tokens, int begin)
+{
+    const int size = static_cast<int>(tokens.size());
+    int depth = 0;
+    int i = begin;
+    while (i < size)
+    {
+        const TokenType type = tokens[i]->type;
+        const bool funcDef = (depth == 0) && (i + 2 < size) &&
+                             ((type == TokenType::TK_INT) || (type == TokenType::TK_VOID)) &&
+                             (tokens[i + 1]->type == TokenType::TK_IDENTIFIER) &&
+                             (tokens[i + 2]->type == TokenType::TK_LEFT_PARENTHESIS);
+        if (!funcDef)
+        {
+            // Nothing is parsed after MainFuncDef.
+            if ((depth == 0) && (type == TokenType::TK_INT) &&
+                (i + 1 < size) && (tokens[i + 1]->type == TokenType::TK_MAIN))
+            {
+                return;
+            }
+            if (type == TokenType::TK_LEFT_BRACE)
+            {
+                depth++;
+            }
+            else if ((type == TokenType::TK_RIGHT_BRACE) && (depth > 0))
+            {
+                depth--;
+            }
+            i++;
+            continue;
+        }
+
+        // The body starts at the first '{', and ends at its matching '}'.
+        int end = i + 3;
+        while ((end < size) && (tokens[end]->type != TokenType::TK_LEFT_BRACE))
+        {
+            end++;
+        }
+        int level = 0;
+        for (; end < size; end++)
+        {
+            if (tokens[end]->type == TokenType::TK_LEFT_BRACE)
+            {
+                level++;
+            }
+            else if ((tokens[end]->type == TokenType::TK_RIGHT_BRACE) && (--level == 0))
+            {
+                break;
+            }
+        }
+        if (end == size)
+        {
+            return;
+        }
+
+        _spans.push_back({ i, end + 1, nullptr, 0, nullptr, nullptr, {} });
+        i = end + 1;
+    }
+}
+
+
+void ResilientSyntacticParser::_ParseSpan(Span* span, const std::vector<TokenPtr>& tokens)
+{
+    TOMIC_TRACE("parse", __func__);
+
+    SyntaxTreePtr fork;
+    {
+        std::lock_guard<std::mutex> lock(_forkMutex);
+        TOMIC_ASSERT(!_idleForks.empty());
+        fork = _idleForks.back();
+        _idleForks.pop_back();
+    }
+
+    const TokenPtr terminator = _pseudoTokens[static_cast<size_t>(TokenType::TK_TERMINATOR)];
+    auto lexicalParser = SpanLexicalParser::New(
+        fork->Tokens(), tokens.data() + span->begin, tokens.data() + span->end, terminator);
+    span->errors = BufferedErrorLogger::New();
+    span->logs = BufferedLogger::New();
+
+    ResilientSyntacticParser worker(lexicalParser, _syntaxMapper, _tokenMapper, span->errors, span->logs);
+    worker._maxDepth = _maxDepth;
+    worker._tree = fork;
+    worker._Reset();
+    worker._pseudoTokens = _pseudoTokens;
+
+    SyntaxNodePtr node = worker._ParseFuncDef();
+    if (node && (lexicalParser->IsOverrun() ||
+                 (lexicalParser->SetCheckPoint() != span->end - span->begin) ||
+                 worker._depthExceeded || worker._recoveryExhausted))
+    {
+        fork->DeleteNode(node);
+        node = nullptr;
+    }
+    span->node = node;
+    span->cost = worker._recoveryCost;
+
+    std::lock_guard<std::mutex> lock(_forkMutex);
+    _idleForks.push_back(fork);
+}
+
+
+SyntaxNodePtr ResilientSyntacticParser::_TakeSpan()
+{
+    const int checkpoint = _lexicalParser->SetCheckPoint();
+    while ((_nextSpan < _spans.size()) && (_spans[_nextSpan].begin < checkpoint))
+    {
+        _nextSpan++;
+    }
+    if ((_nextSpan == _spans.size()) || (_spans[_nextSpan].begin != checkpoint))
+    {
+        return nullptr;
+    }
+
+    Span& span = _spans[_nextSpan++];
+    span.done.wait();
+
+    // Recovery of the span must not run out of the budget here, see
+    // _Synchronize, or it may give up at a different place.
+    if (!span.node || _IsTryParse() || _recoveryExhausted || _depthExceeded ||
+        (_recoveryCost + span.cost > _RECOVERY_BUDGET_BASE))
+    {
+        return nullptr;
+    }
+
+    // Unknown tokens in the span are reported on the next read.
+    _lexicalParser->Rollback(span.end);
+    span.logs->Flush(_logger.get());
+    span.errors->Flush(_errorLogger.get());
+    _recoveryCost += span.cost;
+
+    SyntaxNodePtr node = span.node;
+    span.node = nullptr;
+    return node;
+}
+
+
+void ResilientSyntacticParser::_JoinSpans()
+{
+    TOMIC_TRACE("parse", __func__);
+
+    _pool->Wait();
+    for (auto& fork : _forks)
+    {
+        _tree->Join(*fork);
+    }
+    for (auto& span : _spans)
+    {
+        if (span.node)
+        {
+            _tree->DeleteNode(span.node);
+        }
+    }
+
+    _spans.clear();
+    _nextSpan = 0;
+    _forks.clear();
+    _idleForks.clear();
+}
+
+
+
+bool ResilientSyntacticParser::_ParseCompUnitItems(std::vector<SyntaxNodePtr>* items, size_t end, bool* funcDefs)
+{
+    TOMIC_TRACE("parse", __func__);
+
+    // The same loops as _ParseCompUnit, so that recovery skips the same
+    // tokens as in a full parse.
+    for (;;)
+    {
+        TokenPtr lookahead = _Lookahead();
+        if (_Match(TokenType::TK_TERMINATOR, lookahead) || (_Begin(lookahead) >= end))
+        {
+            return true;
+        }
+
+        if (!*funcDefs)
+        {
+            if (_MatchDecl())
+            {
+                SyntaxNodePtr decl = _ParseDecl();
+                if (decl)
+                {
+                    items->push_back(decl);
+                    continue;
+                }
+                _LogFailedToParse(SyntaxType::ST_DECL);
+                if (_Synchronize(_compUnitSyncSet))
+                {
+                    continue;
+                }
+                return false;
+            }
+            *funcDefs = true;
+        }
+
+        if (_MatchFuncDef())
+        {
+            SyntaxNodePtr funcDef = _ParseFuncDef();
+            if (funcDef)
+            {
+                items->push_back(funcDef);
+                continue;
+            }
+            _LogFailedToParse(SyntaxType::ST_FUNC_DEF);
+            if (_Synchronize(_compUnitSyncSet))
+            {
+                continue;
+            }
+            return false;
+        }
+
+        if (_MatchMainFuncDef())
+        {
+            SyntaxNodePtr mainFuncDef = _ParseMainFuncDef();
+            if (mainFuncDef)
+            {
+                items->push_back(mainFuncDef);
+            }
+            return mainFuncDef != nullptr;
+        }
+        if (!_Synchronize(_compUnitSyncSet))
+        {
+            return false;
+        }
+        *funcDefs = false;
+    }
+}
+
+
+SyntaxNodePtr ResilientSyntacticParser::_ParseCompUnit()
+{
+    TOMIC_TRACE("parse", __func__);
+
+    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_COMP_UNIT);
+    auto checkpoint = _lexicalParser->SetCheckPoint();
+
+    // Decl and FuncDef, and anything else before MainFuncDef is skipped.
+    do
+    {
+        // Parse Decl
+        while (_MatchDecl())
+        {
+            SyntaxNodePtr decl = _ParseDecl();
+            if (!decl)
+            {
+                _LogFailedToParse(SyntaxType::ST_DECL);
+                if (_Synchronize(_compUnitSyncSet))
+                {
+                    continue;
+                }
+                _PostParseError(checkpoint, root);
+                return nullptr;
+            }
+            root->InsertEndChild(decl);
+        }
+
+        // Parse FuncDef
+        while (_MatchFuncDef())
+        {
+            SyntaxNodePtr funcDef = _TakeSpan();
+            if (!funcDef)
+            {
+                funcDef = _ParseFuncDef();
+            }
+            if (!funcDef)
+            {
+                _LogFailedToParse(SyntaxType::ST_FUNC_DEF);
+                if (_Synchronize(_compUnitSyncSet))
+                {
+                    continue;
+                }
+                _PostParseError(checkpoint, root);
+                return nullptr;
+            }
+            root->InsertEndChild(funcDef);
+        }
+    } while (!_MatchMainFuncDef() && _Synchronize(_compUnitSyncSet));
+
+    // Parse MainFuncDef
+    SyntaxNodePtr mainFuncDef = _ParseMainFuncDef();
+    if (!mainFuncDef)
+    {
+        _Log(LogLevel::ERROR, "Failed to parse <MainFuncDef>");
+        _PostParseError(checkpoint, root);
+        return nullptr;
+    }
+    root->InsertEndChild(mainFuncDef);
+
+    return root;
+}
+
+
+bool ResilientSyntacticParser::_MatchDecl()
+{
+    // const ...
+    if (_Match(TokenType::TK_CONST, _Lookahead()))
+    {
+        return true;
+    }
+
+    // int ident, ...
+    // As long as the third one is not '(', it must be a declaration.
+    if (_MatchAny(_varDeclFirstSet, _Lookahead()) && _Match(TokenType::TK_IDENTIFIER, _Lookahead(2)))
+    {
+        return !_Match(TokenType::TK_LEFT_PARENTHESIS, _Lookahead(3));
+    }
+
+    return false;
+}
+
+
+bool ResilientSyntacticParser::_MatchMainFuncDef()
+{
+    return _Match(TokenType::TK_INT, _Lookahead()) && _Match(TokenType::TK_MAIN, _Lookahead(2));
+}
+
+
+bool ResilientSyntacticParser::_MatchFuncDef()
+{
+    if (!_MatchAny(_funcDefFirstSet, _Lookahead()))
+    {
+        return false;
+    }
+
+    return _Match(TokenType::TK_IDENTIFIER, _Lookahead(2)) &&
+        _Match(TokenType::TK_LEFT_PARENTHESIS, _Lookahead(3));
+}
+
+
+/*
+ * ==================== Decl ====================
+ */
+
+SyntaxNodePtr ResilientSyntacticParser::_ParseDecl()
+{
+    TOMIC_TRACE("parse", __func__);
+
+    auto checkpoint = _lexicalParser->SetCheckPoint();
+    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_DECL);
+
+    TokenPtr lookahead = _Lookahead();
+
+    if (_Match(TokenType::TK_CONST, lookahead))
+    {
+        auto constDecl = _ParseConstDecl();
+        if (!constDecl)
+        {
+            _LogFailedToParse(SyntaxType::ST_CONST_DECL);
+            _PostParseError(checkpoint, root);
+            return nullptr;
+        }
+        root->InsertEndChild(constDecl);
+    }
+    else
+    {
+        auto varDecl = _ParseVarDecl();
+        if (!varDecl)
+        {
+            _LogFailedToParse(SyntaxType::ST_VAR_DECL);
+            _PostParseError(checkpoint, root);
+            return nullptr;
+        }
+        root->InsertEndChild(varDecl);
+    }
+
+    return root;
+}
+
+
+SyntaxNodePtr ResilientSyntacticParser::_ParseBType()
+{
+    TOMIC_TRACE("parse", __func__);
+
+    auto checkpoint = _lexicalParser->SetCheckPoint();
+    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_BTYPE);
+
+    SyntaxNodePtr child;
+    if (_Match(TokenType::TK_INT, _Lookahead()))
+    {
+        child = _tree->NewTerminalNode(_Next());
+    }
+    else
+    {
+        _LogExpect(TokenType::TK_INT);
+        _PostParseError(checkpoint, root);
+        return nullptr;
+    }
+    root->InsertEndChild(child);
+
+    return root;
+}
+
+
+SyntaxNodePtr ResilientSyntacticParser::_ParseConstDecl()
+{
+    TOMIC_TRACE("parse", __func__);
+
+    auto checkpoint = _lexicalParser->SetCheckPoint();
+    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_CONST_DECL);
+
+    // const
+    if (!_Match(TokenType::TK_CONST, _Lookahead()))
+    {
+        _LogExpect(TokenType::TK_CONST);
+        _PostParseError(checkpoint, root);
+        return nullptr;
+    }
+    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
+
+    // BType
+    SyntaxNodePtr type = _ParseBType();
+    if (!type)
+    {
+        _LogFailedToParse(SyntaxType::ST_BTYPE);
+        _PostParseError(checkpoint, root);
+        return nullptr;
+    }
+    root->InsertEndChild(type);
 
     // ConstDef
     SyntaxNodePtr constDef = _ParseConstDef();
@@ -518,6 +1368,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseConstDecl()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseConstDef()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_CONST_DEF);
 
@@ -584,6 +1436,14 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseConstDef()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseConstInitVal()
 {
+    TOMIC_TRACE("parse", __func__);
+
+    NestingScope nesting(&_depth);
+    if (!_CheckDepth())
+    {
+        return nullptr;
+    }
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_CONST_INIT_VAL);
 
@@ -655,6 +1515,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseConstInitVal()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseVarDecl()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_VAR_DECL);
 
@@ -710,6 +1572,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseVarDecl()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseVarDef()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_VAR_DEF);
 
@@ -755,7 +1619,7 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseVarDef()
     // Check existence of '=', if not, return success, because it's a declaration.
     if (!_Match(TokenType::TK_ASSIGN, _Lookahead()))
     {
-        _Log(LogLevel::WARNING, "No initial value for %s", identifier->Token()->lexeme.c_str());
+        _Log(LogLevel::WARNING, "No initial value for %s", identifier->Token().Lexeme());
         return root;
     }
     root->InsertEndChild(_tree->NewTerminalNode(_Next()));
@@ -776,6 +1640,14 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseVarDef()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseInitVal()
 {
+    TOMIC_TRACE("parse", __func__);
+
+    NestingScope nesting(&_depth);
+    if (!_CheckDepth())
+    {
+        return nullptr;
+    }
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_INIT_VAL);
 
@@ -851,6 +1723,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseInitVal()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseFuncDef()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FUNC_DEF);
 
@@ -880,6 +1754,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseFuncDef()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseFuncDecl()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FUNC_DECL);
 
@@ -943,6 +1819,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseFuncDecl()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseFuncType()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FUNC_TYPE);
 
@@ -963,6 +1841,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseFuncType()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseFuncFParams()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FUNC_FPARAMS);
 
@@ -994,6 +1874,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseFuncFParams()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseFuncFParam()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FUNC_FPARAM);
 
@@ -1066,6 +1948,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseFuncFParam()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseFuncAParams()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FUNC_APARAMS);
 
@@ -1097,6 +1981,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseFuncAParams()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseFuncAParam()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FUNC_APARAM);
 
@@ -1115,6 +2001,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseFuncAParam()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseBlock()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_BLOCK);
 
@@ -1135,13 +2023,17 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseBlock()
         return root;
     }
 
-    // BlockItem
-    while (!_Match(TokenType::TK_RIGHT_BRACE, _Lookahead()))
+    // BlockItem, till '}', or EOF or the next function if '}' is missing.
+    while (!_MatchAny(_blockEndSet, _Lookahead()) && !_MatchFuncDef() && !_MatchMainFuncDef())
     {
         auto blockItem = _ParseBlockItem();
         if (!blockItem)
         {
             _LogFailedToParse(SyntaxType::ST_BLOCK_ITEM);
+            if (_Synchronize(_blockItemSyncSet))
+            {
+                continue;
+            }
             _PostParseError(checkpoint, root);
             return nullptr;
         }
@@ -1165,6 +2057,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseBlock()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseBlockItem()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_BLOCK_ITEM);
 
@@ -1180,7 +2074,7 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseBlockItem()
         }
         root->InsertEndChild(constDecl);
     }
-    else if (_Match(TokenType::TK_INT, lookahead))
+    else if (_MatchAny(_varDeclFirstSet, lookahead))
     {
         auto varDecl = _ParseVarDecl();
         if (!varDecl)
@@ -1209,6 +2103,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseBlockItem()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseMainFuncDef()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_MAIN_FUNC_DEF);
 
@@ -1275,6 +2171,14 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseMainFuncDef()
  */
 SyntaxNodePtr ResilientSyntacticParser::_ParseStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
+    NestingScope nesting(&_depth);
+    if (!_CheckDepth())
+    {
+        return nullptr;
+    }
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_STMT);
     TokenPtr lookahead = _Lookahead();
@@ -1359,6 +2263,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseStmt()
  */
 SyntaxNodePtr ResilientSyntacticParser::_ParseStmtAux()
 {
+    TOMIC_TRACE("parse", __func__);
+
     // InStmt is the simplest, so try parse it first.
     auto inStmt = _ParseInStmt();
     if (inStmt)
@@ -1388,6 +2294,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseStmtAux()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseAssignmentStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_ASSIGNMENT_STMT);
 
@@ -1437,7 +2345,17 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseAssignmentStmt()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseLVal()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
+
+    // Stmt alternatives all start with LVal, so it may be parsed again.
+    auto memo = _Recall(SyntaxType::ST_LVAL, checkpoint);
+    if (memo)
+    {
+        return memo;
+    }
+
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_LVAL);
 
     // Identifier
@@ -1477,12 +2395,14 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseLVal()
         }
     }
 
-    return root;
+    return _Memorize(SyntaxType::ST_LVAL, checkpoint, root);
 }
 
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseCond()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_COND);
 
@@ -1501,6 +2421,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseCond()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseIfStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_IF_STMT);
 
@@ -1574,6 +2496,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseIfStmt()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseForStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FOR_STMT);
 
@@ -1683,6 +2607,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseForStmt()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseForInitStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FOR_INIT_STMT);
 
@@ -1721,6 +2647,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseForInitStmt()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseForStepStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FOR_STEP_STMT);
 
@@ -1759,6 +2687,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseForStepStmt()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseExpStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_EXP_STMT);
 
@@ -1809,6 +2739,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseExpStmt()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseBreakStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_BREAK_STMT);
 
@@ -1838,6 +2770,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseBreakStmt()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseContinueStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_CONTINUE_STMT);
 
@@ -1867,6 +2801,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseContinueStmt()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseReturnStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_RETURN_STMT);
 
@@ -1911,6 +2847,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseReturnStmt()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseInStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_IN_STMT);
 
@@ -1979,6 +2917,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseInStmt()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseOutStmt()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_OUT_STMT);
 
@@ -2004,245 +2944,90 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseOutStmt()
     if (_Match(TokenType::TK_FORMAT, _Lookahead()))
     {
         root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    }
-    else
-    {
-        _LogExpect(TokenType::TK_FORMAT);
-    }
-
-    // ',' Exp
-    while (_Match(TokenType::TK_COMMA, _Lookahead()))
-    {
-        // Skip ','
-        root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-        SyntaxNodePtr exp = _ParseExp();
-        if (!exp)
-        {
-            _LogFailedToParse(SyntaxType::ST_EXP);
-            _PostParseError(checkpoint, root);
-            return nullptr;
-        }
-        root->InsertEndChild(exp);
-    }
-
-    // ')'
-    if (!_Match(TokenType::TK_RIGHT_PARENTHESIS, _Lookahead()))
-    {
-        _LogExpectAfter(TokenType::TK_RIGHT_PARENTHESIS);
-        _RecoverFromMissingToken(root, TokenType::TK_RIGHT_PARENTHESIS);
-    }
-    else
-    {
-        root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-    }
-
-    // ';'
-    if (!_Match(TokenType::TK_SEMICOLON, _Lookahead()))
-    {
-        _LogExpectAfter(TokenType::TK_SEMICOLON);
-        _RecoverFromMissingToken(root, TokenType::TK_SEMICOLON);
-    }
-    else
-    {
-        root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-    }
-
-    return root;
-}
-
-
-SyntaxNodePtr ResilientSyntacticParser::_ParseExp()
-{
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_EXP);
-
-    auto addExp = _ParseAddExp();
-    if (!addExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(addExp);
-
-    return root;
-}
-
-
-SyntaxNodePtr ResilientSyntacticParser::_ParseConstExp()
-{
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_CONST_EXP);
-
-    auto addExp = _ParseAddExp();
-    if (!addExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(addExp);
-
-    return root;
-}
-
-
-SyntaxNodePtr ResilientSyntacticParser::_ParseAddExp()
-{
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_ADD_EXP);
-
-    auto mulExp = _ParseMulExp();
-    if (!mulExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_MUL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(mulExp);
-
-    auto addExpAux = _ParseAddExpAux();
-    if (!addExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
+
     }
-    // Notice that addExpAux can be epsilon.
-    if (!addExpAux->IsEpsilon())
+    else
     {
-        root->InsertEndChild(addExpAux);
+        _LogExpect(TokenType::TK_FORMAT);
     }
 
-    return root;
-}
-
-
-static std::vector<TokenType> _addExpAuxFirstSet = {
-    TokenType::TK_PLUS,
-    TokenType::TK_MINUS
-};
+    // ',' Exp
+    while (_Match(TokenType::TK_COMMA, _Lookahead()))
+    {
+        // Skip ','
+        root->InsertEndChild(_tree->NewTerminalNode(_Next()));
 
+        SyntaxNodePtr exp = _ParseExp();
+        if (!exp)
+        {
+            _LogFailedToParse(SyntaxType::ST_EXP);
+            _PostParseError(checkpoint, root);
+            return nullptr;
+        }
+        root->InsertEndChild(exp);
+    }
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseAddExpAux()
-{
-    if (!_MatchAny(_addExpAuxFirstSet, _Lookahead()))
+    // ')'
+    if (!_Match(TokenType::TK_RIGHT_PARENTHESIS, _Lookahead()))
     {
-        return _tree->NewEpsilonNode();
+        _LogExpectAfter(TokenType::TK_RIGHT_PARENTHESIS);
+        _RecoverFromMissingToken(root, TokenType::TK_RIGHT_PARENTHESIS);
     }
-
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_ADD_EXP);
-
-    // '+' or '-'
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    // MulExp
-    auto mulExp = _ParseMulExp();
-    if (!mulExp)
+    else
     {
-        _LogFailedToParse(SyntaxType::ST_MUL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
+        root->InsertEndChild(_tree->NewTerminalNode(_Next()));
     }
-    root->InsertEndChild(mulExp);
 
-    // AddExpAux
-    auto addExpAux = _ParseAddExpAux();
-    if (!addExpAux)
+    // ';'
+    if (!_Match(TokenType::TK_SEMICOLON, _Lookahead()))
     {
-        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
+        _LogExpectAfter(TokenType::TK_SEMICOLON);
+        _RecoverFromMissingToken(root, TokenType::TK_SEMICOLON);
     }
-    // Notice that addExpAux can be epsilon.
-    if (!addExpAux->IsEpsilon())
+    else
     {
-        root->InsertEndChild(addExpAux);
+        root->InsertEndChild(_tree->NewTerminalNode(_Next()));
     }
 
     return root;
 }
 
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseMulExp()
+SyntaxNodePtr ResilientSyntacticParser::_ParseExp()
 {
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_MUL_EXP);
+    TOMIC_TRACE("parse", __func__);
 
-    auto unaryExp = _ParseUnaryExp();
-    if (!unaryExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_UNARY_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(unaryExp);
+    auto checkpoint = _lexicalParser->SetCheckPoint();
+    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_EXP);
 
-    auto mulExpAux = _ParseMulExpAux();
-    if (!mulExpAux)
+    auto addExp = _ParseAddExp();
+    if (!addExp)
     {
-        _LogFailedToParse(SyntaxType::ST_MUL_EXP);
+        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
         _PostParseError(checkpoint, root);
         return nullptr;
     }
-    // Notice that mulExpAux can be epsilon.
-    if (!mulExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(mulExpAux);
-    }
+    root->InsertEndChild(addExp);
 
     return root;
 }
 
 
-static std::vector<TokenType> _mulExpAuxFirstSet = {
-    TokenType::TK_MULTIPLY,
-    TokenType::TK_DIVIDE,
-    TokenType::TK_MOD
-};
-
-
-SyntaxNodePtr ResilientSyntacticParser::_ParseMulExpAux()
+SyntaxNodePtr ResilientSyntacticParser::_ParseConstExp()
 {
-    if (!_MatchAny(_mulExpAuxFirstSet, _Lookahead()))
-    {
-        return _tree->NewEpsilonNode();
-    }
+    TOMIC_TRACE("parse", __func__);
 
     auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_MUL_EXP);
-
-    // '*' or '/' or '%'
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    // UnaryExp
-    auto unaryExp = _ParseUnaryExp();
-    if (!unaryExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_UNARY_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(unaryExp);
+    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_CONST_EXP);
 
-    // MulExpAux
-    auto mulExpAux = _ParseMulExpAux();
-    if (!mulExpAux)
+    auto addExp = _ParseAddExp();
+    if (!addExp)
     {
-        _LogFailedToParse(SyntaxType::ST_MUL_EXP);
+        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
         _PostParseError(checkpoint, root);
         return nullptr;
     }
-    // Notice that mulExpAux can be epsilon.
-    if (!mulExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(mulExpAux);
-    }
+    root->InsertEndChild(addExp);
 
     return root;
 }
@@ -2250,14 +3035,21 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseMulExpAux()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseUnaryExp()
 {
+    TOMIC_TRACE("parse", __func__);
+
+    NestingScope nesting(&_depth);
+    if (!_CheckDepth())
+    {
+        return nullptr;
+    }
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_UNARY_EXP);
 
     // UnaryExp -> UnaryOp UnaryExp
-    auto unaryOp = _ParseUnaryOp();
-    if (unaryOp)
+    if (_MatchAny(_unaryOpFirstSet, _Lookahead()))
     {
-        root->InsertEndChild(unaryOp);
+        root->InsertEndChild(_ParseUnaryOp());
         auto unaryExp = _ParseUnaryExp();
         if (!unaryExp)
         {
@@ -2299,6 +3091,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseUnaryExp()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseUnaryOp()
 {
+    TOMIC_TRACE("parse", __func__);
+
     // auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_UNARY_OP);
 
@@ -2332,6 +3126,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseUnaryOp()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParsePrimaryExp()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_PRIMARY_EXP);
 
@@ -2396,6 +3192,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParsePrimaryExp()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseFuncCall()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_FUNC_CALL);
 
@@ -2450,6 +3248,8 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseFuncCall()
 
 SyntaxNodePtr ResilientSyntacticParser::_ParseNumber()
 {
+    TOMIC_TRACE("parse", __func__);
+
     auto checkpoint = _lexicalParser->SetCheckPoint();
     auto root = _tree->NewNonTerminalNode(SyntaxType::ST_NUMBER);
 
@@ -2466,316 +3266,92 @@ SyntaxNodePtr ResilientSyntacticParser::_ParseNumber()
 }
 
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseOrExp()
+namespace
 {
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_OR_EXP);
-
-    auto andExp = _ParseAndExp();
-    if (!andExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_AND_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(andExp);
-
-    auto orExpAux = _ParseOrExpAux();
-    if (!orExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_OR_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that orExpAux can be epsilon.
-    if (!orExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(orExpAux);
-    }
-
-    return root;
-}
-
-
-static std::vector<TokenType> _orExpAuxFirstSet = {
-    TokenType::TK_OR
-};
-
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseOrExpAux()
+struct BinaryExpLevel
 {
-    if (!_MatchAny(_orExpAuxFirstSet, _Lookahead()))
-    {
-        return _tree->NewEpsilonNode();
-    }
-
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_OR_EXP);
-
-    // '||'
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    // AndExp
-    auto andExp = _ParseAndExp();
-    if (!andExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_AND_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(andExp);
-
-    // OrExpAux
-    auto orExpAux = _ParseOrExpAux();
-    if (!orExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_OR_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that orExpAux can be epsilon.
-    if (!orExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(orExpAux);
-    }
-
-    return root;
-}
-
+    SyntaxType type;
+    TokenSet operators;
+};
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseAndExp()
-{
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_AND_EXP);
 
-    auto eqExp = _ParseEqExp();
-    if (!eqExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_EQ_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(eqExp);
+// From the lowest precedence to the highest. Operands of the last level
+// are UnaryExp.
+constexpr BinaryExpLevel _binaryExpLevels[] = {
+    { SyntaxType::ST_OR_EXP, { TokenType::TK_OR } },
+    { SyntaxType::ST_AND_EXP, { TokenType::TK_AND } },
+    { SyntaxType::ST_EQ_EXP, { TokenType::TK_EQUAL, TokenType::TK_NOT_EQUAL } },
+    { SyntaxType::ST_REL_EXP,
+      { TokenType::TK_LESS, TokenType::TK_LESS_EQUAL, TokenType::TK_GREATER, TokenType::TK_GREATER_EQUAL } },
+    { SyntaxType::ST_ADD_EXP, { TokenType::TK_PLUS, TokenType::TK_MINUS } },
+    { SyntaxType::ST_MUL_EXP, { TokenType::TK_MULTIPLY, TokenType::TK_DIVIDE, TokenType::TK_MOD } }
+};
 
-    auto andExpAux = _ParseAndExpAux();
-    if (!andExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_AND_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that andExpAux can be epsilon.
-    if (!andExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(andExpAux);
-    }
+constexpr int BINARY_EXP_LEVEL_COUNT = sizeof(_binaryExpLevels) / sizeof(_binaryExpLevels[0]);
+constexpr int OR_EXP_LEVEL = 0;
+constexpr int ADD_EXP_LEVEL = 4;
 
-    return root;
 }
 
 
-static std::vector<TokenType> _andExpAuxFirstSet = {
-    TokenType::TK_AND
-};
-
-
-SyntaxNodePtr ResilientSyntacticParser::_ParseAndExpAux()
+SyntaxNodePtr ResilientSyntacticParser::_ParseOrExp()
 {
-    if (!_MatchAny(_andExpAuxFirstSet, _Lookahead()))
-    {
-        return _tree->NewEpsilonNode();
-    }
-
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_AND_EXP);
-
-    // '&&'
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    // EqExp
-    auto eqExp = _ParseEqExp();
-    if (!eqExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_EQ_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(eqExp);
-
-    // AndExpAux
-    auto andExpAux = _ParseAndExpAux();
-    if (!andExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_AND_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that andExpAux can be epsilon.
-    if (!andExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(andExpAux);
-    }
-
-    return root;
+    return _ParseBinaryExp(OR_EXP_LEVEL);
 }
 
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseEqExp()
+SyntaxNodePtr ResilientSyntacticParser::_ParseAddExp()
 {
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_EQ_EXP);
-
-    auto relExp = _ParseRelExp();
-    if (!relExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_REL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(relExp);
-
-    auto eqExpAux = _ParseEqExpAux();
-    if (!eqExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_EQ_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that eqExpAux can be epsilon.
-    if (!eqExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(eqExpAux);
-    }
-
-    return root;
+    return _ParseBinaryExp(ADD_EXP_LEVEL);
 }
 
 
-static std::vector<TokenType> _eqExpAuxFirstSet = {
-    TokenType::TK_EQUAL,
-    TokenType::TK_NOT_EQUAL
-};
-
-
-SyntaxNodePtr ResilientSyntacticParser::_ParseEqExpAux()
+/*
+ * Binary expressions are parsed by precedence climbing. Each level parses
+ * operands of the next level, and for each operator, what is parsed so far
+ * becomes the left operand of a new node. So the tree is left-recursive
+ * right away, e.g. a + b - c gives AddExp(AddExp(AddExp(a) + b) - c).
+ */
+SyntaxNodePtr ResilientSyntacticParser::_ParseBinaryExp(int level)
 {
-    if (!_MatchAny(_eqExpAuxFirstSet, _Lookahead()))
-    {
-        return _tree->NewEpsilonNode();
-    }
-
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_EQ_EXP);
-
-    // '==' or '!='
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    // RelExp
-    auto relExp = _ParseRelExp();
-    if (!relExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_REL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(relExp);
-
-    // EqExpAux
-    auto eqExpAux = _ParseEqExpAux();
-    if (!eqExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_EQ_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that eqExpAux can be epsilon.
-    if (!eqExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(eqExpAux);
-    }
+    TOMIC_TRACE("parse", __func__);
 
-    return root;
-}
+    TOMIC_ASSERT(level < BINARY_EXP_LEVEL_COUNT);
 
+    const BinaryExpLevel& current = _binaryExpLevels[level];
+    const bool isLast = (level + 1 == BINARY_EXP_LEVEL_COUNT);
+    const SyntaxType operandType = isLast ? SyntaxType::ST_UNARY_EXP : _binaryExpLevels[level + 1].type;
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseRelExp()
-{
     auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_REL_EXP);
-
-    auto addExp = _ParseAddExp();
-    if (!addExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(addExp);
+    auto root = _tree->NewNonTerminalNode(current.type);
 
-    auto relExpAux = _ParseRelExpAux();
-    if (!relExpAux)
+    auto operand = isLast ? _ParseUnaryExp() : _ParseBinaryExp(level + 1);
+    if (!operand)
     {
-        _LogFailedToParse(SyntaxType::ST_REL_EXP);
+        _LogFailedToParse(operandType);
         _PostParseError(checkpoint, root);
         return nullptr;
     }
-    // Notice that relExpAux can be epsilon.
-    if (!relExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(relExpAux);
-    }
-
-    return root;
-}
-
-
-static std::vector<TokenType> _relExpAuxFirstSet = {
-    TokenType::TK_LESS,
-    TokenType::TK_LESS_EQUAL,
-    TokenType::TK_GREATER,
-    TokenType::TK_GREATER_EQUAL
-};
-
+    root->InsertEndChild(operand);
 
-SyntaxNodePtr ResilientSyntacticParser::_ParseRelExpAux()
-{
-    if (!_MatchAny(_relExpAuxFirstSet, _Lookahead()))
+    while (_MatchAny(current.operators, _Lookahead()))
     {
-        return _tree->NewEpsilonNode();
-    }
-
-    auto checkpoint = _lexicalParser->SetCheckPoint();
-    auto root = _tree->NewNonTerminalNode(SyntaxType::ST_REL_EXP);
+        auto left = root;
+        root = _tree->NewNonTerminalNode(current.type);
+        root->InsertEndChild(left);
 
-    // '<' or '<=' or '>' or '>='
-    // Already checked in _MatchAny().
-    root->InsertEndChild(_tree->NewTerminalNode(_Next()));
-
-    // AddExp
-    auto addExp = _ParseAddExp();
-    if (!addExp)
-    {
-        _LogFailedToParse(SyntaxType::ST_ADD_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    root->InsertEndChild(addExp);
+        // Operator, already checked in _MatchAny().
+        root->InsertEndChild(_tree->NewTerminalNode(_Next()));
 
-    // RelExpAux
-    auto relExpAux = _ParseRelExpAux();
-    if (!relExpAux)
-    {
-        _LogFailedToParse(SyntaxType::ST_REL_EXP);
-        _PostParseError(checkpoint, root);
-        return nullptr;
-    }
-    // Notice that relExpAux can be epsilon.
-    if (!relExpAux->IsEpsilon())
-    {
-        root->InsertEndChild(relExpAux);
+        operand = isLast ? _ParseUnaryExp() : _ParseBinaryExp(level + 1);
+        if (!operand)
+        {
+            _LogFailedToParse(operandType);
+            _PostParseError(checkpoint, root);
+            return nullptr;
+        }
+        root->InsertEndChild(operand);
     }
 
     return root;
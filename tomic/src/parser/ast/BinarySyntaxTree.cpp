@@ -0,0 +1,336 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/parser/ast/BinarySyntaxTree.h>
+#include <tomic/parser/ast/CompactSyntaxTree.h>
+#include <tomic/utils/StringUtil.h>
+#include <tomic/utils/Trace.h>
+
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+TOMIC_BEGIN
+
+/*
+ * ================================ Node ================================
+ */
+
+BinarySyntaxNode BinarySyntaxNode::LastChild() const
+{
+    BinarySyntaxNode last;
+    for (auto child = FirstChild(); child; child = child.NextSibling())
+    {
+        last = child;
+    }
+    return last;
+}
+
+
+bool BinarySyntaxNode::HasAttribute(SyntaxAttribute attr) const
+{
+    const BinaryAstNode& record = _Record();
+    for (uint32_t i = record.typedBegin; i < record.typedBegin + record.typedCount; i++)
+    {
+        if (_tree->_typed[i].attr == static_cast<uint32_t>(attr))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool BinarySyntaxNode::HasAttribute(const char* name) const
+{
+    return Attribute(name) != nullptr;
+}
+
+
+const char* BinarySyntaxNode::Attribute(const char* name, const char* defaultValue) const
+{
+    const BinaryAstNode& record = _Record();
+    for (uint32_t i = record.namedBegin; i < record.namedBegin + record.namedCount; i++)
+    {
+        const auto& attr = _tree->_named[i];
+        if (strcmp(_tree->_strings + attr.name, name) == 0)
+        {
+            return _tree->_strings + attr.value;
+        }
+    }
+    return defaultValue;
+}
+
+
+// Same as SyntaxNode::Attributes.
+std::vector<std::pair<std::string, std::string>> BinarySyntaxNode::Attributes() const
+{
+    const BinaryAstNode& record = _Record();
+    const uint32_t typedEnd = record.typedBegin + record.typedCount;
+    const uint32_t namedEnd = record.namedBegin + record.namedCount;
+
+    std::vector<std::pair<std::string, std::string>> attributes;
+    attributes.reserve(record.typedCount + record.namedCount);
+
+    uint32_t named = record.namedBegin;
+    for (uint32_t i = record.typedBegin; i < typedEnd; i++)
+    {
+        const auto attr = static_cast<SyntaxAttribute>(_tree->_typed[i].attr);
+        const int value = _tree->_typed[i].value;
+        const char* name = SyntaxAttributeName(attr);
+        while ((named < namedEnd) && (strcmp(_tree->_strings + _tree->_named[named].name, name) < 0))
+        {
+            const auto& other = _tree->_named[named++];
+            attributes.emplace_back(_tree->_strings + other.name, _tree->_strings + other.value);
+        }
+        attributes.emplace_back(name, IsBoolSyntaxAttribute(attr)
+                                          ? StringUtil::BoolToString(value != 0)
+                                          : StringUtil::IntToString(value));
+    }
+    while (named < namedEnd)
+    {
+        const auto& attr = _tree->_named[named++];
+        attributes.emplace_back(_tree->_strings + attr.name, _tree->_strings + attr.value);
+    }
+
+    return attributes;
+}
+
+
+/*
+ * ================================ Read ================================
+ */
+
+BinarySyntaxTree::BinarySyntaxTree(twio::IInputStreamPtr stream) : _stream(stream)
+{
+    TOMIC_ASSERT(_stream && _IsValid(_stream->Data(), _stream->Size()));
+
+    const char* data = _stream->Data();
+    _header = reinterpret_cast<const BinaryAstHeader*>(data);
+    _nodes = reinterpret_cast<const BinaryAstNode*>(data + _header->nodes);
+    _tokens = reinterpret_cast<const BinaryAstToken*>(data + _header->tokens);
+    _typed = reinterpret_cast<const BinaryAstTypedAttribute*>(data + _header->typed);
+    _named = reinterpret_cast<const BinaryAstNamedAttribute*>(data + _header->named);
+    _strings = data + _header->strings;
+}
+
+
+std::shared_ptr<BinarySyntaxTree> BinarySyntaxTree::New(twio::IInputStreamPtr stream)
+{
+    if (!stream || !_IsValid(stream->Data(), stream->Size()))
+    {
+        return nullptr;
+    }
+    return std::make_shared<BinarySyntaxTree>(stream);
+}
+
+
+std::shared_ptr<BinarySyntaxTree> BinarySyntaxTree::Load(const char* path)
+{
+    TOMIC_TRACE("ast", "BinarySyntaxTree::Load");
+
+    auto stream = twio::MappedInputStream::New(path);
+    if (!stream->IsReady())
+    {
+        return nullptr;
+    }
+    return New(stream);
+}
+
+
+// A section of count records must be aligned, and lie in the image.
+static bool _IsSection(uint64_t offset, uint64_t count, size_t recordSize, size_t size)
+{
+    return (offset % 8 == 0) && (offset <= size) && (count <= (size - offset) / recordSize);
+}
+
+
+bool BinarySyntaxTree::_IsValid(const char* data, size_t size)
+{
+    if (!data || (reinterpret_cast<uintptr_t>(data) % 8 != 0) || (size < sizeof(BinaryAstHeader)))
+    {
+        return false;
+    }
+
+    const auto header = reinterpret_cast<const BinaryAstHeader*>(data);
+    if ((memcmp(header->magic, BinaryAstHeader::MAGIC, sizeof(header->magic)) != 0) ||
+        (header->version != BinaryAstHeader::VERSION) ||
+        (header->byteOrder != BinaryAstHeader::ENDIAN_MARK))
+    {
+        return false;
+    }
+
+    if (!_IsSection(header->nodes, header->nodeCount, sizeof(BinaryAstNode), size) ||
+        !_IsSection(header->tokens, header->tokenCount, sizeof(BinaryAstToken), size) ||
+        !_IsSection(header->typed, header->typedCount, sizeof(BinaryAstTypedAttribute), size) ||
+        !_IsSection(header->named, header->namedCount, sizeof(BinaryAstNamedAttribute), size) ||
+        !_IsSection(header->strings, header->stringSize, 1, size))
+    {
+        return false;
+    }
+
+    // So that no string runs past the image.
+    return (header->stringSize == 0) || (data[header->strings + header->stringSize - 1] == '\0');
+}
+
+
+/*
+ * ================================ Write ================================
+ */
+
+namespace
+{
+
+// Strings are stored once, and looked up by content. Lexemes are kept by
+// the arena, and attributes by the tree, so views of them are stable.
+class StringTable
+{
+public:
+    uint32_t Add(const char* str, size_t length)
+    {
+        std::string_view view(str, length);
+        auto it = _offsets.find(view);
+        if (it != _offsets.end())
+        {
+            return it->second;
+        }
+
+        TOMIC_ASSERT(_strings.size() + length < UINT32_MAX);
+        auto offset = static_cast<uint32_t>(_strings.size());
+        _strings.append(str, length);
+        _strings.push_back('\0');
+        _offsets.emplace(view, offset);
+
+        return offset;
+    }
+
+
+    uint32_t Add(const std::string& str) { return Add(str.c_str(), str.length()); }
+
+    const std::string& Strings() const { return _strings; }
+
+private:
+    std::string _strings;
+    std::unordered_map<std::string_view, uint32_t> _offsets;
+};
+
+
+template<typename TRecord>
+void _WriteSection(const twio::IWriterPtr& writer, const std::vector<TRecord>& records)
+{
+    if (!records.empty())
+    {
+        writer->Write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(TRecord));
+    }
+}
+
+} // namespace
+
+
+/*
+ * Preorder of CompactSyntaxTree is kept, so children and siblings are
+ * resolved from sub-tree ends, and attributes are copied section by
+ * section. Each section is written as one large block.
+ */
+void BinarySyntaxTree::Write(const CompactSyntaxTree& tree, twio::IWriterPtr writer)
+{
+    TOMIC_TRACE("ast", "BinarySyntaxTree::Write");
+
+    TOMIC_ASSERT(writer);
+    TOMIC_ASSERT(tree.Size() < BinaryAstHeader::NONE);
+
+    const auto size = static_cast<uint32_t>(tree.Size());
+    const TokenArena* arena = tree._tokens.get();
+    StringTable strings;
+
+    std::vector<BinaryAstNode> nodes(size);
+    std::vector<BinaryAstToken> tokens;
+    for (uint32_t id = 0; id < size; id++)
+    {
+        BinaryAstNode& node = nodes[id];
+        const CompactNodeId parent = tree._parents[id];
+        const CompactNodeId end = tree._ends[id];
+
+        node.parent = parent;
+        node.firstChild = (end > id + 1) ? id + 1 : BinaryAstHeader::NONE;
+        node.nextSibling = ((parent != CompactSyntaxTree::NONE) && (end < tree._ends[parent]))
+                               ? end
+                               : BinaryAstHeader::NONE;
+        node.type = static_cast<uint32_t>(tree._types[id]);
+
+        node.typedBegin = tree._typedBegins[id];
+        node.typedCount = static_cast<uint8_t>(tree._typedBegins[id + 1] - tree._typedBegins[id]);
+        node.namedBegin = tree._namedBegins[id];
+        TOMIC_ASSERT(tree._namedBegins[id + 1] - tree._namedBegins[id] <= UINT16_MAX);
+        node.namedCount = static_cast<uint16_t>(tree._namedBegins[id + 1] - tree._namedBegins[id]);
+
+        node.token = BinaryAstHeader::NONE;
+        switch (tree._kinds[id])
+        {
+        case CompactSyntaxTree::NodeKind::NON_TERMINAL:
+            node.kind = BinaryAstNode::NON_TERMINAL;
+            break;
+        case CompactSyntaxTree::NodeKind::TERMINAL:
+        {
+            node.kind = BinaryAstNode::TERMINAL;
+            node.token = static_cast<uint32_t>(tokens.size());
+
+            const uint32_t index = tree._tokenIndices[id];
+            const Token& token = arena->At(index);
+            tokens.push_back({ static_cast<uint32_t>(token.type),
+                               strings.Add(arena->Lexeme(index), token.length),
+                               token.length,
+                               arena->Position(index),
+                               arena->LineNo(index),
+                               arena->CharNo(index) });
+            break;
+        }
+        case CompactSyntaxTree::NodeKind::EPSILON:
+            node.kind = BinaryAstNode::EPSILON;
+            break;
+        }
+    }
+
+    std::vector<BinaryAstTypedAttribute> typed;
+    typed.reserve(tree._typedAttributes.size());
+    for (const auto& attr : tree._typedAttributes)
+    {
+        typed.push_back({ static_cast<uint32_t>(attr.attr), attr.value });
+    }
+
+    std::vector<BinaryAstNamedAttribute> named;
+    named.reserve(tree._namedAttributes.size());
+    for (const auto& attr : tree._namedAttributes)
+    {
+        named.push_back({ strings.Add(attr.first), strings.Add(attr.second) });
+    }
+
+    // All records are multiples of 8 bytes, so sections stay aligned.
+    BinaryAstHeader header{};
+    memcpy(header.magic, BinaryAstHeader::MAGIC, sizeof(header.magic));
+    header.version = BinaryAstHeader::VERSION;
+    header.byteOrder = BinaryAstHeader::ENDIAN_MARK;
+    header.nodeCount = size;
+    header.tokenCount = static_cast<uint32_t>(tokens.size());
+    header.typedCount = static_cast<uint32_t>(typed.size());
+    header.namedCount = static_cast<uint32_t>(named.size());
+    header.stringSize = strings.Strings().size();
+    header.nodes = sizeof(BinaryAstHeader);
+    header.tokens = header.nodes + nodes.size() * sizeof(BinaryAstNode);
+    header.typed = header.tokens + tokens.size() * sizeof(BinaryAstToken);
+    header.named = header.typed + typed.size() * sizeof(BinaryAstTypedAttribute);
+    header.strings = header.named + named.size() * sizeof(BinaryAstNamedAttribute);
+
+    writer->Write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _WriteSection(writer, nodes);
+    _WriteSection(writer, tokens);
+    _WriteSection(writer, typed);
+    _WriteSection(writer, named);
+    writer->Write(strings.Strings().data(), strings.Strings().size());
+}
+
+
+TOMIC_END
@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/parser/ast/CompactAstVisitor.h>
+#include <tomic/parser/ast/CompactSyntaxTree.h>
+#include <tomic/parser/ast/SyntaxNode.h>
+#include <tomic/parser/ast/SyntaxTree.h>
+#include <tomic/utils/StringUtil.h>
+
+#include <algorithm>
+
+TOMIC_BEGIN
+
+/*
+ * ================================ Node ================================
+ */
+
+CompactSyntaxNode CompactSyntaxNode::LastChild() const
+{
+    CompactSyntaxNode last;
+    for (auto child = FirstChild(); child; child = child.NextSibling())
+    {
+        last = child;
+    }
+    return last;
+}
+
+
+bool CompactSyntaxNode::HasAttribute(const char* name) const
+{
+    return Attribute(name) != nullptr;
+}
+
+
+const char* CompactSyntaxNode::Attribute(const char* name, const char* defaultValue) const
+{
+    for (uint32_t i = _tree->_namedBegins[_id]; i < _tree->_namedBegins[_id + 1]; i++)
+    {
+        const auto& attr = _tree->_namedAttributes[i];
+        if (attr.first == name)
+        {
+            return attr.second.c_str();
+        }
+    }
+    return defaultValue;
+}
+
+
+// Same as SyntaxNode::Attributes.
+std::vector<std::pair<std::string, std::string>> CompactSyntaxNode::Attributes() const
+{
+    const uint32_t typedBegin = _tree->_typedBegins[_id];
+    const uint32_t typedEnd = _tree->_typedBegins[_id + 1];
+    const uint32_t namedBegin = _tree->_namedBegins[_id];
+    const uint32_t namedEnd = _tree->_namedBegins[_id + 1];
+
+    std::vector<std::pair<std::string, std::string>> attributes;
+    attributes.reserve(typedEnd - typedBegin + namedEnd - namedBegin);
+
+    uint32_t named = namedBegin;
+    for (uint32_t i = typedBegin; i < typedEnd; i++)
+    {
+        const auto& typed = _tree->_typedAttributes[i];
+        const char* name = SyntaxAttributeName(typed.attr);
+        while ((named < namedEnd) && (_tree->_namedAttributes[named].first < name))
+        {
+            attributes.emplace_back(_tree->_namedAttributes[named++]);
+        }
+        attributes.emplace_back(name, IsBoolSyntaxAttribute(typed.attr)
+                                          ? StringUtil::BoolToString(typed.value != 0)
+                                          : StringUtil::IntToString(typed.value));
+    }
+    while (named < namedEnd)
+    {
+        attributes.emplace_back(_tree->_namedAttributes[named++]);
+    }
+
+    return attributes;
+}
+
+
+/*
+ * ================================ Tree ================================
+ */
+
+CompactSyntaxTree::CompactSyntaxTree(const SyntaxTree& tree) : _tokens(tree.Tokens())
+{
+    _typedBegins.push_back(0);
+    _namedBegins.push_back(0);
+
+    if (!tree.Root())
+    {
+        return;
+    }
+
+    // Children are pushed in reverse, so that they are popped in order.
+    std::vector<std::pair<SyntaxNodePtr, CompactNodeId>> stack;
+    stack.emplace_back(tree.Root(), NONE);
+    while (!stack.empty())
+    {
+        auto [node, parent] = stack.back();
+        stack.pop_back();
+
+        CompactNodeId id = _Append(node, parent);
+        for (auto child = node->LastChild(); child; child = child->PrevSibling())
+        {
+            stack.emplace_back(child, id);
+        }
+    }
+
+    // A parent is always before its children, so a reversed scan sees all
+    // descendants of a node before the node itself.
+    for (CompactNodeId id = static_cast<CompactNodeId>(Size()) - 1; id > 0; id--)
+    {
+        CompactNodeId parent = _parents[id];
+        _ends[parent] = std::max(_ends[parent], _ends[id]);
+    }
+}
+
+
+std::shared_ptr<CompactSyntaxTree> CompactSyntaxTree::New(SyntaxTreePtr tree)
+{
+    TOMIC_ASSERT(tree);
+
+    return std::make_shared<CompactSyntaxTree>(*tree);
+}
+
+
+/*
+ * Equivalent to SyntaxNode::Accept. Non-terminals entered are kept on a
+ * stack until their sub-trees are done, or a visit fails, in which case the
+ * rest of the sub-tree is skipped.
+ */
+bool CompactSyntaxTree::Accept(CompactAstVisitorPtr visitor) const
+{
+    TOMIC_ASSERT(visitor);
+
+    const CompactNodeId size = static_cast<CompactNodeId>(Size());
+    std::vector<CompactNodeId> open;
+    CompactNodeId id = 0;
+    bool result = true;
+
+    while (id < size)
+    {
+        while (!open.empty() && (!result || (id >= _ends[open.back()])))
+        {
+            CompactNodeId top = open.back();
+            open.pop_back();
+            id = _ends[top];
+            result = visitor->VisitExit(Node(top));
+        }
+        if (id >= size)
+        {
+            break;
+        }
+
+        switch (_kinds[id])
+        {
+        case NodeKind::NON_TERMINAL:
+            if (visitor->VisitEnter(Node(id)))
+            {
+                open.push_back(id);
+                result = true;
+                id++;
+            }
+            else
+            {
+                result = visitor->VisitExit(Node(id));
+                id = _ends[id];
+            }
+            break;
+        case NodeKind::TERMINAL:
+            result = visitor->Visit(Node(id));
+            id++;
+            break;
+        case NodeKind::EPSILON:
+            result = true;
+            id++;
+            break;
+        }
+    }
+
+    // The last nodes may close several sub-trees at once.
+    while (!open.empty())
+    {
+        CompactNodeId top = open.back();
+        open.pop_back();
+        result = visitor->VisitExit(Node(top));
+    }
+
+    return result;
+}
+
+
+CompactNodeId CompactSyntaxTree::_Append(SyntaxNodePtr node, CompactNodeId parent)
+{
+    auto id = static_cast<CompactNodeId>(Size());
+
+    _types.push_back(node->Type());
+    _parents.push_back(parent);
+    _ends.push_back(id + 1);
+
+    if (node->IsTerminal())
+    {
+        TOMIC_ASSERT(node->Token() == TokenPtr(_tokens.get(), node->Token().Index()));
+        _kinds.push_back(NodeKind::TERMINAL);
+        _tokenIndices.push_back(node->Token().Index());
+    }
+    else
+    {
+        _kinds.push_back(node->IsEpsilon() ? NodeKind::EPSILON : NodeKind::NON_TERMINAL);
+        _tokenIndices.push_back(NONE);
+    }
+
+    for (int i = 0; i < static_cast<int>(SyntaxAttribute::SA_COUNT); i++)
+    {
+        auto attr = static_cast<SyntaxAttribute>(i);
+        if (node->HasAttribute(attr))
+        {
+            _typedAttributes.push_back({ attr, node->_slots[i] });
+        }
+    }
+    _typedBegins.push_back(static_cast<uint32_t>(_typedAttributes.size()));
+
+    _namedAttributes.insert(_namedAttributes.end(), node->_attributes.begin(), node->_attributes.end());
+    _namedBegins.push_back(static_cast<uint32_t>(_namedAttributes.size()));
+
+    return id;
+}
+
+
+TOMIC_END
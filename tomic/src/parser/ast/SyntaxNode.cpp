@@ -14,7 +14,7 @@ TOMIC_BEGIN
 SyntaxNode::SyntaxNode(SyntaxNodeType nodeType, SyntaxType type)
     : _tree(nullptr), _parent(nullptr),
       _prev(nullptr), _next(nullptr), _firstChild(nullptr), _lastChild(nullptr),
-      _type(type), _nodeType(nodeType)
+      _type(type), _slotMask(0), _nodeType(nodeType)
 {
 }
 
@@ -22,7 +22,7 @@ SyntaxNode::SyntaxNode(SyntaxNodeType nodeType, SyntaxType type)
 SyntaxNode::SyntaxNode(SyntaxNodeType nodeType, SyntaxType type, TokenPtr token)
     : _tree(nullptr), _parent(nullptr), _prev(nullptr),
       _next(nullptr), _firstChild(nullptr), _lastChild(nullptr), _type(type),
-      _token(token), _nodeType(nodeType)
+      _token(token), _slotMask(0), _nodeType(nodeType)
 {
 }
 
@@ -192,48 +192,40 @@ SyntaxNodePtr SyntaxNode::_Unlink(SyntaxNodePtr child)
  * ==================== AST Attributes ====================
  */
 
-bool SyntaxNode::HasAttribute(const char* name) const
+bool SyntaxNode::QueryIntAttribute(SyntaxAttribute attr, int* value, int defaultValue) const
 {
-    return _attributes.find(name) != _attributes.end();
+    const bool found = HasAttribute(attr);
+    if (value)
+    {
+        *value = found ? _slots[static_cast<int>(attr)] : defaultValue;
+    }
+    return found;
 }
 
 
-const char* SyntaxNode::Attribute(const char* name, const char* defaultValue) const
+bool SyntaxNode::QueryBoolAttribute(SyntaxAttribute attr, bool* value, bool defaultValue) const
 {
-    auto it = _attributes.find(name);
-    if (it != _attributes.end())
+    const bool found = HasAttribute(attr);
+    if (value)
     {
-        return it->second.c_str();
+        *value = found ? (_slots[static_cast<int>(attr)] != 0) : defaultValue;
     }
-    return defaultValue;
+    return found;
 }
 
 
-int SyntaxNode::IntAttribute(const char* name, int defaultValue) const
+bool SyntaxNode::HasAttribute(const char* name) const
 {
-    auto it = _attributes.find(name);
-    if (it != _attributes.end())
-    {
-        int value;
-        if (StringUtil::ToInt(it->second.c_str(), &value))
-        {
-            return value;
-        }
-    }
-    return defaultValue;
+    return _attributes.find(name) != _attributes.end();
 }
 
 
-bool SyntaxNode::BoolAttribute(const char* name, bool defaultValue) const
+const char* SyntaxNode::Attribute(const char* name, const char* defaultValue) const
 {
     auto it = _attributes.find(name);
     if (it != _attributes.end())
     {
-        bool value;
-        if (StringUtil::ToBool(it->second.c_str(), &value))
-        {
-            return value;
-        }
+        return it->second.c_str();
     }
     return defaultValue;
 }
@@ -259,56 +251,6 @@ bool SyntaxNode::QueryAttribute(const char* name, const char** value, const char
 }
 
 
-bool SyntaxNode::QueryIntAttribute(const char* name, int* value, int defaultValue) const
-{
-    const char* attr;
-
-    if (QueryAttribute(name, &attr, nullptr))
-    {
-        if (value)
-        {
-            if (!StringUtil::ToInt(attr, value))
-            {
-                *value = defaultValue;
-            }
-        }
-        return true;
-    }
-
-    if (value)
-    {
-        *value = defaultValue;
-    }
-
-    return false;
-}
-
-
-bool SyntaxNode::QueryBoolAttribute(const char* name, bool* value, bool defaultValue) const
-{
-    const char* attr;
-
-    if (QueryAttribute(name, &attr, nullptr))
-    {
-        if (value)
-        {
-            if (!StringUtil::ToBool(attr, value))
-            {
-                *value = defaultValue;
-            }
-        }
-        return true;
-    }
-
-    if (value)
-    {
-        *value = defaultValue;
-    }
-
-    return false;
-}
-
-
 SyntaxNodePtr SyntaxNode::SetAttribute(const char* name, const char* value)
 {
     std::map<std::string, std::string>::iterator it;
@@ -320,18 +262,6 @@ SyntaxNodePtr SyntaxNode::SetAttribute(const char* name, const char* value)
 }
 
 
-SyntaxNodePtr SyntaxNode::SetIntAttribute(const char* name, int value)
-{
-    return SetAttribute(name, StringUtil::IntToString(value));
-}
-
-
-SyntaxNodePtr SyntaxNode::SetBoolAttribute(const char* name, bool value)
-{
-    return SetAttribute(name, StringUtil::BoolToString(value));
-}
-
-
 SyntaxNodePtr SyntaxNode::RemoveAttribute(const char* name)
 {
     std::map<std::string, std::string>::iterator it;
@@ -343,6 +273,42 @@ SyntaxNodePtr SyntaxNode::RemoveAttribute(const char* name)
 }
 
 
+/*
+ * Typed attributes and string ones are both ordered by name, so they are
+ * merged here.
+ */
+std::vector<std::pair<std::string, std::string>> SyntaxNode::Attributes() const
+{
+    std::vector<std::pair<std::string, std::string>> attributes;
+    attributes.reserve(_attributes.size() + static_cast<int>(SyntaxAttribute::SA_COUNT));
+
+    auto it = _attributes.begin();
+    for (int i = 0; i < static_cast<int>(SyntaxAttribute::SA_COUNT); i++)
+    {
+        auto attr = static_cast<SyntaxAttribute>(i);
+        if (!HasAttribute(attr))
+        {
+            continue;
+        }
+        const char* name = SyntaxAttributeName(attr);
+        while ((it != _attributes.end()) && (it->first < name))
+        {
+            attributes.emplace_back(*it++);
+        }
+        const int value = _slots[i];
+        attributes.emplace_back(name, IsBoolSyntaxAttribute(attr)
+                                          ? StringUtil::BoolToString(value != 0)
+                                          : StringUtil::IntToString(value));
+    }
+    while (it != _attributes.end())
+    {
+        attributes.emplace_back(*it++);
+    }
+
+    return attributes;
+}
+
+
 bool SyntaxNode::_FindAttribute(const char* name, std::map<std::string, std::string>::iterator* attr)
 {
     auto it = _attributes.find(name);
@@ -393,22 +359,62 @@ NonTerminalSyntaxNode::NonTerminalSyntaxNode(SyntaxType type)
 }
 
 
+/*
+ * Traverse the sub-tree with an explicit stack of entered nodes, so that
+ * deep trees will not overflow the native stack. It behaves the same as
+ * the recursive one: children are skipped if VisitEnter returns false, and
+ * the rest siblings are skipped if a child returns false. The next sibling
+ * is fetched only after a node is exited, so visitors can still modify the
+ * children of the exited node.
+ */
 bool NonTerminalSyntaxNode::Accept(AstVisitorPtr visitor)
 {
     TOMIC_ASSERT(visitor);
 
-    if (visitor->VisitEnter(this))
+    if (!visitor->VisitEnter(this))
+    {
+        return visitor->VisitExit(this);
+    }
+
+    std::vector<SyntaxNodePtr> stack;
+    stack.push_back(this);
+
+    SyntaxNodePtr next = FirstChild();
+    for (;;)
     {
-        for (auto node = FirstChild(); node; node = node->NextSibling())
+        if (!next)
         {
-            if (!node->Accept(visitor))
+            SyntaxNodePtr node = stack.back();
+            stack.pop_back();
+
+            bool result = visitor->VisitExit(node);
+            if (stack.empty())
             {
-                break;
+                return result;
             }
+            next = result ? node->NextSibling() : nullptr;
+            continue;
         }
-    }
 
-    return visitor->VisitExit(this);
+        SyntaxNodePtr node = next;
+        bool result = true;
+        if (node->IsNonTerminal())
+        {
+            if (visitor->VisitEnter(node))
+            {
+                stack.push_back(node);
+                next = node->FirstChild();
+                continue;
+            }
+            result = visitor->VisitExit(node);
+        }
+        else if (node->IsTerminal())
+        {
+            result = visitor->Visit(node);
+        }
+
+        next = result ? node->NextSibling() : nullptr;
+    }
 }
 
 
@@ -9,9 +9,31 @@
 #include <tomic/Shared.h>
 
 #include <algorithm>
+#include <iterator>
+#include <new>
+#include <vector>
 
 TOMIC_BEGIN
 
+// All kinds of nodes share one slot size, which can also hold a link of
+// the free list.
+static constexpr size_t SLOT_ALIGN = std::max({ alignof(NonTerminalSyntaxNode),
+                                                alignof(TerminalSyntaxNode),
+                                                alignof(EpsilonSyntaxNode),
+                                                alignof(void*) });
+static constexpr size_t SLOT_SIZE = (std::max({ sizeof(NonTerminalSyntaxNode),
+                                                sizeof(TerminalSyntaxNode),
+                                                sizeof(EpsilonSyntaxNode),
+                                                sizeof(void*) }) + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+
+static_assert(SLOT_ALIGN <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Slab is not aligned for nodes");
+
+
+SyntaxTree::SyntaxTree() : _root(nullptr), _owner(this), _free(nullptr)
+{
+}
+
+
 SyntaxTree::~SyntaxTree()
 {
     _ClearUp();
@@ -26,9 +48,8 @@ std::shared_ptr<SyntaxTree> SyntaxTree::New()
 
 SyntaxNodePtr SyntaxTree::NewTerminalNode(TokenPtr token)
 {
-    auto node = new TerminalSyntaxNode(token);
-    node->_tree = this;
-    _nodes.insert(node);
+    auto node = new(_Allocate()) TerminalSyntaxNode(token);
+    node->_tree = _owner;
 
     return node;
 }
@@ -36,9 +57,8 @@ SyntaxNodePtr SyntaxTree::NewTerminalNode(TokenPtr token)
 
 SyntaxNodePtr SyntaxTree::NewNonTerminalNode(SyntaxType type)
 {
-    auto node = new NonTerminalSyntaxNode(type);
-    node->_tree = this;
-    _nodes.insert(node);
+    auto node = new(_Allocate()) NonTerminalSyntaxNode(type);
+    node->_tree = _owner;
 
     return node;
 }
@@ -46,9 +66,8 @@ SyntaxNodePtr SyntaxTree::NewNonTerminalNode(SyntaxType type)
 
 SyntaxNodePtr SyntaxTree::NewEpsilonNode()
 {
-    auto node = new EpsilonSyntaxNode();
-    node->_tree = this;
-    _nodes.insert(node);
+    auto node = new(_Allocate()) EpsilonSyntaxNode();
+    node->_tree = _owner;
 
     return node;
 }
@@ -57,7 +76,7 @@ SyntaxNodePtr SyntaxTree::NewEpsilonNode()
 void SyntaxTree::DeleteNode(SyntaxNodePtr node)
 {
     TOMIC_ASSERT(node);
-    TOMIC_ASSERT(node->_tree == this);
+    TOMIC_ASSERT(node->_tree == _owner);
 
     if (node == _root)
     {
@@ -74,8 +93,7 @@ void SyntaxTree::DeleteNode(SyntaxNodePtr node)
         DeleteNode(node->FirstChild());
     }
 
-    _nodes.erase(node);
-    delete node;
+    _Free(node);
 }
 
 
@@ -92,6 +110,49 @@ SyntaxNodePtr SyntaxTree::SetRoot(SyntaxNodePtr root)
 }
 
 
+SyntaxTree* SyntaxTree::SetTokens(TokenArenaPtr tokens)
+{
+    _tokens = std::move(tokens);
+    return this;
+}
+
+
+std::shared_ptr<SyntaxTree> SyntaxTree::Fork()
+{
+    auto fork = New();
+    fork->_owner = _owner;
+    fork->_tokens = _tokens;
+
+    return fork;
+}
+
+
+/*
+ * Slabs of the fork are put before the last one of this tree, so that this
+ * tree goes on allocating from where it was. The free list of the fork is
+ * usually short, as it only has nodes of failed parses.
+ */
+void SyntaxTree::Join(SyntaxTree& fork)
+{
+    TOMIC_ASSERT(fork._owner == _owner);
+    TOMIC_ASSERT(&fork != this);
+
+    auto last = _slabs.empty() ? _slabs.end() : _slabs.end() - 1;
+    _slabs.insert(last,
+                  std::make_move_iterator(fork._slabs.begin()),
+                  std::make_move_iterator(fork._slabs.end()));
+    fork._slabs.clear();
+
+    while (fork._free)
+    {
+        void* slot = fork._free;
+        fork._free = *static_cast<void**>(slot);
+        *static_cast<void**>(slot) = _free;
+        _free = slot;
+    }
+}
+
+
 bool SyntaxTree::Accept(AstVisitorPtr visitor)
 {
     TOMIC_ASSERT(visitor);
@@ -101,13 +162,62 @@ bool SyntaxTree::Accept(AstVisitorPtr visitor)
 }
 
 
+void* SyntaxTree::_Allocate()
+{
+    if (_free)
+    {
+        void* slot = _free;
+        _free = *static_cast<void**>(slot);
+        return slot;
+    }
+
+    if (_slabs.empty() || (_slabs.back().used == SLAB_SIZE))
+    {
+        _slabs.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[SLAB_SIZE * SLOT_SIZE]), 0 });
+    }
+
+    Slab& slab = _slabs.back();
+    return slab.storage.get() + SLOT_SIZE * slab.used++;
+}
+
+
+void SyntaxTree::_Free(SyntaxNodePtr node)
+{
+    node->~SyntaxNode();
+
+    void* slot = node;
+    *static_cast<void**>(slot) = _free;
+    _free = slot;
+}
+
+
+/*
+ * Nodes still have to be destructed for their attributes, but their memory
+ * is released slab by slab. Slots in the free list are already destructed.
+ */
 void SyntaxTree::_ClearUp()
 {
-    for (auto it = _nodes.begin(); it != _nodes.end(); it++)
+    std::vector<void*> freed;
+    for (void* slot = _free; slot; slot = *static_cast<void**>(slot))
     {
-        delete *it;
+        freed.push_back(slot);
     }
-    _nodes.clear();
+    std::sort(freed.begin(), freed.end());
+
+    for (const auto& slab : _slabs)
+    {
+        for (size_t j = 0; j < slab.used; j++)
+        {
+            void* slot = slab.storage.get() + SLOT_SIZE * j;
+            if (!std::binary_search(freed.begin(), freed.end(), slot))
+            {
+                static_cast<SyntaxNodePtr>(slot)->~SyntaxNode();
+            }
+        }
+    }
+
+    _slabs.clear();
+    _free = nullptr;
     _root = nullptr;
 }
 
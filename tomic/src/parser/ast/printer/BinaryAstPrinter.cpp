@@ -0,0 +1,38 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/parser/ast/printer/BinaryAstPrinter.h>
+#include <tomic/parser/ast/BinarySyntaxTree.h>
+#include <tomic/parser/ast/CompactSyntaxTree.h>
+#include <tomic/parser/ast/SyntaxTree.h>
+#include <tomic/utils/Trace.h>
+
+TOMIC_BEGIN
+
+void BinaryAstPrinter::Print(SyntaxTreePtr tree, twio::IWriterPtr writer)
+{
+    TOMIC_TRACE("print", "BinaryAstPrinter::Print");
+
+    TOMIC_ASSERT(tree);
+    TOMIC_ASSERT(writer);
+
+    // The image is laid out in preorder, same as the compact tree.
+    BinarySyntaxTree::Write(CompactSyntaxTree(*tree), writer);
+}
+
+
+void BinaryAstPrinter::Print(CompactSyntaxTreePtr tree, twio::IWriterPtr writer)
+{
+    TOMIC_TRACE("print", "BinaryAstPrinter::PrintCompact");
+
+    TOMIC_ASSERT(tree);
+    TOMIC_ASSERT(writer);
+
+    BinarySyntaxTree::Write(*tree, writer);
+}
+
+
+TOMIC_END
@@ -5,11 +5,18 @@
  */
 
 #include <tomic/parser/ast/printer/JsonAstPrinter.h>
+#include <tomic/parser/ast/CompactSyntaxTree.h>
 #include <tomic/parser/ast/SyntaxNode.h>
 #include <tomic/parser/ast/SyntaxTree.h>
+#include <tomic/utils/Trace.h>
+
+#include <cstring>
 
 TOMIC_BEGIN
 
+static const EscapeTable JSON_ESCAPES{ { '\"', "\\\"" } };
+
+
 JsonAstPrinter::JsonAstPrinter(ISyntaxMapperPtr syntaxMapperPtr, ITokenMapperPtr tokenMapper)
     : _syntaxMapper(syntaxMapperPtr), _tokenMapper(tokenMapper), _depth(0), _indent(2)
 {
@@ -20,19 +27,78 @@ JsonAstPrinter::JsonAstPrinter(ISyntaxMapperPtr syntaxMapperPtr, ITokenMapperPtr
 
 void JsonAstPrinter::Print(SyntaxTreePtr tree, twio::IWriterPtr writer)
 {
+    TOMIC_TRACE("print", "JsonAstPrinter::Print");
+
     TOMIC_ASSERT(tree);
     TOMIC_ASSERT(writer);
 
-    _writer = writer;
+    _out.Open(writer);
 
     // In Json, one level has two indents.
     _depth = -2;
 
     tree->Accept(this);
+
+    _out.Close();
+}
+
+
+void JsonAstPrinter::Print(CompactSyntaxTreePtr tree, twio::IWriterPtr writer)
+{
+    TOMIC_TRACE("print", "JsonAstPrinter::PrintCompact");
+
+    TOMIC_ASSERT(tree);
+    TOMIC_ASSERT(writer);
+
+    _out.Open(writer);
+
+    // In Json, one level has two indents.
+    _depth = -2;
+
+    tree->Accept(this);
+
+    _out.Close();
 }
 
 
 bool JsonAstPrinter::VisitEnter(SyntaxNodePtr node)
+{
+    return _VisitEnter(node);
+}
+
+
+bool JsonAstPrinter::VisitEnter(CompactSyntaxNode node)
+{
+    return _VisitEnter(node);
+}
+
+
+bool JsonAstPrinter::VisitExit(SyntaxNodePtr node)
+{
+    return _VisitExit(node);
+}
+
+
+bool JsonAstPrinter::VisitExit(CompactSyntaxNode node)
+{
+    return _VisitExit(node);
+}
+
+
+bool JsonAstPrinter::Visit(SyntaxNodePtr node)
+{
+    return _Visit(node);
+}
+
+
+bool JsonAstPrinter::Visit(CompactSyntaxNode node)
+{
+    return _Visit(node);
+}
+
+
+template<typename TNode>
+bool JsonAstPrinter::_VisitEnter(TNode node)
 {
     TOMIC_ASSERT(node);
 
@@ -44,36 +110,30 @@ bool JsonAstPrinter::VisitEnter(SyntaxNodePtr node)
 
     // name
     _PrintIndent(_depth + 1);
-    if (descr)
-    {
-        _writer->WriteFormat("\"name\": \"%s\",\n", descr);
-    }
-    else
-    {
-        _writer->WriteFormat("\"name\": \"MISSING-%d\"\n", _depth);
-    }
+    _PrintField("name", descr, descr ? ",\n" : "\n");
 
     // children
     _PrintIndent(_depth + 1);
     if (node->HasChildren())
     {
-        _writer->Write("\"children\": [\n");
+        _out.Append("\"children\": [\n");
     }
     else
     {
-        _writer->Write("\"children\": []\n");
+        _out.Append("\"children\": []\n");
     }
 
     return true;
 }
 
 
-bool JsonAstPrinter::VisitExit(SyntaxNodePtr node)
+template<typename TNode>
+bool JsonAstPrinter::_VisitExit(TNode node)
 {
     if (node->HasChildren())
     {
         _PrintIndent(_depth + 1);
-        _writer->Write("]\n");
+        _out.Append("]\n", 2);
     }
 
     _PrintClosing(_depth, node);
@@ -84,7 +144,8 @@ bool JsonAstPrinter::VisitExit(SyntaxNodePtr node)
 }
 
 
-bool JsonAstPrinter::Visit(SyntaxNodePtr node)
+template<typename TNode>
+bool JsonAstPrinter::_Visit(TNode node)
 {
     TOMIC_ASSERT(node);
 
@@ -109,7 +170,8 @@ bool JsonAstPrinter::Visit(SyntaxNodePtr node)
 }
 
 
-void JsonAstPrinter::_VisitNonTerminal(SyntaxNodePtr node)
+template<typename TNode>
+void JsonAstPrinter::_VisitNonTerminal(TNode node)
 {
     TOMIC_ASSERT(node);
     TOMIC_ASSERT(node->IsNonTerminal());
@@ -121,21 +183,15 @@ void JsonAstPrinter::_VisitNonTerminal(SyntaxNodePtr node)
 
     // name
     _PrintIndent(_depth + 1);
-    if (descr)
-    {
-        _writer->WriteFormat("\"name\": \"%s\"\n", descr);
-    }
-    else
-    {
-        _writer->WriteFormat("\"name\": \"MISSING-%d\"\n", _depth);
-    }
+    _PrintField("name", descr, "\n");
 
     // Closing.
     _PrintClosing(_depth, node);
 }
 
 
-void JsonAstPrinter::_VisitTerminal(SyntaxNodePtr node)
+template<typename TNode>
+void JsonAstPrinter::_VisitTerminal(TNode node)
 {
     TOMIC_ASSERT(node);
     TOMIC_ASSERT(node->IsTerminal());
@@ -146,51 +202,28 @@ void JsonAstPrinter::_VisitTerminal(SyntaxNodePtr node)
     // name
     auto syntacticDescr = _syntaxMapper->Description(node->Type());
     _PrintIndent(_depth + 1);
-    if (syntacticDescr)
-    {
-        _writer->WriteFormat("\"name\": \"%s\",\n", syntacticDescr);
-    }
-    else
-    {
-        _writer->WriteFormat("\"name\": \"MISSING-%d\",\n", _depth);
-    }
+    _PrintField("name", syntacticDescr, ",\n");
 
     // token
     auto token = node->Token();
     auto tokenDescr = _tokenMapper->Description(token->type);
     _PrintIndent(_depth + 1);
-    if (tokenDescr)
-    {
-        _writer->WriteFormat("\"token\": \"%s\",\n", tokenDescr);
-    }
-    else
-    {
-        _writer->WriteFormat("\"token\": \"MISSING-%d\",\n", _depth);
-    }
+    _PrintField("token", tokenDescr, ",\n");
 
     // lexeme
     _PrintIndent(_depth + 1);
-    const char* lexeme = token->lexeme.c_str();
-    _writer->Write("\"lexeme\": \"");
-    for (const char* p = lexeme; *p; p++)
-    {
-        if (*p == '\"')
-        {
-            _writer->Write("\\\"");
-        }
-        else
-        {
-            _writer->WriteFormat("%c", *p);
-        }
-    }
-    _writer->Write("\"\n");
+    const char* lexeme = token.Lexeme();
+    _out.Append("\"lexeme\": \"");
+    _out.AppendEscaped(lexeme, strlen(lexeme), JSON_ESCAPES);
+    _out.Append("\"\n", 2);
 
     // Closing
     _PrintClosing(_depth, node);
 }
 
 
-void JsonAstPrinter::_VisitEpsilon(SyntaxNodePtr node)
+template<typename TNode>
+void JsonAstPrinter::_VisitEpsilon(TNode node)
 {
     TOMIC_ASSERT(node);
     TOMIC_ASSERT(node->IsEpsilon());
@@ -200,14 +233,7 @@ void JsonAstPrinter::_VisitEpsilon(SyntaxNodePtr node)
 
     // name
     auto descr = _syntaxMapper->Description(node->Type());
-    if (descr)
-    {
-        _writer->WriteFormat("\"name\": \"%s\"\n", descr);
-    }
-    else
-    {
-        _writer->WriteFormat("\"name\": \"MISSING-%d\"\n", _depth);
-    }
+    _PrintField("name", descr, "\n");
 
     // Closing
     _PrintClosing(_depth, node);
@@ -216,30 +242,48 @@ void JsonAstPrinter::_VisitEpsilon(SyntaxNodePtr node)
 
 void JsonAstPrinter::_PrintIndent(int depth)
 {
-    for (int i = 0; i < depth * _indent; i++)
+    _out.AppendRepeat(' ', depth * _indent);
+}
+
+
+// Missing values are named after the depth.
+void JsonAstPrinter::_PrintField(const char* name, const char* value, const char* suffix)
+{
+    _out.Append('\"');
+    _out.Append(name);
+    _out.Append("\": \"", 4);
+    if (value)
+    {
+        _out.Append(value);
+    }
+    else
     {
-        _writer->Write(" ");
+        _out.Append("MISSING-", 8);
+        _out.AppendInt(_depth);
     }
+    _out.Append('\"');
+    _out.Append(suffix);
 }
 
 
-void JsonAstPrinter::_PrintOpening(int depth, SyntaxNodePtr node)
+template<typename TNode>
+void JsonAstPrinter::_PrintOpening(int depth, TNode node)
 {
     _PrintIndent(depth);
-    _writer->Write("{\n");
+    _out.Append("{\n", 2);
 }
 
 
-void JsonAstPrinter::_PrintClosing(int depth, SyntaxNodePtr node)
+template<typename TNode>
+void JsonAstPrinter::_PrintClosing(int depth, TNode node)
 {
     _PrintIndent(depth);
-    _writer->Write("}");
-    auto parent = node->Parent();
-    if (parent && node != parent->LastChild())
+    _out.Append('}');
+    if (node->NextSibling())
     {
-        _writer->Write(",");
+        _out.Append(',');
     }
-    _writer->Write("\n");
+    _out.Append('\n');
 }
 
 
@@ -5,8 +5,10 @@
  */
 
 #include <tomic/parser/ast/printer/StandardAstPrinter.h>
+#include <tomic/parser/ast/CompactSyntaxTree.h>
 #include <tomic/parser/ast/SyntaxNode.h>
 #include <tomic/parser/ast/SyntaxTree.h>
+#include <tomic/utils/Trace.h>
 
 TOMIC_BEGIN
 
@@ -20,6 +22,21 @@ StandardAstPrinter::StandardAstPrinter(ISyntaxMapperPtr syntaxMapperPtr, ITokenM
 
 void StandardAstPrinter::Print(SyntaxTreePtr tree, twio::IWriterPtr writer)
 {
+    TOMIC_TRACE("print", "StandardAstPrinter::Print");
+
+    TOMIC_ASSERT(tree);
+    TOMIC_ASSERT(writer);
+
+    _writer = writer;
+
+    tree->Accept(this);
+}
+
+
+void StandardAstPrinter::Print(CompactSyntaxTreePtr tree, twio::IWriterPtr writer)
+{
+    TOMIC_TRACE("print", "StandardAstPrinter::PrintCompact");
+
     TOMIC_ASSERT(tree);
     TOMIC_ASSERT(writer);
 
@@ -30,13 +47,51 @@ void StandardAstPrinter::Print(SyntaxTreePtr tree, twio::IWriterPtr writer)
 
 
 bool StandardAstPrinter::VisitEnter(SyntaxNodePtr node)
+{
+    return _VisitEnter(node);
+}
+
+
+bool StandardAstPrinter::VisitEnter(CompactSyntaxNode node)
+{
+    return _VisitEnter(node);
+}
+
+
+bool StandardAstPrinter::VisitExit(SyntaxNodePtr node)
+{
+    return _VisitExit(node);
+}
+
+
+bool StandardAstPrinter::VisitExit(CompactSyntaxNode node)
+{
+    return _VisitExit(node);
+}
+
+
+bool StandardAstPrinter::Visit(SyntaxNodePtr node)
+{
+    return _Visit(node);
+}
+
+
+bool StandardAstPrinter::Visit(CompactSyntaxNode node)
+{
+    return _Visit(node);
+}
+
+
+template<typename TNode>
+bool StandardAstPrinter::_VisitEnter(TNode node)
 {
     TOMIC_ASSERT(node);
     return true;
 }
 
 
-bool StandardAstPrinter::VisitExit(SyntaxNodePtr node)
+template<typename TNode>
+bool StandardAstPrinter::_VisitExit(TNode node)
 {
     if (node->IsNonTerminal())
     {
@@ -47,7 +102,8 @@ bool StandardAstPrinter::VisitExit(SyntaxNodePtr node)
 }
 
 
-bool StandardAstPrinter::Visit(SyntaxNodePtr node)
+template<typename TNode>
+bool StandardAstPrinter::_Visit(TNode node)
 {
     TOMIC_ASSERT(node);
 
@@ -60,7 +116,8 @@ bool StandardAstPrinter::Visit(SyntaxNodePtr node)
 }
 
 
-void StandardAstPrinter::_VisitNonTerminal(SyntaxNodePtr node)
+template<typename TNode>
+void StandardAstPrinter::_VisitNonTerminal(TNode node)
 {
     TOMIC_ASSERT(node);
     TOMIC_ASSERT(node->IsNonTerminal());
@@ -73,7 +130,8 @@ void StandardAstPrinter::_VisitNonTerminal(SyntaxNodePtr node)
 }
 
 
-void StandardAstPrinter::_VisitTerminal(SyntaxNodePtr node)
+template<typename TNode>
+void StandardAstPrinter::_VisitTerminal(TNode node)
 {
     TOMIC_ASSERT(node);
     TOMIC_ASSERT(node->IsTerminal());
@@ -84,12 +142,13 @@ void StandardAstPrinter::_VisitTerminal(SyntaxNodePtr node)
 
     _writer->WriteFormat("%s", descr);
     _writer->Write(" ");
-    _writer->Write(token->lexeme.c_str());
+    _writer->Write(token.Lexeme());
     _writer->Write("\n");
 }
 
 
-void StandardAstPrinter::_VisitEpsilon(SyntaxNodePtr node)
+template<typename TNode>
+void StandardAstPrinter::_VisitEpsilon(TNode node)
 {
 }
 
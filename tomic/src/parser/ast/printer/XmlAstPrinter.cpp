@@ -5,11 +5,18 @@
  */
 
 #include <tomic/parser/ast/printer/XmlAstPrinter.h>
+#include <tomic/parser/ast/CompactSyntaxTree.h>
 #include <tomic/parser/ast/SyntaxNode.h>
 #include <tomic/parser/ast/SyntaxTree.h>
+#include <tomic/utils/Trace.h>
+
+#include <cstring>
 
 TOMIC_BEGIN
 
+static const EscapeTable XML_ESCAPES{ { '&', "&amp;" }, { '<', "&lt;" }, { '>', "&gt;" }, { '\n', "\\n" } };
+
+
 XmlAstPrinter::XmlAstPrinter(ISyntaxMapperPtr syntaxMapperPtr, ITokenMapperPtr tokenMapper)
     : _syntaxMapper(syntaxMapperPtr), _tokenMapper(tokenMapper), _depth(0), _indent(2)
 {
@@ -20,19 +27,78 @@ XmlAstPrinter::XmlAstPrinter(ISyntaxMapperPtr syntaxMapperPtr, ITokenMapperPtr t
 
 void XmlAstPrinter::Print(SyntaxTreePtr tree, twio::IWriterPtr writer)
 {
+    TOMIC_TRACE("print", "XmlAstPrinter::Print");
+
     TOMIC_ASSERT(tree);
     TOMIC_ASSERT(writer);
 
-    _writer = writer;
+    _out.Open(writer);
 
     // To make first element with depth 0, we set depth to -1.
     _depth = -1;
 
     tree->Accept(this);
+
+    _out.Close();
+}
+
+
+void XmlAstPrinter::Print(CompactSyntaxTreePtr tree, twio::IWriterPtr writer)
+{
+    TOMIC_TRACE("print", "XmlAstPrinter::PrintCompact");
+
+    TOMIC_ASSERT(tree);
+    TOMIC_ASSERT(writer);
+
+    _out.Open(writer);
+
+    // To make first element with depth 0, we set depth to -1.
+    _depth = -1;
+
+    tree->Accept(this);
+
+    _out.Close();
 }
 
 
 bool XmlAstPrinter::VisitEnter(SyntaxNodePtr node)
+{
+    return _VisitEnter(node);
+}
+
+
+bool XmlAstPrinter::VisitEnter(CompactSyntaxNode node)
+{
+    return _VisitEnter(node);
+}
+
+
+bool XmlAstPrinter::VisitExit(SyntaxNodePtr node)
+{
+    return _VisitExit(node);
+}
+
+
+bool XmlAstPrinter::VisitExit(CompactSyntaxNode node)
+{
+    return _VisitExit(node);
+}
+
+
+bool XmlAstPrinter::Visit(SyntaxNodePtr node)
+{
+    return _Visit(node);
+}
+
+
+bool XmlAstPrinter::Visit(CompactSyntaxNode node)
+{
+    return _Visit(node);
+}
+
+
+template<typename TNode>
+bool XmlAstPrinter::_VisitEnter(TNode node)
 {
     TOMIC_ASSERT(node);
 
@@ -42,26 +108,27 @@ bool XmlAstPrinter::VisitEnter(SyntaxNodePtr node)
     {
         _depth++;
         _PrintIndent(_depth);
-        _writer->WriteFormat("<%s", descr);
-        for (auto attr : node->Attributes())
-        {
-            _writer->WriteFormat(" %s=\'%s\'", attr.first.c_str(), attr.second.c_str());
-        }
-        _writer->Write(">\n");
+        _out.Append('<');
+        _out.Append(descr);
+        _PrintAttributes(node);
+        _out.Append(">\n", 2);
     }
 
     return true;
 }
 
 
-bool XmlAstPrinter::VisitExit(SyntaxNodePtr node)
+template<typename TNode>
+bool XmlAstPrinter::_VisitExit(TNode node)
 {
     auto descr = _syntaxMapper->Description(node->Type());
 
     if (descr)
     {
         _PrintIndent(_depth);
-        _writer->WriteFormat("</%s>\n", descr);
+        _out.Append("</", 2);
+        _out.Append(descr);
+        _out.Append(">\n", 2);
         _depth--;
     }
 
@@ -69,7 +136,8 @@ bool XmlAstPrinter::VisitExit(SyntaxNodePtr node)
 }
 
 
-bool XmlAstPrinter::Visit(SyntaxNodePtr node)
+template<typename TNode>
+bool XmlAstPrinter::_Visit(TNode node)
 {
     TOMIC_ASSERT(node);
 
@@ -98,26 +166,26 @@ bool XmlAstPrinter::Visit(SyntaxNodePtr node)
 }
 
 
-void XmlAstPrinter::_VisitNonTerminal(SyntaxNodePtr node)
+template<typename TNode>
+void XmlAstPrinter::_VisitNonTerminal(TNode node)
 {
     auto descr = _syntaxMapper->Description(node->Type());
 
     if (descr)
     {
         _PrintIndent(_depth);
-        _writer->WriteFormat("<%s", descr);
-        for (auto attr : node->Attributes())
-        {
-            _writer->WriteFormat(" %s=\'%s\'", attr.first.c_str(), attr.second.c_str());
-        }
-        _writer->Write(" />\n");
+        _out.Append('<');
+        _out.Append(descr);
+        _PrintAttributes(node);
+        _out.Append(" />\n", 4);
     }
 
     // Visit will not recurse into children.
 }
 
 
-void XmlAstPrinter::_VisitTerminal(SyntaxNodePtr node)
+template<typename TNode>
+void XmlAstPrinter::_VisitTerminal(TNode node)
 {
     auto syntacticDescr = _syntaxMapper->Description(node->Type());
 
@@ -127,65 +195,63 @@ void XmlAstPrinter::_VisitTerminal(SyntaxNodePtr node)
     }
 
     _PrintIndent(_depth);
-    _writer->WriteFormat("<%s", syntacticDescr);
+    _out.Append('<');
+    _out.Append(syntacticDescr);
 
     const char* tokenDescr = _tokenMapper->Description(node->Token()->type);
-    _writer->WriteFormat(" token=\'%s\'", tokenDescr ? tokenDescr : "\'\'");
-    const char* lexeme = node->Token()->lexeme.c_str();
-    _writer->Write(" lexeme=\'");
-    for (const char* p = lexeme; *p; p++)
-    {
-        switch (*p)
-        {
-        case '&':
-            _writer->Write("&amp;");
-            break;
-        case '<':
-            _writer->Write("&lt;");
-            break;
-        case '>':
-            _writer->Write("&gt;");
-            break;
-        case '\n':
-            _writer->Write("\\n");
-            break;
-        default:
-            _writer->WriteFormat("%c", *p);
-            break;
-        }
-    }
-    _writer->Write("\'");
+    _out.Append(" token=\'", 8);
+    _out.Append(tokenDescr ? tokenDescr : "\'\'");
+    _out.Append('\'');
 
-    _writer->WriteFormat(" line=\'%d\'", node->Token()->lineNo);
-    _writer->WriteFormat(" char=\'%d\'", node->Token()->charNo);
+    const char* lexeme = node->Token().Lexeme();
+    _out.Append(" lexeme=\'", 9);
+    _out.AppendEscaped(lexeme, strlen(lexeme), XML_ESCAPES);
+    _out.Append('\'');
 
-    for (auto attr : node->Attributes())
-    {
-        _writer->WriteFormat(" %s=\'%s\'", attr.first.c_str(), attr.second.c_str());
-    }
+    _out.Append(" line=\'", 7);
+    _out.AppendInt(node->Token().LineNo());
+    _out.Append("\' char=\'", 8);
+    _out.AppendInt(node->Token().CharNo());
+    _out.Append('\'');
 
-    _writer->Write(" />\n");
+    _PrintAttributes(node);
+
+    _out.Append(" />\n", 4);
 }
 
 
-void XmlAstPrinter::_VisitEpsilon(SyntaxNodePtr node)
+template<typename TNode>
+void XmlAstPrinter::_VisitEpsilon(TNode node)
 {
     auto descr = _syntaxMapper->Description(node->Type());
     if (descr)
     {
         _PrintIndent(_depth);
-        _writer->WriteFormat("<%s>\n", descr);
+        _out.Append('<');
+        _out.Append(descr);
+        _out.Append(">\n", 2);
     }
 }
 
 
-void XmlAstPrinter::_PrintIndent(int depth)
+template<typename TNode>
+void XmlAstPrinter::_PrintAttributes(TNode node)
 {
-    for (int i = 0; i < depth * _indent; i++)
+    for (const auto& attr : node->Attributes())
     {
-        _writer->Write(" ");
+        _out.Append(' ');
+        _out.Append(attr.first);
+        _out.Append("=\'", 2);
+        _out.Append(attr.second);
+        _out.Append('\'');
     }
 }
 
 
+void XmlAstPrinter::_PrintIndent(int depth)
+{
+    _out.AppendRepeat(' ', depth * _indent);
+}
+
+
 TOMIC_END
@@ -0,0 +1,440 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/parser/grammar/Grammar.h>
+
+#include <initializer_list>
+
+TOMIC_BEGIN
+
+/*
+ * ==================== Symbols ====================
+ */
+
+/*
+ * Repetitions and optional parts of the grammar are written as right
+ * recursive auxiliary non-terminals, which only exist here.
+ */
+enum GrammarAux
+{
+    GA_DECL_LIST = static_cast<int>(SyntaxType::ST_COUNT),
+    GA_FUNC_DEF_LIST,
+    GA_CONST_DEF_LIST,
+    GA_VAR_DEF_LIST,
+    GA_CONST_DIMS,
+    GA_CONST_INIT_VALS,
+    GA_CONST_INIT_VAL_LIST,
+    GA_VAR_INIT,
+    GA_INIT_VALS,
+    GA_INIT_VAL_LIST,
+    GA_FUNC_FPARAMS_OPT,
+    GA_FUNC_FPARAM_LIST,
+    GA_FUNC_FPARAM_DIMS,
+    GA_FUNC_FPARAM_DIM,
+    GA_FUNC_APARAMS_OPT,
+    GA_FUNC_APARAM_LIST,
+    GA_BLOCK_ITEMS,
+    GA_EXP_DIMS,
+    GA_ELSE_OPT,
+    GA_FOR_INIT_STMT_OPT,
+    GA_COND_OPT,
+    GA_FOR_STEP_STMT_OPT,
+    GA_EXP_OPT,
+    GA_OUT_ARGS,
+
+    GA_END
+};
+
+
+static constexpr int _NON_TERMINAL_COUNT = GA_END;
+
+// Symbols in productions, terminals are [0, TOKEN_TYPE_COUNT), and the
+// rest are non-terminals.
+#define T(NAME) (static_cast<int>(TokenType::TK_##NAME))
+#define N(NAME) (TOKEN_TYPE_COUNT + static_cast<int>(SyntaxType::ST_##NAME))
+#define A(NAME) (TOKEN_TYPE_COUNT + GA_##NAME)
+
+static constexpr int _MAX_RHS_LENGTH = 9;
+
+
+struct Production
+{
+    int lhs;
+    int rhs[_MAX_RHS_LENGTH];
+    int length;
+
+    constexpr Production(int lhs, std::initializer_list<int> rhs) : lhs(lhs), rhs(), length(0)
+    {
+        for (int symbol : rhs)
+        {
+            this->rhs[length++] = symbol;
+        }
+    }
+};
+
+
+/*
+ * ==================== Productions ====================
+ */
+
+static constexpr Production _PRODUCTIONS[] = {
+    // CompUnit -> { Decl } { FuncDef } MainFuncDef
+    { N(COMP_UNIT), { A(DECL_LIST), A(FUNC_DEF_LIST), N(MAIN_FUNC_DEF) } },
+    { A(DECL_LIST), { N(DECL), A(DECL_LIST) } },
+    { A(DECL_LIST), {} },
+    { A(FUNC_DEF_LIST), { N(FUNC_DEF), A(FUNC_DEF_LIST) } },
+    { A(FUNC_DEF_LIST), {} },
+
+    // Decl -> ConstDecl | VarDecl
+    { N(DECL), { N(CONST_DECL) } },
+    { N(DECL), { N(VAR_DECL) } },
+    { N(BTYPE), { T(INT) } },
+
+    // ConstDecl -> 'const' BType ConstDef { ',' ConstDef } ';'
+    { N(CONST_DECL), { T(CONST), N(BTYPE), N(CONST_DEF), A(CONST_DEF_LIST), T(SEMICOLON) } },
+    { A(CONST_DEF_LIST), { T(COMMA), N(CONST_DEF), A(CONST_DEF_LIST) } },
+    { A(CONST_DEF_LIST), {} },
+
+    // ConstDef -> Ident { '[' ConstExp ']' } '=' ConstInitVal
+    { N(CONST_DEF), { T(IDENTIFIER), A(CONST_DIMS), T(ASSIGN), N(CONST_INIT_VAL) } },
+    { A(CONST_DIMS), { T(LEFT_BRACKET), N(CONST_EXP), T(RIGHT_BRACKET), A(CONST_DIMS) } },
+    { A(CONST_DIMS), {} },
+
+    // ConstInitVal -> ConstExp | '{' [ ConstInitVal { ',' ConstInitVal } ] '}'
+    { N(CONST_INIT_VAL), { N(CONST_EXP) } },
+    { N(CONST_INIT_VAL), { T(LEFT_BRACE), A(CONST_INIT_VALS), T(RIGHT_BRACE) } },
+    { A(CONST_INIT_VALS), { N(CONST_INIT_VAL), A(CONST_INIT_VAL_LIST) } },
+    { A(CONST_INIT_VALS), {} },
+    { A(CONST_INIT_VAL_LIST), { T(COMMA), N(CONST_INIT_VAL), A(CONST_INIT_VAL_LIST) } },
+    { A(CONST_INIT_VAL_LIST), {} },
+
+    // VarDecl -> BType VarDef { ',' VarDef } ';'
+    { N(VAR_DECL), { N(BTYPE), N(VAR_DEF), A(VAR_DEF_LIST), T(SEMICOLON) } },
+    { A(VAR_DEF_LIST), { T(COMMA), N(VAR_DEF), A(VAR_DEF_LIST) } },
+    { A(VAR_DEF_LIST), {} },
+
+    // VarDef -> Ident { '[' ConstExp ']' } [ '=' InitVal ]
+    { N(VAR_DEF), { T(IDENTIFIER), A(CONST_DIMS), A(VAR_INIT) } },
+    { A(VAR_INIT), { T(ASSIGN), N(INIT_VAL) } },
+    { A(VAR_INIT), {} },
+
+    // InitVal -> Exp | '{' [ InitVal { ',' InitVal } ] '}'
+    { N(INIT_VAL), { N(EXP) } },
+    { N(INIT_VAL), { T(LEFT_BRACE), A(INIT_VALS), T(RIGHT_BRACE) } },
+    { A(INIT_VALS), { N(INIT_VAL), A(INIT_VAL_LIST) } },
+    { A(INIT_VALS), {} },
+    { A(INIT_VAL_LIST), { T(COMMA), N(INIT_VAL), A(INIT_VAL_LIST) } },
+    { A(INIT_VAL_LIST), {} },
+
+    // FuncDef -> FuncType Ident '(' [ FuncFParams ] ')' Block
+    { N(FUNC_DEF), { N(FUNC_TYPE), T(IDENTIFIER), T(LEFT_PARENTHESIS), A(FUNC_FPARAMS_OPT),
+                     T(RIGHT_PARENTHESIS), N(BLOCK) } },
+    { A(FUNC_FPARAMS_OPT), { N(FUNC_FPARAMS) } },
+    { A(FUNC_FPARAMS_OPT), {} },
+    { N(FUNC_TYPE), { T(VOID) } },
+    { N(FUNC_TYPE), { T(INT) } },
+
+    // FuncFParams -> FuncFParam { ',' FuncFParam }
+    { N(FUNC_FPARAMS), { N(FUNC_FPARAM), A(FUNC_FPARAM_LIST) } },
+    { A(FUNC_FPARAM_LIST), { T(COMMA), N(FUNC_FPARAM), A(FUNC_FPARAM_LIST) } },
+    { A(FUNC_FPARAM_LIST), {} },
+
+    // FuncFParam -> BType Ident [ '[' ']' [ '[' ConstExp ']' ] ]
+    { N(FUNC_FPARAM), { N(BTYPE), T(IDENTIFIER), A(FUNC_FPARAM_DIMS) } },
+    { A(FUNC_FPARAM_DIMS), { T(LEFT_BRACKET), T(RIGHT_BRACKET), A(FUNC_FPARAM_DIM) } },
+    { A(FUNC_FPARAM_DIMS), {} },
+    { A(FUNC_FPARAM_DIM), { T(LEFT_BRACKET), N(CONST_EXP), T(RIGHT_BRACKET) } },
+    { A(FUNC_FPARAM_DIM), {} },
+
+    // FuncAParams -> Exp { ',' Exp }
+    { N(FUNC_APARAMS), { N(EXP), A(FUNC_APARAM_LIST) } },
+    { A(FUNC_APARAM_LIST), { T(COMMA), N(EXP), A(FUNC_APARAM_LIST) } },
+    { A(FUNC_APARAM_LIST), {} },
+
+    // Block -> '{' { BlockItem } '}'
+    { N(BLOCK), { T(LEFT_BRACE), A(BLOCK_ITEMS), T(RIGHT_BRACE) } },
+    { A(BLOCK_ITEMS), { N(BLOCK_ITEM), A(BLOCK_ITEMS) } },
+    { A(BLOCK_ITEMS), {} },
+
+    // BlockItem -> ConstDecl | VarDecl | Stmt
+    { N(BLOCK_ITEM), { N(CONST_DECL) } },
+    { N(BLOCK_ITEM), { N(VAR_DECL) } },
+    { N(BLOCK_ITEM), { N(STMT) } },
+
+    // MainFuncDef -> 'int' 'main' '(' ')' Block
+    { N(MAIN_FUNC_DEF), { T(INT), T(MAIN), T(LEFT_PARENTHESIS), T(RIGHT_PARENTHESIS), N(BLOCK) } },
+
+    // Stmt
+    { N(STMT), { N(ASSIGNMENT_STMT) } },
+    { N(STMT), { N(EXP_STMT) } },
+    { N(STMT), { N(BLOCK) } },
+    { N(STMT), { N(IF_STMT) } },
+    { N(STMT), { N(FOR_STMT) } },
+    { N(STMT), { N(BREAK_STMT) } },
+    { N(STMT), { N(CONTINUE_STMT) } },
+    { N(STMT), { N(RETURN_STMT) } },
+    { N(STMT), { N(IN_STMT) } },
+    { N(STMT), { N(OUT_STMT) } },
+
+    // AssignmentStmt -> LVal '=' Exp ';'
+    { N(ASSIGNMENT_STMT), { N(LVAL), T(ASSIGN), N(EXP), T(SEMICOLON) } },
+
+    // LVal -> Ident { '[' Exp ']' }
+    { N(LVAL), { T(IDENTIFIER), A(EXP_DIMS) } },
+    { A(EXP_DIMS), { T(LEFT_BRACKET), N(EXP), T(RIGHT_BRACKET), A(EXP_DIMS) } },
+    { A(EXP_DIMS), {} },
+
+    { N(COND), { N(OR_EXP) } },
+
+    // IfStmt -> 'if' '(' Cond ')' Stmt [ 'else' Stmt ]
+    { N(IF_STMT), { T(IF), T(LEFT_PARENTHESIS), N(COND), T(RIGHT_PARENTHESIS), N(STMT), A(ELSE_OPT) } },
+    { A(ELSE_OPT), { T(ELSE), N(STMT) } },
+    { A(ELSE_OPT), {} },
+
+    // ForStmt -> 'for' '(' [ ForInitStmt ] ';' [ Cond ] ';' [ ForStepStmt ] ')' Stmt
+    { N(FOR_STMT), { T(FOR), T(LEFT_PARENTHESIS), A(FOR_INIT_STMT_OPT), T(SEMICOLON), A(COND_OPT),
+                     T(SEMICOLON), A(FOR_STEP_STMT_OPT), T(RIGHT_PARENTHESIS), N(STMT) } },
+    { A(FOR_INIT_STMT_OPT), { N(FOR_INIT_STMT) } },
+    { A(FOR_INIT_STMT_OPT), {} },
+    { A(COND_OPT), { N(COND) } },
+    { A(COND_OPT), {} },
+    { A(FOR_STEP_STMT_OPT), { N(FOR_STEP_STMT) } },
+    { A(FOR_STEP_STMT_OPT), {} },
+    { N(FOR_INIT_STMT), { N(LVAL), T(ASSIGN), N(EXP) } },
+    { N(FOR_STEP_STMT), { N(LVAL), T(ASSIGN), N(EXP) } },
+
+    // ExpStmt -> [ Exp ] ';'
+    { N(EXP_STMT), { A(EXP_OPT), T(SEMICOLON) } },
+    { A(EXP_OPT), { N(EXP) } },
+    { A(EXP_OPT), {} },
+
+    { N(BREAK_STMT), { T(BREAK), T(SEMICOLON) } },
+    { N(CONTINUE_STMT), { T(CONTINUE), T(SEMICOLON) } },
+    { N(RETURN_STMT), { T(RETURN), A(EXP_OPT), T(SEMICOLON) } },
+
+    // InStmt -> LVal '=' 'getint' '(' ')' ';'
+    { N(IN_STMT), { N(LVAL), T(ASSIGN), T(GETINT), T(LEFT_PARENTHESIS), T(RIGHT_PARENTHESIS),
+                    T(SEMICOLON) } },
+
+    // OutStmt -> 'printf' '(' FormatString { ',' Exp } ')' ';'
+    { N(OUT_STMT), { T(PRINTF), T(LEFT_PARENTHESIS), T(FORMAT), A(OUT_ARGS), T(RIGHT_PARENTHESIS),
+                     T(SEMICOLON) } },
+    { A(OUT_ARGS), { T(COMMA), N(EXP), A(OUT_ARGS) } },
+    { A(OUT_ARGS), {} },
+
+    // Exp
+    { N(EXP), { N(ADD_EXP) } },
+    { N(CONST_EXP), { N(ADD_EXP) } },
+
+    { N(OR_EXP), { N(AND_EXP) } },
+    { N(OR_EXP), { N(OR_EXP), T(OR), N(AND_EXP) } },
+    { N(AND_EXP), { N(EQ_EXP) } },
+    { N(AND_EXP), { N(AND_EXP), T(AND), N(EQ_EXP) } },
+    { N(EQ_EXP), { N(REL_EXP) } },
+    { N(EQ_EXP), { N(EQ_EXP), T(EQUAL), N(REL_EXP) } },
+    { N(EQ_EXP), { N(EQ_EXP), T(NOT_EQUAL), N(REL_EXP) } },
+    { N(REL_EXP), { N(ADD_EXP) } },
+    { N(REL_EXP), { N(REL_EXP), T(LESS), N(ADD_EXP) } },
+    { N(REL_EXP), { N(REL_EXP), T(LESS_EQUAL), N(ADD_EXP) } },
+    { N(REL_EXP), { N(REL_EXP), T(GREATER), N(ADD_EXP) } },
+    { N(REL_EXP), { N(REL_EXP), T(GREATER_EQUAL), N(ADD_EXP) } },
+    { N(ADD_EXP), { N(MUL_EXP) } },
+    { N(ADD_EXP), { N(ADD_EXP), T(PLUS), N(MUL_EXP) } },
+    { N(ADD_EXP), { N(ADD_EXP), T(MINUS), N(MUL_EXP) } },
+    { N(MUL_EXP), { N(UNARY_EXP) } },
+    { N(MUL_EXP), { N(MUL_EXP), T(MULTIPLY), N(UNARY_EXP) } },
+    { N(MUL_EXP), { N(MUL_EXP), T(DIVIDE), N(UNARY_EXP) } },
+    { N(MUL_EXP), { N(MUL_EXP), T(MOD), N(UNARY_EXP) } },
+
+    // UnaryExp -> PrimaryExp | FuncCall | UnaryOp UnaryExp
+    { N(UNARY_EXP), { N(PRIMARY_EXP) } },
+    { N(UNARY_EXP), { N(FUNC_CALL) } },
+    { N(UNARY_EXP), { N(UNARY_OP), N(UNARY_EXP) } },
+    { N(UNARY_OP), { T(PLUS) } },
+    { N(UNARY_OP), { T(MINUS) } },
+    { N(UNARY_OP), { T(NOT) } },
+
+    // PrimaryExp -> '(' Exp ')' | LVal | Number
+    { N(PRIMARY_EXP), { T(LEFT_PARENTHESIS), N(EXP), T(RIGHT_PARENTHESIS) } },
+    { N(PRIMARY_EXP), { N(LVAL) } },
+    { N(PRIMARY_EXP), { N(NUMBER) } },
+
+    // FuncCall -> Ident '(' [ FuncAParams ] ')'
+    { N(FUNC_CALL), { T(IDENTIFIER), T(LEFT_PARENTHESIS), A(FUNC_APARAMS_OPT), T(RIGHT_PARENTHESIS) } },
+    { A(FUNC_APARAMS_OPT), { N(FUNC_APARAMS) } },
+    { A(FUNC_APARAMS_OPT), {} },
+
+    { N(NUMBER), { T(INTEGER) } }
+};
+
+#undef T
+#undef N
+#undef A
+
+
+/*
+ * ==================== Sets ====================
+ */
+
+struct GrammarSets
+{
+    bool nullable[_NON_TERMINAL_COUNT];
+    TokenSet first[_NON_TERMINAL_COUNT];
+    TokenSet follow[_NON_TERMINAL_COUNT];
+};
+
+
+static constexpr bool _IsTerminal(int symbol)
+{
+    return symbol < TOKEN_TYPE_COUNT;
+}
+
+
+static constexpr TokenSet _TerminalSet(int symbol)
+{
+    return { static_cast<TokenType>(symbol) };
+}
+
+
+/*
+ * Both sets are computed by iterating to a fixed point, which takes a few
+ * passes over the productions.
+ */
+static constexpr GrammarSets _ComputeSets()
+{
+    GrammarSets sets{};
+
+    // Nullable and FIRST.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (const auto& production : _PRODUCTIONS)
+        {
+            int lhs = production.lhs - TOKEN_TYPE_COUNT;
+            TokenSet first = sets.first[lhs];
+            bool nullable = true;
+            for (int i = 0; nullable && (i < production.length); i++)
+            {
+                int symbol = production.rhs[i];
+                if (_IsTerminal(symbol))
+                {
+                    first |= _TerminalSet(symbol);
+                    nullable = false;
+                }
+                else
+                {
+                    first |= sets.first[symbol - TOKEN_TYPE_COUNT];
+                    nullable = sets.nullable[symbol - TOKEN_TYPE_COUNT];
+                }
+            }
+            if ((first != sets.first[lhs]) || (nullable && !sets.nullable[lhs]))
+            {
+                sets.first[lhs] = first;
+                sets.nullable[lhs] = sets.nullable[lhs] || nullable;
+                changed = true;
+            }
+        }
+    }
+
+    // FOLLOW, scanning each right-hand side backwards with what may follow
+    // the current symbol.
+    sets.follow[static_cast<int>(SyntaxType::ST_COMP_UNIT)] = { TokenType::TK_TERMINATOR };
+    changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (const auto& production : _PRODUCTIONS)
+        {
+            TokenSet trailer = sets.follow[production.lhs - TOKEN_TYPE_COUNT];
+            for (int i = production.length - 1; i >= 0; i--)
+            {
+                int symbol = production.rhs[i];
+                if (_IsTerminal(symbol))
+                {
+                    trailer = _TerminalSet(symbol);
+                    continue;
+                }
+
+                int nonTerminal = symbol - TOKEN_TYPE_COUNT;
+                TokenSet follow = sets.follow[nonTerminal] | trailer;
+                if (follow != sets.follow[nonTerminal])
+                {
+                    sets.follow[nonTerminal] = follow;
+                    changed = true;
+                }
+                if (sets.nullable[nonTerminal])
+                {
+                    trailer |= sets.first[nonTerminal];
+                }
+                else
+                {
+                    trailer = sets.first[nonTerminal];
+                }
+            }
+        }
+    }
+
+    return sets;
+}
+
+
+static constexpr GrammarSets _SETS = _ComputeSets();
+
+
+static constexpr TokenSet _First(SyntaxType type)
+{
+    return _SETS.first[static_cast<int>(type)];
+}
+
+
+static constexpr TokenSet _Follow(SyntaxType type)
+{
+    return _SETS.follow[static_cast<int>(type)];
+}
+
+
+// The parsers rely on these.
+static_assert(_First(SyntaxType::ST_VAR_DECL) == TokenSet{ TokenType::TK_INT },
+              "VarDecl should start with int");
+static_assert(_First(SyntaxType::ST_FUNC_DEF) == TokenSet{ TokenType::TK_INT, TokenType::TK_VOID },
+              "FuncDef should start with int or void");
+static_assert(_First(SyntaxType::ST_UNARY_OP) ==
+              TokenSet{ TokenType::TK_PLUS, TokenType::TK_MINUS, TokenType::TK_NOT },
+              "UnaryOp should be +, - or !");
+static_assert(!_First(SyntaxType::ST_EXP).Contains(TokenType::TK_SEMICOLON) &&
+              !_SETS.nullable[static_cast<int>(SyntaxType::ST_EXP)],
+              "Exp should not be empty");
+static_assert(_Follow(SyntaxType::ST_STMT).Contains(TokenType::TK_ELSE),
+              "Stmt may be followed by else");
+
+
+/*
+ * ==================== Grammar ====================
+ */
+
+TokenSet Grammar::First(SyntaxType type)
+{
+    TOMIC_ASSERT(type < SyntaxType::ST_COUNT);
+    return _First(type);
+}
+
+
+TokenSet Grammar::Follow(SyntaxType type)
+{
+    TOMIC_ASSERT(type < SyntaxType::ST_COUNT);
+    return _Follow(type);
+}
+
+
+bool Grammar::IsNullable(SyntaxType type)
+{
+    TOMIC_ASSERT(type < SyntaxType::ST_COUNT);
+    return _SETS.nullable[static_cast<int>(type)];
+}
+
+
+TOMIC_END
@@ -12,29 +12,44 @@ TOMIC_BEGIN
 
 SymbolTableBlockPtr SymbolTable::NewRoot()
 {
-    auto block = SymbolTableBlock::New(_nextId++, this, nullptr);
-    _blocks[block->Id()] = block;
-    return block.get();
+    return NewBlock(nullptr);
 }
 
 
 SymbolTableBlockPtr SymbolTable::NewBlock(SymbolTableBlockPtr parent)
 {
-    auto block = SymbolTableBlock::New(_nextId++, this, parent);
-    _blocks[block->Id()] = block;
+    auto block = SymbolTableBlock::New(static_cast<int>(_blocks.size()), this, parent);
+    _blocks.push_back(block);
     return block.get();
 }
 
 
 SymbolTableBlockPtr SymbolTable::GetBlock(int id) const
 {
-    auto it = _blocks.find(id);
-    if (it != _blocks.end())
+    if ((id < 0) || (id >= static_cast<int>(_blocks.size())))
+    {
+        return nullptr;
+    }
+
+    return _blocks[id].get();
+}
+
+
+int SymbolTable::InternSymbol(const std::string& name)
+{
+    return _symbols.emplace(name, static_cast<int>(_symbols.size())).first->second;
+}
+
+
+int SymbolTable::FindSymbol(const std::string& name) const
+{
+    auto it = _symbols.find(name);
+    if (it != _symbols.end())
     {
-        return it->second.get();
+        return it->second;
     }
 
-    return nullptr;
+    return -1;
 }
 
 
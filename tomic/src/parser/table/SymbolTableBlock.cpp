@@ -20,7 +20,7 @@ SymbolTableBlockPtr SymbolTableBlock::AddEntry(SymbolTableEntryPtr entry)
 {
     TOMIC_ASSERT(entry);
 
-    _entries.push_back(entry);
+    _entries.emplace(_table->InternSymbol(entry->Name()), entry);
 
     return this;
 }
@@ -28,15 +28,19 @@ SymbolTableBlockPtr SymbolTableBlock::AddEntry(SymbolTableEntryPtr entry)
 
 SymbolTableEntryPtr SymbolTableBlock::FindEntry(const std::string& name) const
 {
-    auto entry = FindLocalEntry(name);
-    if (entry)
+    int symbol = _table->FindSymbol(name);
+    if (symbol == -1)
     {
-        return entry;
+        return nullptr;
     }
 
-    if (_parent)
+    for (auto block = this; block; block = block->_parent)
     {
-        return _parent->FindEntry(name);
+        auto entry = block->_FindLocalEntry(symbol);
+        if (entry)
+        {
+            return entry;
+        }
     }
 
     return nullptr;
@@ -45,12 +49,22 @@ SymbolTableEntryPtr SymbolTableBlock::FindEntry(const std::string& name) const
 
 SymbolTableEntryPtr SymbolTableBlock::FindLocalEntry(const std::string& name) const
 {
-    for (auto entry : _entries)
+    int symbol = _table->FindSymbol(name);
+    if (symbol == -1)
     {
-        if (entry->Name() == name)
-        {
-            return entry;
-        }
+        return nullptr;
+    }
+
+    return _FindLocalEntry(symbol);
+}
+
+
+SymbolTableEntryPtr SymbolTableBlock::_FindLocalEntry(int symbol) const
+{
+    auto it = _entries.find(symbol);
+    if (it != _entries.end())
+    {
+        return it->second;
     }
 
     return nullptr;
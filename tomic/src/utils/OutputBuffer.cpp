@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/utils/OutputBuffer.h>
+
+#include <charconv>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+TOMIC_BEGIN
+
+/*
+ * ================================ EscapeTable ================================
+ */
+
+EscapeTable::EscapeTable(std::initializer_list<std::pair<char, const char*>> escapes)
+    : _escapes{}, _specials{}, _specialCount(0)
+{
+    TOMIC_ASSERT(escapes.size() <= MAX_SPECIALS);
+
+    for (const auto& [ch, escape] : escapes)
+    {
+        _escapes[static_cast<unsigned char>(ch)] = escape;
+        _specials[_specialCount++] = ch;
+    }
+}
+
+
+const char* EscapeTable::Find(const char* begin, const char* end) const
+{
+    const char* p = begin;
+
+#ifdef __SSE2__
+    __m128i specials[MAX_SPECIALS];
+    for (int i = 0; i < _specialCount; i++)
+    {
+        specials[i] = _mm_set1_epi8(_specials[i]);
+    }
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hits = _mm_setzero_si128();
+        for (int i = 0; i < _specialCount; i++)
+        {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, specials[i]));
+        }
+        int mask = _mm_movemask_epi8(hits);
+        if (mask != 0)
+        {
+            return p + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    for (; p < end; p++)
+    {
+        if (Escape(*p))
+        {
+            return p;
+        }
+    }
+
+    return end;
+}
+
+
+/*
+ * ================================ OutputBuffer ================================
+ */
+
+OutputBuffer::OutputBuffer()
+{
+    _buffer.reserve(BLOCK_SIZE * 2);
+}
+
+
+OutputBuffer::~OutputBuffer()
+{
+    Close();
+}
+
+
+void OutputBuffer::Open(twio::IWriterPtr writer)
+{
+    TOMIC_ASSERT(writer);
+
+    Flush();
+    _writer = writer;
+}
+
+
+void OutputBuffer::Close()
+{
+    Flush();
+    _writer = nullptr;
+}
+
+
+void OutputBuffer::Flush()
+{
+    if (_writer && !_buffer.empty())
+    {
+        _writer->Write(_buffer.data(), _buffer.length());
+    }
+    _buffer.clear();
+}
+
+
+void OutputBuffer::AppendRepeat(char ch, int count)
+{
+    if (count > 0)
+    {
+        _buffer.append(count, ch);
+        _FlushIfFull();
+    }
+}
+
+
+void OutputBuffer::AppendInt(int value)
+{
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    Append(digits, result.ptr - digits);
+}
+
+
+// Runs with nothing to escape are copied at once.
+void OutputBuffer::AppendEscaped(const char* str, size_t length, const EscapeTable& table)
+{
+    const char* end = str + length;
+    for (const char* p = str; p < end;)
+    {
+        const char* special = table.Find(p, end);
+        _buffer.append(p, special - p);
+        if (special == end)
+        {
+            break;
+        }
+        _buffer.append(table.Escape(*special));
+        p = special + 1;
+    }
+    _FlushIfFull();
+}
+
+
+TOMIC_END
@@ -235,6 +235,25 @@ bool HasAttribute(const SyntaxNodePtr node, const char* name)
 }
 
 
+bool HasAttribute(const SyntaxNodePtr node, SyntaxAttribute attr)
+{
+    if (node->HasAttribute(attr))
+    {
+        return true;
+    }
+
+    for (auto child = node->FirstChild(); child; child = child->NextSibling())
+    {
+        if (HasAttribute(child, attr))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 const char* GetAttribute(const SyntaxNodePtr node, const char* name, const char* defaultValue)
 {
     const char* value;
@@ -248,11 +267,11 @@ const char* GetAttribute(const SyntaxNodePtr node, const char* name, const char*
 }
 
 
-int GetIntAttribute(const SyntaxNodePtr node, const char* name, int defaultValue)
+int GetIntAttribute(const SyntaxNodePtr node, SyntaxAttribute attr, int defaultValue)
 {
     int value;
 
-    if (QueryIntAttribute(node, name, &value, defaultValue))
+    if (QueryIntAttribute(node, attr, &value, defaultValue))
     {
         return value;
     }
@@ -261,11 +280,11 @@ int GetIntAttribute(const SyntaxNodePtr node, const char* name, int defaultValue
 }
 
 
-bool GetBoolAttribute(const SyntaxNodePtr node, const char* name, bool defaultValue)
+bool GetBoolAttribute(const SyntaxNodePtr node, SyntaxAttribute attr, bool defaultValue)
 {
     bool value;
 
-    if (QueryBoolAttribute(node, name, &value, defaultValue))
+    if (QueryBoolAttribute(node, attr, &value, defaultValue))
     {
         return value;
     }
@@ -297,50 +316,38 @@ bool QueryAttribute(const SyntaxNodePtr node, const char* name, const char** val
 }
 
 
-bool QueryIntAttribute(const SyntaxNodePtr node, const char* name, int* value, int defaultValue)
+bool QueryIntAttribute(const SyntaxNodePtr node, SyntaxAttribute attr, int* value, int defaultValue)
 {
-    const char* attr;
-
-    if (QueryAttribute(node, name, &attr, nullptr))
+    if (node->QueryIntAttribute(attr, value, defaultValue))
     {
-        if (value)
-        {
-            if (!StringUtil::ToInt(attr, value))
-            {
-                *value = defaultValue;
-            }
-        }
         return true;
     }
 
-    if (value)
+    for (auto child = node->FirstChild(); child; child = child->NextSibling())
     {
-        *value = defaultValue;
+        if (QueryIntAttribute(child, attr, value, defaultValue))
+        {
+            return true;
+        }
     }
 
     return false;
 }
 
 
-bool QueryBoolAttribute(const SyntaxNodePtr node, const char* name, bool* value, bool defaultValue)
+bool QueryBoolAttribute(const SyntaxNodePtr node, SyntaxAttribute attr, bool* value, bool defaultValue)
 {
-    const char* attr;
-
-    if (QueryAttribute(node, name, &attr, nullptr))
+    if (node->QueryBoolAttribute(attr, value, defaultValue))
     {
-        if (value)
-        {
-            if (!StringUtil::ToBool(attr, value))
-            {
-                *value = defaultValue;
-            }
-        }
         return true;
     }
 
-    if (value)
+    for (auto child = node->FirstChild(); child; child = child->NextSibling())
     {
-        *value = defaultValue;
+        if (QueryBoolAttribute(child, attr, value, defaultValue))
+        {
+            return true;
+        }
     }
 
     return false;
@@ -369,6 +376,27 @@ bool HasInheritedAttribute(const SyntaxNodePtr node, const char* name)
 }
 
 
+bool HasInheritedAttribute(const SyntaxNodePtr node, SyntaxAttribute attr)
+{
+    if (node->HasAttribute(attr))
+    {
+        return true;
+    }
+
+    SyntaxNodePtr parent = node->Parent();
+    while (parent)
+    {
+        if (parent->HasAttribute(attr))
+        {
+            return true;
+        }
+        parent = parent->Parent();
+    }
+
+    return false;
+}
+
+
 const char* GetInheritedAttribute(const SyntaxNodePtr node, const char* name, const char* defaultValue)
 {
     if (node->HasAttribute(name))
@@ -390,19 +418,19 @@ const char* GetInheritedAttribute(const SyntaxNodePtr node, const char* name, co
 }
 
 
-int GetInheritedIntAttribute(const SyntaxNodePtr node, const char* name, int defaultValue)
+int GetInheritedIntAttribute(const SyntaxNodePtr node, SyntaxAttribute attr, int defaultValue)
 {
-    if (node->HasAttribute(name))
+    if (node->HasAttribute(attr))
     {
-        return node->IntAttribute(name, defaultValue);
+        return node->IntAttribute(attr, defaultValue);
     }
 
     SyntaxNodePtr parent = node->Parent();
     while (parent)
     {
-        if (parent->HasAttribute(name))
+        if (parent->HasAttribute(attr))
         {
-            return parent->IntAttribute(name, defaultValue);
+            return parent->IntAttribute(attr, defaultValue);
         }
         parent = parent->Parent();
     }
@@ -411,19 +439,19 @@ int GetInheritedIntAttribute(const SyntaxNodePtr node, const char* name, int def
 }
 
 
-bool GetInheritedBoolAttribute(const SyntaxNodePtr node, const char* name, bool defaultValue)
+bool GetInheritedBoolAttribute(const SyntaxNodePtr node, SyntaxAttribute attr, bool defaultValue)
 {
-    if (node->HasAttribute(name))
+    if (node->HasAttribute(attr))
     {
-        return node->BoolAttribute(name, defaultValue);
+        return node->BoolAttribute(attr, defaultValue);
     }
 
     SyntaxNodePtr parent = node->Parent();
     while (parent)
     {
-        if (parent->HasAttribute(name))
+        if (parent->HasAttribute(attr))
         {
-            return parent->BoolAttribute(name, defaultValue);
+            return parent->BoolAttribute(attr, defaultValue);
         }
         parent = parent->Parent();
     }
@@ -450,6 +478,22 @@ bool HasSynthesizedAttribute(const SyntaxNodePtr node, const char* name)
 }
 
 
+bool HasSynthesizedAttribute(const SyntaxNodePtr node, SyntaxAttribute attr)
+{
+    if (HasAttribute(node, attr))
+    {
+        return true;
+    }
+
+    if (node->PrevSibling())
+    {
+        return HasSynthesizedAttribute(node->PrevSibling(), attr);
+    }
+
+    return false;
+}
+
+
 const char* GetSynthesizedAttribute(const SyntaxNodePtr node, const char* name, const char* defaultValue)
 {
     const char* value;
@@ -468,36 +512,36 @@ const char* GetSynthesizedAttribute(const SyntaxNodePtr node, const char* name,
 }
 
 
-int GetSynthesizedIntAttribute(const SyntaxNodePtr node, const char* name, int defaultValue)
+int GetSynthesizedIntAttribute(const SyntaxNodePtr node, SyntaxAttribute attr, int defaultValue)
 {
     int value;
 
-    if (QueryIntAttribute(node, name, &value, defaultValue))
+    if (QueryIntAttribute(node, attr, &value, defaultValue))
     {
         return value;
     }
 
     if (node->PrevSibling())
     {
-        return GetSynthesizedIntAttribute(node->PrevSibling(), name, defaultValue);
+        return GetSynthesizedIntAttribute(node->PrevSibling(), attr, defaultValue);
     }
 
     return defaultValue;
 }
 
 
-bool GetSynthesizedBoolAttribute(const SyntaxNodePtr node, const char* name, bool defaultValue)
+bool GetSynthesizedBoolAttribute(const SyntaxNodePtr node, SyntaxAttribute attr, bool defaultValue)
 {
     bool value;
 
-    if (QueryBoolAttribute(node, name, &value, defaultValue))
+    if (QueryBoolAttribute(node, attr, &value, defaultValue))
     {
         return value;
     }
 
     if (node->PrevSibling())
     {
-        return GetSynthesizedBoolAttribute(node->PrevSibling(), name, defaultValue);
+        return GetSynthesizedBoolAttribute(node->PrevSibling(), attr, defaultValue);
     }
 
     return defaultValue;
@@ -599,8 +643,9 @@ typedef int (*BinaryFunc)(int, int);
 static int _Add(int left, int right) { return left + right; }
 static int _Sub(int left, int right) { return left - right; }
 static int _Mul(int left, int right) { return left * right; }
-static int _Div(int left, int right) { return left / right; }
-static int _Mod(int left, int right) { return left % right; }
+// Division by zero is undefined, fold it to 0 instead of trapping.
+static int _Div(int left, int right) { return (right == 0) ? 0 : left / right; }
+static int _Mod(int left, int right) { return (right == 0) ? 0 : left % right; }
 static int _And(int left, int right) { return left && right; }
 static int _Or(int left, int right) { return left || right; }
 
@@ -731,7 +776,7 @@ static UnaryFunc _GetUnaryEvaluator(const char* op)
 
 int EvaluateNumber(const SyntaxNodePtr node)
 {
-    const char* number = node->FirstChild()->Token()->lexeme.c_str();
+    const char* number = node->FirstChild()->Token().Lexeme();
     int value;
     if (StringUtil::ToInt(number, &value))
     {
@@ -747,12 +792,12 @@ int EvaluateNumber(const SyntaxNodePtr node)
 
 bool TryEvaluateLVal(const SyntaxNodePtr node, SymbolTableBlockPtr block, int* value)
 {
-    if (node->IntAttribute("dim", -1) != 0)
+    if (node->IntAttribute(SyntaxAttribute::SA_DIM, -1) != 0)
     {
         return false;
     }
 
-    const char* name = node->FirstChild()->Token()->lexeme.c_str();
+    const char* name = node->FirstChild()->Token().Lexeme();
     auto rawEntry = block->FindEntry(name);
 
     if ((!rawEntry) || (rawEntry->EntryType() != SymbolTableEntryType::ET_CONSTANT))
@@ -770,22 +815,30 @@ bool TryEvaluateLVal(const SyntaxNodePtr node, SymbolTableBlockPtr block, int* v
     else if (dim == 1)
     {
         auto index = GetDirectChildNode(node, SyntaxType::ST_EXP);
-        if (!index->BoolAttribute("det"))
+        if (!index->BoolAttribute(SyntaxAttribute::SA_DET))
         {
             return false;
         }
-        *value = entry->Value(index->IntAttribute("value"));
+        if (!entry->HasValue(index->IntAttribute(SyntaxAttribute::SA_VALUE)))
+        {
+            return false;
+        }
+        *value = entry->Value(index->IntAttribute(SyntaxAttribute::SA_VALUE));
         return true;
     }
     else if (dim == 2)
     {
         auto index1 = GetDirectChildNode(node, SyntaxType::ST_EXP, 1);
         auto index2 = GetDirectChildNode(node, SyntaxType::ST_EXP, 2);
-        if (!index1->BoolAttribute("det") || !index2->BoolAttribute("det"))
+        if (!index1->BoolAttribute(SyntaxAttribute::SA_DET) || !index2->BoolAttribute(SyntaxAttribute::SA_DET))
+        {
+            return false;
+        }
+        if (!entry->HasValue(index1->IntAttribute(SyntaxAttribute::SA_VALUE), index2->IntAttribute(SyntaxAttribute::SA_VALUE)))
         {
             return false;
         }
-        *value = entry->Value(index1->IntAttribute("value"), index2->IntAttribute("value"));
+        *value = entry->Value(index1->IntAttribute(SyntaxAttribute::SA_VALUE), index2->IntAttribute(SyntaxAttribute::SA_VALUE));
         return true;
     }
 
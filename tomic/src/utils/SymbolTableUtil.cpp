@@ -37,8 +37,8 @@ void BuildParamVariableEntries(SyntaxNodePtr funcParams,
 
     for (auto& param : params)
     {
-        int dim = param->IntAttribute("dim");
-        SymbolValueType type = static_cast<SymbolValueType>(param->IntAttribute("type"));
+        int dim = param->IntAttribute(SyntaxAttribute::SA_DIM);
+        SymbolValueType type = static_cast<SymbolValueType>(param->IntAttribute(SyntaxAttribute::SA_TYPE));
         VariableEntryBuilder builder(param->Attribute("name"));
         builder.Type(type);
 
@@ -49,7 +49,7 @@ void BuildParamVariableEntries(SyntaxNodePtr funcParams,
         }
         else if (dim == 2)
         {
-            builder.Size(0, param->IntAttribute("size"));
+            builder.Size(0, param->IntAttribute(SyntaxAttribute::SA_SIZE));
         }
 
         list.emplace_back(param, builder.Build());
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/utils/ThreadPool.h>
+
+TOMIC_BEGIN
+
+ThreadPool::ThreadPool(int threads) : _pending(0), _stopped(false)
+{
+    TOMIC_ASSERT(threads > 0);
+
+    for (int i = 0; i < threads; i++)
+    {
+        _workers.emplace_back(&ThreadPool::_Work, this);
+    }
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopped = true;
+    }
+    _taskReady.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+
+std::shared_ptr<ThreadPool> ThreadPool::New(int threads)
+{
+    return std::make_shared<ThreadPool>(threads);
+}
+
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push(std::move(task));
+        _pending++;
+    }
+    _taskReady.notify_one();
+}
+
+
+void ThreadPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _allDone.wait(lock, [this] { return _pending == 0; });
+}
+
+
+void ThreadPool::_Work()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _taskReady.wait(lock, [this] { return _stopped || !_tasks.empty(); });
+            if (_tasks.empty())
+            {
+                // Stopped, and nothing left to do.
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+
+        task();
+
+        bool done;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            done = (--_pending == 0);
+        }
+        if (done)
+        {
+            _allDone.notify_all();
+        }
+    }
+}
+
+
+TOMIC_END
@@ -0,0 +1,263 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/utils/TimeReport.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/*
+ * ================================ Allocation ================================
+ */
+
+static std::atomic<size_t> _allocCount(0);
+static std::atomic<size_t> _allocBytes(0);
+
+
+void* operator new(size_t size)
+{
+    _allocCount.fetch_add(1, std::memory_order_relaxed);
+    _allocBytes.fetch_add(size, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+
+TOMIC_BEGIN
+
+/*
+ * ================================ Phases ================================
+ */
+
+TimeReport::Scope::Scope(TimeReport* report, const char* name) : _report(report)
+{
+    if (_report)
+    {
+        _report->Begin(name);
+    }
+}
+
+
+TimeReport::Scope::~Scope()
+{
+    if (_report)
+    {
+        _report->End();
+    }
+}
+
+
+std::shared_ptr<TimeReport> TimeReport::New()
+{
+    return std::make_shared<TimeReport>();
+}
+
+
+void TimeReport::Begin(const char* name)
+{
+    _marks.push_back({
+        _phases.size(),
+        std::chrono::steady_clock::now(),
+        CpuTime(),
+        AllocCount(),
+        AllocBytes()
+    });
+    _phases.push_back({ name, static_cast<int>(_marks.size()) - 1, 0.0, 0.0, 0, 0, 0 });
+}
+
+
+void TimeReport::End()
+{
+    TOMIC_ASSERT(!_marks.empty() && "Unbalanced phase");
+
+    const Mark& mark = _marks.back();
+    Phase& phase = _phases[mark.index];
+    phase.wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - mark.wall).count();
+    phase.cpu = CpuTime() - mark.cpu;
+    phase.peakRss = PeakRss();
+    phase.allocCount = AllocCount() - mark.allocCount;
+    phase.allocBytes = AllocBytes() - mark.allocBytes;
+
+    _marks.pop_back();
+}
+
+
+/*
+ * ================================ Output ================================
+ */
+
+void TimeReport::Print(twio::IWriterPtr writer) const
+{
+    writer->WriteFormat("%-24s %12s %12s %14s %12s %14s\n",
+                        "Phase", "Wall (ms)", "CPU (ms)", "Peak RSS (MB)", "Allocations", "Alloc (MB)");
+    for (const auto& phase : _phases)
+    {
+        std::string name(phase.depth * 2, ' ');
+        name += phase.name;
+        writer->WriteFormat("%-24s %12.3f %12.3f %14.2f %12zu %14.2f\n",
+                            name.c_str(),
+                            phase.wall * 1e3,
+                            phase.cpu * 1e3,
+                            static_cast<double>(phase.peakRss) / (1024.0 * 1024.0),
+                            phase.allocCount,
+                            static_cast<double>(phase.allocBytes) / (1024.0 * 1024.0));
+    }
+}
+
+
+void TimeReport::PrintJson(twio::IWriterPtr writer) const
+{
+    writer->Write("[");
+    for (size_t i = 0; i < _phases.size();)
+    {
+        if (i > 0)
+        {
+            writer->Write(",");
+        }
+        i = _PrintJson(writer, i);
+    }
+    writer->Write("]\n");
+}
+
+
+// Print a phase with its sub-phases, and return the index after them.
+size_t TimeReport::_PrintJson(twio::IWriterPtr writer, size_t index) const
+{
+    const Phase& phase = _phases[index];
+    writer->WriteFormat(R"({"name":"%s","wall":%.6f,"cpu":%.6f,"peakRss":%zu,"allocCount":%zu,"allocBytes":%zu,"phases":[)",
+                        phase.name.c_str(),
+                        phase.wall,
+                        phase.cpu,
+                        phase.peakRss,
+                        phase.allocCount,
+                        phase.allocBytes);
+
+    size_t next = index + 1;
+    while ((next < _phases.size()) && (_phases[next].depth > phase.depth))
+    {
+        if (next > index + 1)
+        {
+            writer->Write(",");
+        }
+        next = _PrintJson(writer, next);
+    }
+    writer->Write("]}");
+
+    return next;
+}
+
+
+/*
+ * ================================ Process ================================
+ */
+
+// CPU time of all threads of the process, in seconds.
+double TimeReport::CpuTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+    {
+        return 0.0;
+    }
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return static_cast<double>(k.QuadPart + u.QuadPart) * 1e-7;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+           + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+
+size_t TimeReport::PeakRss()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // Linux reports it in kilobytes.
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+
+size_t TimeReport::AllocCount()
+{
+    return _allocCount.load(std::memory_order_relaxed);
+}
+
+
+size_t TimeReport::AllocBytes()
+{
+    return _allocBytes.load(std::memory_order_relaxed);
+}
+
+
+TOMIC_END
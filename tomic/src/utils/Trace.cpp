@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Copyright (C) Tony's Studio 2018 - 2023. All rights reserved.
+ *
+ *   For BUAA 2023 Compiler Technology
+ */
+
+#include <tomic/utils/Trace.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+TOMIC_BEGIN
+
+namespace
+{
+
+struct TraceEvent
+{
+    const char* category;
+    const char* name;
+    const char* argName;
+    int arg;
+    uint64_t begin;
+    uint64_t end;
+};
+
+
+struct TraceBuffer
+{
+    int tid;
+    std::vector<TraceEvent> events;
+};
+
+
+// Buffers are never freed, so that they can outlive their threads.
+std::mutex _mutex;
+std::vector<std::unique_ptr<TraceBuffer>> _buffers;
+thread_local TraceBuffer* _localBuffer = nullptr;
+
+std::chrono::steady_clock::time_point _origin;
+
+
+TraceBuffer* _LocalBuffer()
+{
+    if (!_localBuffer)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _buffers.push_back(std::make_unique<TraceBuffer>());
+        _localBuffer = _buffers.back().get();
+        _localBuffer->tid = static_cast<int>(_buffers.size());
+    }
+    return _localBuffer;
+}
+
+}
+
+
+std::atomic<bool> Tracer::_enabled(false);
+
+
+void Tracer::Start()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto& buffer : _buffers)
+        {
+            buffer->events.clear();
+        }
+    }
+    _origin = std::chrono::steady_clock::now();
+    _enabled.store(true, std::memory_order_relaxed);
+}
+
+
+void Tracer::Stop()
+{
+    _enabled.store(false, std::memory_order_relaxed);
+}
+
+
+uint64_t Tracer::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _origin).count();
+}
+
+
+void Tracer::Record(const char* category, const char* name, const char* argName, int arg,
+                    uint64_t begin, uint64_t end)
+{
+    _LocalBuffer()->events.push_back({ category, name, argName, arg, begin, end });
+}
+
+
+/*
+ * Complete events ("ph": "X") in microseconds. Events of a thread are in
+ * the order they end, which is fine for the viewer.
+ */
+void Tracer::Dump(twio::IWriterPtr writer)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    writer->Write(R"({"displayTimeUnit":"ms","traceEvents":[)");
+    bool first = true;
+    for (const auto& buffer : _buffers)
+    {
+        for (const auto& event : buffer->events)
+        {
+            if (!first)
+            {
+                writer->Write(",\n");
+            }
+            first = false;
+            writer->WriteFormat(R"({"cat":"%s","name":"%s","ph":"X","pid":1,"tid":%d,"ts":%.3f,"dur":%.3f)",
+                                event.category,
+                                event.name,
+                                buffer->tid,
+                                static_cast<double>(event.begin) * 1e-3,
+                                static_cast<double>(event.end - event.begin) * 1e-3);
+            if (event.argName)
+            {
+                writer->WriteFormat(R"(,"args":{"%s":%d})", event.argName, event.arg);
+            }
+            writer->Write("}");
+        }
+    }
+    writer->Write("]}\n");
+}
+
+
+TOMIC_END